@@ -14,6 +14,7 @@
 // wxWindows headers
 #include <wx/wx.h>
 #include <wx/clipbrd.h>
+#include <wx/progdlg.h>
 
 #include "db/pgConn.h"
 #include "ctl/ctlSQLGrid.h"
@@ -24,6 +25,61 @@
 #define EXTRAEXTENT_HEIGHT 6
 #define EXTRAEXTENT_WIDTH  6
 
+// Copies of more cells than this run in a thread, with a progress dialogue
+#define COPY_BACKGROUND_CELLS   200000
+
+// Rows formatted between progress updates
+#define COPY_CHUNK_ROWS         1000
+
+// Rows measured at each end of a column and at random in between
+#define SAMPLE_ROWS             100
+
+// Text widths remembered per font, and the longest text remembered
+#define EXTENT_CACHE_SIZE       10000
+#define EXTENT_CACHE_TEXT       256
+
+
+// Formats a copy off the GUI thread; see ctlSQLGrid::CanCopyInBackground()
+class ctlSQLGridCopyThread : public wxThread
+{
+public:
+	ctlSQLGridCopyThread(ctlSQLGrid *_grid, const wxArrayInt &_rows, const wxArrayInt &_cols)
+		: wxThread(wxTHREAD_JOINABLE), grid(_grid), rows(_rows), cols(_cols)
+	{
+		done = 0;
+		ok = false;
+	}
+
+	void *Entry()
+	{
+		size_t first;
+
+		ok = true;
+		for (first = 0 ; first < rows.GetCount() && ok ; first += COPY_CHUNK_ROWS)
+		{
+			size_t last = wxMin(first + COPY_CHUNK_ROWS, rows.GetCount());
+			ok = grid->FormatCopyRows(text, rows, first, last, cols, this);
+			done = last;
+		}
+
+		return 0;
+	}
+
+	size_t GetDone() const
+	{
+		return done;
+	}
+
+	wxString text;
+	bool ok;
+
+private:
+	ctlSQLGrid *grid;
+	const wxArrayInt &rows, &cols;
+	volatile size_t done;
+};
+
+
 BEGIN_EVENT_TABLE(ctlSQLGrid, wxGrid)
 	EVT_MENU(MNU_COPY, ctlSQLGrid::OnCopy)
 	EVT_MOUSEWHEEL(ctlSQLGrid::OnMouseWheel)
@@ -149,83 +205,182 @@ wxString ctlSQLGrid::GetExportLine(int row, wxArrayInt cols)
 	return str;
 }
 
-int ctlSQLGrid::Copy()
+void ctlSQLGrid::PrepareCopy(const wxArrayInt &cols)
 {
-	wxString str;
-	int copied = 0;
+	copySeparator = settings->GetCopyColSeparator();
+	copyQuoteChar = settings->GetCopyQuoteChar();
+
+	int quoting = settings->GetCopyQuoting();
 	size_t i;
 
-	if (GetSelectedRows().GetCount())
+	copyQuote.Empty();
+	copyQuote.Alloc(cols.GetCount());
+	for (i = 0 ; i < cols.GetCount() ; i++)
 	{
-		wxArrayInt rows = GetSelectedRows();
+		if (quoting == 1)
+			copyQuote.Add(IsColText(cols.Item(i)) ? 1 : 0);
+		else if (quoting == 2)
+			/* Quote everything */
+			copyQuote.Add(1);
+		else
+			copyQuote.Add(0);
+	}
+}
 
-		for (i = 0 ; i < rows.GetCount() ; i++)
-		{
-			str.Append(GetExportLine(rows.Item(i)));
 
-			if (rows.GetCount() > 1)
-				str.Append(END_OF_LINE);
-		}
+bool ctlSQLGrid::FormatCopyRows(wxString &str, const wxArrayInt &rows, size_t first, size_t last, const wxArrayInt &cols, wxThread *thread)
+{
+	bool lineEnds = rows.GetCount() > 1;
+	size_t i, col;
 
-		copied = rows.GetCount();
-	}
-	else if (GetSelectedCols().GetCount())
+	for (i = first ; i < last ; i++)
 	{
-		wxArrayInt cols = GetSelectedCols();
-		size_t numRows = GetNumberRows();
+		if (thread && !(i % COPY_CHUNK_ROWS) && thread->TestDestroy())
+			return false;
+
+		// Once some rows are done, size the buffer for all of them
+		if (i == COPY_CHUNK_ROWS && rows.GetCount() > i)
+			str.Alloc(str.Length() / i * rows.GetCount() + str.Length() / 10);
 
-		for (i = 0 ; i < numRows ; i++)
+		int row = rows.Item(i);
+		for (col = 0 ; col < cols.GetCount() ; col++)
 		{
-			str.Append(GetExportLine(i, cols));
+			if (col > 0)
+				str.Append(copySeparator);
 
-			if (numRows > 1)
-				str.Append(END_OF_LINE);
+			if (copyQuote.Item(col))
+			{
+				str.Append(copyQuoteChar);
+				str.Append(GetCopyValue(row, cols.Item(col)));
+				str.Append(copyQuoteChar);
+			}
+			else
+				str.Append(GetCopyValue(row, cols.Item(col)));
 		}
 
-		copied = numRows;
+		if (lineEnds)
+			str.Append(END_OF_LINE);
+	}
+
+	return true;
+}
+
+
+void ctlSQLGrid::GetSelectedRange(wxArrayInt &rows, wxArrayInt &cols)
+{
+	int i;
+
+	rows.Empty();
+	cols.Empty();
+
+	if (GetSelectedRows().GetCount())
+	{
+		rows = GetSelectedRows();
+
+		cols.Alloc(GetNumberCols());
+		for (i = 0 ; i < GetNumberCols() ; i++)
+			cols.Add(i);
+	}
+	else if (GetSelectedCols().GetCount())
+	{
+		cols = GetSelectedCols();
+
+		rows.Alloc(GetNumberRows());
+		for (i = 0 ; i < GetNumberRows() ; i++)
+			rows.Add(i);
 	}
 	else if (GetSelectionBlockTopLeft().GetCount() > 0 &&
 	         GetSelectionBlockBottomRight().GetCount() > 0)
 	{
-		unsigned int x1, x2, y1, y2;
+		int x1, x2, y1, y2;
 
 		x1 = GetSelectionBlockTopLeft()[0].GetCol();
 		x2 = GetSelectionBlockBottomRight()[0].GetCol();
 		y1 = GetSelectionBlockTopLeft()[0].GetRow();
 		y2 = GetSelectionBlockBottomRight()[0].GetRow();
 
-		for (i = y1; i <= y2; i++)
-		{
-			str.Append(GetExportLine(i, x1, x2));
-
-			if (y2 > y1)
-				str.Append(END_OF_LINE);
-		}
-
-		copied = y2 - y1 + 1;
+		for (i = x1 ; i <= x2 ; i++)
+			cols.Add(i);
+		rows.Alloc(y2 - y1 + 1);
+		for (i = y1 ; i <= y2 ; i++)
+			rows.Add(i);
 	}
 	else
 	{
-		int row, col;
+		rows.Add(GetGridCursorRow());
+		cols.Add(GetGridCursorCol());
+	}
 
-		row = GetGridCursorRow();
-		col = GetGridCursorCol();
+	if (GetNumberCols() == 0)
+		cols.Empty();
+}
 
-		str.Append(GetExportLine(row, col, col));
-		copied = 1;
-	}
 
-	if (copied && wxTheClipboard->Open())
+int ctlSQLGrid::Copy()
+{
+	wxArrayInt rows, cols;
+
+	GetSelectedRange(rows, cols);
+
+	PrepareCopy(cols);
+
+	wxString str;
+	bool ok;
+
+	if (CanCopyInBackground() && rows.GetCount() * cols.GetCount() > COPY_BACKGROUND_CELLS)
+		ok = CopyInBackground(str, rows, cols);
+	else
+		ok = FormatCopyRows(str, rows, 0, rows.GetCount(), cols, 0);
+
+	int copied = 0;
+	if (ok && rows.GetCount() && wxTheClipboard->Open())
 	{
 		wxTheClipboard->SetData(new wxTextDataObject(str));
 		wxTheClipboard->Close();
+		copied = rows.GetCount();
 	}
-	else
+
+	return copied;
+}
+
+
+bool ctlSQLGrid::CopyInBackground(wxString &str, const wxArrayInt &rows, const wxArrayInt &cols)
+{
+	ctlSQLGridCopyThread *thread = new ctlSQLGridCopyThread(this, rows, cols);
+
+	if (thread->Create() != wxTHREAD_NO_ERROR || thread->Run() != wxTHREAD_NO_ERROR)
 	{
-		copied = 0;
+		delete thread;
+		return FormatCopyRows(str, rows, 0, rows.GetCount(), cols, 0);
 	}
 
-	return copied;
+	// The dialogue is application modal, so nothing can replace the data
+	// being copied until the thread is done
+	wxProgressDialog progress(_("Copy"), _("Copying the selection to the clipboard..."), rows.GetCount(), this,
+	                          wxPD_APP_MODAL | wxPD_AUTO_HIDE | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME | wxPD_REMAINING_TIME);
+
+	bool cancelled = false;
+	while (thread->IsRunning())
+	{
+		wxMilliSleep(50);
+		if (!progress.Update(thread->GetDone()))
+		{
+			cancelled = true;
+			break;
+		}
+	}
+
+	if (cancelled)
+		thread->Delete();
+	else
+		thread->Wait();
+
+	bool ok = !cancelled && thread->ok;
+	if (ok)
+		str.swap(thread->text);
+
+	delete thread;
+	return ok;
 }
 
 void ctlSQLGrid::OnLabelDoubleClick(wxGridEvent &event)
@@ -275,17 +430,7 @@ void ctlSQLGrid::OnLabelDoubleClick(wxGridEvent &event)
 	}
 	else if (col >= 0)
 	{
-		for (row = 0 ; row < GetNumberRows() ; row++)
-		{
-			if (CheckRowPresent(row))
-			{
-				extent = GetBestSize(row, col).GetWidth();
-				if (extent > extentWant)
-					extentWant = extent;
-			}
-		}
-
-		extentWant += EXTRAEXTENT_WIDTH;
+		extentWant = GetSampledColWidth(col);
 		extentWant = wxMax(extentWant, GetColMinimalAcceptableWidth());
 		extentWant = wxMin(extentWant, maxWidth * 3 / 4);
 		int currentWidth = GetColumnWidth(col);
@@ -313,6 +458,81 @@ void ctlSQLGrid::OnLabelDoubleClick(wxGridEvent &event)
 	}
 }
 
+int ctlSQLGrid::GetSampledColWidth(int col)
+{
+	wxClientDC dc(GetGridWindow());
+	wxArrayString lines;
+	long w, h;
+
+	dc.SetFont(GetLabelFont());
+	StringToLines(GetColLabelValue(col), lines);
+	GetTextBoxSize(dc, lines, &w, &h);
+	int width = w;
+
+	wxArrayInt rows;
+	int row, numRows = GetNumberRows();
+	if (numRows <= SAMPLE_ROWS * 3)
+	{
+		for (row = 0 ; row < numRows ; row++)
+			rows.Add(row);
+	}
+	else
+	{
+		rows.Alloc(SAMPLE_ROWS * 3);
+		for (row = 0 ; row < SAMPLE_ROWS ; row++)
+		{
+			rows.Add(row);
+			rows.Add(numRows - 1 - row);
+			rows.Add(SAMPLE_ROWS + rand() % (numRows - SAMPLE_ROWS * 2));
+		}
+	}
+
+	wxFont font = GetDefaultCellFont();
+	wxString fontDesc = font.GetNativeFontInfoDesc();
+	if (fontDesc != extentFont)
+	{
+		extentCache.clear();
+		extentFont = fontDesc;
+	}
+	dc.SetFont(font);
+
+	size_t i;
+	for (i = 0 ; i < rows.GetCount() ; i++)
+	{
+		if (CheckRowPresent(rows.Item(i)))
+			width = wxMax(width, GetTextWidth(dc, GetCellValue(rows.Item(i), col)));
+	}
+
+	return width + EXTRAEXTENT_WIDTH;
+}
+
+
+int ctlSQLGrid::GetTextWidth(wxDC &dc, const wxString &text)
+{
+	bool cache = text.Length() <= EXTENT_CACHE_TEXT;
+	if (cache)
+	{
+		ctlSQLGridExtentMap::iterator it = extentCache.find(text);
+		if (it != extentCache.end())
+			return it->second;
+	}
+
+	wxArrayString lines;
+	long w, h;
+	StringToLines(text, lines);
+	GetTextBoxSize(dc, lines, &w, &h);
+
+	if (cache)
+	{
+		if (extentCache.size() >= EXTENT_CACHE_SIZE)
+			extentCache.clear();
+		extentCache[text] = w;
+	}
+
+	return w;
+}
+
+
 wxSize ctlSQLGrid::GetBestSize(int row, int col)
 {
 	wxSize size;
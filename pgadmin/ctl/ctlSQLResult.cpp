@@ -20,6 +20,7 @@
 #include "ctl/ctlSQLResult.h"
 #include "utils/sysSettings.h"
 #include "frm/frmExport.h"
+#include "frm/menu.h"
 
 
 
@@ -28,13 +29,27 @@ ctlSQLResult::ctlSQLResult(wxWindow *parent, pgConn *_conn, wxWindowID id, const
 {
 	conn = _conn;
 	thread = 0;
+	rowcountSuppressed = false;
+	viewCol = -1;
 
-	SetTable(new sqlResultTable(), true);
+	sqlResultTable *table = new sqlResultTable();
+	table->SetView(&view);
+	SetTable(table, true);
 
 	EnableEditing(false);
 	SetSizer(new wxBoxSizer(wxVERTICAL));
 
 	Connect(wxID_ANY, wxEVT_GRID_RANGE_SELECT, wxGridRangeSelectEventHandler(ctlSQLResult::OnGridSelect));
+	Connect(wxID_ANY, wxEVT_GRID_CELL_RIGHT_CLICK, wxGridEventHandler(ctlSQLResult::OnCellRightClick));
+	Connect(wxID_ANY, wxEVT_GRID_LABEL_RIGHT_CLICK, wxGridEventHandler(ctlSQLResult::OnLabelRightClick));
+	Connect(MNU_ASCSORT, wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(ctlSQLResult::OnAscSort));
+	Connect(MNU_DESCSORT, wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(ctlSQLResult::OnDescSort));
+	Connect(MNU_REMOVESORT, wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(ctlSQLResult::OnRemoveSort));
+	Connect(MNU_INCLUDEFILTER, wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(ctlSQLResult::OnIncludeFilter));
+	Connect(MNU_EXCLUDEFILTER, wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(ctlSQLResult::OnExcludeFilter));
+	Connect(MNU_CONDITIONFILTER, wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(ctlSQLResult::OnConditionFilter));
+	Connect(MNU_REMOVEFILTERS, wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(ctlSQLResult::OnRemoveFilters));
+	Connect(MNU_AGGREGATE, wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(ctlSQLResult::OnAggregate));
 }
 
 
@@ -95,7 +110,20 @@ bool ctlSQLResult::IsColText(int col)
 }
 
 
-int ctlSQLResult::Execute(const wxString &query, int resultToRetrieve, wxWindow *caller, long eventId, void *data)
+// Results with this many different shapes have their widths remembered
+#define MAX_SHAPES 50
+
+wxString ctlSQLResult::GetShapeKey(const wxArrayString &headers)
+{
+	wxString key;
+	size_t i;
+	for (i = 0 ; i < headers.GetCount() ; i++)
+		key += headers.Item(i) + wxT("\t");
+	return key;
+}
+
+
+int ctlSQLResult::Execute(const wxString &query, int resultToRetrieve, wxWindow *caller, long eventId, void *data, bool binaryResults)
 {
 	colSizes.Empty();
 	colHeaders.Empty();
@@ -105,22 +133,19 @@ int ctlSQLResult::Execute(const wxString &query, int resultToRetrieve, wxWindow
 		colHeaders.Add(this->GetColLabelValue(col));
 	}
 
-	wxGridTableMessage *msg;
-	sqlResultTable *table = (sqlResultTable *)GetTable();
-	msg = new wxGridTableMessage(table, wxGRIDTABLE_NOTIFY_ROWS_DELETED, 0, GetNumberRows());
-	ProcessTableMessage(*msg);
-	delete msg;
-	msg = new wxGridTableMessage(table, wxGRIDTABLE_NOTIFY_COLS_DELETED, 0, GetNumberCols());
-	ProcessTableMessage(*msg);
-	delete msg;
-
-	Abort();
+	// Remember the widths, including any the user set, for when a result
+	// of the same shape comes back
+	if (colHeaders.GetCount() > 0)
+	{
+		if (shapeWidths.size() >= MAX_SHAPES)
+			shapeWidths.clear();
+		shapeWidths[GetShapeKey(colHeaders)] = colSizes;
+	}
 
-	colNames.Empty();
-	colTypes.Empty();
-	colTypClasses.Empty();
+	ClearResult();
 
 	thread = new pgQueryThread(conn, query, resultToRetrieve, caller, eventId, data);
+	thread->SetBinaryResults(binaryResults);
 
 	if (thread->Create() != wxTHREAD_NO_ERROR)
 	{
@@ -135,12 +160,34 @@ int ctlSQLResult::Execute(const wxString &query, int resultToRetrieve, wxWindow
 }
 
 
+void ctlSQLResult::ClearResult()
+{
+	wxGridTableMessage *msg;
+	sqlResultTable *table = (sqlResultTable *)GetTable();
+	msg = new wxGridTableMessage(table, wxGRIDTABLE_NOTIFY_ROWS_DELETED, 0, GetNumberRows());
+	ProcessTableMessage(*msg);
+	delete msg;
+	msg = new wxGridTableMessage(table, wxGRIDTABLE_NOTIFY_COLS_DELETED, 0, GetNumberCols());
+	ProcessTableMessage(*msg);
+	delete msg;
+
+	Abort();
+
+	colNames.Empty();
+	colTypes.Empty();
+	colTypClasses.Empty();
+}
+
+
 int ctlSQLResult::Abort()
 {
 	if (thread)
 	{
 		((sqlResultTable *)GetTable())->SetThread(0);
 
+		// The view points into the result the thread owns
+		view.Reset();
+
 		thread->Delete();
 		delete thread;
 	}
@@ -159,6 +206,7 @@ void ctlSQLResult::DisplayData(bool single)
 		return;
 
 	rowcountSuppressed = single;
+	view.Reset(thread->DataSet());
 	Freeze();
 
 	/*
@@ -203,6 +251,20 @@ void ctlSQLResult::DisplayData(bool single)
 		size_t hdrIndex = 0;
 		long col, nCols = thread->DataSet()->NumCols();
 
+		wxArrayString headers;
+		for (col = 0 ; col < nCols ; col++)
+			headers.Add(thread->DataSet()->ColName(col) + wxT("\n") + thread->DataSet()->ColFullType(col));
+
+		wxArrayInt shapeSizes;
+		ctlSQLResultWidthMap::iterator shape = shapeWidths.find(GetShapeKey(headers));
+		if (shape != shapeWidths.end() && shape->second.GetCount() == (size_t)nCols)
+			shapeSizes = shape->second;
+
+		// New columns get the width of their content, up to a third
+		// of the window
+		int maxWidth, maxHeight;
+		GetClientSize(&maxWidth, &maxHeight);
+
 		for (col = 0 ; col < nCols ; col++)
 		{
 			colName = thread->DataSet()->ColName(col);
@@ -211,12 +273,14 @@ void ctlSQLResult::DisplayData(bool single)
 			colTypes.Add(colType);
 			colTypClasses.Add(thread->DataSet()->ColTypClass(col));
 
-			wxString colHeader = colName + wxT("\n") + colType;
+			wxString colHeader = headers.Item(col);
 
-			if (hdrIndex < colHeaders.GetCount() && colHeaders.Item(hdrIndex) == colHeader)
+			if (shapeSizes.GetCount())
+				w = shapeSizes.Item(col);
+			else if (hdrIndex < colHeaders.GetCount() && colHeaders.Item(hdrIndex) == colHeader)
 				w = colSizes.Item(hdrIndex++);
 			else
-				w = -1;
+				w = wxMax(wxMin(GetSampledColWidth(col), maxWidth / 3), GetColMinimalAcceptableWidth());
 
 			SetColSize(col, w);
 			if (thread->DataSet()->ColTypClass(col) == PGTYPCLASS_NUMERIC)
@@ -253,10 +317,16 @@ pgError ctlSQLResult::GetResultError()
 	return conn->GetLastResultError();
 }
 
+// The rows shown, which are fewer than the rows of the result while a
+// filter is set
 long ctlSQLResult::NumRows() const
 {
 	if (thread && thread->DataValid())
+	{
+		if (view.IsActive())
+			return view.GetCount();
 		return thread->DataSet()->NumRows();
+	}
 	return 0;
 }
 
@@ -302,7 +372,7 @@ wxString ctlSQLResult::OnGetItemText(long item, long col) const
 		}
 		if (item >= 0)
 		{
-			thread->DataSet()->Locate(item + 1);
+			thread->DataSet()->Locate(view.GetRow(item) + 1);
 			return thread->DataSet()->GetVal(col);
 		}
 		else
@@ -316,13 +386,311 @@ void ctlSQLResult::OnGridSelect(wxGridRangeSelectEvent &event)
 	SetFocus();
 }
 
+
+bool ctlSQLResult::CanChangeView()
+{
+	return thread && !thread->IsRunning() && thread->DataValid() &&
+	       thread->ReturnCode() == PGRES_TUPLES_OK && !rowcountSuppressed;
+}
+
+
+void ctlSQLResult::OnLabelRightClick(wxGridEvent &event)
+{
+	if (!CanChangeView() || event.GetCol() < 0)
+		return;
+
+	viewCol = event.GetCol();
+
+	wxMenu *xmenu = new wxMenu();
+	xmenu->Append(MNU_ASCSORT, _("Sort &Ascending"), _("Sort the rows on this column, without querying the server again."));
+	xmenu->Append(MNU_DESCSORT, _("Sort &Descending"), _("Sort the rows on this column in descending order, without querying the server again."));
+	xmenu->Append(MNU_REMOVESORT, _("&Remove Sort"), _("Show the rows in the order the server returned them."));
+	xmenu->AppendSeparator();
+	xmenu->Append(MNU_CONDITIONFILTER, _("&Filter..."), _("Display only those rows whose value in this column meets a condition."));
+	xmenu->Append(MNU_REMOVEFILTERS, _("Remove F&ilter"), _("Display all rows of the result."));
+
+	xmenu->Enable(MNU_REMOVESORT, view.GetSortCol() >= 0);
+	xmenu->Enable(MNU_REMOVEFILTERS, view.GetFilterCount() > 0);
+
+	PopupMenu(xmenu);
+	delete xmenu;
+}
+
+
+void ctlSQLResult::OnCellRightClick(wxGridEvent &event)
+{
+	if (!CanChangeView() || event.GetRow() < 0 || event.GetCol() < 0)
+		return;
+
+	viewCol = event.GetCol();
+	SetGridCursor(event.GetRow(), event.GetCol());
+
+	wxMenu *xmenu = new wxMenu();
+	xmenu->Append(MNU_COPY, _("&Copy"), _("Copy selected cells to clipboard."));
+	xmenu->Append(MNU_AGGREGATE, _("A&ggregate Selection"), _("Show the count, sum, average, minimum and maximum of the selected cells."));
+	xmenu->AppendSeparator();
+	xmenu->Append(MNU_INCLUDEFILTER, _("Filter By &Selection"), _("Display only those rows that have this value in this column."));
+	xmenu->Append(MNU_EXCLUDEFILTER, _("Filter E&xcluding Selection"), _("Display only those rows that do not have this value in this column."));
+	xmenu->Append(MNU_CONDITIONFILTER, _("&Filter..."), _("Display only those rows whose value in this column meets a condition."));
+	xmenu->Append(MNU_REMOVEFILTERS, _("Remove F&ilter"), _("Display all rows of the result."));
+	xmenu->AppendSeparator();
+	xmenu->Append(MNU_ASCSORT, _("Sort &Ascending"), _("Sort the rows on this column, without querying the server again."));
+	xmenu->Append(MNU_DESCSORT, _("Sort &Descending"), _("Sort the rows on this column in descending order, without querying the server again."));
+	xmenu->Append(MNU_REMOVESORT, _("&Remove Sort"), _("Show the rows in the order the server returned them."));
+
+	xmenu->Enable(MNU_REMOVESORT, view.GetSortCol() >= 0);
+	xmenu->Enable(MNU_REMOVEFILTERS, view.GetFilterCount() > 0);
+
+	PopupMenu(xmenu);
+	delete xmenu;
+}
+
+
+// Tells the grid the rows changed after the view did
+void ctlSQLResult::RefreshView(long oldRows)
+{
+	wxGridTableMessage *msg;
+	sqlResultTable *table = (sqlResultTable *)GetTable();
+
+	BeginBatch();
+	ClearSelection();
+	msg = new wxGridTableMessage(table, wxGRIDTABLE_NOTIFY_ROWS_DELETED, 0, oldRows);
+	ProcessTableMessage(*msg);
+	delete msg;
+	msg = new wxGridTableMessage(table, wxGRIDTABLE_NOTIFY_ROWS_APPENDED, NumRows());
+	ProcessTableMessage(*msg);
+	delete msg;
+	EndBatch();
+
+	if (NumRows() > 0)
+		MakeCellVisible(0, wxMax(viewCol, 0));
+	ForceRefresh();
+}
+
+
+void ctlSQLResult::OnAscSort(wxCommandEvent &event)
+{
+	if (!CanChangeView())
+		return;
+
+	long oldRows = GetNumberRows();
+	view.Sort(viewCol, true);
+	RefreshView(oldRows);
+}
+
+
+void ctlSQLResult::OnDescSort(wxCommandEvent &event)
+{
+	if (!CanChangeView())
+		return;
+
+	long oldRows = GetNumberRows();
+	view.Sort(viewCol, false);
+	RefreshView(oldRows);
+}
+
+
+void ctlSQLResult::OnRemoveSort(wxCommandEvent &event)
+{
+	if (!CanChangeView())
+		return;
+
+	long oldRows = GetNumberRows();
+	view.RemoveSort();
+	RefreshView(oldRows);
+}
+
+
+void ctlSQLResult::OnIncludeFilter(wxCommandEvent &event)
+{
+	int row = GetGridCursorRow();
+	if (!CanChangeView() || row < 0 || viewCol < 0)
+		return;
+
+	pgSet *set = thread->DataSet();
+	long setRow = view.GetRow(row);
+
+	long oldRows = GetNumberRows();
+	if (set->IsNullAt(setRow, viewCol))
+		view.AddFilter(viewCol, RESULTFILTER_ISNULL, wxEmptyString);
+	else
+		view.AddFilter(viewCol, RESULTFILTER_EQUAL, set->GetValAt(setRow, viewCol));
+	RefreshView(oldRows);
+}
+
+
+void ctlSQLResult::OnExcludeFilter(wxCommandEvent &event)
+{
+	int row = GetGridCursorRow();
+	if (!CanChangeView() || row < 0 || viewCol < 0)
+		return;
+
+	pgSet *set = thread->DataSet();
+	long setRow = view.GetRow(row);
+
+	long oldRows = GetNumberRows();
+	if (set->IsNullAt(setRow, viewCol))
+		view.AddFilter(viewCol, RESULTFILTER_ISNOTNULL, wxEmptyString);
+	else
+		view.AddFilter(viewCol, RESULTFILTER_NOTEQUAL, set->GetValAt(setRow, viewCol));
+	RefreshView(oldRows);
+}
+
+
+void ctlSQLResult::OnConditionFilter(wxCommandEvent &event)
+{
+	if (!CanChangeView() || viewCol < 0)
+		return;
+
+	pgSet *set = thread->DataSet();
+	wxString colName = set->ColName(viewCol);
+
+	// In the order of the RESULTFILTER_xxx values
+	wxArrayString conditions;
+	conditions.Add(_("equal to"));
+	conditions.Add(_("not equal to"));
+	conditions.Add(_("less than"));
+	conditions.Add(_("less than or equal to"));
+	conditions.Add(_("greater than"));
+	conditions.Add(_("greater than or equal to"));
+	conditions.Add(_("containing"));
+	conditions.Add(_("not containing"));
+	conditions.Add(_("null"));
+	conditions.Add(_("not null"));
+
+	int op = wxGetSingleChoiceIndex(wxString::Format(_("Display only those rows whose value in column %s is"), colName.c_str()),
+	                                _("Filter"), conditions, this);
+	if (op < 0)
+		return;
+
+	wxString value;
+	if (op != RESULTFILTER_ISNULL && op != RESULTFILTER_ISNOTNULL)
+	{
+		int row = GetGridCursorRow();
+		if (row >= 0 && row < NumRows() && !set->IsNullAt(view.GetRow(row), viewCol))
+			value = set->GetValAt(view.GetRow(row), viewCol);
+
+		wxTextEntryDialog dlg(this, colName + wxT(" ") + conditions.Item(op) + wxT(":"),
+		                      _("Filter"), value);
+		if (dlg.ShowModal() != wxID_OK)
+			return;
+		value = dlg.GetValue();
+	}
+
+	long oldRows = GetNumberRows();
+	view.AddFilter(viewCol, op, value);
+	RefreshView(oldRows);
+}
+
+
+void ctlSQLResult::OnRemoveFilters(wxCommandEvent &event)
+{
+	if (!CanChangeView())
+		return;
+
+	long oldRows = GetNumberRows();
+	view.RemoveFilters();
+	RefreshView(oldRows);
+}
+
+
+void ctlSQLResult::OnAggregate(wxCommandEvent &event)
+{
+	if (!CanChangeView())
+		return;
+
+	wxArrayInt rows, cols, setRows;
+	GetSelectedRange(rows, cols);
+
+	size_t i;
+	setRows.Alloc(rows.GetCount());
+	for (i = 0 ; i < rows.GetCount() ; i++)
+	{
+		if (rows.Item(i) >= 0 && rows.Item(i) < NumRows())
+			setRows.Add(view.GetRow(rows.Item(i)));
+	}
+
+	wxString str;
+	for (i = 0 ; i < cols.GetCount() ; i++)
+	{
+		if (cols.Item(i) < 0)
+			continue;
+		if (!str.IsEmpty())
+			str += wxT("\n\n");
+		str += thread->DataSet()->ColName(cols.Item(i)) + wxT("\n");
+		str += view.Aggregate(setRows, cols.Item(i));
+	}
+
+	if (!str.IsEmpty())
+		wxMessageBox(str, _("Aggregate Selection"), wxICON_INFORMATION | wxOK, this);
+}
+
+static wxString AddThousandsSeparator(const wxString &value, const wxString &separator)
+{
+	wxString s = value;
+	size_t pos = s.find(wxT("."));
+	if (pos == wxString::npos)
+		pos = s.length();
+	while (pos > 3)
+	{
+		pos -= 3;
+		if (pos > 1 || !s.StartsWith(wxT("-")))
+			s.insert(pos, separator);
+	}
+	return s;
+}
+
+
+void ctlSQLResult::PrepareCopy(const wxArrayInt &cols)
+{
+	ctlSQLGrid::PrepareCopy(cols);
+
+	copyIndicateNull = settings->GetIndicateNull();
+	copyThousandsSeparator = settings->GetThousandsSeparator();
+
+	copyNumeric.Empty();
+	if (thread && thread->DataValid())
+	{
+		long col, nCols = thread->DataSet()->NumCols();
+		copyNumeric.Alloc(nCols);
+		for (col = 0 ; col < nCols ; col++)
+			copyNumeric.Add(thread->DataSet()->ColTypClass(col) == PGTYPCLASS_NUMERIC ? 1 : 0);
+	}
+}
+
+
+// Same text as sqlResultTable::GetValue(), but straight from the result
+wxString ctlSQLResult::GetCopyValue(int row, int col)
+{
+	if (!thread || !thread->DataValid() || col >= (int)copyNumeric.GetCount())
+		return ctlSQLGrid::GetCopyValue(row, col);
+
+	pgSet *set = thread->DataSet();
+	row = view.GetRow(row);
+
+	if (copyIndicateNull && set->IsNullAt(row, col))
+		return wxT("<NULL>");
+
+	if (copyNumeric.Item(col) && !copyThousandsSeparator.IsEmpty())
+		return AddThousandsSeparator(set->GetValAt(row, col), copyThousandsSeparator);
+
+	return set->GetValAt(row, col);
+}
+
+
+bool ctlSQLResult::CanCopyInBackground()
+{
+	return thread && thread->DataValid();
+}
+
+
 wxString sqlResultTable::GetValue(int row, int col)
 {
 	if (thread && thread->DataValid())
 	{
 		if (col >= 0)
 		{
-			thread->DataSet()->Locate(row + 1);
+			thread->DataSet()->Locate(view->GetRow(row) + 1);
 			if (settings->GetIndicateNull() && thread->DataSet()->IsNull(col))
 				return wxT("<NULL>");
 			else
@@ -331,17 +699,7 @@ wxString sqlResultTable::GetValue(int row, int col)
 				        settings->GetThousandsSeparator().Length() > 0)
 				{
 					/* Add thousands separator */
-					wxString s = thread->DataSet()->GetVal(col);
-					size_t pos = s.find(wxT("."));
-					if (pos == wxString::npos)
-						pos = s.length();
-					while (pos > 3)
-					{
-						pos -= 3;
-						if (pos > 1 || !s.StartsWith(wxT("-")))
-							s.insert(pos, settings->GetThousandsSeparator());
-					}
-					return s;
+					return AddThousandsSeparator(thread->DataSet()->GetVal(col), settings->GetThousandsSeparator());
 				}
 				else
 					return thread->DataSet()->GetVal(col);
@@ -356,12 +714,17 @@ wxString sqlResultTable::GetValue(int row, int col)
 sqlResultTable::sqlResultTable()
 {
 	thread = 0;
+	view = 0;
 }
 
 int sqlResultTable::GetNumberRows()
 {
 	if (thread && thread->DataValid())
+	{
+		if (view && view->IsActive())
+			return view->GetCount();
 		return thread->DataSet()->NumRows();
+	}
 	return 0;
 }
 
@@ -0,0 +1,823 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// ctlSQLResultView.cpp - Sorted and filtered view of a query result
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "pgAdmin3.h"
+
+// wxWindows headers
+#include <wx/wx.h>
+
+#include <math.h>
+#include <float.h>
+
+// App headers
+#include "ctl/ctlSQLResultView.h"
+
+#include <wx/arrimpl.cpp>
+WX_DEFINE_OBJARRAY(sqlResultFilterArray);
+
+// Fewest rows given to a thread, and most threads used
+#define RESULTVIEW_CHUNK_ROWS   50000
+#define RESULTVIEW_MAX_THREADS  8
+
+// Rows put in order by insertion before the merging starts
+#define RESULTVIEW_RUN_ROWS     32
+
+// Longest value shown with the aggregates
+#define RESULTVIEW_MAX_TEXT     40
+
+enum
+{
+	TASK_KEYS = 0,
+	TASK_FILTER,
+	TASK_SORT,
+	TASK_MERGE
+};
+
+
+// Runs one part of a task of the view; see sqlResultView::RunJobs()
+class sqlResultViewThread : public wxThread
+{
+public:
+	sqlResultViewThread(sqlResultView *_view, int _task, long _first, long _middle, long _last)
+		: wxThread(wxTHREAD_JOINABLE)
+	{
+		view = _view;
+		task = _task;
+		first = _first;
+		middle = _middle;
+		last = _last;
+	}
+
+	void *Entry()
+	{
+		view->RunTask(task, first, middle, last);
+		return 0;
+	}
+
+private:
+	sqlResultView *view;
+	int task;
+	long first, middle, last;
+};
+
+
+static long ParseDigits(const char *&s)
+{
+	long value = 0;
+	while (isdigit((unsigned char)*s))
+		value = value * 10 + (*s++ - '0');
+	return value;
+}
+
+
+// Numbers as the server writes them, read the same way whatever the locale
+// of the client. The currency symbol and group separators of money are
+// skipped, and NaN sorts above infinity as it does on the server.
+static double ParseNumber(const char *s)
+{
+	bool negative = false;
+
+	// tid
+	if (*s == '(')
+	{
+		s++;
+		double block = ParseDigits(s);
+		if (*s == ',')
+			s++;
+		return block * 65536.0 + ParseDigits(s);
+	}
+
+	while (*s && !isdigit((unsigned char)*s) && *s != '.')
+	{
+		if (*s == '-')
+			negative = true;
+		else if (*s == 'N')
+			return HUGE_VAL;
+		else if (*s == 'I')
+			return negative ? -HUGE_VAL : DBL_MAX;
+		s++;
+	}
+
+	double value = 0.0;
+	int scale = 0;
+	bool fraction = false;
+	for (;; s++)
+	{
+		if (isdigit((unsigned char)*s))
+		{
+			value = value * 10.0 + (*s - '0');
+			if (fraction)
+				scale--;
+		}
+		else if (*s == '.' && !fraction)
+			fraction = true;
+		else if (*s != ',')
+			break;
+	}
+
+	if (*s == 'e' || *s == 'E')
+	{
+		s++;
+		bool negativeExponent = (*s == '-');
+		if (*s == '-' || *s == '+')
+			s++;
+		long exponent = ParseDigits(s);
+		scale += negativeExponent ? -exponent : exponent;
+	}
+
+	// Dividing by an exact power of ten keeps 0.1 and 0.10 equal
+	if (scale < 0)
+		value /= pow(10.0, -scale);
+	else if (scale > 0)
+		value *= pow(10.0, scale);
+
+	return negative ? -value : value;
+}
+
+
+// Days from a fixed day to the given date of the Gregorian calendar
+static double DaysFromCivil(long year, long month, long day)
+{
+	if (month <= 2)
+		year--;
+	long era = (year >= 0 ? year : year - 399) / 400;
+	long yearOfEra = year - era * 400;
+	long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+	return era * 146097.0 + dayOfEra;
+}
+
+
+// Timestamps and times in the ISO style the connection asks for, and
+// intervals in the postgres style, as seconds. Values with a time zone are
+// moved to UTC; months and years of intervals are counted as 30 and 365.25
+// days, like the server does to compare them.
+static double ParseDateTime(const char *s)
+{
+	if (!strcmp(s, "infinity"))
+		return HUGE_VAL;
+	if (!strcmp(s, "-infinity"))
+		return -HUGE_VAL;
+
+	double seconds = 0.0;
+	const char *p = s;
+
+	// Date, the year having four digits or more
+	while (isdigit((unsigned char)*p))
+		p++;
+	if (p - s >= 4 && *p == '-')
+	{
+		p = s;
+		long year = ParseDigits(p);
+		if (*p == '-')
+			p++;
+		long month = ParseDigits(p);
+		if (*p == '-')
+			p++;
+		long day = ParseDigits(p);
+
+		if (strstr(p, " BC"))
+			year = 1 - year;
+
+		seconds = DaysFromCivil(year, month, day) * 86400.0;
+	}
+	else
+		p = s;
+
+	// Time of day and parts of an interval
+	while (*p)
+	{
+		if (*p == ' ' || *p == 'T')
+		{
+			p++;
+			continue;
+		}
+
+		bool negative = false;
+		if (*p == '-' || *p == '+')
+			negative = (*p++ == '-');
+
+		if (!isdigit((unsigned char)*p))
+			break;
+
+		long number = ParseDigits(p);
+		if (*p == ':')
+		{
+			double time = number * 3600.0;
+			p++;
+			time += ParseDigits(p) * 60.0;
+			if (*p == ':')
+			{
+				p++;
+				time += ParseDigits(p);
+				if (*p == '.')
+				{
+					double scale = 0.1;
+					for (p++ ; isdigit((unsigned char)*p) ; p++, scale /= 10.0)
+						time += (*p - '0') * scale;
+				}
+			}
+			seconds += negative ? -time : time;
+
+			// A time zone follows the time straight away
+			if (*p == '+' || *p == '-')
+			{
+				bool west = (*p++ == '-');
+				double zone = ParseDigits(p) * 3600.0;
+				if (*p == ':')
+				{
+					p++;
+					zone += ParseDigits(p) * 60.0;
+					if (*p == ':')
+					{
+						p++;
+						zone += ParseDigits(p);
+					}
+				}
+				seconds += west ? zone : -zone;
+			}
+		}
+		else
+		{
+			while (*p == ' ')
+				p++;
+
+			double unit;
+			if (!strncmp(p, "year", 4))
+				unit = 365.25 * 86400.0;
+			else if (!strncmp(p, "mon", 3))
+				unit = 30.0 * 86400.0;
+			else if (!strncmp(p, "day", 3))
+				unit = 86400.0;
+			else
+				break;
+
+			seconds += (negative ? -number : number) * unit;
+			while (isalpha((unsigned char)*p))
+				p++;
+		}
+	}
+
+	return seconds;
+}
+
+
+sqlResultKeys::sqlResultKeys(pgSet *_set, int _col)
+{
+	set = _set;
+	col = _col;
+	typClass = set->ColTypClass(col);
+
+	long count = set->NumRows();
+	nulls = new char[count];
+
+	switch (typClass)
+	{
+		case PGTYPCLASS_NUMERIC:
+		case PGTYPCLASS_BOOL:
+		case PGTYPCLASS_DATE:
+			numbers = new double[count];
+			texts = 0;
+			break;
+		default:
+			numbers = 0;
+			texts = new const char *[count];
+			break;
+	}
+}
+
+
+sqlResultKeys::~sqlResultKeys()
+{
+	delete [] nulls;
+	if (numbers)
+		delete [] numbers;
+	if (texts)
+		delete [] texts;
+}
+
+
+void sqlResultKeys::Build(long first, long last)
+{
+	long row;
+	for (row = first ; row < last ; row++)
+	{
+		nulls[row] = set->IsNullAt(row, col) ? 1 : 0;
+
+		const char *value = set->GetCharPtrAt(row, col);
+		if (numbers)
+			numbers[row] = nulls[row] ? 0.0 : ParseValue(value);
+		else
+			texts[row] = value;
+	}
+}
+
+
+double sqlResultKeys::ParseValue(const char *value) const
+{
+	switch (typClass)
+	{
+		case PGTYPCLASS_NUMERIC:
+			return ParseNumber(value);
+		case PGTYPCLASS_BOOL:
+			return *value == 't' ? 1.0 : 0.0;
+		case PGTYPCLASS_DATE:
+			return ParseDateTime(value);
+	}
+	return 0.0;
+}
+
+
+// Text compares byte by byte, which is code point order for UTF-8
+int sqlResultKeys::Compare(long row1, long row2) const
+{
+	if (nulls[row1] || nulls[row2])
+		return nulls[row1] - nulls[row2];
+
+	if (numbers)
+	{
+		if (numbers[row1] < numbers[row2])
+			return -1;
+		if (numbers[row1] > numbers[row2])
+			return 1;
+		return 0;
+	}
+
+	return strcmp(texts[row1], texts[row2]);
+}
+
+
+sqlResultView::sqlResultView()
+{
+	set = 0;
+	colCount = 0;
+	keys = 0;
+	sortCol = -1;
+	sortAscending = true;
+
+	taskKeys = 0;
+	taskRows = 0;
+	taskScratch = 0;
+	taskAscending = true;
+	taskMatches = 0;
+	taskFilter = 0;
+	taskText = 0;
+	taskNumber = 0.0;
+}
+
+
+sqlResultView::~sqlResultView()
+{
+	Reset();
+}
+
+
+void sqlResultView::Reset(pgSet *_set)
+{
+	if (keys)
+	{
+		long col;
+		for (col = 0 ; col < colCount ; col++)
+		{
+			if (keys[col])
+				delete keys[col];
+		}
+		delete [] keys;
+		keys = 0;
+	}
+
+	rows.Clear();
+	filters.Clear();
+	sortCol = -1;
+	sortAscending = true;
+
+	set = _set;
+	colCount = 0;
+	if (set)
+	{
+		colCount = set->NumCols();
+		keys = new sqlResultKeys *[colCount];
+		memset(keys, 0, colCount * sizeof(sqlResultKeys *));
+	}
+}
+
+
+long sqlResultView::GetCount() const
+{
+	if (IsActive())
+		return rows.GetCount();
+	if (set)
+		return set->NumRows();
+	return 0;
+}
+
+
+void sqlResultView::Sort(int col, bool ascending)
+{
+	if (!set || col < 0 || col >= colCount)
+		return;
+
+	sortCol = col;
+	sortAscending = ascending;
+	Apply();
+}
+
+
+void sqlResultView::RemoveSort()
+{
+	sortCol = -1;
+	Apply();
+}
+
+
+void sqlResultView::AddFilter(int col, int op, const wxString &value)
+{
+	if (!set || col < 0 || col >= colCount)
+		return;
+
+	sqlResultFilter filter;
+	filter.col = col;
+	filter.op = op;
+	filter.value = value;
+	filters.Add(filter);
+
+	Apply();
+}
+
+
+void sqlResultView::RemoveFilters()
+{
+	filters.Clear();
+	Apply();
+}
+
+
+// Works out the rows of the view again from the filters and the sort
+void sqlResultView::Apply()
+{
+	rows.Clear();
+	if (!IsActive())
+		return;
+
+	wxBusyCursor wait;
+
+	long row, count = set->NumRows();
+	wxArrayLong firsts, lasts;
+	GetChunks(count, firsts, lasts);
+
+	char *matches = new char[count];
+	memset(matches, 1, count);
+
+	size_t i;
+	for (i = 0 ; i < filters.GetCount() ; i++)
+	{
+		const sqlResultFilter &filter = filters.Item(i);
+		sqlResultKeys *filterKeys = GetKeys(filter.col);
+
+		// The value in the encoding of the result, to compare with the
+		// text of the rows as it is
+		wxCharBuffer text = filter.value.mb_str(set->GetConversion());
+
+		taskKeys = filterKeys;
+		taskFilter = &filter;
+		taskText = text.data() ? text.data() : "";
+		taskNumber = filterKeys->IsNumber() ? filterKeys->ParseValue(taskText) : 0.0;
+		taskMatches = matches;
+
+		RunJobs(TASK_FILTER, firsts, firsts, lasts);
+	}
+
+	rows.Alloc(count);
+	for (row = 0 ; row < count ; row++)
+	{
+		if (matches[row])
+			rows.Add(row);
+	}
+	delete [] matches;
+
+	if (sortCol >= 0)
+		SortRows(rows, GetKeys(sortCol), sortAscending);
+}
+
+
+sqlResultKeys *sqlResultView::GetKeys(int col)
+{
+	if (!keys[col])
+	{
+		keys[col] = new sqlResultKeys(set, col);
+
+		wxArrayLong firsts, lasts;
+		GetChunks(set->NumRows(), firsts, lasts);
+
+		taskKeys = keys[col];
+		RunJobs(TASK_KEYS, firsts, firsts, lasts);
+	}
+	return keys[col];
+}
+
+
+// Stable, so rows with equal values keep the order they had. As on the
+// server, nulls come last in ascending order and first in descending order.
+void sqlResultView::SortRows(wxArrayInt &list, sqlResultKeys *sortKeys, bool ascending)
+{
+	long count = list.GetCount();
+	if (count < 2)
+		return;
+
+	int *scratch = new int[count];
+
+	taskKeys = sortKeys;
+	taskAscending = ascending;
+	taskRows = &list[0];
+	taskScratch = scratch;
+
+	// Each thread sorts a part of the rows...
+	wxArrayLong firsts, lasts;
+	GetChunks(count, firsts, lasts);
+	RunJobs(TASK_SORT, firsts, firsts, lasts);
+
+	// ...then neighbouring parts are merged in pairs until one is left
+	while (firsts.GetCount() > 1)
+	{
+		wxArrayLong mergeFirsts, middles, mergeLasts;
+		size_t i;
+
+		for (i = 0 ; i + 1 < firsts.GetCount() ; i += 2)
+		{
+			mergeFirsts.Add(firsts.Item(i));
+			middles.Add(firsts.Item(i + 1));
+			mergeLasts.Add(lasts.Item(i + 1));
+		}
+		RunJobs(TASK_MERGE, mergeFirsts, middles, mergeLasts);
+
+		if (i < firsts.GetCount())
+		{
+			mergeFirsts.Add(firsts.Item(i));
+			mergeLasts.Add(lasts.Item(i));
+		}
+		firsts = mergeFirsts;
+		lasts = mergeLasts;
+	}
+
+	delete [] scratch;
+}
+
+
+void sqlResultView::SortRange(long first, long last)
+{
+	long i, j, width;
+
+	for (i = first ; i < last ; i += RESULTVIEW_RUN_ROWS)
+	{
+		long runLast = wxMin(i + RESULTVIEW_RUN_ROWS, last);
+		for (j = i + 1 ; j < runLast ; j++)
+		{
+			int row = taskRows[j];
+			long k = j;
+			while (k > i && CompareRows(taskRows[k - 1], row) > 0)
+			{
+				taskRows[k] = taskRows[k - 1];
+				k--;
+			}
+			taskRows[k] = row;
+		}
+	}
+
+	for (width = RESULTVIEW_RUN_ROWS ; width < last - first ; width *= 2)
+	{
+		for (i = first ; i + width < last ; i += 2 * width)
+			MergeRange(i, i + width, wxMin(i + 2 * width, last));
+	}
+}
+
+
+void sqlResultView::MergeRange(long first, long middle, long last)
+{
+	// Already in order
+	if (CompareRows(taskRows[middle - 1], taskRows[middle]) <= 0)
+		return;
+
+	long i = first, j = middle, k = first;
+	while (i < middle && j < last)
+	{
+		if (CompareRows(taskRows[j], taskRows[i]) < 0)
+			taskScratch[k++] = taskRows[j++];
+		else
+			taskScratch[k++] = taskRows[i++];
+	}
+	while (i < middle)
+		taskScratch[k++] = taskRows[i++];
+
+	// What is left of the second half is in place already
+	memcpy(taskRows + first, taskScratch + first, (k - first) * sizeof(int));
+}
+
+
+// Like in SQL, a null meets no condition but IS NULL
+bool sqlResultView::Matches(long row) const
+{
+	int op = taskFilter->op;
+
+	if (op == RESULTFILTER_ISNULL)
+		return taskKeys->IsNull(row);
+	if (op == RESULTFILTER_ISNOTNULL)
+		return !taskKeys->IsNull(row);
+	if (taskKeys->IsNull(row))
+		return false;
+
+	if (op == RESULTFILTER_CONTAINS || op == RESULTFILTER_NOTCONTAINS)
+	{
+		bool found = strstr(set->GetCharPtrAt(row, taskFilter->col), taskText) != 0;
+		return op == RESULTFILTER_CONTAINS ? found : !found;
+	}
+
+	int rc;
+	if (taskKeys->IsNumber())
+	{
+		double number = taskKeys->GetNumber(row);
+		rc = number < taskNumber ? -1 : (number > taskNumber ? 1 : 0);
+	}
+	else
+		rc = strcmp(taskKeys->GetText(row), taskText);
+
+	switch (op)
+	{
+		case RESULTFILTER_EQUAL:
+			return rc == 0;
+		case RESULTFILTER_NOTEQUAL:
+			return rc != 0;
+		case RESULTFILTER_LESS:
+			return rc < 0;
+		case RESULTFILTER_LESSEQUAL:
+			return rc <= 0;
+		case RESULTFILTER_GREATER:
+			return rc > 0;
+		case RESULTFILTER_GREATEREQUAL:
+			return rc >= 0;
+	}
+	return false;
+}
+
+
+void sqlResultView::RunTask(int task, long first, long middle, long last)
+{
+	long row;
+
+	switch (task)
+	{
+		case TASK_KEYS:
+			taskKeys->Build(first, last);
+			break;
+
+		case TASK_FILTER:
+			for (row = first ; row < last ; row++)
+			{
+				if (taskMatches[row] && !Matches(row))
+					taskMatches[row] = 0;
+			}
+			break;
+
+		case TASK_SORT:
+			SortRange(first, last);
+			break;
+
+		case TASK_MERGE:
+			MergeRange(first, middle, last);
+			break;
+	}
+}
+
+
+// Runs the task on each of the given ranges of rows at the same time: the
+// first range on the calling thread, the others on threads of their own.
+// The ranges never overlap, so the task needs no locking.
+void sqlResultView::RunJobs(int task, const wxArrayLong &firsts, const wxArrayLong &middles, const wxArrayLong &lasts)
+{
+	wxArrayPtrVoid threads;
+	size_t i;
+
+	for (i = 1 ; i < firsts.GetCount() ; i++)
+	{
+		sqlResultViewThread *thread = new sqlResultViewThread(this, task, firsts.Item(i), middles.Item(i), lasts.Item(i));
+		if (thread->Create() != wxTHREAD_NO_ERROR || thread->Run() != wxTHREAD_NO_ERROR)
+		{
+			delete thread;
+			RunTask(task, firsts.Item(i), middles.Item(i), lasts.Item(i));
+		}
+		else
+			threads.Add(thread);
+	}
+
+	if (firsts.GetCount() > 0)
+		RunTask(task, firsts.Item(0), middles.Item(0), lasts.Item(0));
+
+	for (i = 0 ; i < threads.GetCount() ; i++)
+	{
+		sqlResultViewThread *thread = (sqlResultViewThread *)threads.Item(i);
+		thread->Wait();
+		delete thread;
+	}
+}
+
+
+// Splits the rows in one range per processor, none of them small
+void sqlResultView::GetChunks(long count, wxArrayLong &firsts, wxArrayLong &lasts)
+{
+	long threadCount = wxThread::GetCPUCount();
+	if (threadCount > RESULTVIEW_MAX_THREADS)
+		threadCount = RESULTVIEW_MAX_THREADS;
+	if (threadCount < 1)
+		threadCount = 1;
+
+	long size = (count + threadCount - 1) / threadCount;
+	if (size < RESULTVIEW_CHUNK_ROWS)
+		size = RESULTVIEW_CHUNK_ROWS;
+
+	long first;
+	for (first = 0 ; first < count ; first += size)
+	{
+		firsts.Add(first);
+		lasts.Add(wxMin(first + size, count));
+	}
+}
+
+
+static wxString ShortText(const wxString &text)
+{
+	if (text.Length() > RESULTVIEW_MAX_TEXT)
+		return text.Left(RESULTVIEW_MAX_TEXT) + wxT("...");
+	return text;
+}
+
+
+wxString sqlResultView::Aggregate(const wxArrayInt &setRows, int col)
+{
+	if (!set || col < 0 || col >= colCount)
+		return wxEmptyString;
+
+	wxBusyCursor wait;
+
+	sqlResultKeys *colKeys = GetKeys(col);
+	bool numeric = (colKeys->GetTypClass() == PGTYPCLASS_NUMERIC);
+
+	wxArrayInt values;
+	values.Alloc(setRows.GetCount());
+
+	long minRow = -1, maxRow = -1;
+	double sum = 0.0;
+	size_t i;
+
+	for (i = 0 ; i < setRows.GetCount() ; i++)
+	{
+		int row = setRows.Item(i);
+		if (colKeys->IsNull(row))
+			continue;
+
+		values.Add(row);
+		if (minRow < 0 || colKeys->Compare(row, minRow) < 0)
+			minRow = row;
+		if (maxRow < 0 || colKeys->Compare(row, maxRow) > 0)
+			maxRow = row;
+		if (numeric)
+			sum += colKeys->GetNumber(row);
+	}
+
+	// Distinct values are neighbours once sorted
+	long distinct = 0;
+	if (values.GetCount() > 0)
+	{
+		SortRows(values, colKeys, true);
+
+		distinct = 1;
+		for (i = 1 ; i < values.GetCount() ; i++)
+		{
+			if (colKeys->Compare(values.Item(i - 1), values.Item(i)))
+				distinct++;
+		}
+	}
+
+	wxString str = wxString::Format(_("Count: %ld (%ld not null, %ld distinct)"),
+	                                (long)setRows.GetCount(), (long)values.GetCount(), distinct);
+
+	if (minRow >= 0)
+	{
+		str += wxT("\n") + wxString::Format(_("Minimum: %s"), ShortText(set->GetValAt(minRow, col)).c_str());
+		str += wxT("\n") + wxString::Format(_("Maximum: %s"), ShortText(set->GetValAt(maxRow, col)).c_str());
+	}
+
+	if (numeric && values.GetCount() > 0)
+	{
+		str += wxT("\n") + wxString::Format(_("Sum: %.15g"), sum);
+		str += wxT("\n") + wxString::Format(_("Average: %.15g"), sum / values.GetCount());
+	}
+
+	return str;
+}
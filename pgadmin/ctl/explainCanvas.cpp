@@ -17,6 +17,9 @@
 #include "pgAdmin3.h"
 
 #include "ctl/explainCanvas.h"
+#include "ctl/explainPlan.h"
+
+WX_DECLARE_VOIDPTR_HASH_MAP(ExplainShape *, explainShapeMap);
 
 
 BEGIN_EVENT_TABLE(ExplainCanvas, wxShapeCanvas)
@@ -31,17 +34,28 @@ ExplainCanvas::ExplainCanvas(wxWindow *parent)
 	GetDiagram()->SetCanvas(this);
 	SetBackgroundColour(*wxWHITE);
 	popup = NULL;
+	rootShape = NULL;
+	plan = NULL;
 }
 
 
 ExplainCanvas::~ExplainCanvas()
 {
+	if (plan)
+		delete plan;
 }
 
 
 void ExplainCanvas::Clear()
 {
 	GetDiagram()->DeleteAllShapes();
+	rootShape = NULL;
+
+	if (plan)
+	{
+		delete plan;
+		plan = NULL;
+	}
 }
 
 
@@ -117,6 +131,58 @@ void ExplainCanvas::SetExplainString(const wxString &str)
 		last = s;
 	}
 
+	LayoutShapes(maxLevel);
+}
+
+
+// Takes ownership of the plan; the shapes refer to its nodes.
+void ExplainCanvas::SetExplainPlan(ExplainPlan *newPlan)
+{
+	Clear();
+
+	plan = newPlan;
+	if (!plan || !plan->GetRoot())
+		return;
+
+	double totalTime = plan->GetTotalRuntime();
+	if (totalTime <= 0.0)
+		totalTime = plan->GetRoot()->GetInclusiveTime();
+
+	// Nodes are stored in pre-order, so every parent already has its shape
+	// when its children are created.
+	const ExplainNodeArray &nodes = plan->GetNodes();
+	explainShapeMap shapes;
+	int maxLevel = 0;
+
+	size_t i;
+	for (i = 0 ; i < nodes.GetCount() ; i++)
+	{
+		ExplainNode *node = nodes.Item(i);
+		ExplainShape *upper = node->GetParent() ? shapes[node->GetParent()] : NULL;
+
+		ExplainShape *s = ExplainShape::Create(upper, node, totalTime);
+		if (!s)
+			continue;
+		s->SetCanvas(this);
+		InsertShape(s);
+		s->Show(true);
+		shapes[node] = s;
+
+		if (node->GetLevel() > maxLevel)
+			maxLevel = node->GetLevel();
+
+		if (!upper)
+			rootShape = s;
+	}
+
+	LayoutShapes(maxLevel);
+}
+
+
+void ExplainCanvas::LayoutShapes(int maxLevel)
+{
+	if (!rootShape)
+		return;
 
 	int x0 = (int)(rootShape->GetWidth() * 3);
 	int y0 = (int)(rootShape->GetHeight() * 3 / 2);
@@ -284,6 +350,8 @@ ExplainText::ExplainText(ExplainPopup *parent, ExplainShape *s) : wxWindow(paren
 	if (w1 < w2)    w1 = w2;
 	dc.GetTextExtent(shape->actual, &w2, &h);
 	if (w1 < w2)    w1 = w2;
+	dc.GetTextExtent(shape->analysis, &w2, &h);
+	if (w1 < w2)    w1 = w2;
 
 	int n = 2;
 	if (!shape->detail.IsEmpty())
@@ -294,6 +362,8 @@ ExplainText::ExplainText(ExplainPopup *parent, ExplainShape *s) : wxWindow(paren
 		n++;
 	if (!shape->actual.IsEmpty())
 		n++;
+	if (!shape->analysis.IsEmpty())
+		n++;
 
 	if (!h)
 		h = GetCharHeight();
@@ -363,6 +433,11 @@ void ExplainText::OnPaint(wxPaintEvent &ev)
 		y += yoffs;
 		dc.DrawText(shape->actual, x, y);
 	}
+	if (!shape->analysis.IsEmpty())
+	{
+		y += yoffs;
+		dc.DrawText(shape->analysis, x, y);
+	}
 
 #if wxUSE_POPUPWIN
 
@@ -0,0 +1,250 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// explainHotNodes.cpp - Sortable list of the plan nodes of an explain
+//
+//////////////////////////////////////////////////////////////////////////
+
+// wxWindows headers
+#include <wx/wx.h>
+
+// App headers
+#include "pgAdmin3.h"
+#include "ctl/explainPlan.h"
+#include "ctl/explainHotNodes.h"
+
+#include <wx/arrimpl.cpp>
+WX_DEFINE_OBJARRAY(explainHotNodeArray);
+
+
+enum
+{
+	COL_NODENO = 0,
+	COL_NAME,
+	COL_EXCLUSIVE,
+	COL_INCLUSIVE,
+	COL_PERCENT,
+	COL_ROWS,
+	COL_PLANROWS,
+	COL_ERROR,
+	COL_LOOPS,
+	COL_SHAREDHIT,
+	COL_SHAREDREAD
+};
+
+
+BEGIN_EVENT_TABLE(ExplainHotNodes, wxListView)
+	EVT_LIST_COL_CLICK(wxID_ANY, ExplainHotNodes::OnColumnClick)
+END_EVENT_TABLE()
+
+
+ExplainHotNodes::ExplainHotNodes(wxWindow *parent)
+	: wxListView(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_VIRTUAL | wxLC_SINGLE_SEL)
+{
+	sortColumn = COL_EXCLUSIVE;
+	sortAscending = false;
+
+	InsertColumn(COL_NODENO, _("#"), wxLIST_FORMAT_RIGHT, 40);
+	InsertColumn(COL_NAME, _("Node"), wxLIST_FORMAT_LEFT, 300);
+	InsertColumn(COL_EXCLUSIVE, _("Exclusive (ms)"), wxLIST_FORMAT_RIGHT, 100);
+	InsertColumn(COL_INCLUSIVE, _("Inclusive (ms)"), wxLIST_FORMAT_RIGHT, 100);
+	InsertColumn(COL_PERCENT, _("% of total"), wxLIST_FORMAT_RIGHT, 70);
+	InsertColumn(COL_ROWS, _("Rows"), wxLIST_FORMAT_RIGHT, 80);
+	InsertColumn(COL_PLANROWS, _("Plan rows"), wxLIST_FORMAT_RIGHT, 80);
+	InsertColumn(COL_ERROR, _("Estimate error"), wxLIST_FORMAT_RIGHT, 90);
+	InsertColumn(COL_LOOPS, _("Loops"), wxLIST_FORMAT_RIGHT, 60);
+	InsertColumn(COL_SHAREDHIT, _("Shared hit"), wxLIST_FORMAT_RIGHT, 80);
+	InsertColumn(COL_SHAREDREAD, _("Shared read"), wxLIST_FORMAT_RIGHT, 80);
+}
+
+
+void ExplainHotNodes::Clear()
+{
+	nodes.Clear();
+	SetItemCount(0);
+	Refresh();
+}
+
+
+void ExplainHotNodes::SetExplainPlan(const ExplainPlan *plan)
+{
+	nodes.Clear();
+
+	if (plan && plan->GetRoot())
+	{
+		double totalTime = plan->GetTotalRuntime();
+		if (totalTime <= 0.0)
+			totalTime = plan->GetRoot()->GetInclusiveTime();
+
+		const ExplainNodeArray &planNodes = plan->GetNodes();
+		nodes.Alloc(planNodes.GetCount());
+
+		size_t i;
+		for (i = 0 ; i < planNodes.GetCount() ; i++)
+		{
+			ExplainNode *node = planNodes.Item(i);
+			explainHotNode hot;
+
+			hot.nodeNo = i + 1;
+			hot.name = node->GetName();
+			hot.hasActual = node->HasActual();
+			hot.hasTiming = node->HasTiming();
+			hot.hasBuffers = node->HasBuffers();
+			hot.exclusiveTime = node->GetExclusiveTime();
+			hot.inclusiveTime = node->GetInclusiveTime();
+			hot.percent = totalTime > 0.0 ? node->GetExclusiveTime() * 100.0 / totalTime : 0.0;
+			hot.actualRows = node->GetActualRows();
+			hot.planRows = node->GetPlanRows();
+			hot.loops = node->GetActualLoops();
+			hot.estimateError = node->GetEstimateError();
+			hot.sharedHit = node->GetExclusiveSharedHitBlocks();
+			hot.sharedRead = node->GetExclusiveSharedReadBlocks();
+
+			nodes.Add(hot);
+		}
+	}
+
+	SortNodes();
+}
+
+
+// Sort state for the comparison function; only used on the GUI thread.
+static int hotNodesSortColumn = COL_EXCLUSIVE;
+static bool hotNodesSortAscending = false;
+
+static int wxCMPFUNC_CONV hotNodesCompare(explainHotNode **a, explainHotNode **b)
+{
+	double va = 0.0, vb = 0.0;
+
+	switch (hotNodesSortColumn)
+	{
+		case COL_NAME:
+		{
+			int rc = (*a)->name.CmpNoCase((*b)->name);
+			if (rc)
+				return hotNodesSortAscending ? rc : -rc;
+			break;
+		}
+		case COL_EXCLUSIVE:
+			va = (*a)->exclusiveTime;
+			vb = (*b)->exclusiveTime;
+			break;
+		case COL_INCLUSIVE:
+			va = (*a)->inclusiveTime;
+			vb = (*b)->inclusiveTime;
+			break;
+		case COL_PERCENT:
+			va = (*a)->percent;
+			vb = (*b)->percent;
+			break;
+		case COL_ROWS:
+			va = (*a)->actualRows;
+			vb = (*b)->actualRows;
+			break;
+		case COL_PLANROWS:
+			va = (*a)->planRows;
+			vb = (*b)->planRows;
+			break;
+		case COL_ERROR:
+			va = (*a)->estimateError;
+			vb = (*b)->estimateError;
+			break;
+		case COL_LOOPS:
+			va = (*a)->loops;
+			vb = (*b)->loops;
+			break;
+		case COL_SHAREDHIT:
+			va = (*a)->sharedHit;
+			vb = (*b)->sharedHit;
+			break;
+		case COL_SHAREDREAD:
+			va = (*a)->sharedRead;
+			vb = (*b)->sharedRead;
+			break;
+	}
+
+	if (va != vb)
+	{
+		int rc = va < vb ? -1 : 1;
+		return hotNodesSortAscending ? rc : -rc;
+	}
+
+	// Keep plan order for equal values
+	return (*a)->nodeNo < (*b)->nodeNo ? -1 : ((*a)->nodeNo > (*b)->nodeNo ? 1 : 0);
+}
+
+
+void ExplainHotNodes::SortNodes()
+{
+	hotNodesSortColumn = sortColumn;
+	hotNodesSortAscending = sortAscending;
+
+	// The node number column simply restores plan order
+	if (sortColumn == COL_NODENO)
+		hotNodesSortColumn = -1;
+
+	nodes.Sort(hotNodesCompare);
+
+	SetItemCount(nodes.GetCount());
+	Refresh();
+}
+
+
+void ExplainHotNodes::OnColumnClick(wxListEvent &ev)
+{
+	int col = ev.GetColumn();
+	if (col < 0)
+		return;
+
+	if (col == sortColumn)
+		sortAscending = !sortAscending;
+	else
+	{
+		sortColumn = col;
+		// Text and plan order sort ascending first, figures descending
+		sortAscending = (col == COL_NAME || col == COL_NODENO);
+	}
+
+	SortNodes();
+}
+
+
+wxString ExplainHotNodes::OnGetItemText(long item, long col) const
+{
+	if (item < 0 || item >= (long)nodes.GetCount())
+		return wxEmptyString;
+
+	const explainHotNode &node = nodes.Item(item);
+
+	switch (col)
+	{
+		case COL_NODENO:
+			return NumToStr(node.nodeNo);
+		case COL_NAME:
+			return node.name;
+		case COL_EXCLUSIVE:
+			return node.hasTiming ? wxString::Format(wxT("%.3f"), node.exclusiveTime) : wxString();
+		case COL_INCLUSIVE:
+			return node.hasTiming ? wxString::Format(wxT("%.3f"), node.inclusiveTime) : wxString();
+		case COL_PERCENT:
+			return node.hasTiming ? wxString::Format(wxT("%.1f"), node.percent) : wxString();
+		case COL_ROWS:
+			return node.hasActual ? wxString::Format(wxT("%.0f"), node.actualRows) : wxString();
+		case COL_PLANROWS:
+			return wxString::Format(wxT("%.0f"), node.planRows);
+		case COL_ERROR:
+			return node.hasActual ? wxString::Format(wxT("%.1f"), node.estimateError) : wxString();
+		case COL_LOOPS:
+			return node.hasActual ? wxString::Format(wxT("%.0f"), node.loops) : wxString();
+		case COL_SHAREDHIT:
+			return node.hasBuffers ? NumToStr(node.sharedHit) : wxString();
+		case COL_SHAREDREAD:
+			return node.hasBuffers ? NumToStr(node.sharedRead) : wxString();
+	}
+
+	return wxEmptyString;
+}
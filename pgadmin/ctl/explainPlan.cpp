@@ -0,0 +1,416 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// explainPlan.cpp - Structured (FORMAT XML) explain plan model
+//
+//////////////////////////////////////////////////////////////////////////
+
+// wxWindows headers
+#include <wx/wx.h>
+
+// App headers
+#include "pgAdmin3.h"
+#include "utils/misc.h"
+#include "ctl/explainPlan.h"
+
+#include <libxml/parser.h>
+
+//
+// libxml convenience macros
+//
+#define XML_FROM_WXSTRING(s) ((xmlChar *)(const char *)s.mb_str(wxConvUTF8))
+#define WXSTRING_FROM_XML(s) wxString((char *)s, wxConvUTF8)
+
+
+// Properties shown as conditions below the node headline, in the order
+// the text format of EXPLAIN prints them
+static const wxChar *conditionProperties[] =
+{
+	wxT("Output"),
+	wxT("Group-Key"),
+	wxT("Sort-Key"),
+	wxT("Index-Cond"),
+	wxT("Recheck-Cond"),
+	wxT("Merge-Cond"),
+	wxT("Hash-Cond"),
+	wxT("Join-Filter"),
+	wxT("Filter"),
+	wxT("One-Time-Filter"),
+	wxT("Rows-Removed-by-Filter"),
+	wxT("Sort-Method"),
+	0
+};
+
+
+ExplainNode::ExplainNode(ExplainNode *parentNode, long nodeLevel)
+{
+	parent = parentNode;
+	level = nodeLevel;
+
+	hasCosts = hasActual = hasTiming = hasBuffers = false;
+	startupCost = totalCost = planRows = 0.0;
+	planWidth = 0;
+	actualStartupTime = actualTotalTime = actualRows = actualLoops = 0.0;
+	inclusiveTime = exclusiveTime = 0.0;
+	estimateError = 1.0;
+	sharedHit = sharedRead = tempRead = tempWritten = 0;
+	exclusiveSharedHit = exclusiveSharedRead = 0;
+}
+
+
+wxString ExplainNode::GetProperty(const wxString &name) const
+{
+	ExplainPropertyMap::const_iterator it = properties.find(name);
+	if (it == properties.end())
+		return wxEmptyString;
+	return it->second;
+}
+
+
+void ExplainNode::ReadValues()
+{
+	hasCosts = HasProperty(wxT("Total-Cost"));
+	hasActual = HasProperty(wxT("Actual-Loops"));
+	hasTiming = HasProperty(wxT("Actual-Total-Time"));
+	hasBuffers = HasProperty(wxT("Shared-Hit-Blocks"));
+
+	startupCost = StrToDouble(GetProperty(wxT("Startup-Cost")));
+	totalCost = StrToDouble(GetProperty(wxT("Total-Cost")));
+	planRows = StrToDouble(GetProperty(wxT("Plan-Rows")));
+	planWidth = StrToLong(GetProperty(wxT("Plan-Width")));
+
+	actualStartupTime = StrToDouble(GetProperty(wxT("Actual-Startup-Time")));
+	actualTotalTime = StrToDouble(GetProperty(wxT("Actual-Total-Time")));
+	actualRows = StrToDouble(GetProperty(wxT("Actual-Rows")));
+	actualLoops = StrToDouble(GetProperty(wxT("Actual-Loops")));
+
+	sharedHit = StrToLong(GetProperty(wxT("Shared-Hit-Blocks")));
+	sharedRead = StrToLong(GetProperty(wxT("Shared-Read-Blocks")));
+	tempRead = StrToLong(GetProperty(wxT("Temp-Read-Blocks")));
+	tempWritten = StrToLong(GetProperty(wxT("Temp-Written-Blocks")));
+
+	// Actual times are averages per loop
+	inclusiveTime = actualTotalTime * actualLoops;
+}
+
+
+void ExplainNode::Analyze()
+{
+	// Timing and buffer counts of a node include those of its children
+	exclusiveTime = inclusiveTime;
+	exclusiveSharedHit = sharedHit;
+	exclusiveSharedRead = sharedRead;
+
+	size_t i;
+	for (i = 0 ; i < children.GetCount() ; i++)
+	{
+		exclusiveTime -= children.Item(i)->inclusiveTime;
+		exclusiveSharedHit -= children.Item(i)->sharedHit;
+		exclusiveSharedRead -= children.Item(i)->sharedRead;
+	}
+
+	// Rounding, and CTEs scanned by more than one node, can make these negative
+	if (exclusiveTime < 0.0)
+		exclusiveTime = 0.0;
+	if (exclusiveSharedHit < 0)
+		exclusiveSharedHit = 0;
+	if (exclusiveSharedRead < 0)
+		exclusiveSharedRead = 0;
+
+	if (hasCosts && hasActual && actualLoops > 0.0)
+	{
+		double actual = actualRows < 1.0 ? 1.0 : actualRows;
+		double planned = planRows < 1.0 ? 1.0 : planRows;
+
+		if (actual > planned)
+			estimateError = actual / planned;
+		else
+			estimateError = planned / actual;
+	}
+	else
+		estimateError = 1.0;
+}
+
+
+wxString ExplainNode::GetName() const
+{
+	wxString type = GetProperty(wxT("Node-Type"));
+	wxString name;
+
+	// Reconstruct the node name the text format would print
+	// (see ExplainNode() in postgresql/src/backend/commands/explain.c)
+	if (type == wxT("Aggregate"))
+	{
+		wxString strategy = GetProperty(wxT("Strategy"));
+		if (strategy == wxT("Sorted"))
+			name = wxT("GroupAggregate");
+		else if (strategy == wxT("Hashed"))
+			name = wxT("HashAggregate");
+		else
+			name = type;
+	}
+	else if (type == wxT("SetOp"))
+	{
+		if (GetProperty(wxT("Strategy")) == wxT("Hashed"))
+			name = wxT("HashSetOp");
+		else
+			name = type;
+		if (HasProperty(wxT("Command")))
+			name += wxT(" ") + GetProperty(wxT("Command"));
+	}
+	else if (type == wxT("ModifyTable") && HasProperty(wxT("Operation")))
+		name = GetProperty(wxT("Operation"));
+	else if (type == wxT("Nested Loop") || type == wxT("Hash Join") || type == wxT("Merge Join"))
+	{
+		wxString joinType = GetProperty(wxT("Join-Type"));
+		if (joinType.IsEmpty() || joinType == wxT("Inner"))
+			name = type;
+		else if (type == wxT("Nested Loop"))
+			name = type + wxT(" ") + joinType + wxT(" Join");
+		else
+			name = type.BeforeFirst(' ') + wxT(" ") + joinType + wxT(" Join");
+	}
+	else
+		name = type;
+
+	if (GetProperty(wxT("Scan-Direction")) == wxT("Backward"))
+		name += wxT(" Backward");
+
+	if (HasProperty(wxT("Index-Name")))
+	{
+		if (type == wxT("Bitmap Index Scan"))
+			name += wxT(" on ");
+		else
+			name += wxT(" using ");
+		name += GetProperty(wxT("Index-Name"));
+	}
+
+	wxString relation = GetProperty(wxT("Relation-Name"));
+	if (relation.IsEmpty())
+		relation = GetProperty(wxT("Function-Name"));
+	if (relation.IsEmpty())
+		relation = GetProperty(wxT("CTE-Name"));
+
+	wxString alias = GetProperty(wxT("Alias"));
+	if (!relation.IsEmpty())
+	{
+		name += wxT(" on ");
+		if (HasProperty(wxT("Schema")))
+			name += GetProperty(wxT("Schema")) + wxT(".");
+		name += relation;
+		if (!alias.IsEmpty() && alias != relation)
+			name += wxT(" ") + alias;
+	}
+	else if (!alias.IsEmpty())
+		name += wxT(" on ") + alias;
+
+	return name;
+}
+
+
+wxString ExplainNode::GetDescription() const
+{
+	// Property values are used verbatim: they carry the same precision
+	// as the text format and do not depend on the client's locale.
+	wxString str = GetName();
+
+	if (hasCosts)
+	{
+		str += wxT("  (cost=") + GetProperty(wxT("Startup-Cost"))
+		       + wxT("..") + GetProperty(wxT("Total-Cost"))
+		       + wxT(" rows=") + GetProperty(wxT("Plan-Rows"))
+		       + wxT(" width=") + GetProperty(wxT("Plan-Width")) + wxT(")");
+	}
+
+	if (hasActual)
+	{
+		if (actualLoops == 0.0)
+			str += wxT(" (never executed)");
+		else if (hasTiming)
+			str += wxT(" (actual time=") + GetProperty(wxT("Actual-Startup-Time"))
+			       + wxT("..") + GetProperty(wxT("Actual-Total-Time"))
+			       + wxT(" rows=") + GetProperty(wxT("Actual-Rows"))
+			       + wxT(" loops=") + GetProperty(wxT("Actual-Loops")) + wxT(")");
+		else
+			str += wxT(" (actual rows=") + GetProperty(wxT("Actual-Rows"))
+			       + wxT(" loops=") + GetProperty(wxT("Actual-Loops")) + wxT(")");
+	}
+
+	return str;
+}
+
+
+wxArrayString ExplainNode::GetConditions() const
+{
+	wxArrayString conditions;
+
+	if (HasProperty(wxT("Subplan-Name")))
+		conditions.Add(GetProperty(wxT("Subplan-Name")));
+
+	const wxChar **prop;
+	for (prop = conditionProperties ; *prop ; prop++)
+	{
+		if (HasProperty(*prop))
+		{
+			wxString label = *prop;
+			label.Replace(wxT("-"), wxT(" "));
+			conditions.Add(label + wxT(": ") + GetProperty(*prop));
+		}
+	}
+
+	if (hasBuffers)
+	{
+		conditions.Add(wxString::Format(_("Buffers: shared hit=%ld read=%ld"), sharedHit, sharedRead));
+		if (tempRead || tempWritten)
+			conditions.Add(wxString::Format(_("Buffers: temp read=%ld written=%ld"), tempRead, tempWritten));
+	}
+
+	return conditions;
+}
+
+
+
+ExplainPlan::ExplainPlan()
+{
+	root = NULL;
+	totalRuntime = 0.0;
+	planningTime = 0.0;
+}
+
+
+ExplainPlan::~ExplainPlan()
+{
+	WX_CLEAR_ARRAY(nodes);
+}
+
+
+bool ExplainPlan::IsXmlPlan(const wxString &str)
+{
+	return str.Strip(wxString::leading).StartsWith(wxT("<explain"));
+}
+
+
+bool ExplainPlan::Parse(const wxString &xml)
+{
+	WX_CLEAR_ARRAY(nodes);
+	root = NULL;
+	totalRuntime = 0.0;
+	planningTime = 0.0;
+
+	xmlDocPtr doc = xmlParseDoc(XML_FROM_WXSTRING(xml));
+	if (!doc)
+	{
+		wxLogError(_("Failed to parse the XML explain output!"));
+		return false;
+	}
+
+	// <explain><Query><Plan>...</Plan>...</Query></explain>
+	xmlNodePtr top = xmlDocGetRootElement(doc);
+	xmlNodePtr query = top ? top->children : NULL;
+	while (query && (query->type != XML_ELEMENT_NODE || xmlStrcmp(query->name, (const xmlChar *)"Query")))
+		query = query->next;
+
+	if (query)
+	{
+		xmlNodePtr cur;
+		for (cur = query->children ; cur ; cur = cur->next)
+		{
+			if (cur->type != XML_ELEMENT_NODE)
+				continue;
+
+			if (!xmlStrcmp(cur->name, (const xmlChar *)"Plan"))
+			{
+				if (!root)
+					root = ReadNode(cur, NULL, 0);
+			}
+			else
+			{
+				xmlChar *content = xmlNodeGetContent(cur);
+				double value = StrToDouble(WXSTRING_FROM_XML(content));
+				xmlFree(content);
+
+				// Total-Runtime up to 9.3, Execution-Time from 9.4
+				if (!xmlStrcmp(cur->name, (const xmlChar *)"Total-Runtime") ||
+				        !xmlStrcmp(cur->name, (const xmlChar *)"Execution-Time"))
+					totalRuntime = value;
+				else if (!xmlStrcmp(cur->name, (const xmlChar *)"Planning-Time"))
+					planningTime = value;
+			}
+		}
+	}
+
+	xmlFreeDoc(doc);
+
+	if (!root)
+	{
+		wxLogError(_("The XML explain output does not contain a plan!"));
+		return false;
+	}
+
+	size_t i;
+	for (i = 0 ; i < nodes.GetCount() ; i++)
+		nodes.Item(i)->Analyze();
+
+	return true;
+}
+
+
+ExplainNode *ExplainPlan::ReadNode(xmlNodePtr planNode, ExplainNode *parent, long level)
+{
+	ExplainNode *node = new ExplainNode(parent, level);
+	nodes.Add(node);
+	if (parent)
+		parent->children.Add(node);
+
+	xmlNodePtr cur;
+	for (cur = planNode->children ; cur ; cur = cur->next)
+	{
+		if (cur->type != XML_ELEMENT_NODE)
+			continue;
+
+		if (!xmlStrcmp(cur->name, (const xmlChar *)"Plans"))
+		{
+			xmlNodePtr kid;
+			for (kid = cur->children ; kid ; kid = kid->next)
+			{
+				if (kid->type == XML_ELEMENT_NODE && !xmlStrcmp(kid->name, (const xmlChar *)"Plan"))
+					ReadNode(kid, node, level + 1);
+			}
+			continue;
+		}
+
+		wxString value;
+		xmlNodePtr item;
+		bool isList = false;
+
+		// List properties (Output, Sort-Key, ...) consist of <Item> elements
+		for (item = cur->children ; item ; item = item->next)
+		{
+			if (item->type != XML_ELEMENT_NODE)
+				continue;
+
+			xmlChar *content = xmlNodeGetContent(item);
+			if (isList)
+				value += wxT(", ");
+			value += WXSTRING_FROM_XML(content);
+			xmlFree(content);
+			isList = true;
+		}
+
+		if (!isList)
+		{
+			xmlChar *content = xmlNodeGetContent(cur);
+			value = WXSTRING_FROM_XML(content);
+			xmlFree(content);
+		}
+
+		node->properties[WXSTRING_FROM_XML(cur->name)] = value;
+	}
+
+	node->ReadValues();
+	return node;
+}
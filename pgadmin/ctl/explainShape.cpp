@@ -17,6 +17,7 @@
 // App headers
 #include "pgAdmin3.h"
 #include "ctl/explainCanvas.h"
+#include "ctl/explainPlan.h"
 
 #include <wx/docview.h>
 
@@ -71,6 +72,7 @@ ExplainShape::ExplainShape(const wxImage &bmp, const wxString &description, long
 	kidCount = 0;
 	totalShapes = 0;
 	usedShapes = 0;
+	node = NULL;
 }
 
 
@@ -417,6 +419,49 @@ ExplainShape *ExplainShape::Create(long level, ExplainShape *last, const wxStrin
 }
 
 
+ExplainShape *ExplainShape::Create(ExplainShape *last, ExplainNode *node, double totalTime)
+{
+	ExplainShape *s = Create(node->GetLevel(), last, node->GetDescription());
+	if (!s)
+		return 0;
+
+	s->node = node;
+
+	wxArrayString conditions = node->GetConditions();
+	size_t i;
+	for (i = 0 ; i < conditions.GetCount() ; i++)
+		s->SetCondition(conditions.Item(i));
+
+	if (node->HasActual() && node->GetActualLoops() > 0.0)
+	{
+		if (node->HasTiming())
+		{
+			s->analysis = wxString::Format(_("exclusive time=%.3f ms"), node->GetExclusiveTime());
+			if (totalTime > 0.0)
+				s->analysis += wxString::Format(wxT(" (%.1f%%)"), node->GetExclusiveTime() * 100.0 / totalTime);
+		}
+		if (node->GetEstimateError() >= 2.0)
+		{
+			if (!s->analysis.IsEmpty())
+				s->analysis += wxT("  ");
+			if (node->IsOverestimated())
+				s->analysis += wxString::Format(_("rows overestimated x%.1f"), node->GetEstimateError());
+			else
+				s->analysis += wxString::Format(_("rows underestimated x%.1f"), node->GetEstimateError());
+		}
+		if (node->HasBuffers())
+		{
+			if (!s->analysis.IsEmpty())
+				s->analysis += wxT("  ");
+			s->analysis += wxString::Format(_("exclusive buffers: shared hit=%ld read=%ld"),
+			                                node->GetExclusiveSharedHitBlocks(), node->GetExclusiveSharedReadBlocks());
+		}
+	}
+
+	return s;
+}
+
+
 ExplainLine::ExplainLine(ExplainShape *from, ExplainShape *to, double weight)
 {
 	SetCanvas(from->GetCanvas());
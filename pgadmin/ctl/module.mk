@@ -20,11 +20,14 @@ pgadmin3_SOURCES += \
         ctl/ctlSQLBox.cpp \
         ctl/ctlSQLGrid.cpp \
         ctl/ctlSQLResult.cpp \
+        ctl/ctlSQLResultView.cpp \
         ctl/ctlDefaultSecurityPanel.cpp \
         ctl/ctlSeclabelPanel.cpp \
         ctl/ctlSecurityPanel.cpp \
         ctl/ctlTree.cpp \
         ctl/explainCanvas.cpp \
+        ctl/explainHotNodes.cpp \
+        ctl/explainPlan.cpp \
         ctl/explainShape.cpp \
         ctl/timespin.cpp \
         ctl/xh_calb.cpp \
@@ -13,7 +13,9 @@ pgadmin3_SOURCES += \
 	db/keywords.c \
 	db/pgConn.cpp \
 	db/pgSet.cpp \
-	db/pgQueryThread.cpp
+	db/pgQueryThread.cpp \
+	db/pgQueryStats.cpp \
+	db/pgConnPool.cpp
 
 EXTRA_DIST += \
         db/module.mk
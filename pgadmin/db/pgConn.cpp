@@ -13,6 +13,7 @@
 
 // wxWindows headers
 #include <wx/wx.h>
+#include <wx/stopwatch.h>
 
 // PostgreSQL headers
 #include <libpq-fe.h>
@@ -43,7 +44,10 @@ typedef u_long in_addr_t;
 #include "db/pgConn.h"
 #include "utils/misc.h"
 #include "db/pgSet.h"
+#include "db/pgQueryStats.h"
+#include "db/pgConnPool.h"
 #include "utils/pgTypeCache.h"
+#include "utils/pgDefs.h"
 
 double pgConn::libpqVersion = 8.0;
 
@@ -55,7 +59,7 @@ static void pgNoticeProcessor(void *arg, const char *message)
 pgConn::pgConn(const wxString &server, const wxString &service, const wxString &hostaddr, const wxString &database, const wxString &username, const wxString &password,
                int port, const wxString &rolename, int sslmode, OID oid, const wxString &applicationname,
                const wxString &sslcert, const wxString &sslkey, const wxString &sslrootcert, const wxString &sslcrl,
-               const bool sslcompression)
+               const bool sslcompression, int connectTimeout)
 {
 	wxString msg;
 
@@ -86,6 +90,12 @@ pgConn::pgConn(const wxString &server, const wxString &service, const wxString &
 	typeCache = new pgTypeCache(this);
 	datatypeCache = NULL;
 
+	subsystem = PGCONN_SUB_BROWSER;
+	pool = 0;
+	suspended = false;
+	lastUsed = time(NULL);
+	busy = 0;
+
 	// Check the hostname/ipaddress
 	conn = 0;
 	noticeArg = 0;
@@ -129,6 +139,12 @@ pgConn::pgConn(const wxString &server, const wxString &service, const wxString &
 		connstr.Append(NumToStr((long)port));
 	}
 
+	if (connectTimeout > 0)
+	{
+		connstr.Append(wxT(" connect_timeout="));
+		connstr.Append(NumToStr((long)connectTimeout));
+	}
+
 	if (libpqVersion > 7.3)
 	{
 		switch (sslmode)
@@ -232,6 +248,9 @@ pgConn::pgConn(const wxString &server, const wxString &service, const wxString &
 
 pgConn::~pgConn()
 {
+	if (pool)
+		pool->Forget(this);
+
 	Close();
 	delete typeCache;
 	delete datatypeCache;
@@ -260,11 +279,14 @@ bool pgConn::DoConnect()
 		connStatus = PGCONN_OK;
 		PQsetNoticeProcessor(conn, pgNoticeProcessor, this);
 
-		wxString sql = wxT("SET DateStyle=ISO;\nSET client_min_messages=notice;\n");
-		if (BackendMinimumVersion(9, 0))
-			sql += wxT("SET bytea_output=escape;\n");
+		// The version string comes with the database details below, so
+		// use the one libpq got at startup here
+		sessionSetup = wxT("SET DateStyle=ISO;\nSET client_min_messages=notice;\n");
+		if (PQserverVersion(conn) >= 90000)
+			sessionSetup += wxT("SET bytea_output=escape;\n");
 
-		sql += wxT("SELECT oid, pg_encoding_to_char(encoding) AS encoding, datlastsysoid\n")
+		wxString sql = sessionSetup;
+		sql += wxT("SELECT oid, pg_encoding_to_char(encoding) AS encoding, datlastsysoid, version() AS version\n")
 		       wxT("  FROM pg_database WHERE ");
 
 		if (save_oid)
@@ -289,6 +311,7 @@ bool pgConn::DoConnect()
 
 			lastSystemOID = set->GetOid(wxT("datlastsysoid"));
 			dbOid = set->GetOid(wxT("oid"));
+			versionString = set->GetVal(wxT("version"));
 			wxString encoding = set->GetVal(wxT("encoding"));
 
 			if (encoding != wxT("SQL_ASCII") && encoding != wxT("MULE_INTERNAL"))
@@ -304,6 +327,7 @@ bool pgConn::DoConnect()
 			{
 				wxLogError(wxT("%s"), GetLastError().c_str());
 			}
+			sessionSetup += wxT("SET client_encoding=") + qtString(encoding) + wxT(";\n");
 
 			delete set;
 
@@ -312,6 +336,7 @@ bool pgConn::DoConnect()
 			{
 				sql = wxT("SET ROLE TO ");
 				sql += qtIdent(dbRole);
+				sessionSetup += sql + wxT(";\n");
 
 				pgSet *set = ExecuteSet(sql);
 
@@ -361,6 +386,72 @@ bool pgConn::Reconnect()
 }
 
 
+void pgConn::Suspend()
+{
+	if (conn)
+	{
+		wxLogInfo(wxT("Suspending idle connection to %s"), GetName().c_str());
+		Close();
+		suspended = true;
+	}
+}
+
+
+bool pgConn::Resume()
+{
+	if (!suspended)
+		return true;
+
+	suspended = false;
+	wxLogInfo(wxT("Resuming connection to %s"), GetName().c_str());
+	bool ok = Reconnect();
+
+	// Make room for this one if the server has too many open; the pool
+	// does this again from its timer if we're not on the GUI thread
+	if (pool)
+		pool->Reclaim(this);
+
+	return ok;
+}
+
+
+bool pgConn::ResetSession()
+{
+	if (GetStatus() != PGCONN_OK || GetTxStatus() != PGCONN_TXSTATUS_IDLE || !BackendMinimumVersion(8, 3))
+		return false;
+
+	return ExecuteVoid(wxT("DISCARD ALL;\n") + sessionSetup, false);
+}
+
+
+void pgConn::Touch()
+{
+	if (suspended)
+		Resume();
+	lastUsed = time(NULL);
+}
+
+
+pgConnBusy::pgConnBusy(pgConn *_conn)
+{
+	conn = _conn;
+	if (conn->pool)
+		conn->pool->SetBusy(conn, true);
+	else
+		conn->busy++;
+	conn->Touch();
+}
+
+
+pgConnBusy::~pgConnBusy()
+{
+	if (conn->pool)
+		conn->pool->SetBusy(conn, false);
+	else
+		conn->busy--;
+}
+
+
 pgConn *pgConn::Duplicate()
 {
 	pgConn *copy = new pgConn(wxString(save_server), wxString(save_service), wxString(save_hostaddr), wxString(save_database), wxString(save_username), wxString(save_password),
@@ -375,6 +466,8 @@ pgConn *pgConn::Duplicate()
 	{
 		copy->GetDatatypeCache()->SetInitial(datatypeCache);
 	}
+	if (copy != NULL)
+		copy->subsystem = subsystem;
 
 	return copy;
 }
@@ -510,66 +603,124 @@ bool pgConn::EdbMinimumVersion(int major, int minor)
 bool pgConn::HasFeature(int featureNo, bool forceCheck)
 {
 	if (!features[FEATURE_INITIALIZED] || forceCheck)
-	{
-		features[FEATURE_INITIALIZED] = true;
+		ReadCapabilities();
 
-		wxString sql =
-		    wxT("SELECT proname, pronargs, proargtypes[0] AS arg0, proargtypes[1] AS arg1, proargtypes[2] AS arg2\n")
-		    wxT("  FROM pg_proc\n")
-		    wxT("  JOIN pg_namespace n ON n.oid=pronamespace\n")
-		    wxT(" WHERE proname IN ('pg_tablespace_size', 'pg_file_read', 'pg_logfile_rotate',")
-		    wxT(                  " 'pg_postmaster_starttime', 'pg_terminate_backend', 'pg_reload_conf',")
-		    wxT(                  " 'pgstattuple', 'pgstatindex')\n")
-		    wxT("   AND nspname IN ('pg_catalog', 'public')");
+	if (featureNo <= FEATURE_INITIALIZED || featureNo >= FEATURE_LAST)
+		return false;
+	return features[featureNo];
+}
 
-		pgSet *set = ExecuteSet(sql);
 
-		if (set)
-		{
-			while (!set->Eof())
-			{
-				wxString proname = set->GetVal(wxT("proname"));
-				long pronargs = set->GetLong(wxT("pronargs"));
-
-				if (proname == wxT("pg_tablespace_size") && pronargs == 1 && set->GetLong(wxT("arg0")) == 26)
-					features[FEATURE_SIZE] = true;
-				else if (proname == wxT("pg_file_read") && pronargs == 3 && set->GetLong(wxT("arg0")) == 25
-				         && set->GetLong(wxT("arg1")) == 20 && set->GetLong(wxT("arg2")) == 20)
-					features[FEATURE_FILEREAD] = true;
-				else if (proname == wxT("pg_logfile_rotate") && pronargs == 0)
-					features[FEATURE_ROTATELOG] = true;
-				else if (proname == wxT("pg_postmaster_starttime") && pronargs == 0)
-					features[FEATURE_POSTMASTER_STARTTIME] = true;
-				else if (proname == wxT("pg_terminate_backend") && pronargs == 1 && set->GetLong(wxT("arg0")) == 23)
-					features[FEATURE_TERMINATE_BACKEND] = true;
-				else if (proname == wxT("pg_reload_conf") && pronargs == 0)
-					features[FEATURE_RELOAD_CONF] = true;
-				else if (proname == wxT("pgstattuple") && pronargs == 1 && set->GetLong(wxT("arg0")) == 25)
-					features[FEATURE_PGSTATTUPLE] = true;
-				else if (proname == wxT("pgstatindex") && pronargs == 1 && set->GetLong(wxT("arg0")) == 25)
-					features[FEATURE_PGSTATINDEX] = true;
+const pgCapabilities &pgConn::GetCapabilities(bool forceCheck)
+{
+	if (!features[FEATURE_INITIALIZED] || forceCheck)
+		ReadCapabilities();
 
-				set->MoveNext();
-			}
-			delete set;
-		}
+	return capabilities;
+}
 
-		// Check for EDB function parameter default support
-		wxString defCol = wxT("'proargdefaults'");
 
-		if (EdbMinimumVersion(8, 3) && !EdbMinimumVersion(8, 4))
-			defCol = wxT("'proargdefvals'");
+static wxString ProcExists(const wxString &condition, bool builtin)
+{
+	wxString sql = wxT("EXISTS (SELECT 1 FROM pg_proc JOIN pg_namespace n ON n.oid=pronamespace WHERE ") + condition;
+	if (builtin)
+		sql += wxT(" AND nspname IN ('pg_catalog', 'public')");
+	return sql + wxT(")");
+}
 
-		wxString hasFuncDefs = ExecuteScalar(wxT("SELECT count(*) FROM pg_attribute WHERE attrelid = 'pg_catalog.pg_proc'::regclass AND attname = ") + defCol);
-		if (hasFuncDefs == wxT("1"))
-			features[FEATURE_FUNCTION_DEFAULTS] = true;
-		else
-			features[FEATURE_FUNCTION_DEFAULTS] = false;
+
+// Fills the feature flags and the capabilities in one round trip, instead
+// of one query per check.
+void pgConn::ReadCapabilities()
+{
+	features[FEATURE_INITIALIZED] = true;
+
+	// Check for EDB function parameter default support
+	wxString defCol = wxT("'proargdefaults'");
+	if (EdbMinimumVersion(8, 3) && !EdbMinimumVersion(8, 4))
+		defCol = wxT("'proargdefvals'");
+
+	wxString sql = wxT("SELECT ")
+	               + ProcExists(wxT("proname='pg_tablespace_size' AND pronargs=1 AND proargtypes[0]=26"), true) + wxT(" AS size,\n       ")
+	               + ProcExists(wxT("proname='pg_file_read' AND pronargs=3 AND proargtypes[0]=25 AND proargtypes[1]=20 AND proargtypes[2]=20"), true) + wxT(" AS fileread,\n       ")
+	               + ProcExists(wxT("proname='pg_logfile_rotate' AND pronargs=0"), true) + wxT(" AS rotatelog,\n       ")
+	               + ProcExists(wxT("proname='pg_postmaster_starttime' AND pronargs=0"), true) + wxT(" AS starttime,\n       ")
+	               + ProcExists(wxT("proname='pg_terminate_backend' AND pronargs=1 AND proargtypes[0]=23"), true) + wxT(" AS terminate,\n       ")
+	               + ProcExists(wxT("proname='pg_reload_conf' AND pronargs=0"), true) + wxT(" AS reloadconf,\n       ")
+	               + ProcExists(wxT("proname='pgstattuple' AND pronargs=1 AND proargtypes[0]=25"), true) + wxT(" AS pgstattuple,\n       ")
+	               + ProcExists(wxT("proname='pgstatindex' AND pronargs=1 AND proargtypes[0]=25"), true) + wxT(" AS pgstatindex,\n       ")
+	               + wxT("EXISTS (SELECT 1 FROM pg_attribute WHERE attrelid = 'pg_catalog.pg_proc'::regclass AND attname = ") + defCol + wxT(") AS funcdefaults,\n       ")
+	               + ProcExists(wxT("proname='pg_get_viewdef' AND proargtypes[1]=16"), false) + wxT(" AS viewdefpretty,\n       ")
+	               + ProcExists(wxT("proname='pldbg_get_target_info'"), false) + wxT(" AS targetinfo,\n       ")
+	               + ProcExists(wxT("proname='plpgsql_oid_debug'"), false) + wxT(" AS plpgsqldebug,\n       ")
+	               + ProcExists(wxT("proname='edb_oid_debug'"), false) + wxT(" AS edbspldebug,\n       ")
+	               + wxT("current_setting('search_path') AS search_path, current_schema() AS current_schema,\n       ")
+	               + wxT("CASE WHEN (SELECT usesuper FROM pg_user WHERE usename=current_user) THEN current_setting('")
+	               + (BackendMinimumVersion(8, 2) ? wxT("shared_preload_libraries") : wxT("preload_libraries"))
+	               + wxT("') ELSE NULL END AS preload_libraries");
+
+	// pg_default_acl has a row per role that altered the default
+	// privileges; like the old separate queries, take the first one rather
+	// than fail the whole probe
+	if (BackendMinimumVersion(9, 0))
+	{
+		sql += wxT(",\n       (SELECT defaclacl FROM pg_catalog.pg_default_acl dacl WHERE dacl.defaclnamespace = 0::OID AND defaclobjtype='r' LIMIT 1) AS defacl_tables")
+		       wxT(",\n       (SELECT defaclacl FROM pg_catalog.pg_default_acl dacl WHERE dacl.defaclnamespace = 0::OID AND defaclobjtype='S' LIMIT 1) AS defacl_seqs")
+		       wxT(",\n       (SELECT defaclacl FROM pg_catalog.pg_default_acl dacl WHERE dacl.defaclnamespace = 0::OID AND defaclobjtype='f' LIMIT 1) AS defacl_funcs");
 	}
+	if (BackendMinimumVersion(9, 2))
+		sql += wxT(",\n       (SELECT defaclacl FROM pg_catalog.pg_default_acl dacl WHERE dacl.defaclnamespace = 0::OID AND defaclobjtype='T' LIMIT 1) AS defacl_types");
+
+	int i;
+	for (i = FEATURE_INITIALIZED + 1 ; i < FEATURE_LAST ; i++)
+		features[i] = false;
+
+	capabilities.viewdefPretty = false;
+	capabilities.debuggerTargetInfo = false;
+	capabilities.plpgsqlDebug = false;
+	capabilities.edbsplDebug = false;
+	capabilities.searchPath = wxEmptyString;
+	capabilities.currentSchema = wxEmptyString;
+	capabilities.preloadLibraries = wxEmptyString;
+	capabilities.defPrivsOnTables = wxEmptyString;
+	capabilities.defPrivsOnSeqs = wxEmptyString;
+	capabilities.defPrivsOnFuncs = wxEmptyString;
+	capabilities.defPrivsOnTypes = wxEmptyString;
+
+	pgSet *set = ExecuteSet(sql);
+	if (!set)
+		return;
+
+	if (!set->Eof())
+	{
+		features[FEATURE_SIZE] = set->GetBool(wxT("size"));
+		features[FEATURE_FILEREAD] = set->GetBool(wxT("fileread"));
+		features[FEATURE_ROTATELOG] = set->GetBool(wxT("rotatelog"));
+		features[FEATURE_POSTMASTER_STARTTIME] = set->GetBool(wxT("starttime"));
+		features[FEATURE_TERMINATE_BACKEND] = set->GetBool(wxT("terminate"));
+		features[FEATURE_RELOAD_CONF] = set->GetBool(wxT("reloadconf"));
+		features[FEATURE_PGSTATTUPLE] = set->GetBool(wxT("pgstattuple"));
+		features[FEATURE_PGSTATINDEX] = set->GetBool(wxT("pgstatindex"));
+		features[FEATURE_FUNCTION_DEFAULTS] = set->GetBool(wxT("funcdefaults"));
+
+		capabilities.viewdefPretty = set->GetBool(wxT("viewdefpretty"));
+		capabilities.debuggerTargetInfo = set->GetBool(wxT("targetinfo"));
+		capabilities.plpgsqlDebug = set->GetBool(wxT("plpgsqldebug"));
+		capabilities.edbsplDebug = set->GetBool(wxT("edbspldebug"));
+		capabilities.searchPath = set->GetVal(wxT("search_path"));
+		capabilities.currentSchema = set->GetVal(wxT("current_schema"));
+		capabilities.preloadLibraries = set->GetVal(wxT("preload_libraries"));
 
-	if (featureNo <= FEATURE_INITIALIZED || featureNo >= FEATURE_LAST)
-		return false;
-	return features[featureNo];
+		if (BackendMinimumVersion(9, 0))
+		{
+			capabilities.defPrivsOnTables = set->GetVal(wxT("defacl_tables"));
+			capabilities.defPrivsOnSeqs = set->GetVal(wxT("defacl_seqs"));
+			capabilities.defPrivsOnFuncs = set->GetVal(wxT("defacl_funcs"));
+		}
+		if (BackendMinimumVersion(9, 2))
+			capabilities.defPrivsOnTypes = set->GetVal(wxT("defacl_types"));
+	}
+	delete set;
 }
 
 
@@ -729,6 +880,7 @@ int pgConn::GetTxStatus()
 
 bool pgConn::ExecuteVoid(const wxString &sql, bool reportError)
 {
+	pgConnBusy running(this);
 	if (GetStatus() != PGCONN_OK)
 		return false;
 
@@ -736,7 +888,9 @@ bool pgConn::ExecuteVoid(const wxString &sql, bool reportError)
 	PGresult *qryRes;
 
 	wxLogSql(wxT("Void query (%s:%d): %s"), this->GetHost().c_str(), this->GetPort(), sql.c_str());
+	wxStopWatch sw;
 	qryRes = PQexec(conn, sql.mb_str(*conv));
+	pgQueryStats::Record(subsystem, sql, sw.Time(), qryRes);
 	lastResultStatus = PQresultStatus(qryRes);
 	SetLastResultError(qryRes);
 
@@ -760,12 +914,15 @@ wxString pgConn::ExecuteScalar(const wxString &sql)
 {
 	wxString result;
 
+	pgConnBusy running(this);
 	if (GetStatus() == PGCONN_OK)
 	{
 		// Execute the query and get the status.
 		PGresult *qryRes;
 		wxLogSql(wxT("Scalar query (%s:%d): %s"), this->GetHost().c_str(), this->GetPort(), sql.c_str());
+		wxStopWatch sw;
 		qryRes = PQexec(conn, sql.mb_str(*conv));
+		pgQueryStats::Record(subsystem, sql, sw.Time(), qryRes);
 		lastResultStatus = PQresultStatus(qryRes);
 		SetLastResultError(qryRes);
 
@@ -797,17 +954,28 @@ wxString pgConn::ExecuteScalar(const wxString &sql)
 	return result;
 }
 
-pgSet *pgConn::ExecuteSet(const wxString &sql)
+pgSet *pgConn::ExecuteSet(const wxString &sql, bool binaryResults)
 {
+	pgConnBusy running(this);
+
 	// Execute the query and get the status.
 	if (GetStatus() == PGCONN_OK)
 	{
 		PGresult *qryRes;
 		wxLogSql(wxT("Set query (%s:%d): %s"), this->GetHost().c_str(), this->GetPort(), sql.c_str());
-		qryRes = PQexec(conn, sql.mb_str(*conv));
+		wxStopWatch sw;
+		bool refused = false;
+		if (binaryResults)
+			qryRes = ExecuteBinary(sql, refused);
+		else
+			qryRes = PQexec(conn, sql.mb_str(*conv));
+		pgQueryStats::Record(subsystem, sql, sw.Time(), qryRes);
 
 		lastResultStatus = PQresultStatus(qryRes);
-		SetLastResultError(qryRes);
+		if (refused)
+			SetLastResultError(NULL, _("The column types of the query result have changed, the result was discarded."));
+		else
+			SetLastResultError(qryRes);
 
 		if (lastResultStatus == PGRES_TUPLES_OK || lastResultStatus == PGRES_COMMAND_OK)
 		{
@@ -828,6 +996,119 @@ pgSet *pgConn::ExecuteSet(const wxString &sql)
 	return new pgSet();
 }
 
+
+// libpq reads all the columns of a result in the same format, so binary
+// is only chosen if pgSet can decode every one of them, and only pays off
+// if some of them are fixed width numbers or timestamps
+int pgConn::ChooseResultFormat(PGresult *desc, bool forText)
+{
+	bool integerDatetimes = false;
+	const char *setting = PQparameterStatus(conn, "integer_datetimes");
+	if (setting && !strcmp(setting, "on"))
+		integerDatetimes = true;
+
+	int fixedWidth = 0;
+	int col, cols = PQnfields(desc);
+	for (col = 0 ; col < cols ; col++)
+	{
+		switch (PQftype(desc, col))
+		{
+			case PGOID_TYPE_BOOL:
+			case PGOID_TYPE_INT2:
+			case PGOID_TYPE_INT4:
+			case PGOID_TYPE_INT8:
+			case PGOID_TYPE_OID:
+			case PGOID_TYPE_FLOAT4:
+			case PGOID_TYPE_FLOAT8:
+				fixedWidth++;
+				break;
+
+			case PGOID_TYPE_TIMESTAMPTZ:
+				// The text would have to be in the session's time zone
+				if (forText)
+					return 0;
+				// fall through
+			case PGOID_TYPE_TIMESTAMP:
+				if (!integerDatetimes)
+					return 0;
+				fixedWidth++;
+				break;
+
+			case PGOID_TYPE_TEXT:
+			case PGOID_TYPE_VARCHAR:
+			case PGOID_TYPE_NAME:
+			case PGOID_TYPE_BPCHAR:
+			case PGOID_TYPE_CHAR:
+				break;
+
+			default:
+				return 0;
+		}
+	}
+
+	return fixedWidth ? 1 : 0;
+}
+
+
+PGresult *pgConn::PrepareBinary(const char *query, int &resultFormat)
+{
+	resultFormat = 0;
+
+	PGresult *res = PQprepare(conn, "", query, 0, NULL);
+	if (PQresultStatus(res) != PGRES_COMMAND_OK)
+		return res;
+	PQclear(res);
+
+	res = PQdescribePrepared(conn, "");
+	if (PQresultStatus(res) != PGRES_COMMAND_OK)
+		return res;
+
+	resultFormat = ChooseResultFormat(res, false);
+	PQclear(res);
+
+	return 0;
+}
+
+
+// Describing the query costs a round trip, so the format is remembered for
+// queries that are run over and over, such as the ones of the status
+// window, and checked again on the result. A binary result that pgSet can
+// no longer read is refused rather than run again in text, which would
+// repeat any side effects of the query; the next run describes it again.
+PGresult *pgConn::ExecuteBinary(const wxString &sql, bool &refused)
+{
+	refused = false;
+
+	wxCharBuffer query = sql.mb_str(*conv);
+	PGresult *res;
+
+	pgResultFormatMap::iterator it = resultFormats.find(sql);
+	if (it != resultFormats.end())
+	{
+		int resultFormat = it->second;
+		res = PQexecParams(conn, query, 0, NULL, NULL, NULL, NULL, resultFormat);
+		if (resultFormat == 0 || PQresultStatus(res) != PGRES_TUPLES_OK || ChooseResultFormat(res, false))
+			return res;
+
+		// The columns have changed their types
+		PQclear(res);
+		resultFormats.erase(sql);
+		refused = true;
+		return 0;
+	}
+
+	int resultFormat;
+	res = PrepareBinary(query, resultFormat);
+	if (res)
+		return res;
+
+	if (resultFormats.size() >= 50)
+		resultFormats.clear();
+	resultFormats[sql] = resultFormat;
+
+	return PQexecPrepared(conn, "", 0, NULL, NULL, NULL, resultFormat);
+}
+
 //////////////////////////////////////////////////////////////////////////
 // COPY functions
 //////////////////////////////////////////////////////////////////////////
@@ -945,6 +1226,10 @@ void pgConn::LogError(const bool quiet)
 
 bool pgConn::IsAlive()
 {
+	// Closed on purpose; it will be reopened when used
+	if (suspended)
+		return true;
+
 	if (GetStatus() != PGCONN_OK)
 		return false;
 
@@ -992,7 +1277,9 @@ void pgConn::Reset()
 
 wxString pgConn::GetVersionString()
 {
-	return ExecuteScalar(wxT("SELECT version();"));
+	if (versionString.IsEmpty())
+		versionString = ExecuteScalar(wxT("SELECT version();"));
+	return versionString;
 }
 
 void pgConn::SetLastResultError(PGresult *res, const wxString &msg)
@@ -0,0 +1,239 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// pgConnPool.cpp - Pool of the connections opened to one server
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "pgAdmin3.h"
+
+// wxWindows headers
+#include <wx/wx.h>
+
+// App headers
+#include "db/pgConn.h"
+#include "db/pgConnPool.h"
+
+
+#define POOL_TIMER_ID   4444
+
+// How often idle connections are looked for, in ms
+#define POOL_CHECK_INTERVAL 30000
+
+
+BEGIN_EVENT_TABLE(pgConnPool, wxEvtHandler)
+	EVT_TIMER(POOL_TIMER_ID,                pgConnPool::OnTimer)
+END_EVENT_TABLE()
+
+
+pgConnPool::pgConnPool() : lock(wxMUTEX_RECURSIVE)
+{
+	timer = new wxTimer(this, POOL_TIMER_ID);
+	timer->Start(POOL_CHECK_INTERVAL);
+}
+
+
+pgConnPool::~pgConnPool()
+{
+	timer->Stop();
+	delete timer;
+
+	Clear();
+
+	// The windows using them delete these themselves
+	wxMutexLocker locker(lock);
+	size_t i;
+	for (i = 0 ; i < leased.GetCount() ; i++)
+		leased.Item(i)->pool = 0;
+}
+
+
+pgConn *pgConnPool::Lease(const wxString &dbName, const wxString &applicationName)
+{
+	while (true)
+	{
+		pgConn *conn = 0;
+		{
+			wxMutexLocker locker(lock);
+			size_t i = idle.GetCount();
+			while (i > 0 && !conn)
+			{
+				i--;
+				if (idle.Item(i)->GetDbname() == dbName && idle.Item(i)->GetApplicationName() == applicationName)
+				{
+					conn = idle.Item(i);
+					idle.RemoveAt(i);
+				}
+			}
+		}
+
+		if (!conn)
+			return 0;
+
+		// Checked without the lock, it runs a query
+		if (conn->IsAlive())
+		{
+			wxMutexLocker locker(lock);
+			leased.Add(conn);
+			return conn;
+		}
+		delete conn;
+	}
+}
+
+
+void pgConnPool::Add(pgConn *conn)
+{
+	conn->pool = this;
+	{
+		wxMutexLocker locker(lock);
+		leased.Add(conn);
+	}
+	Reclaim(conn);
+}
+
+
+void pgConnPool::Clear()
+{
+	wxMutexLocker locker(lock);
+	while (idle.GetCount())
+		delete idle.Last();
+}
+
+
+void pgConnPool::Release(pgConn *conn)
+{
+	if (!conn)
+		return;
+
+	if (conn->pool)
+		conn->pool->Put(conn);
+	else
+		delete conn;
+}
+
+
+void pgConnPool::Put(pgConn *conn)
+{
+	Forget(conn);
+
+	conn->RegisterNoticeProcessor(0, 0);
+	conn->SetSubsystem(PGCONN_SUB_BROWSER);
+
+	if (settings->GetConnPoolTimeout() > 0 && !conn->IsSuspended() && conn->ResetSession())
+	{
+		{
+			wxMutexLocker locker(lock);
+			idle.Add(conn);
+		}
+		Reclaim();
+	}
+	else
+		delete conn;
+}
+
+
+void pgConnPool::Forget(pgConn *conn)
+{
+	wxMutexLocker locker(lock);
+	if (leased.Index(conn) != wxNOT_FOUND)
+		leased.Remove(conn);
+	if (idle.Index(conn) != wxNOT_FOUND)
+		idle.Remove(conn);
+}
+
+
+// Closes the connections that have been idle for too long, and the least
+// recently used ones while there are more open than allowed. Browser
+// connections are only suspended, and never while a query runs on them.
+void pgConnPool::Reclaim(pgConn *keep)
+{
+	// Only the GUI thread suspends connections, the timer catches up with
+	// connections resumed elsewhere
+	if (!wxThread::IsMain())
+		return;
+
+	wxMutexLocker locker(lock);
+
+	time_t timeout = settings->GetConnPoolTimeout() * 60L;
+	long maxConns = settings->GetConnPoolMaxConnections();
+	time_t now = time(NULL);
+	size_t i;
+
+	i = idle.GetCount();
+	while (i > 0)
+	{
+		i--;
+		if (now - idle.Item(i)->GetLastUsed() >= timeout)
+			delete idle.Item(i);
+	}
+
+	pgConnArray candidates;
+	long open = idle.GetCount();
+	for (i = 0 ; i < leased.GetCount() ; i++)
+	{
+		pgConn *conn = leased.Item(i);
+		if (conn->IsSuspended())
+			continue;
+
+		open++;
+		if (conn != keep && !conn->busy && conn->GetSubsystem() == PGCONN_SUB_BROWSER &&
+		        conn->GetStatus() == PGCONN_OK && conn->GetTxStatus() == PGCONN_TXSTATUS_IDLE)
+		{
+			if (timeout > 0 && now - conn->GetLastUsed() >= timeout)
+			{
+				conn->Suspend();
+				open--;
+			}
+			else
+				candidates.Add(conn);
+		}
+	}
+
+	if (maxConns <= 0)
+		return;
+
+	while (open > maxConns)
+	{
+		// Idle connections go first, oldest first
+		if (idle.GetCount())
+		{
+			delete idle.Item(0);
+			open--;
+			continue;
+		}
+
+		if (candidates.IsEmpty())
+			break;
+
+		size_t oldest = 0;
+		for (i = 1 ; i < candidates.GetCount() ; i++)
+		{
+			if (candidates.Item(i)->GetLastUsed() < candidates.Item(oldest)->GetLastUsed())
+				oldest = i;
+		}
+		candidates.Item(oldest)->Suspend();
+		candidates.RemoveAt(oldest);
+		open--;
+	}
+}
+
+
+void pgConnPool::SetBusy(pgConn *conn, bool busy)
+{
+	wxMutexLocker locker(lock);
+	if (busy)
+		conn->busy++;
+	else
+		conn->busy--;
+}
+
+
+void pgConnPool::OnTimer(wxTimerEvent &ev)
+{
+	Reclaim();
+}
@@ -0,0 +1,277 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// pgQueryStats.cpp - Timing statistics of the queries pgAdmin executes
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "pgAdmin3.h"
+
+// wxWindows headers
+#include <wx/wx.h>
+#include <wx/hashmap.h>
+#include <wx/thread.h>
+
+// App headers
+#include "db/pgQueryStats.h"
+
+#include <wx/arrimpl.cpp>
+WX_DEFINE_OBJARRAY(pgQueryStatsArray);
+
+WX_DECLARE_STRING_HASH_MAP(pgQueryStatsEntry *, pgQueryStatsMap);
+
+// Only this much of a statement is kept; query tool scripts can be huge
+#define PGSTATS_MAX_SQL         2000
+// Further statements are counted as "other statements" of their subsystem
+#define PGSTATS_MAX_STATEMENTS  2000
+
+
+static wxMutex statsLock;
+static pgQueryStatsMap statsMap;
+static long statsHistograms[PGCONN_SUB_COUNT][PGSTATS_BUCKETS];
+
+
+pgQueryStatsEntry::pgQueryStatsEntry()
+{
+	subsystem = PGCONN_SUB_BROWSER;
+	calls = 0;
+	totalTime = 0.0;
+	maxTime = 0.0;
+	rows = 0.0;
+	bytes = 0.0;
+}
+
+
+void pgQueryStats::Record(int subsystem, const wxString &sql, long elapsed, PGresult *res)
+{
+	if (subsystem < 0 || subsystem >= PGCONN_SUB_COUNT)
+		subsystem = PGCONN_SUB_BROWSER;
+
+	double rows = 0.0, bytes = 0.0;
+	if (res)
+	{
+		if (PQresultStatus(res) == PGRES_TUPLES_OK)
+		{
+			int nRows = PQntuples(res), nCols = PQnfields(res);
+			int row, col;
+
+			rows = nRows;
+			for (row = 0 ; row < nRows ; row++)
+			{
+				for (col = 0 ; col < nCols ; col++)
+					bytes += PQgetlength(res, row, col);
+			}
+		}
+		else
+		{
+			char *s = PQcmdTuples(res);
+			if (*s)
+				rows = atol(s);
+		}
+	}
+
+	int bucket = 0;
+	while (bucket < PGSTATS_BUCKETS - 1 && elapsed >= (1L << bucket))
+		bucket++;
+
+	// Keep the subsystems apart
+	wxString key = wxString::Format(wxT("%d "), subsystem) + NormaliseQuery(sql);
+
+	wxMutexLocker locker(statsLock);
+
+	statsHistograms[subsystem][bucket]++;
+
+	pgQueryStatsEntry *entry;
+	pgQueryStatsMap::iterator it = statsMap.find(key);
+	if (it != statsMap.end())
+		entry = it->second;
+	else
+	{
+		if (statsMap.size() >= PGSTATS_MAX_STATEMENTS)
+		{
+			key = wxString::Format(wxT("%d "), subsystem) + _("(other statements)");
+			it = statsMap.find(key);
+		}
+
+		if (it != statsMap.end())
+			entry = it->second;
+		else
+		{
+			entry = new pgQueryStatsEntry();
+			entry->sql = key.AfterFirst(' ');
+			entry->subsystem = subsystem;
+			statsMap[key] = entry;
+		}
+	}
+
+	entry->calls++;
+	entry->totalTime += elapsed;
+	if (elapsed > entry->maxTime)
+		entry->maxTime = elapsed;
+	entry->rows += rows;
+	entry->bytes += bytes;
+}
+
+
+static int wxCMPFUNC_CONV pgQueryStatsCompare(pgQueryStatsEntry **a, pgQueryStatsEntry **b)
+{
+	if ((*a)->totalTime != (*b)->totalTime)
+		return (*a)->totalTime > (*b)->totalTime ? -1 : 1;
+	return (*a)->calls > (*b)->calls ? -1 : ((*a)->calls < (*b)->calls ? 1 : 0);
+}
+
+
+void pgQueryStats::GetTopEntries(pgQueryStatsArray &entries, int subsystem, size_t maxEntries)
+{
+	entries.Clear();
+
+	{
+		wxMutexLocker locker(statsLock);
+
+		pgQueryStatsMap::iterator it;
+		for (it = statsMap.begin() ; it != statsMap.end() ; ++it)
+		{
+			if (subsystem < 0 || it->second->subsystem == subsystem)
+				entries.Add(*it->second);
+		}
+	}
+
+	entries.Sort(pgQueryStatsCompare);
+
+	while (entries.GetCount() > maxEntries)
+		entries.RemoveAt(entries.GetCount() - 1);
+}
+
+
+void pgQueryStats::GetHistogram(int subsystem, long *counts)
+{
+	wxMutexLocker locker(statsLock);
+
+	int s, b;
+	for (b = 0 ; b < PGSTATS_BUCKETS ; b++)
+	{
+		counts[b] = 0;
+		for (s = 0 ; s < PGCONN_SUB_COUNT ; s++)
+		{
+			if (subsystem < 0 || s == subsystem)
+				counts[b] += statsHistograms[s][b];
+		}
+	}
+}
+
+
+void pgQueryStats::Reset()
+{
+	wxMutexLocker locker(statsLock);
+
+	pgQueryStatsMap::iterator it;
+	for (it = statsMap.begin() ; it != statsMap.end() ; ++it)
+		delete it->second;
+	statsMap.clear();
+
+	memset(statsHistograms, 0, sizeof(statsHistograms));
+}
+
+
+wxString pgQueryStats::GetSubsystemName(int subsystem)
+{
+	switch (subsystem)
+	{
+		case PGCONN_SUB_BROWSER:
+			return _("Browser");
+		case PGCONN_SUB_STATUS:
+			return _("Server status");
+		case PGCONN_SUB_QUERYTOOL:
+			return _("Query tool");
+		case PGCONN_SUB_EDITGRID:
+			return _("Edit grid");
+		case PGCONN_SUB_DEBUGGER:
+			return _("Debugger");
+	}
+	return wxEmptyString;
+}
+
+
+wxString pgQueryStats::GetBucketName(int bucket)
+{
+	if (bucket == 0)
+		return _("< 1 ms");
+	if (bucket == PGSTATS_BUCKETS - 1)
+		return wxString::Format(_(">= %ld ms"), 1L << (bucket - 1));
+	return wxString::Format(_("%ld - %ld ms"), 1L << (bucket - 1), (1L << bucket) - 1);
+}
+
+
+// Replaces string and numeric literals by '?' and collapses white space,
+// so that the same statement run with different arguments is grouped.
+wxString pgQueryStats::NormaliseQuery(const wxString &sql)
+{
+	wxString result;
+	size_t len = sql.Length() < PGSTATS_MAX_SQL ? sql.Length() : PGSTATS_MAX_SQL;
+	result.Alloc(len + 4);
+
+	bool space = false;
+	size_t i = 0;
+	while (i < len)
+	{
+		wxChar c = sql.GetChar(i);
+
+		if (wxIsspace(c))
+		{
+			space = true;
+			i++;
+			continue;
+		}
+		if (space && !result.IsEmpty())
+			result += wxT(' ');
+		space = false;
+
+		if (c == '\'')
+		{
+			// A doubled quote continues the literal
+			i++;
+			while (i < len)
+			{
+				if (sql.GetChar(i) == '\'')
+				{
+					if (i + 1 < len && sql.GetChar(i + 1) == '\'')
+						i++;
+					else
+						break;
+				}
+				i++;
+			}
+			i++;
+			result += wxT('?');
+		}
+		else if (wxIsdigit(c) && (result.IsEmpty() || !(wxIsalnum(result.Last()) || result.Last() == '_')))
+		{
+			while (i < len && (wxIsdigit(sql.GetChar(i)) || sql.GetChar(i) == '.'))
+				i++;
+			result += wxT('?');
+		}
+		else if (c == '"')
+		{
+			// Quoted identifiers are kept as they are
+			size_t end = sql.find('"', i + 1);
+			if (end == wxString::npos || end >= len)
+				end = len - 1;
+			result += sql.Mid(i, end - i + 1);
+			i = end + 1;
+		}
+		else
+		{
+			result += c;
+			i++;
+		}
+	}
+
+	if (len < sql.Length())
+		result += wxT("...");
+
+	return result;
+}
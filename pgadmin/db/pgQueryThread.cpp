@@ -13,6 +13,7 @@
 
 // wxWindows headers
 #include <wx/wx.h>
+#include <wx/stopwatch.h>
 
 // PostgreSQL headers
 #include <libpq-fe.h>
@@ -40,6 +41,7 @@ pgQueryThread::pgQueryThread(pgConn *_conn, const wxString &qry, int _resultToRe
 	result = 0;
 	resultToRetrieve = _resultToRetrieve;
 	rc = -1;
+	binaryResults = false;
 	insertedOid = (OID) - 1;
 	caller = _caller;
 	eventId = _eventId;
@@ -47,6 +49,7 @@ pgQueryThread::pgQueryThread(pgConn *_conn, const wxString &qry, int _resultToRe
 
 	wxLogSql(wxT("Thread query (%s:%d): %s"), conn->GetHost().c_str(), conn->GetPort(), qry.c_str());
 
+	conn->Resume();
 	conn->RegisterNoticeProcessor(pgNoticeProcessor, this);
 	if (conn->conn)
 		PQsetnonblocking(conn->conn, 1);
@@ -92,10 +95,88 @@ void pgQueryThread::appendMessageRaw(const wxString &str)
 }
 
 
+// Prepares the query as the unnamed statement and describes it, without
+// blocking so that the query can still be cancelled. Returns 1 with the
+// format of the results chosen, or with the result of the failing step in
+// failed; 0 if the connection broke and -1 if cancelling failed.
+int pgQueryThread::prepareBinary(const char *queryBuf, int &resultFormat, PGresult *&failed)
+{
+	int step;
+	for (step = 0 ; step < 2 ; step++)
+	{
+		int sent;
+		if (step == 0)
+			sent = PQsendPrepare(conn->conn, "", queryBuf, 0, NULL);
+		else
+			sent = PQsendDescribePrepared(conn->conn, "");
+		if (!sent)
+			return 0;
+
+		PGresult *res = 0;
+		int ret = waitForResult(res);
+		if (ret <= 0 || !res)
+		{
+			if (res)
+				PQclear(res);
+			return(ret < 0 ? ret : 0);
+		}
+		if (PQresultStatus(res) != PGRES_COMMAND_OK)
+		{
+			failed = res;
+			return 1;
+		}
+		if (step == 1)
+			resultFormat = conn->ChooseResultFormat(res, true);
+		PQclear(res);
+	}
+	return 1;
+}
+
+
+// Waits for the results of a command that returns no rows, keeping the
+// first one. Returns 1 once they are all read, 0 if the connection broke
+// and -1 if cancelling failed.
+int pgQueryThread::waitForResult(PGresult *&res)
+{
+	while (true)
+	{
+		if (TestDestroy())
+		{
+			if (rc != -3)
+			{
+				if (!PQrequestCancel(conn->conn)) // could not abort; abort failed.
+					return -1;
+
+				rc = -3;
+			}
+		}
+		if (!PQconsumeInput(conn->conn))
+			return 0;
+		if (PQisBusy(conn->conn))
+		{
+			Yield();
+			this->Sleep(10);
+			continue;
+		}
+
+		PGresult *next = PQgetResult(conn->conn);
+		if (!next)
+			return 1;
+		if (res)
+			PQclear(next);
+		else
+			res = next;
+	}
+}
+
+
 int pgQueryThread::execute()
 {
 	rowsInserted = -1L;
 
+	// Keeps the pool from suspending the connection while we use it
+	pgConnBusy running(conn);
+
 	if (!conn->conn)
 		return(raiseEvent(0));
 
@@ -106,15 +187,39 @@ int pgQueryThread::execute()
 		return(raiseEvent(0));
 	}
 
-	if (!PQsendQuery(conn->conn, queryBuf))
+	wxStopWatch sw;
+	PGresult *lastResult = 0;
+	bool sent;
+	if (binaryResults)
+	{
+		// If preparing or describing the query fails, its result is the
+		// one returned
+		int resultFormat = 0;
+		int ret = prepareBinary(queryBuf, resultFormat, lastResult);
+		if (ret < 0)
+			return(raiseEvent(ret));
+
+		// A cancel that came while preparing most likely found the server
+		// idle and was ignored, so don't run the query at all
+		if (ret && !lastResult && (rc == -3 || TestDestroy()))
+		{
+			rc = -3;
+			conn->SetLastResultError(NULL, _("The query was cancelled."));
+			return(raiseEvent(-3));
+		}
+		sent = ret && (lastResult || PQsendQueryPrepared(conn->conn, "", 0, NULL, NULL, NULL, resultFormat));
+	}
+	else
+		sent = (PQsendQuery(conn->conn, queryBuf) != 0);
+	if (!sent)
 	{
 		conn->SetLastResultError(NULL);
 		conn->IsAlive();
 		return(raiseEvent(0));
 	}
 	int resultsRetrieved = 0;
-	PGresult *lastResult = 0;
-	while (true)
+	bool prepareFailed = (lastResult != 0);
+	while (!prepareFailed)
 	{
 		if (TestDestroy())
 		{
@@ -219,6 +324,8 @@ int pgQueryThread::execute()
 	if (!result)
 		result = lastResult;
 
+	pgQueryStats::Record(conn->GetSubsystem(), query, sw.Time(), result);
+
 	conn->SetLastResultError(result);
 
 	appendMessage(wxT("\n"));
@@ -14,6 +14,10 @@
 // wxWindows headers
 #include <wx/wx.h>
 
+#include <float.h>
+#include <locale.h>
+#include <math.h>
+
 // PostgreSQL headers
 #include <libpq-fe.h>
 
@@ -34,6 +38,9 @@ pgSet::pgSet()
 	nCols = 0;
 	nRows = 0;
 	pos = 0;
+	needColQuoting = false;
+	binary = false;
+	shortestFloats = false;
 }
 
 pgSet::pgSet(PGresult *newRes, pgConn *newConn, wxMBConv &cnv, bool needColQt)
@@ -43,6 +50,8 @@ pgSet::pgSet(PGresult *newRes, pgConn *newConn, wxMBConv &cnv, bool needColQt)
 
 	conn = newConn;
 	res = newRes;
+	binary = false;
+	shortestFloats = false;
 
 	// Make sure we have tuples
 	if (PQresultStatus(res) != PGRES_TUPLES_OK)
@@ -56,6 +65,12 @@ pgSet::pgSet(PGresult *newRes, pgConn *newConn, wxMBConv &cnv, bool needColQt)
 		nCols = PQnfields(res);
 		nRows = PQntuples(res);
 		MoveFirst();
+
+		// Since 12, the server writes the shortest text that reads back
+		// as the same float
+		binary = (PQbinaryTuples(res) != 0);
+		if (binary && conn && conn->connection())
+			shortestFloats = (PQserverVersion(conn->connection()) >= 120000);
 	}
 }
 
@@ -188,6 +203,9 @@ wxString pgSet::GetVal(const int col) const
 {
 	wxASSERT(col < nCols && col >= 0);
 
+	if (binary)
+		return GetBinaryValAt(pos - 1, col);
+
 	return wxString(GetCharPtr(col), conv);
 }
 
@@ -202,6 +220,9 @@ long pgSet::GetLong(const int col) const
 {
 	wxASSERT(col < nCols && col >= 0);
 
+	if (IsBinary(col))
+		return (long)GetBinaryIntAt(pos - 1, col);
+
 	char *c = PQgetvalue(res, pos - 1, col);
 	if (c)
 		return atol(c);
@@ -212,11 +233,7 @@ long pgSet::GetLong(const int col) const
 
 long pgSet::GetLong(const wxString &col) const
 {
-	char *c = PQgetvalue(res, pos - 1, ColNumber(col));
-	if (c)
-		return atol(c);
-	else
-		return 0;
+	return GetLong(ColNumber(col));
 }
 
 
@@ -224,6 +241,9 @@ bool pgSet::GetBool(const int col) const
 {
 	wxASSERT(col < nCols && col >= 0);
 
+	if (IsBinary(col))
+		return GetBinaryIntAt(pos - 1, col) != 0;
+
 	char *c = PQgetvalue(res, pos - 1, col);
 	if (c)
 	{
@@ -244,6 +264,9 @@ wxDateTime pgSet::GetDateTime(const int col) const
 {
 	wxASSERT(col < nCols && col >= 0);
 
+	if (IsBinary(col))
+		return GetBinaryDateTimeAt(pos - 1, col);
+
 	wxDateTime dt;
 	wxString str = GetVal(col);
 	/* This hasn't just been used. ( Is not infinity ) */
@@ -263,6 +286,14 @@ wxDateTime pgSet::GetDate(const int col) const
 {
 	wxASSERT(col < nCols && col >= 0);
 
+	if (IsBinary(col))
+	{
+		wxDateTime dt = GetBinaryDateTimeAt(pos - 1, col);
+		if (dt.IsValid())
+			dt.ResetTime();
+		return dt;
+	}
+
 	wxDateTime dt;
 	wxString str = GetVal(col);
 	/* This hasn't just been used. ( Is not infinity ) */
@@ -282,6 +313,9 @@ double pgSet::GetDouble(const int col) const
 {
 	wxASSERT(col < nCols && col >= 0);
 
+	if (IsBinary(col))
+		return GetBinaryNumberAt(pos - 1, col);
+
 	return StrToDouble(GetVal(col));
 }
 
@@ -296,6 +330,9 @@ wxULongLong pgSet::GetLongLong(const int col) const
 {
 	wxASSERT(col < nCols && col >= 0);
 
+	if (IsBinary(col))
+		return wxULongLong((wxULongLong_t)GetBinaryIntAt(pos - 1, col));
+
 	char *c = PQgetvalue(res, pos - 1, col);
 	if (c)
 		return atolonglong(c);
@@ -313,6 +350,9 @@ OID pgSet::GetOid(const int col) const
 {
 	wxASSERT(col < nCols && col >= 0);
 
+	if (IsBinary(col))
+		return (OID)GetBinaryIntAt(pos - 1, col);
+
 	char *c = PQgetvalue(res, pos - 1, col);
 	if (c)
 		return (OID)strtoul(c, 0, 10);
@@ -327,6 +367,402 @@ OID pgSet::GetOid(const wxString &col) const
 }
 
 
+//////////////////////////////////////////////////////////////////
+// Binary values
+//////////////////////////////////////////////////////////////////
+
+// Timestamps are microseconds since 2000-01-01, with the largest and the
+// smallest value standing for infinity and -infinity
+#define BINARY_TIMESTAMP_END    wxLL(0x7FFFFFFFFFFFFFFF)
+#define BINARY_TIMESTAMP_BEGIN  (-BINARY_TIMESTAMP_END - 1)
+#define BINARY_DAY_MICROS       wxLL(86400000000)
+
+// Milliseconds from 1970-01-01 to 2000-01-01
+#define BINARY_EPOCH_MILLIS     wxLL(946684800000)
+
+
+// Integers come in network byte order
+static wxInt64 ReadBinaryInt(const char *value, int length, bool isSigned)
+{
+	const unsigned char *p = (const unsigned char *)value;
+	wxUint64 n = 0;
+	int i;
+
+	for (i = 0 ; i < length ; i++)
+		n = (n << 8) | p[i];
+
+	if (isSigned && length > 0 && length < 8 && (p[0] & 0x80))
+		n |= ~(wxUint64)0 << (length * 8);
+
+	return (wxInt64)n;
+}
+
+
+static double ReadBinaryFloat(const char *value, int length)
+{
+	wxUint64 bits = (wxUint64)ReadBinaryInt(value, length, false);
+
+	if (length == 4)
+	{
+		wxUint32 bits32 = (wxUint32)bits;
+		float f;
+		memcpy(&f, &bits32, sizeof(f));
+		return f;
+	}
+
+	double d;
+	memcpy(&d, &bits, sizeof(d));
+	return d;
+}
+
+
+static void FormatBinaryInt(wxInt64 value, char *buf)
+{
+	char digits[24];
+	int count = 0;
+	wxUint64 n = value < 0 ? -(wxUint64)value : (wxUint64)value;
+
+	do
+	{
+		digits[count++] = (char)('0' + n % 10);
+		n /= 10;
+	}
+	while (n);
+
+	if (value < 0)
+		*buf++ = '-';
+	while (count)
+		*buf++ = digits[--count];
+	*buf = 0;
+}
+
+
+// The text the server writes for a float in its default settings: before
+// 12, FLT_DIG or DBL_DIG significant digits as %g writes them; since then
+// the fewest digits that read back as the same value, written in exponent
+// notation unless the exponent is in [-4, 6) for float4 or [-4, 15) for
+// float8, whatever the number of digits
+static void FormatBinaryFloat(double value, bool isFloat4, bool shortest, char *buf)
+{
+	if (value != value)
+	{
+		strcpy(buf, "NaN");
+		return;
+	}
+	if (value > DBL_MAX)
+	{
+		strcpy(buf, "Infinity");
+		return;
+	}
+	if (value < -DBL_MAX)
+	{
+		strcpy(buf, "-Infinity");
+		return;
+	}
+
+	if (!shortest)
+	{
+		sprintf(buf, "%.*g", isFloat4 ? FLT_DIG : DBL_DIG, value);
+
+		// Whatever the locale of the client, like the server
+		char point = *localeconv()->decimal_point;
+		if (point != '.')
+		{
+			char *p = strchr(buf, point);
+			if (p)
+				*p = '.';
+		}
+		return;
+	}
+
+	// A value that reads back with n digits does with more as well
+	char text[32];
+	int low = 1, high = isFloat4 ? 9 : 17;
+	while (low < high)
+	{
+		int mid = (low + high) / 2;
+		sprintf(text, "%.*e", mid - 1, value);
+		if (isFloat4 ? (float)strtod(text, 0) == (float)value : strtod(text, 0) == value)
+			high = mid;
+		else
+			low = mid + 1;
+	}
+	sprintf(text, "%.*e", low - 1, value);
+
+	// Take the digits and the exponent apart, skipping the decimal point
+	// of whatever locale the client uses
+	char digits[20];
+	int count = 0;
+	const char *p = text;
+	if (*p == '-')
+		p++;
+	for ( ; *p != 'e' ; p++)
+	{
+		if (*p >= '0' && *p <= '9')
+			digits[count++] = *p;
+	}
+	int exponent = atoi(p + 1);
+
+	char *out = buf;
+	if (text[0] == '-')
+		*out++ = '-';
+
+	int i;
+	if (exponent < -4 || exponent >= (isFloat4 ? 6 : 15))
+	{
+		*out++ = digits[0];
+		if (count > 1)
+		{
+			*out++ = '.';
+			for (i = 1 ; i < count ; i++)
+				*out++ = digits[i];
+		}
+		sprintf(out, "e%c%02d", exponent < 0 ? '-' : '+', exponent < 0 ? -exponent : exponent);
+	}
+	else if (exponent < 0)
+	{
+		*out++ = '0';
+		*out++ = '.';
+		for (i = -1 ; i > exponent ; i--)
+			*out++ = '0';
+		for (i = 0 ; i < count ; i++)
+			*out++ = digits[i];
+		*out = 0;
+	}
+	else
+	{
+		for (i = 0 ; i <= exponent ; i++)
+			*out++ = i < count ? digits[i] : '0';
+		if (count > exponent + 1)
+		{
+			*out++ = '.';
+			for ( ; i < count ; i++)
+				*out++ = digits[i];
+		}
+		*out = 0;
+	}
+}
+
+
+// Breaks a timestamp down into the fields of the Gregorian calendar
+static void SplitBinaryTimestamp(wxInt64 micros, long &year, int &month, int &day, int &hour, int &minute, int &second, long &fraction)
+{
+	wxInt64 days = micros / BINARY_DAY_MICROS;
+	wxInt64 rest = micros % BINARY_DAY_MICROS;
+	if (rest < 0)
+	{
+		rest += BINARY_DAY_MICROS;
+		days--;
+	}
+
+	// Days since 0000-03-01, so that leap days end the year
+	long z = (long)days + 730425;
+	long era = (z >= 0 ? z : z - 146096) / 146097;
+	long dayOfEra = z - era * 146097;
+	long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+	long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+	long shiftedMonth = (5 * dayOfYear + 2) / 153;
+
+	day = (int)(dayOfYear - (153 * shiftedMonth + 2) / 5 + 1);
+	month = (int)(shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9);
+	year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+
+	long secs = (long)(rest / 1000000);
+	fraction = (long)(rest % 1000000);
+	hour = (int)(secs / 3600);
+	minute = (int)(secs / 60 % 60);
+	second = (int)(secs % 60);
+}
+
+
+// The ISO style the connection asks for; values with a time zone are
+// written in UTC
+static void FormatBinaryTimestamp(wxInt64 micros, bool withZone, char *buf)
+{
+	if (micros == BINARY_TIMESTAMP_END)
+	{
+		strcpy(buf, "infinity");
+		return;
+	}
+	if (micros == BINARY_TIMESTAMP_BEGIN)
+	{
+		strcpy(buf, "-infinity");
+		return;
+	}
+
+	long year, fraction;
+	int month, day, hour, minute, second;
+	SplitBinaryTimestamp(micros, year, month, day, hour, minute, second, fraction);
+
+	bool bc = (year <= 0);
+	if (bc)
+		year = 1 - year;
+
+	char *p = buf + sprintf(buf, "%04ld-%02d-%02d %02d:%02d:%02d", year, month, day, hour, minute, second);
+	if (fraction)
+	{
+		p += sprintf(p, ".%06ld", fraction);
+		while (p[-1] == '0')
+			*--p = 0;
+	}
+	if (withZone)
+	{
+		strcpy(p, "+00");
+		p += 3;
+	}
+	if (bc)
+		strcpy(p, " BC");
+}
+
+
+const char *pgSet::GetTextAt(const long row, const int col, char *buf) const
+{
+	const char *value = PQgetvalue(res, row, col);
+
+	if (!IsBinary(col) || PQgetisnull(res, row, col))
+		return value;
+
+	OID type = PQftype(res, col);
+	switch (type)
+	{
+		case PGOID_TYPE_BOOL:
+			strcpy(buf, *value ? "t" : "f");
+			break;
+
+		case PGOID_TYPE_INT2:
+		case PGOID_TYPE_INT4:
+		case PGOID_TYPE_INT8:
+		case PGOID_TYPE_OID:
+			FormatBinaryInt(GetBinaryIntAt(row, col), buf);
+			break;
+
+		case PGOID_TYPE_FLOAT4:
+		case PGOID_TYPE_FLOAT8:
+			FormatBinaryFloat(ReadBinaryFloat(value, PQgetlength(res, row, col)), type == PGOID_TYPE_FLOAT4, shortestFloats, buf);
+			break;
+
+		case PGOID_TYPE_TIMESTAMP:
+		case PGOID_TYPE_TIMESTAMPTZ:
+			FormatBinaryTimestamp(GetBinaryIntAt(row, col), type == PGOID_TYPE_TIMESTAMPTZ, buf);
+			break;
+
+		default:
+			// Text types look the same in both formats
+			return value;
+	}
+
+	return buf;
+}
+
+
+wxString pgSet::GetBinaryValAt(const long row, const int col) const
+{
+	char buf[PGSET_BINARY_TEXT];
+	return wxString(GetTextAt(row, col, buf), conv);
+}
+
+
+wxInt64 pgSet::GetBinaryIntAt(const long row, const int col) const
+{
+	if (PQgetisnull(res, row, col))
+		return 0;
+
+	const char *value = PQgetvalue(res, row, col);
+	int length = PQgetlength(res, row, col);
+
+	switch (PQftype(res, col))
+	{
+		case PGOID_TYPE_BOOL:
+			return *value ? 1 : 0;
+
+		case PGOID_TYPE_INT2:
+		case PGOID_TYPE_INT4:
+		case PGOID_TYPE_INT8:
+		case PGOID_TYPE_TIMESTAMP:
+		case PGOID_TYPE_TIMESTAMPTZ:
+			return ReadBinaryInt(value, length, true);
+
+		case PGOID_TYPE_OID:
+			return ReadBinaryInt(value, length, false);
+
+		case PGOID_TYPE_FLOAT4:
+		case PGOID_TYPE_FLOAT8:
+			return (wxInt64)ReadBinaryFloat(value, length);
+	}
+
+	return atolonglong(value);
+}
+
+
+double pgSet::GetBinaryNumberAt(const long row, const int col) const
+{
+	if (PQgetisnull(res, row, col))
+		return 0.0;
+
+	switch (PQftype(res, col))
+	{
+		case PGOID_TYPE_FLOAT4:
+		case PGOID_TYPE_FLOAT8:
+			return ReadBinaryFloat(PQgetvalue(res, row, col), PQgetlength(res, row, col));
+
+		case PGOID_TYPE_TIMESTAMP:
+		case PGOID_TYPE_TIMESTAMPTZ:
+		{
+			wxInt64 micros = GetBinaryIntAt(row, col);
+			if (micros == BINARY_TIMESTAMP_END)
+				return HUGE_VAL;
+			if (micros == BINARY_TIMESTAMP_BEGIN)
+				return -HUGE_VAL;
+			return micros / 1000000.0;
+		}
+	}
+
+	return (double)GetBinaryIntAt(row, col);
+}
+
+
+wxDateTime pgSet::GetBinaryDateTimeAt(const long row, const int col) const
+{
+	wxDateTime dt;
+	OID type = PQftype(res, col);
+
+	if (type != PGOID_TYPE_TIMESTAMP && type != PGOID_TYPE_TIMESTAMPTZ)
+	{
+		wxString str = GetBinaryValAt(row, col);
+		if (!str.IsEmpty())
+			dt.ParseDateTime(str);
+		return dt;
+	}
+
+	if (PQgetisnull(res, row, col))
+		return dt;
+
+	// Like infinity as text, which does not parse
+	wxInt64 micros = GetBinaryIntAt(row, col);
+	if (micros == BINARY_TIMESTAMP_END || micros == BINARY_TIMESTAMP_BEGIN)
+		return dt;
+
+	if (type == PGOID_TYPE_TIMESTAMPTZ)
+	{
+		wxInt64 millis = micros / 1000;
+		if (micros % 1000 < 0)
+			millis--;
+		return wxDateTime(wxLongLong(millis + BINARY_EPOCH_MILLIS));
+	}
+
+	// Without a time zone, the fields are taken as local time as they are
+	// when the text is parsed
+	long year, fraction;
+	int month, day, hour, minute, second;
+	SplitBinaryTimestamp(micros, year, month, day, hour, minute, second, fraction);
+
+	dt.Set((wxDateTime::wxDateTime_t)day, (wxDateTime::Month)(month - 1), (int)year,
+	       (wxDateTime::wxDateTime_t)hour, (wxDateTime::wxDateTime_t)minute, (wxDateTime::wxDateTime_t)second,
+	       (wxDateTime::wxDateTime_t)(fraction / 1000));
+	return dt;
+}
+
+
 //////////////////////////////////////////////////////////////////
 
 pgSetIterator::pgSetIterator(pgConn *conn, const wxString &qry)
@@ -30,6 +30,7 @@
 #include "dd/ddmodel/ddDatabaseDesign.h"
 
 ddDatabaseDesign *ddXmlStorage::design = NULL;
+wxString ddXmlStorage::readError;
 ctlAuiNotebook *ddXmlStorage::tabs = NULL;
 
 ddXmlStorage::ddXmlStorage():
@@ -532,120 +533,33 @@ void ddXmlStorage::WriteLocal(xmlTextWriterPtr writer, hdDrawing *diagram)
 	xmlTextWriterEndElement(writer);
 }
 
-//This is needed because table doesn't have any explicit order when stored then I created all first
-void ddXmlStorage::initialModelParse(xmlTextReaderPtr reader)
-{
-	int ret, tmp;
-	xmlChar *value;
-
-	if(reader != NULL)
-	{
-		wxString tableName = wxEmptyString, tableAlias = wxEmptyString, TableID;
-		xmlTextReaderSetParserProp( reader, XML_PARSER_VALIDATE, 1 );
-		ret = xmlTextReaderRead(reader);
-		while (ret == 1)
-		{
-			if(getNodeType(reader) == 1 && getNodeName(reader).IsSameAs(_("TABLE"), false)) //libxml 1 for start element
-			{
-				//Look for table ID
-				tmp = xmlTextReaderHasAttributes(reader);
-				TableID = _("TableID");
-				if(tmp)
-				{
-					value = xmlTextReaderGetAttribute(reader, XML_FROM_WXSTRING(TableID));
-				}
-
-				if(value)
-				{
-					TableID = WXSTRING_FROM_XML(value);
-					xmlFree(value);
-				}
-
-				// <!ELEMENT POINTS (POINT*)>
-				wxString tmpInt;
-				tmp = xmlTextReaderRead(reader);	//go to POINTS
-				wxArrayInt x, y;
-				if(getNodeName(reader).IsSameAs(_("POINTS")) && getNodeType(reader) == 1 && !xmlTextReaderIsEmptyElement(reader) )
-				{
-					tmp = xmlTextReaderRead(reader);	//go POINT
-					do
-					{
-						// --> POINT
-						//<!ELEMENT POINT (X,Y)>
-						tmp = xmlTextReaderRead(reader);	//go X
-						tmp = xmlTextReaderRead(reader);	//go X Value
-						tmp = xmlTextReaderRead(reader);	//go to /X
-
-						tmp = xmlTextReaderRead(reader);	//go Y
-						tmp = xmlTextReaderRead(reader);	//go Y Value
-						tmp = xmlTextReaderRead(reader);	//go to /Y
-
-						tmp = xmlTextReaderRead(reader);	//go /POINT
-						tmp = xmlTextReaderRead(reader);	//go POINT or /POINTS ?
-					}
-					while(getNodeName(reader).IsSameAs(_("POINT"), false));
-				}
-
-				tmp = xmlTextReaderRead(reader);	//go to TITLE
-				tmp = xmlTextReaderRead(reader);	//go to NAME
-				tmp = xmlTextReaderRead(reader);	//go to NAME Value
-				value = xmlTextReaderValue(reader);  //Value of NAME
-				if(value)
-				{
-					tableName = WXSTRING_FROM_XML(value);
-					design->addTableToMapping(TableID, tableName);
-					xmlFree(value);
-				}
-				tmp = xmlTextReaderRead(reader);	//go to /NAME
-
-				tmp = xmlTextReaderRead(reader);	//go to ALIAS or /TITLE
-				if(getNodeName(reader).IsSameAs(_("ALIAS"), false))
-				{
-					tmp = xmlTextReaderRead(reader);	//go to ALIAS Value
-					value = xmlTextReaderValue(reader);  //Value of ALIAS
-					if(value)
-					{
-						tableAlias = WXSTRING_FROM_XML(value);
-						xmlFree(value);
-					}
-					tmp = xmlTextReaderRead(reader);	//go to /ALIAS
-					tmp = xmlTextReaderRead(reader);	//go to /TITLE
-				}
-				ddTableFigure *t = new ddTableFigure(tableName, -1, -1);
-
-				design->addTableToModel(t);
-			}
-			ret = xmlTextReaderRead(reader);
-		}
-
-		//Once the document has been fully parsed check the validation results
-		if (xmlTextReaderIsValid(reader) != 1)
-		{
-			wxMessageBox(_("Model is not following embedded DTD definition, check it.\n"));
-			return;
-		}
-	}
-	//reset reader to begining of stream
-}
-
-
-
 bool ddXmlStorage::Read(xmlTextReaderPtr reader)
 {
 	int ret;
 
 	if(reader != NULL)
 	{
-		xmlTextReaderSetParserProp( reader, XML_PARSER_VALIDATE, 1 );
+		//Checking the embedded DTD is slow for big models, and only useful for hand edited files
+		bool validate = settings->GetDDValidateModels();
+		if(validate)
+			xmlTextReaderSetParserProp( reader, XML_PARSER_VALIDATE, 1 );
+		readError = wxEmptyString;
 		ret = xmlTextReaderRead(reader);
-		while (ret == 1)
+		while (ret == 1 && readError.IsEmpty())
 		{
 			selectReader(reader);
 			ret = xmlTextReaderRead(reader);
 		}
 
+		//A reference that can't be resolved stops loading the model
+		if (!readError.IsEmpty())
+		{
+			wxMessageBox(readError, _("Error"), wxICON_ERROR | wxOK);
+			return false;
+		}
+
 		//Once the document has been fully parsed check the validation results
-		if (xmlTextReaderIsValid(reader) != 1)
+		if (validate && xmlTextReaderIsValid(reader) != 1)
 		{
 			wxMessageBox(_("Model is not following embedded DTD definition, check it.\n"));
 			return false;
@@ -664,6 +578,13 @@ bool ddXmlStorage::Read(xmlTextReaderPtr reader)
 	return false;
 }
 
+//Names of nodes are interned at libxml dictionary, compare them without any copy
+bool ddXmlStorage::isNode(xmlTextReaderPtr reader, const char *name)
+{
+	const xmlChar *nodeName = xmlTextReaderConstName(reader);
+	return nodeName != NULL && xmlStrcasecmp(nodeName, BAD_CAST name) == 0;
+}
+
 wxString ddXmlStorage::getNodeName(xmlTextReaderPtr reader)
 {
 	xmlChar *name;
@@ -698,27 +619,28 @@ void ddXmlStorage::selectReader(xmlTextReaderPtr reader)
 {
 	if(getNodeType(reader) == 1) //libxml 1 for start element
 	{
-		if(getNodeName(reader).IsSameAs(_("VERSION"), false))
+		if(isNode(reader, "VERSION"))
 		{
 			checkVersion(reader);
 		}
-		if(getNodeName(reader).IsSameAs(_("MODEL"), false))
+		if(isNode(reader, "MODEL"))
 		{
 			//<!ELEMENT MODEL (TABLE+)>
 		}
 
-		if(getNodeName(reader).IsSameAs(_("TABLE"), false))
+		if(isNode(reader, "TABLE"))
 		{
 			getTable(reader);
 		}
 
-		if(getNodeName(reader).IsSameAs(_("RELATIONSHIP"), false))
+		if(isNode(reader, "RELATIONSHIP"))
 		{
 			ddRelationshipFigure *r = getRelationship(reader);
-			design->addTableToModel(r);
+			if(r)
+				design->getEditor()->addModelFigure(r);
 		}
 
-		if(getNodeName(reader).IsSameAs(_("DIAGRAMS"), false))
+		if(isNode(reader, "DIAGRAMS"))
 		{
 			initDiagrams(reader);
 		}
@@ -786,7 +708,7 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 	*/
 
 	int tmp;
-	wxString TableID, node, tmpInt;
+	wxString TableID, node;
 	xmlChar *value;
 
 	//<!ATTLIST TABLE	TableID ID #REQUIRED >
@@ -812,7 +734,7 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 	// <!ELEMENT POINTS (POINT*)>
 	tmp = xmlTextReaderRead(reader);	//go to POINTS
 	wxArrayInt x, y;
-	if(getNodeName(reader).IsSameAs(_("POINTS")) && getNodeType(reader) == 1 && !xmlTextReaderIsEmptyElement(reader) )
+	if(isNode(reader, "POINTS") && getNodeType(reader) == 1 && !xmlTextReaderIsEmptyElement(reader) )
 	{
 		tmp = xmlTextReaderRead(reader);	//go POINT
 		do
@@ -824,8 +746,7 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 			value = xmlTextReaderValue(reader);  //Value of X
 			if(value)
 			{
-				tmpInt = WXSTRING_FROM_XML(value);
-				x.Add(wxAtoi(tmpInt));
+				x.Add(atoi((const char *)value));
 				xmlFree(value);
 			}
 			tmp = xmlTextReaderRead(reader);	//go to /X
@@ -835,18 +756,17 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 			value = xmlTextReaderValue(reader);  //Value of Y
 			if(value)
 			{
-				tmpInt = WXSTRING_FROM_XML(value);
-				y.Add(wxAtoi(tmpInt));
+				y.Add(atoi((const char *)value));
 				xmlFree(value);
 			}
 			tmp = xmlTextReaderRead(reader);	//go to /Y
 			tmp = xmlTextReaderRead(reader);	//go /POINT
 			tmp = xmlTextReaderRead(reader);	//go POINT or /POINTS ?
 		}
-		while(getNodeName(reader).IsSameAs(_("POINT"), false));
+		while(isNode(reader, "POINT"));
 	}
 
-	if(!getNodeName(reader).IsSameAs(_("POINTS"), false))
+	if(!isNode(reader, "POINTS"))
 		processResult(-1);
 
 	// --> TITLE
@@ -868,7 +788,7 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /NAME
 	tmp = xmlTextReaderRead(reader);	//go to ALIAS or /TITLE
-	if(getNodeName(reader).IsSameAs(_("ALIAS"), false))
+	if(isNode(reader, "ALIAS"))
 	{
 		tmp = xmlTextReaderRead(reader);	//go to ALIAS Value
 		value = xmlTextReaderValue(reader);  //Value of ALIAS
@@ -886,7 +806,7 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 	//<!ELEMENT UKNAME (#PCDATA)>
 	tmp = xmlTextReaderRead(reader);	//go to UKNAMES or PKNAMES?
 	wxArrayString ukNames;
-	if(getNodeName(reader).IsSameAs(_("UKNAMES"), false))
+	if(isNode(reader, "UKNAMES"))
 	{
 		tmp = xmlTextReaderRead(reader);	//go UKNAME
 		do
@@ -901,17 +821,17 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 			tmp = xmlTextReaderRead(reader);	//go to /UKNAME
 			tmp = xmlTextReaderRead(reader);	//go to UKNAME or /UKNAMES ?
 		}
-		while(getNodeName(reader).IsSameAs(_("UKNAME"), false));
+		while(isNode(reader, "UKNAME"));
 		tmp = xmlTextReaderRead(reader);	//go to PKNAME
 	}
 
 	// --> PKNAME
 	//<!ELEMENT PKNAME (#PCDATA)>
 	wxString pkName;
-	if(getNodeName(reader).IsSameAs(_("PKNAME")))
+	if(isNode(reader, "PKNAME"))
 	{
 		tmp = xmlTextReaderRead(reader);	//go to PKNAME Value or PKNAME node?
-		if(!getNodeName(reader).IsSameAs(_("PKNAME")))
+		if(!isNode(reader, "PKNAME"))
 		{
 			value = xmlTextReaderValue(reader);  //Value of PKNAME
 			if(value)
@@ -931,8 +851,7 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		beginDrawCols = wxAtoi(tmpInt);
+		beginDrawCols = atoi((const char *)value);
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /BEGINDRAWCOLS
@@ -944,8 +863,7 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		beginDrawIdxs = wxAtoi(tmpInt);
+		beginDrawIdxs = atoi((const char *)value);
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /BEGINDRAWIDXS
@@ -957,8 +875,7 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		maxColIndex = wxAtoi(tmpInt);
+		maxColIndex = atoi((const char *)value);
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /MAXCOLINDEX
@@ -970,8 +887,7 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		minIdxIndex = wxAtoi(tmpInt);
+		minIdxIndex = atoi((const char *)value);
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /MINIDXINDEX
@@ -983,8 +899,7 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		maxIdxIndex = wxAtoi(tmpInt);
+		maxIdxIndex = atoi((const char *)value);
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /MAXIDXINDEX
@@ -996,8 +911,7 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		colsRowsSize = wxAtoi(tmpInt);
+		colsRowsSize = atoi((const char *)value);
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /COLSROWSSIZE
@@ -1009,8 +923,7 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		colsWindow = wxAtoi(tmpInt);
+		colsWindow = atoi((const char *)value);
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /COLSWINDOW
@@ -1022,8 +935,7 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		idxsRowsSize = wxAtoi(tmpInt);
+		idxsRowsSize = atoi((const char *)value);
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /IDXSROWSSIZE
@@ -1035,8 +947,7 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		idxsWindow = wxAtoi(tmpInt);
+		idxsWindow = atoi((const char *)value);
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /IDXSWINDOW
@@ -1045,20 +956,19 @@ ddTableFigure *ddXmlStorage::getTable(xmlTextReaderPtr reader)
 
 	tmp = xmlTextReaderRead(reader);	//go to COLUMNS
 
-	//Use empty table without columns created at preparsing to fill it with metadata
-
-	ddTableFigure *t = design->getTable(tableName);
-	if(t != NULL)
-		t->InitTableValues(ukNames, pkName, beginDrawCols, beginDrawIdxs, maxColIndex, minIdxIndex, maxIdxIndex, colsRowsSize, colsWindow, idxsRowsSize, idxsWindow);
-	else
-		wxMessageBox(_("Table initial metadata info not found"));
+	//All tables are stored before relationships that need them, so each one can be
+	//created when found. Browser is refreshed once the whole model has been read.
+	design->addTableToMapping(TableID, tableName);
+	ddTableFigure *t = new ddTableFigure(tableName, -1, -1);
+	design->getEditor()->addModelFigure(t);
+	t->InitTableValues(ukNames, pkName, beginDrawCols, beginDrawIdxs, maxColIndex, minIdxIndex, maxIdxIndex, colsRowsSize, colsWindow, idxsRowsSize, idxsWindow);
 
 
 	//CHANGE 300,300 for right value when displaybox metadata will be added
 
 
 	//COLUMNS node have COLUMN children?
-	if(getNodeName(reader).IsSameAs(_("COLUMNS")) && getNodeType(reader) == 1 && !xmlTextReaderIsEmptyElement(reader) )
+	if(isNode(reader, "COLUMNS") && getNodeType(reader) == 1 && !xmlTextReaderIsEmptyElement(reader) )
 	{
 		ddColumnFigure *c;
 		do
@@ -1097,7 +1007,7 @@ ddColumnFigure *ddXmlStorage::getColumn(xmlTextReaderPtr reader, ddTableFigure *
 	xmlChar *value;
 	int tmp;
 	tmp = xmlTextReaderRead(reader);	//go to COLUMN
-	if(getNodeName(reader).IsSameAs(_("COLUMN")) && getNodeType(reader) == 1 && !xmlTextReaderIsEmptyElement(reader) )
+	if(isNode(reader, "COLUMN") && getNodeType(reader) == 1 && !xmlTextReaderIsEmptyElement(reader) )
 	{
 		// --> ATTRIBUTE*
 		//Element(s) Attribute*
@@ -1120,13 +1030,11 @@ ddColumnFigure *ddXmlStorage::getColumn(xmlTextReaderPtr reader, ddTableFigure *
 		// --> OPTION
 		//<!ELEMENT OPTION (#PCDATA)>
 		int option;
-		wxString tmpInt;
 		tmp = xmlTextReaderRead(reader);	//go to OPTION Value
 		value = xmlTextReaderValue(reader);  //Value
 		if(value)
 		{
-			tmpInt = WXSTRING_FROM_XML(value);
-			option = wxAtoi(tmpInt);
+			option = atoi((const char *)value);
 			xmlFree(value);
 		}
 		tmp = xmlTextReaderRead(reader);	//go to /OPTION
@@ -1139,8 +1047,7 @@ ddColumnFigure *ddXmlStorage::getColumn(xmlTextReaderPtr reader, ddTableFigure *
 		value = xmlTextReaderValue(reader);  //Value
 		if(value)
 		{
-			tmpInt = WXSTRING_FROM_XML(value);
-			ukindex = wxAtoi(tmpInt);
+			ukindex = atoi((const char *)value);
 			xmlFree(value);
 		}
 		tmp = xmlTextReaderRead(reader);	//go to /UKINDEX
@@ -1153,8 +1060,7 @@ ddColumnFigure *ddXmlStorage::getColumn(xmlTextReaderPtr reader, ddTableFigure *
 		value = xmlTextReaderValue(reader);  //Value of ISPK
 		if(value)
 		{
-			tmpInt = WXSTRING_FROM_XML(value);
-			isPk = tmpInt.IsSameAs(_("T"));
+			isPk = xmlStrEqual(value, BAD_CAST "T");
 			xmlFree(value);
 		}
 		tmp = xmlTextReaderRead(reader);	//go to /ISPK
@@ -1176,14 +1082,13 @@ ddColumnFigure *ddXmlStorage::getColumn(xmlTextReaderPtr reader, ddTableFigure *
 		//<!ELEMENT PRECISION (#PCDATA)>
 		tmp = xmlTextReaderRead(reader);	//go to PRECISION? or SCALE? or ALIAS? or GENERATEFKNAME
 		int precision = -1;
-		if(getNodeName(reader).IsSameAs(_("PRECISION")))
+		if(isNode(reader, "PRECISION"))
 		{
 			tmp = xmlTextReaderRead(reader);	//go to PRECISION Value
 			value = xmlTextReaderValue(reader);  //Value of PRECISION
 			if(value)
 			{
-				tmpInt = WXSTRING_FROM_XML(value);
-				precision = wxAtoi(tmpInt);
+				precision = atoi((const char *)value);
 				xmlFree(value);
 			}
 			tmp = xmlTextReaderRead(reader);	//go to /PRECISION
@@ -1194,14 +1099,13 @@ ddColumnFigure *ddXmlStorage::getColumn(xmlTextReaderPtr reader, ddTableFigure *
 		//<!ELEMENT SCALE (#PCDATA)>
 
 		int scale = -1;
-		if(getNodeName(reader).IsSameAs(_("SCALE")))
+		if(isNode(reader, "SCALE"))
 		{
 			tmp = xmlTextReaderRead(reader);	//go to SCALE Value
 			value = xmlTextReaderValue(reader);  //Value of SCALE
 			if(value)
 			{
-				tmpInt = WXSTRING_FROM_XML(value);
-				scale = wxAtoi(tmpInt);
+				scale = atoi((const char *)value);
 				xmlFree(value);
 			}
 			tmp = xmlTextReaderRead(reader);	//go to /SCALE
@@ -1215,8 +1119,7 @@ ddColumnFigure *ddXmlStorage::getColumn(xmlTextReaderPtr reader, ddTableFigure *
 		value = xmlTextReaderValue(reader);  //Value of GENERATEFKNAME
 		if(value)
 		{
-			tmpInt = WXSTRING_FROM_XML(value);
-			generateFkName = tmpInt.IsSameAs(_("T"));
+			generateFkName = xmlStrEqual(value, BAD_CAST "T");
 			xmlFree(value);
 		}
 		tmp = xmlTextReaderRead(reader);	//go to /GENERATEFKNAME
@@ -1256,7 +1159,6 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 	*/
 
 	xmlChar *value;
-	wxString tmpInt;
 	int tmp;
 
 	//<!ATTLIST RELATIONSHIP SourceTableID IDREF #REQUIRED >
@@ -1290,6 +1192,15 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 	ddTableFigure *source = design->getTable(design->getTableName(SourceTableID));
 	ddTableFigure *destination = design->getTable(design->getTableName(DestTableID));
 
+	//Tables are created as they are read, so they must be stored before the
+	//relationships that refer to them, as the DTD says
+	if(!source || !destination)
+	{
+		readError = wxString::Format(_("Relationship refers to table %s that is not defined before it."),
+		                             (source ? DestTableID : SourceTableID).c_str());
+		return NULL;
+	}
+
 	ddRelationshipFigure *relation = new ddRelationshipFigure();
 	relation->setStartTerminal(new ddRelationshipTerminal(relation, false));
 	relation->setEndTerminal(new ddRelationshipTerminal(relation, true));
@@ -1304,7 +1215,7 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 	int x, y, posIdx = 0;
 
 	tmp = xmlTextReaderRead(reader);	//go to POINTSRELATION
-	if(getNodeName(reader).IsSameAs(_("POINTSRELATION"), false))
+	if(isNode(reader, "POINTSRELATION"))
 	{
 		//only first time inside POINTSRELATION this is needed
 		tmp = xmlTextReaderRead(reader);	//go POINTS
@@ -1320,7 +1231,7 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 				firstPoint = false;
 			}
 
-			if(getNodeName(reader).IsSameAs(_("POINTS")) && getNodeType(reader) == 1 && !xmlTextReaderIsEmptyElement(reader) )
+			if(isNode(reader, "POINTS") && getNodeType(reader) == 1 && !xmlTextReaderIsEmptyElement(reader) )
 			{
 				//only first time inside POINTS this is needed
 				tmp = xmlTextReaderRead(reader);	//go POINT
@@ -1331,8 +1242,7 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 					value = xmlTextReaderValue(reader);  //Value of X
 					if(value)
 					{
-						tmpInt = WXSTRING_FROM_XML(value);
-						x = wxAtoi(tmpInt);
+						x = atoi((const char *)value);
 						xmlFree(value);
 					}
 					tmp = xmlTextReaderRead(reader);	//go to /X
@@ -1342,8 +1252,7 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 					value = xmlTextReaderValue(reader);  //Value of Y
 					if(value)
 					{
-						tmpInt = WXSTRING_FROM_XML(value);
-						y = wxAtoi(tmpInt);
+						y = atoi((const char *)value);
 						xmlFree(value);
 					}
 					tmp = xmlTextReaderRead(reader);	//go to /Y
@@ -1352,11 +1261,11 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 
 					tmp = xmlTextReaderRead(reader);	//go POINT or /POINTS?
 				}
-				while(getNodeName(reader).IsSameAs(_("POINT"), false) && getNodeType(reader) == 1);
+				while(isNode(reader, "POINT") && getNodeType(reader) == 1);
 			}
 			else
 			{
-				if(! (getNodeName(reader).IsSameAs(_("POINTS")) && xmlTextReaderIsEmptyElement(reader))  )
+				if(! (isNode(reader, "POINTS") && xmlTextReaderIsEmptyElement(reader))  )
 				{
 					processResult(-1);
 				}
@@ -1364,10 +1273,10 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 			posIdx++;  //change of points array then change view position index
 			tmp = xmlTextReaderRead(reader);	//go POINTS or /POINTSRELATION?
 		}
-		while(getNodeName(reader).IsSameAs(_("POINTS"), false) && getNodeType(reader) == 1);
+		while(isNode(reader, "POINTS") && getNodeType(reader) == 1);
 	}
 
-	if(!getNodeName(reader).IsSameAs(_("POINTSRELATION"), false))
+	if(!isNode(reader, "POINTSRELATION"))
 	{
 		processResult(-1);
 	}
@@ -1380,8 +1289,7 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		ukindex = wxAtoi(tmpInt);
+		ukindex = atoi((const char *)value);
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /UKINDEX
@@ -1390,7 +1298,7 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 	//<!ELEMENT NAME (#PCDATA)>
 	tmp = xmlTextReaderRead(reader);	//go to NAME or ONUPDATE
 	wxString RelationshipName = wxEmptyString;
-	if(getNodeName(reader).IsSameAs(_("NAME"), false))
+	if(isNode(reader, "NAME"))
 	{
 
 		tmp = xmlTextReaderRead(reader);	//go to NAME Value
@@ -1412,8 +1320,7 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		onUpdate = wxAtoi(tmpInt);
+		onUpdate = atoi((const char *)value);
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /ONUPDATE
@@ -1426,8 +1333,7 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		onDelete = wxAtoi(tmpInt);
+		onDelete = atoi((const char *)value);
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /ONDELETE
@@ -1440,8 +1346,7 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value of MATCHSIMPLE
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		matchSimple = tmpInt.IsSameAs(_("T"));
+		matchSimple = xmlStrEqual(value, BAD_CAST "T");
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /MATCHSIMPLE
@@ -1454,8 +1359,7 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value of IDENTIFYING
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		identifying = tmpInt.IsSameAs(_("T"));
+		identifying = xmlStrEqual(value, BAD_CAST "T");
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /IDENTIFYING
@@ -1468,8 +1372,7 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value of ONETOMANY
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		oneToMany = tmpInt.IsSameAs(_("T"));
+		oneToMany = xmlStrEqual(value, BAD_CAST "T");
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /ONETOMANY
@@ -1482,8 +1385,7 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value of MANDATORY
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		mandatory = tmpInt.IsSameAs(_("T"));
+		mandatory = xmlStrEqual(value, BAD_CAST "T");
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /MANDATORY
@@ -1496,8 +1398,7 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 	value = xmlTextReaderValue(reader);  //Value of FKFROMPK
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		fkFromPk = tmpInt.IsSameAs(_("T"));
+		fkFromPk = xmlStrEqual(value, BAD_CAST "T");
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /FKFROMPK
@@ -1510,7 +1411,7 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 	// --> RELATIONITEMS
 	//<!ELEMENT RELATIONITEMS (RELATIONITEM*)>
 	tmp = xmlTextReaderRead(reader);	//go to RELATIONITEMS
-	if(getNodeName(reader).IsSameAs(_("RELATIONITEMS")) && getNodeType(reader) == 1 && !xmlTextReaderIsEmptyElement(reader) )
+	if(isNode(reader, "RELATIONITEMS") && getNodeType(reader) == 1 && !xmlTextReaderIsEmptyElement(reader) )
 	{
 		tmp = xmlTextReaderRead(reader);	//go RELATIONITEM
 		do
@@ -1521,7 +1422,7 @@ ddRelationshipFigure *ddXmlStorage::getRelationship(xmlTextReaderPtr reader)
 
 			tmp = xmlTextReaderRead(reader);	//go to RELATIONITEM or /RELATIONITEMS
 		}
-		while(getNodeName(reader).IsSameAs(_("RELATIONITEM"), false));
+		while(isNode(reader, "RELATIONITEM"));
 	}
 
 	tmp = xmlTextReaderRead(reader);	//go to /RELATIONSHIP
@@ -1541,7 +1442,6 @@ ddRelationshipItem *ddXmlStorage::getRelationshipItem(xmlTextReaderPtr reader, d
 	<!ELEMENT INITIALALIASNAME (#PCDATA)>
 	*/
 	xmlChar *value;
-	wxString tmpInt;
 	int tmp;
 
 	// --> AUTOGENFK
@@ -1552,8 +1452,7 @@ ddRelationshipItem *ddXmlStorage::getRelationshipItem(xmlTextReaderPtr reader, d
 	value = xmlTextReaderValue(reader);  //Value of AUTOGENFK
 	if(value)
 	{
-		tmpInt = WXSTRING_FROM_XML(value);
-		autoGenFk = tmpInt.IsSameAs(_("T"));
+		autoGenFk = xmlStrEqual(value, BAD_CAST "T");
 		xmlFree(value);
 	}
 	tmp = xmlTextReaderRead(reader);	//go to /AUTOGENFK
@@ -1597,7 +1496,7 @@ ddRelationshipItem *ddXmlStorage::getRelationshipItem(xmlTextReaderPtr reader, d
 	//<!ELEMENT INITIALALIASNAME (#PCDATA)>
 	tmp = xmlTextReaderRead(reader);	//go to INITIALALIASNAME
 	wxString initialAliasName = wxEmptyString;
-	if(getNodeName(reader).IsSameAs(_("INITIALALIASNAME"), false))
+	if(isNode(reader, "INITIALALIASNAME"))
 	{
 		tmp = xmlTextReaderRead(reader);	//go to INITIALALIASNAME Value
 		value = xmlTextReaderValue(reader);  //Value of INITIALALIASNAME
@@ -1639,7 +1538,7 @@ void ddXmlStorage::initDiagrams(xmlTextReaderPtr reader)
 
 	//<!ELEMENT DIAGRAM (NAME, TABLEREF*)>
 	tmp = xmlTextReaderRead(reader);	//go to DIAGRAM
-	if(getNodeName(reader).IsSameAs(_("DIAGRAM")) && getNodeType(reader) == 1 && !xmlTextReaderIsEmptyElement(reader) )
+	if(isNode(reader, "DIAGRAM") && getNodeType(reader) == 1 && !xmlTextReaderIsEmptyElement(reader) )
 	{
 		do
 		{
@@ -1667,7 +1566,7 @@ void ddXmlStorage::initDiagrams(xmlTextReaderPtr reader)
 			//<!ELEMENT TABLEREF EMPTY>
 			tmp = xmlTextReaderRead(reader);	//go to TABLEREF
 			bool firstTime = true;
-			if(getNodeName(reader).IsSameAs(_("TABLEREF")) && xmlTextReaderIsEmptyElement(reader))
+			if(isNode(reader, "TABLEREF") && xmlTextReaderIsEmptyElement(reader))
 			{
 				wxString TableID, tableName;
 				if(firstTime)
@@ -1696,10 +1595,14 @@ void ddXmlStorage::initDiagrams(xmlTextReaderPtr reader)
 
 					tableName = design->getTableName(TableID);
 					//Add table to diagram
-					newDiagram->add(design->getTable(tableName));
+					ddTableFigure *table = design->getTable(tableName);
+					if(table)
+						newDiagram->add(table);
+					else
+						readError = wxString::Format(_("Diagram refers to table %s that is not defined."), TableID.c_str());
 					tmp = xmlTextReaderRead(reader);	//go to TABLEREF or /DIAGRAM?
 				}
-				while(getNodeName(reader).IsSameAs(_("TABLEREF"), false));
+				while(isNode(reader, "TABLEREF"));
 			}
 			//After adding a new diagram check for all needed relationships at diagram and add it.
 			if(design)
@@ -1713,7 +1616,7 @@ void ddXmlStorage::initDiagrams(xmlTextReaderPtr reader)
 			}
 			tmp = xmlTextReaderRead(reader);	//go to DIAGRAM or /DIAGRAMS?
 		}
-		while(getNodeName(reader).IsSameAs(_("DIAGRAM"), false));
+		while(isNode(reader, "DIAGRAM"));
 	}
 
 
@@ -14,6 +14,7 @@
 // wxWindows headers
 #include <wx/wx.h>
 #include <wx/regex.h>
+#include <wx/progdlg.h>
 
 // App headers
 #include "schema/pgSchema.h"
@@ -45,6 +46,7 @@ BEGIN_EVENT_TABLE(SelTablesPage, wxWizardPage)
 	EVT_BUTTON(DDREMOVEALL, SelTablesPage::OnButtonRemoveAll)
 	EVT_BUTTON(DDADD, SelTablesPage::OnButtonAdd)
 	EVT_BUTTON(DDADDALL, SelTablesPage::OnButtonAddAll)
+	EVT_MENU(DDIMPORTERROR, SelTablesPage::OnImportError)
 	EVT_WIZARD_PAGE_CHANGING(wxID_ANY, SelTablesPage::OnWizardPageChanging)
 END_EVENT_TABLE()
 
@@ -222,263 +224,230 @@ OID ddImportDBUtils::getTableOID(pgConn *connection, wxString schemaName, wxStri
 // Don't support inherited tables right now, or tables where a column is part of more than one Unique Key.
 ddStubTable *ddImportDBUtils::getTable(pgConn *connection, wxString tableName, OID tableOid)
 {
-	wxString sql;
-	int currentcol;
-	ddStubTable *table = NULL;
-	ddStubColumn *column = NULL;
+	oidsHashMap tableOids;
+	stubTablesHashMap tables;
+	wxArrayString inheritedTables;
 
+	tableOids[tableName] = tableOid;
+	getTables(connection, tableOids, tables, inheritedTables);
+
+	if (tables.find(tableName) == tables.end())
+		return NULL;
+
+	return tables[tableName];
+}
+
+// Build the stubs of all given tables with a fixed number of queries, each one
+// covering every table at once. Tables with inherited columns are not imported
+// but reported back through inheritedTables. If a query fails, no table is
+// returned.
+bool ddImportDBUtils::getTables(pgConn *connection, oidsHashMap &tableOids, stubTablesHashMap &tables, wxArrayString &inheritedTables, ddImportDBThread *thread)
+{
+	stubTablesOidHashMap candidates, stubs;
+	stubTablesOidHashMap::iterator st;
+	oidsHashMap::iterator it;
+
+	if (tableOids.empty())
+		return true;
+
+	for (it = tableOids.begin(); it != tableOids.end(); ++it)
+		candidates[it->second] = new ddStubTable(it->first, it->second);
 
 	// grab inherited tables  [if found don't allow table import because this feature isn't supported right now]
-	sql = wxT("SELECT inhparent::regclass AS inhrelname,\n")
-	      wxT("  (SELECT count(*) FROM pg_attribute WHERE attrelid=inhparent AND attnum>0) AS colscount\n")
-	      wxT("  FROM pg_inherits\n")
-	      wxT("  WHERE inhrelid =  ") + NumToStr(tableOid) + wxT("::oid\n")
-	      wxT("  ORDER BY inhseqno");
-	pgSet *inhtables = connection->ExecuteSet(sql);
-
-	if(inhtables && inhtables->Eof())
+	if (thread)
+		thread->SetProgress(1, _("Looking for inherited tables..."));
+
+	wxString sql = wxT("SELECT DISTINCT inhrelid\n")
+	               wxT("  FROM pg_inherits\n")
+	               wxT(" WHERE inhrelid = ANY(") + oidArray(candidates) + wxT(")");
+	pgSet *inhtables = executeSet(connection, sql, thread);
+	if (!inhtables)
 	{
-		wxString systemRestriction;
-		systemRestriction = wxT("\n   AND att.attnum > 0");
-
-		sql =
-		    wxT("SELECT att.*, def.*, pg_catalog.pg_get_expr(def.adbin, def.adrelid) AS defval, CASE WHEN att.attndims > 0 THEN 1 ELSE 0 END AS isarray, format_type(ty.oid,NULL) AS typname, format_type(ty.oid,att.atttypmod) AS displaytypname, tn.nspname as typnspname, et.typname as elemtypname,\n")
-		    wxT("  ty.typstorage AS defaultstorage, cl.relname, na.nspname, att.attstattarget, description, cs.relname AS sername, ns.nspname AS serschema,\n")
-		    wxT("  (SELECT count(1) FROM pg_type t2 WHERE t2.typname=ty.typname) > 1 AS isdup, indkey");
-
-		if (connection->BackendMinimumVersion(9, 1))
-			sql += wxT(",\n  coll.collname, nspc.nspname as collnspname");
-		if (connection->BackendMinimumVersion(8, 5))
-			sql += wxT(",\n  attoptions");
-		if (connection->BackendMinimumVersion(7, 4))
-			sql +=
-			    wxT(",\n")
-			    wxT("  EXISTS(SELECT 1 FROM  pg_constraint WHERE conrelid=att.attrelid AND contype='f'")
-			    wxT(" AND att.attnum=ANY(conkey)) As isfk");
-		if (connection->BackendMinimumVersion(9, 1))
-		{
-			sql += wxT(",\n(SELECT array_agg(label) FROM pg_seclabels sl1 WHERE sl1.objoid=att.attrelid AND sl1.objsubid=att.attnum) AS labels");
-			sql += wxT(",\n(SELECT array_agg(provider) FROM pg_seclabels sl2 WHERE sl2.objoid=att.attrelid AND sl2.objsubid=att.attnum) AS providers");
-		}
+		for (st = candidates.begin(); st != candidates.end(); ++st)
+			delete st->second;
+		return false;
+	}
 
-		sql += wxT("\n")
-		       wxT("  FROM pg_attribute att\n")
-		       wxT("  JOIN pg_type ty ON ty.oid=atttypid\n")
-		       wxT("  JOIN pg_namespace tn ON tn.oid=ty.typnamespace\n")
-		       wxT("  JOIN pg_class cl ON cl.oid=att.attrelid\n")
-		       wxT("  JOIN pg_namespace na ON na.oid=cl.relnamespace\n")
-		       wxT("  LEFT OUTER JOIN pg_type et ON et.oid=ty.typelem\n")
-		       wxT("  LEFT OUTER JOIN pg_attrdef def ON adrelid=att.attrelid AND adnum=att.attnum\n")
-		       wxT("  LEFT OUTER JOIN pg_description des ON des.objoid=att.attrelid AND des.objsubid=att.attnum\n")
-		       wxT("  LEFT OUTER JOIN (pg_depend JOIN pg_class cs ON objid=cs.oid AND cs.relkind='S') ON refobjid=att.attrelid AND refobjsubid=att.attnum\n")
-		       wxT("  LEFT OUTER JOIN pg_namespace ns ON ns.oid=cs.relnamespace\n")
-		       wxT("  LEFT OUTER JOIN pg_index pi ON pi.indrelid=att.attrelid AND indisprimary\n");
-		if (connection->BackendMinimumVersion(9, 1))
-			sql += wxT("  LEFT OUTER JOIN pg_collation coll ON att.attcollation=coll.oid\n")
-			       wxT("  LEFT OUTER JOIN pg_namespace nspc ON coll.collnamespace=nspc.oid\n");
-		sql += wxT(" WHERE att.attrelid = ") + NumToStr(tableOid)
-		       + systemRestriction + wxT("\n")
-		       wxT("   AND att.attisdropped IS FALSE\n")
-		       wxT(" ORDER BY att.attnum");
-
-		table = new ddStubTable(tableName, tableOid);
-
-		pgSet *columns = connection->ExecuteSet(sql);
-		if (columns)
-		{
-			currentcol = 0;
-			while (!columns->Eof())
-			{
-				currentcol++;
-				column = new ddStubColumn(columns->GetVal(wxT("attname")), tableOid);
-				column->pgColNumber = columns->GetLong(wxT("attnum"));
-				wxString pkCols = columns->GetVal(wxT("indkey"));
-				bool isPK = false;
-				wxStringTokenizer indkey(pkCols);
-				while (indkey.HasMoreTokens())
-				{
-					wxString str = indkey.GetNextToken();
-					if (StrToLong(str) == column->pgColNumber)
-					{
-						isPK = true;
-						break;
-					}
-				}
-				column->isPrimaryKey = isPK;
-
-				long typmod = columns->GetLong(wxT("atttypmod"));
-				pgDatatype *dt = new pgDatatype(columns->GetVal(wxT("typnspname")), columns->GetVal(wxT("typname")),
-				                                columns->GetBool(wxT("isdup")),
-				                                columns->GetLong(wxT("attndims")), typmod);
-
-				column->typeColumn = dt;
-				column->isNotNull = columns->GetBool(wxT("attnotnull"));
-				wxString colName = column->columnName;
-				table->cols[colName] = column;
-				columns->MoveNext();
-			}
+	while (!inhtables->Eof())
+	{
+		OID inhrelid = inhtables->GetOid(wxT("inhrelid"));
+		ddStubTable *table = candidates[inhrelid];
+		inheritedTables.Add(table->tableName);
+		candidates.erase(inhrelid);
+		delete table;
+		inhtables->MoveNext();
+	}
+	delete inhtables;
 
-			delete columns;
-		}
-		setUniqueConstraints(connection, table);
-		setPkName(connection, table);
-		return table;
+	for (st = candidates.begin(); st != candidates.end(); ++st)
+		stubs[st->first] = st->second;
+
+	if (stubs.empty())
+		return true;
+
+	if (thread)
+		thread->SetProgress(2, _("Reading columns..."));
+	bool ok = setColumns(connection, stubs, thread);
+
+	if (ok && thread)
+		thread->SetProgress(thread->GetSteps(), _("Reading primary and unique keys..."));
+	if (ok)
+		ok = setKeys(connection, stubs, thread);
+
+	for (st = stubs.begin(); st != stubs.end(); ++st)
+	{
+		if (ok)
+			tables[st->second->tableName] = st->second;
+		else
+			delete st->second;
 	}
 
-	return table;
+	return ok;
 }
 
-//true on everything fine, false when some error is found
-bool ddImportDBUtils::setUniqueConstraints(pgConn *connection, ddStubTable *table)
+// The import thread must not log, so its queries bypass ExecuteSet() and
+// hand their errors to the thread. Returns NULL if the query failed.
+pgSet *ddImportDBUtils::executeSet(pgConn *connection, const wxString &sql, ddImportDBThread *thread)
 {
-	bool out = true;
-	//temporary fix, this should be adapted to pgadmin way of working
-	// check for extended ruleutils with pretty-print option
-	wxString prettyOption;
-	wxString exprname = connection->ExecuteScalar(wxT("SELECT proname FROM pg_proc WHERE proname='pg_get_viewdef' AND proargtypes[1]=16"));
-	if (!exprname.IsEmpty())
-		prettyOption = wxT(", true");
+	if (!thread)
+		return connection->ExecuteSet(sql);
 
-	wxString query;
-
-	wxString proname, projoin;
-	if (connection->BackendMinimumVersion(7, 4))
+	wxMBConv *conv = connection->GetConv();
+	PGresult *res = PQexec(connection->connection(), sql.mb_str(*conv));
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
 	{
-		proname = wxT("indnatts, ");
-		if (connection->BackendMinimumVersion(7, 5))
-		{
-			proname += wxT("cls.reltablespace AS spcoid, spcname, ");
-			projoin = wxT("  LEFT OUTER JOIN pg_tablespace ta on ta.oid=cls.reltablespace\n");
-		}
+		thread->AddError(wxString(PQresultErrorMessage(res), *conv));
+		PQclear(res);
+		return NULL;
 	}
-	else
+
+	return new pgSet(res, connection, *conv, false);
+}
+
+// Format the OIDs of the tables as an array literal usable with = ANY()
+wxString ddImportDBUtils::oidArray(stubTablesOidHashMap &tables)
+{
+	wxString list;
+	stubTablesOidHashMap::iterator it;
+	for (it = tables.begin(); it != tables.end(); ++it)
 	{
-		proname = wxT("proname, pn.nspname as pronspname, proargtypes, ");
-		projoin =   wxT("  LEFT OUTER JOIN pg_proc pr ON pr.oid=indproc\n")
-		            wxT("  LEFT OUTER JOIN pg_namespace pn ON pn.oid=pr.pronamespace\n");
+		if (!list.IsEmpty())
+			list += wxT(",");
+		list += NumToStr(it->first);
 	}
-	query = wxT("SELECT DISTINCT ON(cls.relname) cls.oid, cls.relname as idxname, indrelid, indkey, indisclustered, indisunique, indisprimary, n.nspname,\n")
-	        wxT("       ") + proname + wxT("tab.relname as tabname, indclass, con.oid AS conoid, CASE contype WHEN 'p' THEN desp.description WHEN 'u' THEN desp.description WHEN 'x' THEN desp.description ELSE des.description END AS description,\n")
-	        wxT("       pg_get_expr(indpred, indrelid") + prettyOption + wxT(") as indconstraint, contype, condeferrable, condeferred, amname\n");
-	if (connection->BackendMinimumVersion(8, 2))
-		query += wxT(", substring(array_to_string(cls.reloptions, ',') from 'fillfactor=([0-9]*)') AS fillfactor \n");
-	query += wxT("  FROM pg_index idx\n")
-	         wxT("  JOIN pg_class cls ON cls.oid=indexrelid\n")
-	         wxT("  JOIN pg_class tab ON tab.oid=indrelid\n")
-	         + projoin +
-	         wxT("  JOIN pg_namespace n ON n.oid=tab.relnamespace\n")
-	         wxT("  JOIN pg_am am ON am.oid=cls.relam\n")
-	         wxT("  LEFT JOIN pg_depend dep ON (dep.classid = cls.tableoid AND dep.objid = cls.oid AND dep.refobjsubid = '0' AND dep.refclassid=(SELECT oid FROM pg_class WHERE relname='pg_constraint') AND dep.deptype='i')\n")
-	         wxT("  LEFT OUTER JOIN pg_constraint con ON (con.tableoid = dep.refclassid AND con.oid = dep.refobjid)\n")
-	         wxT("  LEFT OUTER JOIN pg_description des ON des.objoid=cls.oid\n")
-	         wxT("  LEFT OUTER JOIN pg_description desp ON (desp.objoid=con.oid AND desp.objsubid = 0)\n")
-	         wxT(" WHERE indrelid = ") + NumToStr(table->OIDTable) + wxT("::oid")
-	         + wxT(" AND contype='u' ")
-	         + wxT("\n")
-	         wxT(" ORDER BY cls.relname");
-	pgSet *indexes = connection->ExecuteSet(query);
-	int ukIndex = -1;
-	wxArrayString UniqueKeysNames;
-
-	if (indexes)
+	return wxT("'{") + list + wxT("}'::oid[]");
+}
+
+bool ddImportDBUtils::setColumns(pgConn *connection, stubTablesOidHashMap &tables, ddImportDBThread *thread)
+{
+	wxString sql =
+	    wxT("SELECT att.attrelid, att.attname, att.attnum, att.atttypmod, att.attndims, att.attnotnull,\n")
+	    wxT("  format_type(ty.oid,NULL) AS typname, tn.nspname as typnspname,\n")
+	    wxT("  (SELECT count(1) FROM pg_type t2 WHERE t2.typname=ty.typname) > 1 AS isdup, indkey\n")
+	    wxT("  FROM pg_attribute att\n")
+	    wxT("  JOIN pg_type ty ON ty.oid=atttypid\n")
+	    wxT("  JOIN pg_namespace tn ON tn.oid=ty.typnamespace\n")
+	    wxT("  LEFT OUTER JOIN pg_index pi ON pi.indrelid=att.attrelid AND indisprimary\n")
+	    wxT(" WHERE att.attrelid = ANY(") + oidArray(tables) + wxT(")\n")
+	    wxT("   AND att.attnum > 0\n")
+	    wxT("   AND att.attisdropped IS FALSE\n")
+	    wxT(" ORDER BY att.attrelid, att.attnum");
+
+	pgSet *columns = executeSet(connection, sql, thread);
+	if (!columns)
+		return false;
+
+	OID lastOid = 0;
+	ddStubTable *table = NULL;
+	ddStubColumn *column = NULL;
+	int tablesRead = 0;
+	while (!columns->Eof())
 	{
-		while (!indexes->Eof())
+		OID tableOid = columns->GetOid(wxT("attrelid"));
+		if (!table || tableOid != lastOid)
 		{
-			ukIndex++;
-			wxString uniqueKeys = indexes->GetVal(wxT("indkey"));
-
-			UniqueKeysNames.Add(indexes->GetVal(wxT("idxname")));
+			table = tables[tableOid];
+			lastOid = tableOid;
+			if (thread)
+				thread->SetProgress(2 + ++tablesRead, wxString::Format(_("Reading table %s..."), table->tableName.c_str()));
+		}
 
-			wxStringTokenizer indkey(uniqueKeys);
-			while (indkey.HasMoreTokens())
+		column = new ddStubColumn(columns->GetVal(wxT("attname")), tableOid);
+		column->pgColNumber = columns->GetLong(wxT("attnum"));
+		wxString pkCols = columns->GetVal(wxT("indkey"));
+		bool isPK = false;
+		wxStringTokenizer indkey(pkCols);
+		while (indkey.HasMoreTokens())
+		{
+			wxString str = indkey.GetNextToken();
+			if (StrToLong(str) == column->pgColNumber)
 			{
-				//Get column number in unique key
-				wxString str = indkey.GetNextToken();
-				//look at all columns [change for hashmap in a future if that option is more optimized]
-				stubColsHashMap::iterator it;
-				ddStubColumn *item;
-				for (it = table->cols.begin(); it != table->cols.end(); ++it)
-				{
-					wxString key = it->first;
-					item = it->second;
-					//If column belong to unique constraint mark it
-					if (StrToLong(str) == item->pgColNumber)
-					{
-						item->uniqueKeyIndex = ukIndex;
-					}
-				}
+				isPK = true;
+				break;
 			}
-			indexes->MoveNext();
 		}
-		table->UniqueKeysNames = UniqueKeysNames;
-		delete indexes;
+		column->isPrimaryKey = isPK;
+
+		long typmod = columns->GetLong(wxT("atttypmod"));
+		pgDatatype *dt = new pgDatatype(columns->GetVal(wxT("typnspname")), columns->GetVal(wxT("typname")),
+		                                columns->GetBool(wxT("isdup")),
+		                                columns->GetLong(wxT("attndims")), typmod);
+
+		column->typeColumn = dt;
+		column->isNotNull = columns->GetBool(wxT("attnotnull"));
+		wxString colName = column->columnName;
+		table->cols[colName] = column;
+		columns->MoveNext();
 	}
-	return out;  //false in a future when detect a column in more than one unique key because this is not supported by database designer right now
+
+	delete columns;
+	return true;
 }
 
-//true on everything fine, false when some error is found
-bool ddImportDBUtils::setPkName(pgConn *connection, ddStubTable *table)
+// Primary key name and unique constraints of all tables in one pass
+bool ddImportDBUtils::setKeys(pgConn *connection, stubTablesOidHashMap &tables, ddImportDBThread *thread)
 {
-	bool out = true;
-	wxString pkName = wxEmptyString;
-
-	//temporary fix, this should be adapted to pgadmin way of working
-	// check for extended ruleutils with pretty-print option
-	wxString prettyOption;
-	wxString exprname = connection->ExecuteScalar(wxT("SELECT proname FROM pg_proc WHERE proname='pg_get_viewdef' AND proargtypes[1]=16"));
-	if (!exprname.IsEmpty())
-		prettyOption = wxT(", true");
-
-	wxString query;
+	wxString query =
+	    wxT("SELECT DISTINCT ON(indrelid, cls.relname) indrelid, cls.relname as idxname, indkey, contype\n")
+	    wxT("  FROM pg_index idx\n")
+	    wxT("  JOIN pg_class cls ON cls.oid=indexrelid\n")
+	    wxT("  JOIN pg_depend dep ON (dep.classid = cls.tableoid AND dep.objid = cls.oid AND dep.refobjsubid = '0' AND dep.refclassid=(SELECT oid FROM pg_class WHERE relname='pg_constraint') AND dep.deptype='i')\n")
+	    wxT("  JOIN pg_constraint con ON (con.tableoid = dep.refclassid AND con.oid = dep.refobjid)\n")
+	    wxT(" WHERE indrelid = ANY(") + oidArray(tables) + wxT(")\n")
+	    wxT("   AND contype IN ('p', 'u')\n")
+	    wxT(" ORDER BY indrelid, cls.relname");
+
+	pgSet *indexes = executeSet(connection, query, thread);
+	if (!indexes)
+		return false;
 
-	wxString proname, projoin;
-	if (connection->BackendMinimumVersion(7, 4))
+	while (!indexes->Eof())
 	{
-		proname = wxT("indnatts, ");
-		if (connection->BackendMinimumVersion(7, 5))
+		ddStubTable *table = tables[indexes->GetOid(wxT("indrelid"))];
+
+		if (indexes->GetVal(wxT("contype")) == wxT("p"))
 		{
-			proname += wxT("cls.reltablespace AS spcoid, spcname, ");
-			projoin = wxT("  LEFT OUTER JOIN pg_tablespace ta on ta.oid=cls.reltablespace\n");
+			table->PrimaryKeyName = indexes->GetVal(wxT("idxname"));
 		}
-	}
-	else
-	{
-		proname = wxT("proname, pn.nspname as pronspname, proargtypes, ");
-		projoin =   wxT("  LEFT OUTER JOIN pg_proc pr ON pr.oid=indproc\n")
-		            wxT("  LEFT OUTER JOIN pg_namespace pn ON pn.oid=pr.pronamespace\n");
-	}
-	query = wxT("SELECT DISTINCT ON(cls.relname) cls.oid, cls.relname as idxname, indrelid, indkey, indisclustered, indisunique, indisprimary, n.nspname,\n")
-	        wxT("       ") + proname + wxT("tab.relname as tabname, indclass, con.oid AS conoid, CASE contype WHEN 'p' THEN desp.description WHEN 'u' THEN desp.description WHEN 'x' THEN desp.description ELSE des.description END AS description,\n")
-	        wxT("       pg_get_expr(indpred, indrelid") + prettyOption + wxT(") as indconstraint, contype, condeferrable, condeferred, amname\n");
-	if (connection->BackendMinimumVersion(8, 2))
-		query += wxT(", substring(array_to_string(cls.reloptions, ',') from 'fillfactor=([0-9]*)') AS fillfactor \n");
-	query += wxT("  FROM pg_index idx\n")
-	         wxT("  JOIN pg_class cls ON cls.oid=indexrelid\n")
-	         wxT("  JOIN pg_class tab ON tab.oid=indrelid\n")
-	         + projoin +
-	         wxT("  JOIN pg_namespace n ON n.oid=tab.relnamespace\n")
-	         wxT("  JOIN pg_am am ON am.oid=cls.relam\n")
-	         wxT("  LEFT JOIN pg_depend dep ON (dep.classid = cls.tableoid AND dep.objid = cls.oid AND dep.refobjsubid = '0' AND dep.refclassid=(SELECT oid FROM pg_class WHERE relname='pg_constraint') AND dep.deptype='i')\n")
-	         wxT("  LEFT OUTER JOIN pg_constraint con ON (con.tableoid = dep.refclassid AND con.oid = dep.refobjid)\n")
-	         wxT("  LEFT OUTER JOIN pg_description des ON des.objoid=cls.oid\n")
-	         wxT("  LEFT OUTER JOIN pg_description desp ON (desp.objoid=con.oid AND desp.objsubid = 0)\n")
-	         wxT(" WHERE indrelid = ") + NumToStr(table->OIDTable) + wxT("::oid")
-	         + wxT(" AND contype='p' ")
-	         + wxT("\n")
-	         wxT(" ORDER BY cls.relname");
-	pgSet *indexes = connection->ExecuteSet(query);
-	if (indexes)
-	{
-		while (!indexes->Eof())
+		else
 		{
-			pkName = indexes->GetVal(wxT("idxname"));
-			indexes->MoveNext();
+			int ukIndex = table->UniqueKeysNames.Count();
+			table->UniqueKeysNames.Add(indexes->GetVal(wxT("idxname")));
+
+			wxStringTokenizer indkey(indexes->GetVal(wxT("indkey")));
+			while (indkey.HasMoreTokens())
+			{
+				//Get column number in unique key and mark the column as belonging to it
+				wxString str = indkey.GetNextToken();
+				ddStubColumn *column = table->getColumnByNumber(StrToLong(str));
+				if (column)
+					column->uniqueKeyIndex = ukIndex;
+			}
 		}
-		delete indexes;
+		indexes->MoveNext();
 	}
-
-	table->PrimaryKeyName = pkName;
-	return out;  //false in a future when detect a column in more than one unique key because this is not supported by database designer right now
+	delete indexes;
+	return true;
 }
 
 void ddImportDBUtils::getAllRelationships(pgConn *connection, stubTablesHashMap &tables, ddDatabaseDesign *design)
@@ -488,330 +457,335 @@ void ddImportDBUtils::getAllRelationships(pgConn *connection, stubTablesHashMap
 	ddTableFigure *sourceTabFigure = NULL;
 	ddTableFigure *destTabFigure = NULL;
 	//Add Tables to the Model
-	stubTablesHashMap::iterator mainIt;
 	ddStubTable *destStubTable = NULL;
+
+	//Fetch the foreign keys of all imported tables at once
+	stubTablesOidHashMap tablesByOid;
+	stubTablesHashMap::iterator mainIt;
 	for (mainIt = tables.begin(); mainIt != tables.end(); ++mainIt)
+		tablesByOid[mainIt->second->OIDTable] = mainIt->second;
+
+	if (tablesByOid.empty())
+		return;
+
+	sql = wxT("SELECT ct.oid, conname, condeferrable, condeferred, confupdtype, confdeltype, confmatchtype, ")
+	      wxT("conkey, confkey, conrelid, confrelid, nl.nspname as fknsp, cl.relname as fktab, ")
+	      wxT("nr.nspname as refnsp, cr.relname as reftab, description");
+	if (connection->BackendMinimumVersion(9, 1))
+		sql += wxT(", convalidated");
+	sql += wxT("\n  FROM pg_constraint ct\n")
+	       wxT("  JOIN pg_class cl ON cl.oid=conrelid\n")
+	       wxT("  JOIN pg_namespace nl ON nl.oid=cl.relnamespace\n")
+	       wxT("  JOIN pg_class cr ON cr.oid=confrelid\n")
+	       wxT("  JOIN pg_namespace nr ON nr.oid=cr.relnamespace\n")
+	       wxT("  LEFT OUTER JOIN pg_description des ON des.objoid=ct.oid\n")
+	       wxT(" WHERE contype='f' AND conrelid = ANY(") + oidArray(tablesByOid) + wxT(")")
+	       //+ restriction +
+	       + wxT("\n")
+	       wxT(" ORDER BY conrelid, conname");
+
+	pgSet *foreignKeys = connection->ExecuteSet(sql);
+
+	if (foreignKeys && foreignKeys->NumRows() > 0)
 	{
-		wxString key = mainIt->first;
-		destStubTable = mainIt->second;
-
-		sql = wxT("SELECT ct.oid, conname, condeferrable, condeferred, confupdtype, confdeltype, confmatchtype, ")
-		      wxT("conkey, confkey, confrelid, nl.nspname as fknsp, cl.relname as fktab, ")
-		      wxT("nr.nspname as refnsp, cr.relname as reftab, description");
-		if (connection->BackendMinimumVersion(9, 1))
-			sql += wxT(", convalidated");
-		sql += wxT("\n  FROM pg_constraint ct\n")
-		       wxT("  JOIN pg_class cl ON cl.oid=conrelid\n")
-		       wxT("  JOIN pg_namespace nl ON nl.oid=cl.relnamespace\n")
-		       wxT("  JOIN pg_class cr ON cr.oid=confrelid\n")
-		       wxT("  JOIN pg_namespace nr ON nr.oid=cr.relnamespace\n")
-		       wxT("  LEFT OUTER JOIN pg_description des ON des.objoid=ct.oid\n")
-		       wxT(" WHERE contype='f' AND conrelid = ") + NumToStr(destStubTable->OIDTable) + wxT("::oid")
-		       //+ restriction +
-		       + wxT("\n")
-		       wxT(" ORDER BY conname");
-
-		pgSet *foreignKeys = connection->ExecuteSet(sql);
-
-		if (foreignKeys && foreignKeys->NumRows() > 0)
+		while (!foreignKeys->Eof())
 		{
-			while (!foreignKeys->Eof())
+			destStubTable = tablesByOid[foreignKeys->GetOid(wxT("conrelid"))];
+
+			wxString sourceSchema, destSchema;
+			sourceSchema = foreignKeys->GetVal(wxT("refnsp"));
+			destSchema = foreignKeys->GetVal(wxT("fknsp"));
+
+			//  Source Table  ----------------------<| Destination Table
+
+			if(sourceSchema.IsSameAs(destSchema, false))
 			{
-				wxString sourceSchema, destSchema;
-				sourceSchema = foreignKeys->GetVal(wxT("refnsp"));
-				destSchema = foreignKeys->GetVal(wxT("fknsp"));
+				wxString sourceTableName = foreignKeys->GetVal(wxT("reftab"));
+				wxString destTableName = foreignKeys->GetVal(wxT("fktab"));
 
-				//  Source Table  ----------------------<| Destination Table
+				destTabFigure = design->getTable(destTableName);
+				sourceTabFigure = design->getTable(sourceTableName);
 
-				if(sourceSchema.IsSameAs(destSchema, false))
+				//Only if both tables were imported at same time
+				if(destTabFigure != NULL && sourceTabFigure != NULL)
 				{
-					wxString sourceTableName = foreignKeys->GetVal(wxT("reftab"));
-					wxString destTableName = foreignKeys->GetVal(wxT("fktab"));
-
-					destTabFigure = design->getTable(destTableName);
-					sourceTabFigure = design->getTable(sourceTableName);
 
-					//Only if both tables were imported at same time
-					if(destTabFigure != NULL && sourceTabFigure != NULL)
+					int ukindex = -1; //Only Supporting foreign keys from PK right now when importing model
+					wxString RelationshipName = foreignKeys->GetVal(wxT("conname"));
+
+					wxString onUpd = foreignKeys->GetVal(wxT("confupdtype"));
+					actionKind onUpdate = 	onUpd.IsSameAs('a') ? FK_ACTION_NO :
+					                        onUpd.IsSameAs('r') ? FK_RESTRICT :
+					                        onUpd.IsSameAs('c') ? FK_CASCADE :
+					                        onUpd.IsSameAs('d') ? FK_SETDEFAULT :
+					                        onUpd.IsSameAs('n') ? FK_SETNULL : FK_ACTION_NO;
+
+
+					wxString onDel = foreignKeys->GetVal(wxT("confdeltype"));
+					actionKind onDelete = 	onUpd.IsSameAs('a') ? FK_ACTION_NO :
+					                        onUpd.IsSameAs('r') ? FK_RESTRICT :
+					                        onUpd.IsSameAs('c') ? FK_CASCADE :
+					                        onUpd.IsSameAs('d') ? FK_SETDEFAULT :
+					                        onUpd.IsSameAs('n') ? FK_SETNULL : FK_ACTION_NO;
+
+					wxString match = foreignKeys->GetVal(wxT("confmatchtype"));
+					bool matchSimple = 	match.IsSameAs('f') ? false :
+					                    match.IsSameAs('u') ? true : false;
+
+
+					//------ Preparing metada to allow discovery of some relationship attributes
+					//Source table columns
+					wxString fkColsSourceTable = foreignKeys->GetVal(wxT("confkey"));
+					//remove {} of string
+					fkColsSourceTable.Remove(0, 1);
+					fkColsSourceTable.RemoveLast();
+					wxString fkColsDestTable = foreignKeys->GetVal(wxT("conkey"));
+					//remove {} of string
+					fkColsDestTable.Remove(0, 1);
+					fkColsDestTable.RemoveLast();
+
+					wxSortedArrayInt sourceFkCols(sortFunc);
+					wxSortedArrayInt destFkCols(sortFunc);
+					wxSortedArrayInt sourcePKs(sortFunc);
+					wxSortedArrayInt destPKs(sortFunc);
+
+					//Split columns from sourceFk
+					wxStringTokenizer confkey(fkColsSourceTable);
+					while (confkey.HasMoreTokens())
 					{
+						wxString str = confkey.GetNextToken();
+						sourceFkCols.Add(StrToLong(str));
+					}
 
-						int ukindex = -1; //Only Supporting foreign keys from PK right now when importing model
-						wxString RelationshipName = foreignKeys->GetVal(wxT("conname"));
-
-						wxString onUpd = foreignKeys->GetVal(wxT("confupdtype"));
-						actionKind onUpdate = 	onUpd.IsSameAs('a') ? FK_ACTION_NO :
-						                        onUpd.IsSameAs('r') ? FK_RESTRICT :
-						                        onUpd.IsSameAs('c') ? FK_CASCADE :
-						                        onUpd.IsSameAs('d') ? FK_SETDEFAULT :
-						                        onUpd.IsSameAs('n') ? FK_SETNULL : FK_ACTION_NO;
-
-
-						wxString onDel = foreignKeys->GetVal(wxT("confdeltype"));
-						actionKind onDelete = 	onUpd.IsSameAs('a') ? FK_ACTION_NO :
-						                        onUpd.IsSameAs('r') ? FK_RESTRICT :
-						                        onUpd.IsSameAs('c') ? FK_CASCADE :
-						                        onUpd.IsSameAs('d') ? FK_SETDEFAULT :
-						                        onUpd.IsSameAs('n') ? FK_SETNULL : FK_ACTION_NO;
-
-						wxString match = foreignKeys->GetVal(wxT("confmatchtype"));
-						bool matchSimple = 	match.IsSameAs('f') ? false :
-						                    match.IsSameAs('u') ? true : false;
-
-
-						//------ Preparing metada to allow discovery of some relationship attributes
-						//Source table columns
-						wxString fkColsSourceTable = foreignKeys->GetVal(wxT("confkey"));
-						//remove {} of string
-						fkColsSourceTable.Remove(0, 1);
-						fkColsSourceTable.RemoveLast();
-						wxString fkColsDestTable = foreignKeys->GetVal(wxT("conkey"));
-						//remove {} of string
-						fkColsDestTable.Remove(0, 1);
-						fkColsDestTable.RemoveLast();
-
-						wxSortedArrayInt sourceFkCols(sortFunc);
-						wxSortedArrayInt destFkCols(sortFunc);
-						wxSortedArrayInt sourcePKs(sortFunc);
-						wxSortedArrayInt destPKs(sortFunc);
-
-						//Split columns from sourceFk
-						wxStringTokenizer confkey(fkColsSourceTable);
-						while (confkey.HasMoreTokens())
-						{
-							wxString str = confkey.GetNextToken();
-							sourceFkCols.Add(StrToLong(str));
-						}
-
-						//Split columns from destFk
-						wxStringTokenizer conkey(fkColsDestTable);
-						while (conkey.HasMoreTokens())
-						{
-							wxString str = conkey.GetNextToken();
-							destFkCols.Add(StrToLong(str));
-						}
+					//Split columns from destFk
+					wxStringTokenizer conkey(fkColsDestTable);
+					while (conkey.HasMoreTokens())
+					{
+						wxString str = conkey.GetNextToken();
+						destFkCols.Add(StrToLong(str));
+					}
 
-						//Get Stub of source table
-						ddStubTable *sourceStubTable = tables[sourceTableName];
+					//Get Stub of source table
+					ddStubTable *sourceStubTable = tables[sourceTableName];
 
-						//Get PK columns of source
-						stubColsHashMap::iterator it;
-						ddStubColumn *column;
-						for (it = sourceStubTable->cols.begin(); it != sourceStubTable->cols.end(); ++it)
-						{
-							wxString key = it->first;
-							column = it->second;
-							if(column->isPrimaryKey)
-								sourcePKs.Add(column->pgColNumber);
-						}
+					//Get PK columns of source
+					stubColsHashMap::iterator it;
+					ddStubColumn *column;
+					for (it = sourceStubTable->cols.begin(); it != sourceStubTable->cols.end(); ++it)
+					{
+						wxString key = it->first;
+						column = it->second;
+						if(column->isPrimaryKey)
+							sourcePKs.Add(column->pgColNumber);
+					}
 
-						//Get PK columns of dest
-						for (it = destStubTable->cols.begin(); it != destStubTable->cols.end(); ++it)
-						{
-							wxString key = it->first;
-							column = it->second;
-							if(column->isPrimaryKey)
-								destPKs.Add(column->pgColNumber);
-						}
+					//Get PK columns of dest
+					for (it = destStubTable->cols.begin(); it != destStubTable->cols.end(); ++it)
+					{
+						wxString key = it->first;
+						column = it->second;
+						if(column->isPrimaryKey)
+							destPKs.Add(column->pgColNumber);
+					}
 
-						//  Source Table  ----------------------<| Destination Table
-						//Default assumption is the source of this fk is a Primary Key.
-						bool fkFromPk = true;
+					//  Source Table  ----------------------<| Destination Table
+					//Default assumption is the source of this fk is a Primary Key.
+					bool fkFromPk = true;
 
-						//first check: number of columns used as fk at Source is the same of the pk at Source
-						if(sourceFkCols.Count() == sourcePKs.Count())
+					//first check: number of columns used as fk at Source is the same of the pk at Source
+					if(sourceFkCols.Count() == sourcePKs.Count())
+					{
+						int i;
+						//Because postgres columns numbers are stored in an ordered array,
+						//their index should be the same at all positions
+						int srcFkCount = sourceFkCols.Count();
+						for(i = 0; i < srcFkCount; i++)
 						{
-							int i;
-							//Because postgres columns numbers are stored in an ordered array,
-							//their index should be the same at all positions
-							int srcFkCount = sourceFkCols.Count();
-							for(i = 0; i < srcFkCount; i++)
+							if( sourceFkCols[i] != sourcePKs[i] )
 							{
-								if( sourceFkCols[i] != sourcePKs[i] )
-								{
-									fkFromPk = false;
-									break;
-								}
+								fkFromPk = false;
+								break;
 							}
 						}
-						else
-						{
-							fkFromPk = true;
-						}
+					}
+					else
+					{
+						fkFromPk = true;
+					}
 
-						//------ Finding fk from uk or pk?
-						int ukIndex = -1;
-						//if fkFromPk = false then is fkfromUK?, check that
-						//all source fk columns should belong to one Uk at source table.
-						if( fkFromPk == false )
+					//------ Finding fk from uk or pk?
+					int ukIndex = -1;
+					//if fkFromPk = false then is fkfromUK?, check that
+					//all source fk columns should belong to one Uk at source table.
+					if( fkFromPk == false )
+					{
+						bool error = false;
+						int baseColNumber = sourceFkCols[sourceFkCols.Count() - 1];
+						int baseUkIdxSourceCol = sourceStubTable->getColumnByNumber(baseColNumber)->uniqueKeyIndex;
+						int nextColNumber, nextUkIdxSourceCol;
+						int countSrcFkCols = sourceFkCols.Count() - 2;
+						while(countSrcFkCols >= 0)
 						{
-							bool error = false;
-							int baseColNumber = sourceFkCols[sourceFkCols.Count() - 1];
-							int baseUkIdxSourceCol = sourceStubTable->getColumnByNumber(baseColNumber)->uniqueKeyIndex;
-							int nextColNumber, nextUkIdxSourceCol;
-							int countSrcFkCols = sourceFkCols.Count() - 2;
-							while(countSrcFkCols >= 0)
+							nextColNumber = sourceFkCols[countSrcFkCols];
+							nextUkIdxSourceCol = sourceStubTable->getColumnByNumber(nextColNumber)->uniqueKeyIndex;
+							countSrcFkCols--;
+							if(baseUkIdxSourceCol != baseUkIdxSourceCol)
 							{
-								nextColNumber = sourceFkCols[countSrcFkCols];
-								nextUkIdxSourceCol = sourceStubTable->getColumnByNumber(nextColNumber)->uniqueKeyIndex;
-								countSrcFkCols--;
-								if(baseUkIdxSourceCol != baseUkIdxSourceCol)
-								{
-									error = true;
-									wxMessageBox(_("Error detecting kind of foreign key source: from Pk or from Uk"), _("Error importing relationship"),  wxICON_ERROR | wxOK);
-									return;
-								}
-							}
-							if(!error)
-							{
-								ukIndex = baseUkIdxSourceCol;
+								error = true;
+								wxMessageBox(_("Error detecting kind of foreign key source: from Pk or from Uk"), _("Error importing relationship"),  wxICON_ERROR | wxOK);
+								return;
 							}
 						}
-
-						//Last check of consistency
-						if(fkFromPk == false && ukIndex < 0)
+						if(!error)
 						{
-							wxMessageBox(_("Error detecting kind of foreign key source: from Pk or from Uk"), _("Error importing relationship"),  wxICON_ERROR | wxOK);
-							return;
+							ukIndex = baseUkIdxSourceCol;
 						}
+					}
+
+					//Last check of consistency
+					if(fkFromPk == false && ukIndex < 0)
+					{
+						wxMessageBox(_("Error detecting kind of foreign key source: from Pk or from Uk"), _("Error importing relationship"),  wxICON_ERROR | wxOK);
+						return;
+					}
 
 
-						//------ identifying relationship or not  -----|-<|?
-						//Default assumption is relationship is identifying
-						bool identifying = true;
+					//------ identifying relationship or not  -----|-<|?
+					//Default assumption is relationship is identifying
+					bool identifying = true;
 
-						//first check: number of columns used as fk at Source is the same of the pk at Source
-						if(destFkCols.Count() == destPKs.Count())
+					//first check: number of columns used as fk at Source is the same of the pk at Source
+					if(destFkCols.Count() == destPKs.Count())
+					{
+						int i;
+						//Because postgres columns numbers are stored in an ordered array,
+						//their index should be the same at all positions
+						int destFkCount = destFkCols.Count();
+						for(i = 0; i < destFkCount; i++)
 						{
-							int i;
-							//Because postgres columns numbers are stored in an ordered array,
-							//their index should be the same at all positions
-							int destFkCount = destFkCols.Count();
-							for(i = 0; i < destFkCount; i++)
+							if( destFkCols[i] != destPKs[i] )
 							{
-								if( destFkCols[i] != destPKs[i] )
-								{
-									identifying = false;
-									break;
-								}
+								identifying = false;
+								break;
 							}
 						}
-						else
-						{
-							identifying = false;
-						}
+					}
+					else
+					{
+						identifying = false;
+					}
 
-						//------ 1:1 or 1:M  ?  as a fact 1:1 have a fk,uk at destination table.
-						// A foreign key have an one to many relationship when there is an UK for same column(s)
-						// inside the foreign key. Assumption, a column on belong to one Uk (no more than one).
-						bool oneToMany = true;
-						int baseColNumber = destFkCols[destFkCols.Count() - 1];
-						int baseUkIdxDestCol = destStubTable->getColumnByNumber(baseColNumber)->uniqueKeyIndex;
-						if(baseUkIdxDestCol != -1)
+					//------ 1:1 or 1:M  ?  as a fact 1:1 have a fk,uk at destination table.
+					// A foreign key have an one to many relationship when there is an UK for same column(s)
+					// inside the foreign key. Assumption, a column on belong to one Uk (no more than one).
+					bool oneToMany = true;
+					int baseColNumber = destFkCols[destFkCols.Count() - 1];
+					int baseUkIdxDestCol = destStubTable->getColumnByNumber(baseColNumber)->uniqueKeyIndex;
+					if(baseUkIdxDestCol != -1)
+					{
+						oneToMany = false;
+						int nextUkIdxDestCol, nextColNumber;
+						int countDestFkCols = destFkCols.Count() - 2;
+						while(countDestFkCols >= 0)
 						{
-							oneToMany = false;
-							int nextUkIdxDestCol, nextColNumber;
-							int countDestFkCols = destFkCols.Count() - 2;
-							while(countDestFkCols >= 0)
+							nextColNumber = destFkCols[countDestFkCols];
+							nextUkIdxDestCol = destStubTable->getColumnByNumber(nextColNumber)->uniqueKeyIndex;
+							countDestFkCols--;
+							//if a dest fk column is not in the same Uk index of first one
+							if(nextUkIdxDestCol != baseUkIdxDestCol)
 							{
-								nextColNumber = destFkCols[countDestFkCols];
-								nextUkIdxDestCol = destStubTable->getColumnByNumber(nextColNumber)->uniqueKeyIndex;
-								countDestFkCols--;
-								//if a dest fk column is not in the same Uk index of first one
-								if(nextUkIdxDestCol != baseUkIdxDestCol)
-								{
-									oneToMany = true;
-									break;
-								}
+								oneToMany = true;
+								break;
 							}
 						}
+					}
 
-						//Step two check all column of fk are inside a unique key (all and not more)
-						if(oneToMany == false)  //assumption is 1:1 relationship until now
+					//Step two check all column of fk are inside a unique key (all and not more)
+					if(oneToMany == false)  //assumption is 1:1 relationship until now
+					{
+						int numberColsInUk = 0, nextUkIdxDestCol, nextColNumber;
+						ddStubColumn *item;
+						for (it = destStubTable->cols.begin(); it != destStubTable->cols.end(); ++it)
 						{
-							int numberColsInUk = 0, nextUkIdxDestCol, nextColNumber;
-							ddStubColumn *item;
-							for (it = destStubTable->cols.begin(); it != destStubTable->cols.end(); ++it)
+							wxString key = it->first;
+							item = it->second;
+							//at each column with same uk index that base comparison column, count it
+							nextColNumber = item->pgColNumber;
+							nextUkIdxDestCol = destStubTable->getColumnByNumber(nextColNumber)->uniqueKeyIndex;
+							if( nextUkIdxDestCol == baseUkIdxDestCol)
 							{
-								wxString key = it->first;
-								item = it->second;
-								//at each column with same uk index that base comparison column, count it
-								nextColNumber = item->pgColNumber;
-								nextUkIdxDestCol = destStubTable->getColumnByNumber(nextColNumber)->uniqueKeyIndex;
-								if( nextUkIdxDestCol == baseUkIdxDestCol)
-								{
-									numberColsInUk++;
-								}
+								numberColsInUk++;
 							}
-
-							//number of columns in uk used by relationship is bigger or lesser than number of columns
-							//in destination table used by relationship as fk dest(dest fk columnn), then is not 1:1
-							if(numberColsInUk != destFkCols.Count())
-								oneToMany = true;
 						}
 
-						//Optional or Mandatory consistency
-						bool mandatoryRelationship;
+						//number of columns in uk used by relationship is bigger or lesser than number of columns
+						//in destination table used by relationship as fk dest(dest fk columnn), then is not 1:1
+						if(numberColsInUk != destFkCols.Count())
+							oneToMany = true;
+					}
 
-						int countDestFkCols = destFkCols.Count() - 1;
-						bool isNotNull;
-						int nnCols = 0, nullCols = 0, nextColNumber;
-						while(countDestFkCols >= 0)
-						{
-							nextColNumber = destFkCols[countDestFkCols];
-							isNotNull = destStubTable->getColumnByNumber(nextColNumber)->isNotNull;
-							countDestFkCols--;
-							if(isNotNull)
-								nnCols++;
-							else
-								nullCols++;
-						}
+					//Optional or Mandatory consistency
+					bool mandatoryRelationship;
 
-						if(nnCols == 0 && nullCols > 0)
-						{
-							mandatoryRelationship = false;
-						}
-						else if(nnCols > 0 && nullCols == 0)
-						{
-							mandatoryRelationship = true;
-						}
+					int countDestFkCols = destFkCols.Count() - 1;
+					bool isNotNull;
+					int nnCols = 0, nullCols = 0, nextColNumber;
+					while(countDestFkCols >= 0)
+					{
+						nextColNumber = destFkCols[countDestFkCols];
+						isNotNull = destStubTable->getColumnByNumber(nextColNumber)->isNotNull;
+						countDestFkCols--;
+						if(isNotNull)
+							nnCols++;
 						else
-						{
-							wxMessageBox(_("Error detecting kind of foreign key: null or not null"), _("Error importing relationship"),  wxICON_ERROR | wxOK);
-							return;
-						}
+							nullCols++;
+					}
 
-						relation = new ddRelationshipFigure();
-						relation->setStartTerminal(new ddRelationshipTerminal(relation, false));
-						relation->setEndTerminal(new ddRelationshipTerminal(relation, true));
-						relation->clearPoints(0);
-						relation->initRelationValues(sourceTabFigure, destTabFigure, ukIndex, RelationshipName, onUpdate, onDelete, matchSimple, identifying, oneToMany, mandatoryRelationship, fkFromPk);
-						relation->updateConnection(0);
-						design->addTableToModel(relation);
-
-						//Add items to relationship
-						wxString srcColName, destColName;
-						ddColumnFigure *sourceCol = NULL, *destinationCol = NULL;
-						bool autoGenFk = false;
-						wxString initialColName;
-						ddRelationshipItem *item = NULL;
-						int i, srcFkCount = sourceFkCols.Count();
-						for(i = 0; i < srcFkCount ; i++)
-						{
-							srcColName  =  sourceStubTable->getColumnByNumber(sourceFkCols[i])->columnName;
-							destColName =  destStubTable->getColumnByNumber(destFkCols[i])->columnName;
-							sourceCol = sourceTabFigure->getColByName(srcColName);
-							destinationCol = destTabFigure->getColByName(destColName);
-							initialColName = srcColName;
-							item = new ddRelationshipItem();
-							item->initRelationshipItemValues(relation, destTabFigure, autoGenFk, destinationCol, sourceCol, initialColName);
-							relation->getItemsHashMap()[item->original->getColumnName()] = item;
-						}
+					if(nnCols == 0 && nullCols > 0)
+					{
+						mandatoryRelationship = false;
+					}
+					else if(nnCols > 0 && nullCols == 0)
+					{
+						mandatoryRelationship = true;
+					}
+					else
+					{
+						wxMessageBox(_("Error detecting kind of foreign key: null or not null"), _("Error importing relationship"),  wxICON_ERROR | wxOK);
+						return;
+					}
+
+					relation = new ddRelationshipFigure();
+					relation->setStartTerminal(new ddRelationshipTerminal(relation, false));
+					relation->setEndTerminal(new ddRelationshipTerminal(relation, true));
+					relation->clearPoints(0);
+					relation->initRelationValues(sourceTabFigure, destTabFigure, ukIndex, RelationshipName, onUpdate, onDelete, matchSimple, identifying, oneToMany, mandatoryRelationship, fkFromPk);
+					relation->updateConnection(0);
+					design->addTableToModel(relation);
+
+					//Add items to relationship
+					wxString srcColName, destColName;
+					ddColumnFigure *sourceCol = NULL, *destinationCol = NULL;
+					bool autoGenFk = false;
+					wxString initialColName;
+					ddRelationshipItem *item = NULL;
+					int i, srcFkCount = sourceFkCols.Count();
+					for(i = 0; i < srcFkCount ; i++)
+					{
+						srcColName  =  sourceStubTable->getColumnByNumber(sourceFkCols[i])->columnName;
+						destColName =  destStubTable->getColumnByNumber(destFkCols[i])->columnName;
+						sourceCol = sourceTabFigure->getColByName(srcColName);
+						destinationCol = destTabFigure->getColByName(destColName);
+						initialColName = srcColName;
+						item = new ddRelationshipItem();
+						item->initRelationshipItemValues(relation, destTabFigure, autoGenFk, destinationCol, sourceCol, initialColName);
+						relation->getItemsHashMap()[item->original->getColumnName()] = item;
 					}
 				}
-				foreignKeys->MoveNext();
 			}
-			delete foreignKeys;
+			foreignKeys->MoveNext();
 		}
+		delete foreignKeys;
 	}
 }
 
@@ -1526,6 +1500,70 @@ bool ddStubColumn::isUniqueKey()
 	return uniqueKeyIndex > -1;
 };
 
+ddImportDBThread::ddImportDBThread(pgConn *connection, oidsHashMap &tableOids, wxWindow *_caller)
+	: wxThread(wxTHREAD_JOINABLE)
+{
+	conn = connection;
+	caller = _caller;
+	oids = tableOids;
+	// Inherited tables, the columns query, every table, the keys query
+	steps = oids.size() + 3;
+	currentStep = 0;
+	failed = false;
+}
+
+ddImportDBThread::~ddImportDBThread()
+{
+	delete conn;
+}
+
+void *ddImportDBThread::Entry()
+{
+	failed = !ddImportDBUtils::getTables(conn, oids, tables, inheritedTables, this);
+	return NULL;
+}
+
+// Strings handed to the GUI thread are copied, so the two threads never
+// share a reference count
+void ddImportDBThread::SetProgress(int step, const wxString &message)
+{
+	wxCriticalSectionLocker cs(criticalSection);
+	currentStep = step;
+	currentMessage = wxString(message.c_str());
+}
+
+void ddImportDBThread::AddError(const wxString &message)
+{
+	{
+		wxCriticalSectionLocker cs(criticalSection);
+		errors.Add(wxString(message.c_str()));
+	}
+
+	wxCommandEvent errorEvent(wxEVT_COMMAND_MENU_SELECTED, DDIMPORTERROR);
+#if wxCHECK_VERSION(2, 9, 0)
+	caller->GetEventHandler()->AddPendingEvent(errorEvent);
+#else
+	caller->AddPendingEvent(errorEvent);
+#endif
+}
+
+wxArrayString ddImportDBThread::GetErrors()
+{
+	wxCriticalSectionLocker cs(criticalSection);
+	wxArrayString result;
+	for (size_t i = 0 ; i < errors.GetCount() ; i++)
+		result.Add(wxString(errors.Item(i).c_str()));
+	errors.Empty();
+	return result;
+}
+
+int ddImportDBThread::GetProgress(wxString &message)
+{
+	wxCriticalSectionLocker cs(criticalSection);
+	message = wxString(currentMessage.c_str());
+	return currentStep;
+}
+
 //
 //
 //
@@ -1786,6 +1824,7 @@ SelTablesPage::SelTablesPage(wxWizard *parent, wxWizardPage *prev)
 	: wxWizardPage(parent)
 {
 	wparent = (ddDBReverseEngineering *) parent;
+	importThread = NULL;
 	m_prev = prev;
 	m_next = NULL;
 
@@ -1963,6 +2002,22 @@ void SelTablesPage::OnButtonRemoveAll(wxCommandEvent &)
 	}
 }
 
+void SelTablesPage::OnImportError(wxCommandEvent &)
+{
+	if (!importThread)
+		return;
+
+	ReportPage *report = (ReportPage *) m_next;
+	wxArrayString errors = importThread->GetErrors();
+	for (size_t i = 0 ; i < errors.GetCount() ; i++)
+	{
+		if (report)
+			report->results->AppendText(_("Error when reading the tables: ") + errors.Item(i) + wxT("\n"));
+		else
+			wxLogError(wxT("%s"), errors.Item(i).c_str());
+	}
+}
+
 void SelTablesPage::OnWizardPageChanging(wxWizardEvent &event)
 {
 	if(event.GetDirection() && m_selTables->GetCount() <= 0)
@@ -1973,44 +2028,91 @@ void SelTablesPage::OnWizardPageChanging(wxWizardEvent &event)
 	else if(event.GetDirection())
 	{
 
+		ReportPage *report = (ReportPage *) m_next;
+		oidsHashMap toImport;
+
 		int itemsCount = m_selTables->GetCount();
-		if( itemsCount > 0)
+		int item;
+		for (item = 0; item < itemsCount; item++)
 		{
-			int item = 0;
-			do
+			wxString tableName = m_selTables->GetString(item);
+			if(wparent->getDesign()->getTable(tableName) != NULL)
 			{
-				ddStubTable *table = ddImportDBUtils::getTable(wparent->getConnection(), m_selTables->GetString(item), wparent->tablesOIDHM[m_selTables->GetString(item)]);
-				if(table == NULL)
-				{
-					ReportPage *tmp = (ReportPage *) m_next;
-					tmp->results->AppendText(_("Error when preparing to import table: ") + m_selTables->GetString(item) + _(", this table have inherited columns and this feature is not supported at this moment.\n\n"));
-				}
-				else if(wparent->getDesign()->getTable(m_selTables->GetString(item)) != NULL)
-				{
-					ReportPage *tmp = (ReportPage *) m_next;
-					tmp->results->AppendText(_("Error when preparing to import table: ") + m_selTables->GetString(item) + _(", this table already exists in the model and updating table at a model is not supported at this moment.\n\n"));
-				}
-				else if(table->tableName.Length() > 0)
-				{
-					if(m_next)
-					{
-						ReportPage *tmp = (ReportPage *) m_next;
-						tmp->results->AppendText(_("Prepared to import table: ") + table->tableName + _("\n"));
-						wparent->stubsHM[table->tableName] = table;
-					}
-				}
-				else
+				if(report)
+					report->results->AppendText(_("Error when preparing to import table: ") + tableName + _(", this table already exists in the model and updating table at a model is not supported at this moment.\n\n"));
+			}
+			else
+				toImport[tableName] = wparent->tablesOIDHM[tableName];
+		}
+
+		if (toImport.empty())
+			return;
+
+		//Fetch the metadata of all selected tables in a worker thread, on a connection of its own
+		pgConn *importConn = wparent->getConnection()->Duplicate();
+		if (importConn->GetStatus() != PGCONN_OK)
+		{
+			wxLogError(_("Could not open a connection to read the tables:\n%s"), importConn->GetLastError().c_str());
+			delete importConn;
+			event.Veto();
+			return;
+		}
+
+		ddImportDBThread *thread = new ddImportDBThread(importConn, toImport, this);
+		if (thread->Create() != wxTHREAD_NO_ERROR)
+		{
+			delete thread;
+			event.Veto();
+			return;
+		}
+		importThread = thread;
+
+		wxProgressDialog progress(_("Import tables"), _("Reading tables metadata..."), thread->GetSteps(), this, wxPD_APP_MODAL | wxPD_SMOOTH | wxPD_ELAPSED_TIME);
+		thread->Run();
+		while (thread->IsRunning())
+		{
+			wxString message;
+			int step = thread->GetProgress(message);
+			if (step > 0)
+				progress.Update(step - 1, message);
+			wxMilliSleep(10);
+			wxTheApp->Yield(true);
+		}
+		thread->Wait();
+
+		//Errors still queued, so none is reported after the thread is gone
+		wxCommandEvent errorEvent;
+		OnImportError(errorEvent);
+		importThread = NULL;
+
+		for (item = 0; item < itemsCount; item++)
+		{
+			wxString tableName = m_selTables->GetString(item);
+			if (toImport.find(tableName) == toImport.end())
+				continue;
+
+			if(thread->tables.find(tableName) != thread->tables.end())
+			{
+				ddStubTable *table = thread->tables[tableName];
+				if(report)
 				{
-					if(m_next)
-					{
-						ReportPage *tmp = (ReportPage *) m_next;
-						tmp->results->AppendText(_("Error when preparing to import table: ") + m_selTables->GetString(item) + _("\n"));
-					}
+					report->results->AppendText(_("Prepared to import table: ") + table->tableName + _("\n"));
+					wparent->stubsHM[table->tableName] = table;
 				}
-				item++;
 			}
-			while(item < itemsCount);
+			else if(thread->inheritedTables.Index(tableName) != wxNOT_FOUND)
+			{
+				if(report)
+					report->results->AppendText(_("Error when preparing to import table: ") + tableName + _(", this table have inherited columns and this feature is not supported at this moment.\n\n"));
+			}
+			else
+			{
+				if(report)
+					report->results->AppendText(_("Error when preparing to import table: ") + tableName + _("\n"));
+			}
 		}
+
+		delete thread;
 	}
 	else if(!event.GetDirection())
 	{
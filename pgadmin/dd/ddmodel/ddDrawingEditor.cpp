@@ -65,6 +65,24 @@ hdDrawing *ddDrawingEditor::createDiagram(wxWindow *owner, bool fromXml)
 	return _tmpModel;
 }
 
+//Keep tables registry of design in sync with model
+void ddDrawingEditor::addModelFigure(hdIFigure *figure)
+{
+	hdDrawingEditor::addModelFigure(figure);
+	databaseDesign->registerTable(figure);
+}
+
+void ddDrawingEditor::deleteModelFigure(hdIFigure *figure)
+{
+	databaseDesign->invalidateTables();
+	hdDrawingEditor::deleteModelFigure(figure);
+}
+
+void ddDrawingEditor::deleteAllModelFigures()
+{
+	databaseDesign->invalidateTables();
+	hdDrawingEditor::deleteAllModelFigures();
+}
 
 void ddDrawingEditor::remOrDelSelFigures(int diagramIndex)
 {
@@ -297,4 +315,6 @@ void ddDrawingEditor::notifyChanged()
 	if(frm)
 		frm->setModelChanged(true);
 	modelChanged = true;
+	//a table could have been renamed
+	databaseDesign->invalidateTables();
 }
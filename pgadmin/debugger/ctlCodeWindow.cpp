@@ -16,10 +16,12 @@
 #include <wx/colour.h>
 #include <wx/tokenzr.h>
 #include <wx/progdlg.h>
+#include <wx/numdlg.h>
 
 // App headers
 #include "debugger/ctlCodeWindow.h"
 #include "debugger/ctlVarWindow.h"
+#include "debugger/ctlProfileWindow.h"
 #include "debugger/frmDebugger.h"
 #include "debugger/dlgDirectDbg.h"
 #include "debugger/dbgConst.h"
@@ -37,15 +39,18 @@
 //  the variable list, call stack, and breakpoint list. That way, the debugger
 //    doesn't bog down when you hit the 'step over' or 'step into' key repeatedly.
 //
-//    Lazy updating is a multi-step operation.  When the target pauses (which
-//  means that a call to pldbg_continue(), pldbg_step_over(), or pldbg_step_into()
-//    has just returned), we update the source code window and then set a flag
-//    (m_updateVars) that tells us to update the variable window during the next
-//    idle period.  As soon as OnIdle() is called, we update the variable window,
-//    turn off the m_updateVars flag, and turn on the next flag (m_updateStack)
-//  to force the stack window to update itself during the next idle period.
-//    After the stack window updates itself, it turns on m_updateBreakpoints() to
-//  force the breakpoint markers to refresh.
+//    The commands that leave the target paused (pldbg_continue(), pldbg_step_over(),
+//  pldbg_step_into(), ...) are sent together with the queries for the variable
+//  list, call stack, and breakpoint list (see waitForPause()), so a single round
+//  trip brings back everything shown at the pause. We update the source code
+//  window first and then show the rest of the state (see showState()).
+//
+//    When the state did not come with the pause (for example, after a variable
+//  was changed), lazy updating is a multi-step operation. A flag (m_updateVars)
+//  tells us to update the variable window during the next idle period, and
+//  OnIdle() asks for the variables, stack and breakpoints at once. If a part
+//  of the state is missing, the matching flag (m_updateStack or
+//  m_updateBreakpoints) is turned on to get it during the next idle period.
 //
 //    2) This class will issue a number of different queries to the proxy process.
 //    Each query executes (one at a time) in a separate thread so that the user
@@ -64,10 +69,12 @@ IMPLEMENT_CLASS(ctlCodeWindow,  pgFrame)
 BEGIN_EVENT_TABLE(ctlCodeWindow , pgFrame)
 	EVT_MENU(MENU_ID_TOGGLE_BREAK,            ctlCodeWindow::OnCommand)
 	EVT_MENU(MENU_ID_CLEAR_ALL_BREAK,         ctlCodeWindow::OnCommand)
+	EVT_MENU(MENU_ID_BREAK_CONDITION,         ctlCodeWindow::OnCommand)
 
 	EVT_MENU(MENU_ID_CONTINUE,                ctlCodeWindow::OnCommand)
 	EVT_MENU(MENU_ID_STEP_OVER,               ctlCodeWindow::OnCommand)
 	EVT_MENU(MENU_ID_STEP_INTO,               ctlCodeWindow::OnCommand)
+	EVT_MENU(MENU_ID_PROFILE,                 ctlCodeWindow::OnCommand)
 	EVT_MENU(MENU_ID_STOP,                    ctlCodeWindow::OnCommand)
 
 	EVT_IDLE(ctlCodeWindow::OnIdle)
@@ -94,6 +101,7 @@ BEGIN_EVENT_TABLE(ctlCodeWindow , pgFrame)
 	EVT_MENU(RESULT_ID_LAST_BREAKPOINT,       ctlCodeWindow::ResultLastBreakpoint)
 	EVT_MENU(RESULT_ID_LISTENER_CREATED,      ctlCodeWindow::ResultListenerCreated)
 	EVT_MENU(RESULT_ID_TARGET_READY,          ctlCodeWindow::ResultTargetReady)
+	EVT_MENU(RESULT_ID_PROFILE_STEP,          ctlCodeWindow::ResultProfileStep)
 
 	EVT_TIMER(wxID_ANY,                       ctlCodeWindow::OnTimer)
 END_EVENT_TABLE()
@@ -110,6 +118,7 @@ wxString ctlCodeWindow::m_commandGetSourceV1(wxT("SELECT %s AS pkg, %s AS func,
 wxString ctlCodeWindow::m_commandGetSourceV2(wxT("SELECT %s AS func, pldbg_get_source(%s,%s) AS source, targetName, args FROM pldbg_get_stack(%s) ORDER BY level LIMIT 1"));
 wxString ctlCodeWindow::m_commandStepOver(wxT("SELECT * FROM pldbg_step_over(%s)"));
 wxString ctlCodeWindow::m_commandStepInto(wxT("SELECT * FROM pldbg_step_into(%s)"));
+wxString ctlCodeWindow::m_commandProfileStep(wxT("SELECT *, pg_catalog.date_part('epoch', pg_catalog.clock_timestamp() - pg_catalog.statement_timestamp()) * 1000 AS elapsed FROM pldbg_step_into(%s)"));
 wxString ctlCodeWindow::m_commandContinue(wxT("SELECT * FROM pldbg_continue(%s)"));
 wxString ctlCodeWindow::m_commandSetBreakpointV1(wxT("SELECT * FROM pldbg_set_breakpoint(%s,%s,%s,%d)"));
 wxString ctlCodeWindow::m_commandSetBreakpointV2(wxT("SELECT * FROM pldbg_set_breakpoint(%s,%s,%d)"));
@@ -147,6 +156,12 @@ ctlCodeWindow::ctlCodeWindow( frmDebugger *parent, wxWindowID id, const dbgConnP
 	  m_updateVars(false),
 	  m_updateStack(false),
 	  m_updateBreakpoints(false),
+	  m_pendingState(NULL),
+	  m_profiling(false),
+	  m_profileStop(false),
+	  m_profileSteps(0),
+	  m_profileLine(0),
+	  m_focusLine(0),
 	  m_progressBar(NULL),
 	  m_timer(this)
 {
@@ -166,6 +181,19 @@ ctlCodeWindow::ctlCodeWindow( frmDebugger *parent, wxWindowID id, const dbgConnP
 	m_view->MarkerDefine( MARKER_CURRENT_BG, wxSTC_MARK_BACKGROUND, *wxGREEN, *wxGREEN );
 	m_view->MarkerDefine( MARKER_BREAKPOINT, wxSTC_MARK_CIRCLEPLUS, *wxRED, *wxRED );
 
+	// And the markers that show how hot each line was in the last profile run
+	wxColour heatColours[HEAT_LEVELS] =
+	{
+		wxColour( 255, 240, 170 ),
+		wxColour( 255, 210, 110 ),
+		wxColour( 255, 165, 70 ),
+		wxColour( 240, 105, 45 ),
+		wxColour( 210, 35, 35 )
+	};
+
+	for( int level = 0; level < HEAT_LEVELS; ++level )
+		m_view->MarkerDefine( MARKER_HEAT + level, wxSTC_MARK_ROUNDRECT, heatColours[level], heatColours[level] );
+
 	m_view->SetMarginWidth(1, 16);
 	m_view->SetMarginType(1, wxSTC_MARGIN_SYMBOL);
 
@@ -352,7 +380,7 @@ void ctlCodeWindow::resumeLocalDebugging()
 	if( m_targetAborted )
 	{
 		m_targetAborted = false;
-		m_dbgConn->startCommand( wxString::Format( m_commandWaitForBreakpoint, m_sessionHandle.c_str()), GetEventHandler(), RESULT_ID_BREAKPOINT );
+		waitForBreakpoint( wxString::Format( m_commandWaitForBreakpoint, m_sessionHandle.c_str()));
 	}
 }
 
@@ -385,6 +413,12 @@ void ctlCodeWindow::setTools(bool enable)
 	if( enable == false )
 		activateDebug = false;
 
+	// While profiling, the user can still stop the profile run (or the target)
+	bool activateProfile = activateDebug;
+
+	if( m_dbgConn != NULL && m_profiling )
+		activateProfile = true;
+
 	ctlMenuToolbar *t = m_parent->m_toolBar;
 	wxMenu *m = m_parent->m_debugMenu;
 
@@ -399,7 +433,7 @@ void ctlCodeWindow::setTools(bool enable)
 		t->EnableTool( MENU_ID_CONTINUE,        activateDebug );
 		t->EnableTool( MENU_ID_TOGGLE_BREAK,       activateDebug );
 		t->EnableTool( MENU_ID_CLEAR_ALL_BREAK, activateDebug );
-		t->EnableTool( MENU_ID_STOP,            activateDebug );
+		t->EnableTool( MENU_ID_STOP,            activateProfile );
 	}
 
 	if (m)
@@ -408,8 +442,11 @@ void ctlCodeWindow::setTools(bool enable)
 		m->Enable( MENU_ID_STEP_OVER,       activateDebug );
 		m->Enable( MENU_ID_CONTINUE,        activateDebug );
 		m->Enable( MENU_ID_TOGGLE_BREAK,       activateDebug );
+		m->Enable( MENU_ID_BREAK_CONDITION, activateDebug );
 		m->Enable( MENU_ID_CLEAR_ALL_BREAK, activateDebug );
-		m->Enable( MENU_ID_STOP,            activateDebug );
+		m->Enable( MENU_ID_PROFILE,         activateProfile );
+		m->Enable( MENU_ID_STOP,            activateProfile );
+		m->Check( MENU_ID_PROFILE,          m_profiling );
 	}
 
 	/* Activate hook */
@@ -434,7 +471,7 @@ void ctlCodeWindow::OnIdle( wxIdleEvent &event )
 	if( m_updateVars )
 	{
 		m_updateVars = false;
-		m_dbgConn->startCommand( wxString::Format( m_commandGetVars, m_sessionHandle.c_str()), GetEventHandler(), RESULT_ID_GET_VARS );
+		m_dbgConn->startCommand( getStateCommand(), GetEventHandler(), RESULT_ID_GET_VARS );
 		return;
 	}
 
@@ -474,7 +511,7 @@ void ctlCodeWindow::ResultPortAttach( wxCommandEvent &event )
 
 		m_sessionHandle = result.getString( 0 );
 
-		m_dbgConn->startCommand( wxString::Format( m_commandWaitForBreakpoint, m_sessionHandle.c_str()), GetEventHandler(), RESULT_ID_BREAKPOINT );
+		waitForBreakpoint( wxString::Format( m_commandWaitForBreakpoint, m_sessionHandle.c_str()));
 	}
 	else
 	{
@@ -497,9 +534,13 @@ void ctlCodeWindow::ResultPortAttach( wxCommandEvent &event )
 void ctlCodeWindow::ResultBreakpoint( wxCommandEvent &event )
 {
 	dbgResultset  result((PGresult *)event.GetClientData());
+	dbgPgResults *state = (dbgPgResults *)event.GetClientObject();
 
 	if( connectionLost( result ))
+	{
+		delete state;
 		closeConnection();
+	}
 	else
 	{
 		if( result.getCommandStatus() == PGRES_TUPLES_OK )
@@ -511,11 +552,12 @@ void ctlCodeWindow::ResultBreakpoint( wxCommandEvent &event )
 				m_focusPackageOid = wxT("0");
 
 			m_focusFuncOid    = result.getString(wxT("func"));
+			m_focusLine       = result.getLong(wxT("linenumber"));
 
 			// The result set contains one tuple:
 			//    packageOID, functionOID, linenumber
 			m_parent->getStatusBar()->SetStatusText(wxString::Format(_( "Paused at line %d"), atoi(result.getString(wxT("linenumber")).ToAscii()) - 1), 1);
-			updateUI(result);
+			updateUI(result, state);
 
 			/* break point markup line number */
 			unhilightCurrentLine();
@@ -535,6 +577,8 @@ void ctlCodeWindow::ResultBreakpoint( wxCommandEvent &event )
 		}
 		else if(result.getCommandStatus() == PGRES_FATAL_ERROR)
 		{
+			delete state;
+
 			if (!m_targetAborted)
 			{
 				// We were waiting for a breakpoint (because we just sent a step into, step over, or continue request) and
@@ -553,6 +597,8 @@ void ctlCodeWindow::ResultBreakpoint( wxCommandEvent &event )
 				}
 			}
 		}
+		else
+			delete state;
 	}
 }
 
@@ -576,45 +622,42 @@ void ctlCodeWindow::launchWaitingDialog()
 // ResultVarList()
 //
 //    This event handler is called when the proxy finishes sending us a list of
-//  variables (in response to an earlier call to pldbg_get_variables()).
-//
-//    We extract the variable names, types, and values from the result set and
-//    add them to the variable (and parameter) windows.
+//  variables (in response to an earlier call to pldbg_get_variables()). The
+//  stack and the breakpoint list are usually asked for in the same command
+//  (see getStateCommand()), and come with the variables.
 
 void ctlCodeWindow::ResultVarList( wxCommandEvent &event )
 {
 	dbgResultset  result((PGresult *)event.GetClientData());
+	dbgPgResults *state = (dbgPgResults *)event.GetClientObject();
 
 	if( connectionLost( result ))
 		closeConnection();
 	else
 	{
-		if( result.getCommandStatus() == PGRES_TUPLES_OK )
+		showVars( result );
+
+		if( state && state->GetCount() > 0 )
 		{
-			// The result set contains one tuple per variable
-			for( int row = 0; row < result.getRowCount(); ++row )
-			{
-				wxString    varName = result.getString( wxT( "name" ), row );
-				char        varClass = result.getString( wxT( "varclass" ), row )[0];
+			dbgResultset stack( state->Item( 0 ));
+			showStack( stack );
 
-				if( varClass == 'A' )
-				{
-					getParamWindow( true )->addVar( varName, result.getString( wxT( "value" ), row ), result.getString( wxT( "dtype" ), row ), result.getBool( wxT( "isconst" ), row ));
-				}
-				else if( varClass == 'P' )
-				{
-					getPkgVarWindow( true )->addVar( varName, result.getString( wxT( "value" ), row ), result.getString( wxT( "dtype" ), row ), result.getBool( wxT( "isconst" ), row ));
-				}
-				else
-				{
-					getVarWindow( true )->addVar( varName, result.getString( wxT( "value" ), row ), result.getString( wxT( "dtype" ), row ), result.getBool( wxT( "isconst" ), row ));
-				}
+			if( state->GetCount() > 1 )
+			{
+				dbgResultset breakpoints( state->Item( 1 ));
+				showBreakpoints( breakpoints );
 			}
+			else
+				m_updateBreakpoints = true;
+		}
+		else
+		{
+			// Update the next part of the user interface
+			m_updateStack = true;
 		}
-
-		// Update the next part of the user interface
-		m_updateStack = true;
 	}
+
+	delete state;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -622,10 +665,6 @@ void ctlCodeWindow::ResultVarList( wxCommandEvent &event )
 //
 //    This event handler is called when the proxy finishes sending us a stack
 //    trace (in response to an earlier call to pldbg_get_stack()).
-//
-//    We extract each frame from the result set and add it to the stack window.
-//    For each frame, the proxy sends us the function name, line number, and
-//  a string that holds the name and value of each argument.
 
 void ctlCodeWindow::ResultStack( wxCommandEvent &event )
 {
@@ -635,21 +674,7 @@ void ctlCodeWindow::ResultStack( wxCommandEvent &event )
 		closeConnection();
 	else
 	{
-		if( result.getCommandStatus() == PGRES_TUPLES_OK )
-		{
-			// The result set contains one tuple per frame:
-			//        package, function, linenumber, args
-
-			wxArrayString    stack;
-
-			for(int row = 0; row < result.getRowCount(); ++row)
-				stack.Add(wxString::Format(wxT( "%s(%s)@%s" ), result.getString(wxT("targetName"), row ).c_str(), result.getString(wxT("args"), row).c_str(), result.getString(wxT("linenumber"), row).c_str()));
-
-			getStackWindow()->clear();
-			getStackWindow()->setStack( stack );
-
-		}
-
+		showStack( result );
 		m_updateBreakpoints = true;
 	}
 }
@@ -659,9 +684,6 @@ void ctlCodeWindow::ResultStack( wxCommandEvent &event )
 //
 //    This event handler is called when the proxy finishes sending us a list of
 //  breakpoints (in response to an earlier SHOW BREAKPOINTS command).
-//
-//    We clear out the old breakpoint markers and then display a new marker
-//    for each breakpoint defined in the current function.
 
 void ctlCodeWindow::ResultBreakpoints(wxCommandEvent &event)
 {
@@ -670,22 +692,165 @@ void ctlCodeWindow::ResultBreakpoints(wxCommandEvent &event)
 	if( connectionLost(result))
 		closeConnection();
 	else
+		showBreakpoints( result );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// getStateCommand()
+//
+//    Returns the queries for the variable list, the call stack and the
+//  breakpoint list, in that order, as a single command.
+
+wxString ctlCodeWindow::getStateCommand()
+{
+	return( wxString::Format( m_commandGetVars, m_sessionHandle.c_str()) + wxT( ";\n" ) +
+	        wxString::Format( m_commandGetStack, m_sessionHandle.c_str()) + wxT( ";\n" ) +
+	        wxString::Format( m_commandGetBreakpoints, m_sessionHandle.c_str()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// waitForPause()
+//
+//    Sends a command that returns when the target pauses (a step, a continue,
+//  ...) followed by the state queries. The proxy runs them all as soon as the
+//  target pauses, and ResultBreakpoint() receives the whole state at once.
+
+void ctlCodeWindow::waitForPause( const wxString &command )
+{
+	m_dbgConn->startCommand( command + wxT( ";\n" ) + getStateCommand(), GetEventHandler(), RESULT_ID_BREAKPOINT );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// waitForBreakpoint()
+//
+//    Like waitForPause(), for a command that runs the target to the next
+//  breakpoint.  If the target reaches a breakpoint whose condition does not
+//  hold, the worker thread continues it without telling us (see
+//  dbgPgThread::breakConditionHolds()), so we only hear about the breakpoint
+//  where the target stays.
+
+void ctlCodeWindow::waitForBreakpoint( const wxString &command )
+{
+	m_dbgConn->startCommand( command + wxT( ";\n" ) + getStateCommand(),
+	                         wxString::Format( m_commandContinue, m_sessionHandle.c_str()) + wxT( ";\n" ) + getStateCommand(),
+	                         GetEventHandler(), RESULT_ID_BREAKPOINT );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// showState()
+//
+//    Shows the results of getStateCommand() received with a pause. Whatever is
+//  missing (because one of the queries failed) is asked for again during the
+//  next idle period.
+
+void ctlCodeWindow::showState( dbgPgResults *state )
+{
+	if( state->GetCount() < 1 )
 	{
-		if(result.getCommandStatus() == PGRES_TUPLES_OK)
-		{
-			clearBreakpointMarkers();
+		m_updateVars = true;
+		return;
+	}
+
+	dbgResultset vars( state->Item( 0 ));
+	showVars( vars );
+
+	if( state->GetCount() < 2 )
+	{
+		m_updateStack = true;
+		return;
+	}
+
+	dbgResultset stack( state->Item( 1 ));
+	showStack( stack );
+
+	if( state->GetCount() < 3 )
+	{
+		m_updateBreakpoints = true;
+		return;
+	}
+
+	dbgResultset breakpoints( state->Item( 2 ));
+	showBreakpoints( breakpoints );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// showVars()
+//
+//    We extract the variable names, types, and values from the result set and
+//    add them to the variable (and parameter) windows. Variables already shown
+//  are updated in place.
 
-			// The result set contains one tuple per breakpoint:
-			//        packageOID, functionOID, linenumber
+void ctlCodeWindow::showVars( dbgResultset &result )
+{
+	if( result.getCommandStatus() == PGRES_TUPLES_OK )
+	{
+		// The result set contains one tuple per variable
+		for( int row = 0; row < result.getRowCount(); ++row )
+		{
+			wxString    varName = result.getString( wxT( "name" ), row );
+			char        varClass = result.getString( wxT( "varclass" ), row )[0];
 
-			for(int row = 0; row < result.getRowCount(); ++row)
+			if( varClass == 'A' )
+			{
+				getParamWindow( true )->addVar( varName, result.getString( wxT( "value" ), row ), result.getString( wxT( "dtype" ), row ), result.getBool( wxT( "isconst" ), row ));
+			}
+			else if( varClass == 'P' )
+			{
+				getPkgVarWindow( true )->addVar( varName, result.getString( wxT( "value" ), row ), result.getString( wxT( "dtype" ), row ), result.getBool( wxT( "isconst" ), row ));
+			}
+			else
 			{
-				m_view->MarkerAdd(result.getLong(wxT("linenumber"), row) - 1, MARKER_BREAKPOINT);
+				getVarWindow( true )->addVar( varName, result.getString( wxT( "value" ), row ), result.getString( wxT( "dtype" ), row ), result.getBool( wxT( "isconst" ), row ));
 			}
 		}
 	}
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// showStack()
+//
+//    We extract each frame from the result set and add it to the stack window.
+//    For each frame, the proxy sends us the function name, line number, and
+//  a string that holds the name and value of each argument.
+
+void ctlCodeWindow::showStack( dbgResultset &result )
+{
+	if( result.getCommandStatus() == PGRES_TUPLES_OK )
+	{
+		// The result set contains one tuple per frame:
+		//        package, function, linenumber, args
+
+		wxArrayString    stack;
+
+		for(int row = 0; row < result.getRowCount(); ++row)
+			stack.Add(wxString::Format(wxT( "%s(%s)@%s" ), result.getString(wxT("targetName"), row ).c_str(), result.getString(wxT("args"), row).c_str(), result.getString(wxT("linenumber"), row).c_str()));
+
+		getStackWindow()->setStack( stack );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// showBreakpoints()
+//
+//    We clear out the old breakpoint markers and then display a new marker
+//    for each breakpoint defined in the current function.
+
+void ctlCodeWindow::showBreakpoints( dbgResultset &result )
+{
+	if(result.getCommandStatus() == PGRES_TUPLES_OK)
+	{
+		clearBreakpointMarkers();
+
+		// The result set contains one tuple per breakpoint:
+		//        packageOID, functionOID, linenumber
+
+		for(int row = 0; row < result.getRowCount(); ++row)
+		{
+			m_view->MarkerAdd(result.getLong(wxT("linenumber"), row) - 1, MARKER_BREAKPOINT);
+		}
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // ResultSource()
 //
@@ -890,6 +1055,15 @@ void ctlCodeWindow::closeConnection()
 		m_dbgConn->Close();
 	m_dbgConn = NULL;
 
+	if (m_profiling)
+		stopProfiling();
+
+	if (m_pendingState)
+	{
+		delete m_pendingState;
+		m_pendingState = NULL;
+	}
+
 	// Let the user know what happened
 	m_parent->getStatusBar()->SetStatusText( _( "Debugger connection terminated (session complete)" ), 1 );
 
@@ -950,7 +1124,7 @@ void ctlCodeWindow::updateSourceCode(dbgResultset &breakpoint)
 //  refresh completes, we schedule a variable refresh for the next idle period.
 //    When the variable refresh completes, it schedules a stack refresh...
 
-void ctlCodeWindow::updateUI(dbgResultset &breakpoint)
+void ctlCodeWindow::updateUI(dbgResultset &breakpoint, dbgPgResults *state)
 {
 	// Arrange for the lazy parts of our UI to be updated
 	// during the next IDLE time
@@ -958,6 +1132,11 @@ void ctlCodeWindow::updateUI(dbgResultset &breakpoint)
 	m_updateStack    = false;
 	m_updateBreakpoints = false;
 
+	// The state that came with the pause is shown once the source code is
+	if (m_pendingState)
+		delete m_pendingState;
+	m_pendingState = state;
+
 	updateSourceCode(breakpoint);
 }
 
@@ -1109,6 +1288,9 @@ void ctlCodeWindow::displaySource(const wxString &packageOID, const wxString &fu
 
 		m_view->Colourise(0, src.Length());
 		m_view->SetReadOnly(true);
+
+		// Replacing the text dropped the heat markers of the last profile run
+		showProfileHeat();
 	}
 
 	// Clear the current-line indicator
@@ -1138,8 +1320,16 @@ void ctlCodeWindow::displaySource(const wxString &packageOID, const wxString &fu
 	m_view->SetCurrentPos(m_view->PositionFromLine(current_line));
 	m_view->EnsureCaretVisible();
 
-	// Update the next lazy part of the user interface (the variable list)
-	m_updateVars = true;
+	// Show the variables, stack and breakpoints received with the pause, or
+	// update the next lazy part of the user interface (the variable list)
+	if (m_pendingState)
+	{
+		showState(m_pendingState);
+		delete m_pendingState;
+		m_pendingState = NULL;
+	}
+	else
+		m_updateVars = true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1175,6 +1365,14 @@ void ctlCodeWindow::OnCommand( wxCommandEvent &event )
 			break;
 		}
 
+		case MENU_ID_BREAK_CONDITION:
+		{
+			// The user wants to set the condition of the breakpoint at the
+			// line that contains the caret
+			editBreakCondition(getLineNo());
+			break;
+		}
+
 		case MENU_ID_CLEAR_ALL_BREAK:
 		{
 			// The user wants to clear all the breakpoint
@@ -1187,7 +1385,7 @@ void ctlCodeWindow::OnCommand( wxCommandEvent &event )
 			// The user wants to continue execution (as opposed to
 			// single-stepping through the code).  Unhilite all
 			// variables and tell the debugger server to continue.
-			m_dbgConn->startCommand( wxString::Format( m_commandContinue, m_sessionHandle.c_str()), GetEventHandler(), RESULT_ID_BREAKPOINT );
+			waitForBreakpoint( wxString::Format( m_commandContinue, m_sessionHandle.c_str()));
 			m_parent->getStatusBar()->SetStatusText( _( "Waiting for target (continue)..." ), 1 );
 			unhilightCurrentLine();
 			disableTools();
@@ -1199,7 +1397,7 @@ void ctlCodeWindow::OnCommand( wxCommandEvent &event )
 			// The user wants to step-over a function invocation (or
 			// just single-step). Unhilite all variables and tell the
 			// debugger server to step-over
-			m_dbgConn->startCommand( wxString::Format( m_commandStepOver, m_sessionHandle.c_str()), GetEventHandler(), RESULT_ID_BREAKPOINT );
+			waitForPause( wxString::Format( m_commandStepOver, m_sessionHandle.c_str()));
 			m_parent->getStatusBar()->SetStatusText( _( "Waiting for target (step over)..." ), 1 );
 			unhilightCurrentLine();
 			disableTools();
@@ -1211,15 +1409,34 @@ void ctlCodeWindow::OnCommand( wxCommandEvent &event )
 			// The user wants to step-into a function invocation (or
 			// just single-step). Unhilite all variables and tell the
 			// debugger server to step-into
-			m_dbgConn->startCommand( wxString::Format( m_commandStepInto, m_sessionHandle.c_str()), GetEventHandler(), RESULT_ID_BREAKPOINT );
+			waitForPause( wxString::Format( m_commandStepInto, m_sessionHandle.c_str()));
 			m_parent->getStatusBar()->SetStatusText( _( "Waiting for target (step into)..." ), 1 );
 			unhilightCurrentLine();
 			disableTools();
 			break;
 		}
 
+		case MENU_ID_PROFILE:
+		{
+			// The user wants to run the target to the end, counting and timing
+			// each line (or, if we are already doing that, to stop at the next
+			// line).
+			if( m_profiling )
+			{
+				m_profileStop = true;
+				m_parent->getStatusBar()->SetStatusText( _( "Stopping profile..." ), 1 );
+			}
+			else
+				startProfiling();
+
+			m_parent->m_debugMenu->Check( MENU_ID_PROFILE, m_profiling && !m_profileStop );
+			break;
+		}
+
 		case MENU_ID_STOP:
 		{
+			if( m_profiling )
+				m_profileStop = true;
 			stopDebugging();
 			if (!m_parent->m_standaloneDirectDbg)
 				closeConnection();
@@ -1273,10 +1490,44 @@ void ctlCodeWindow::clearBreakpoint( int lineNumber, bool requestUpdate )
 	else
 		m_dbgConn->startCommand(wxString::Format(m_commandClearBreakpointV2, m_sessionHandle.c_str(), m_displayedFuncOid.c_str(), lineNumber + 1), GetEventHandler(), RESULT_ID_NEW_BREAKPOINT);
 
+	m_dbgConn->setBreakCondition(m_displayedFuncOid, lineNumber + 1, wxEmptyString, 0);
+
 	if (requestUpdate)
 		m_updateBreakpoints = true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// editBreakCondition()
+//
+//    Asks the user for the condition and the hit count of the breakpoint at the
+//  given line (creating the breakpoint if there is none yet).  The condition is
+//  an SQL boolean expression that may refer to the variables of the function
+//  by name, for example "i > 100 AND name LIKE 'x%'".
+
+void ctlCodeWindow::editBreakCondition( int lineNumber )
+{
+	dbgBreakCondition condition;
+
+	m_dbgConn->getBreakCondition(m_displayedFuncOid, lineNumber + 1, condition);
+
+	wxTextEntryDialog dlg(this, _("Stop at this breakpoint only when the following SQL expression is true\n(leave it empty to stop whatever the values of the variables):"),
+	                      _("Breakpoint condition"), condition.m_expression);
+
+	if (dlg.ShowModal() != wxID_OK)
+		return;
+
+	long hitCount = wxGetNumberFromUser(_("Stop at this breakpoint only from the given hit on\n(0 or 1 to stop at every hit):"),
+	                                    _("Hit count"), _("Breakpoint condition"), condition.m_hitCount, 0, 1000000, this);
+
+	if (hitCount < 0)
+		return;
+
+	if (!isBreakpoint(lineNumber))
+		setBreakpoint(lineNumber);
+
+	m_dbgConn->setBreakCondition(m_displayedFuncOid, lineNumber + 1, dlg.GetValue().Strip(wxString::both), hitCount);
+}
+
 void ctlCodeWindow::clearAllBreakpoints()
 {
 	int    lineNo = 0;
@@ -1313,7 +1564,7 @@ void ctlCodeWindow::OnSelectFrame( wxCommandEvent &event )
 	if( event.GetSelection() != -1 )
 	{
 		if (!m_targetComplete && !m_targetAborted)
-			m_dbgConn->startCommand( wxString::Format( m_commandSelectFrame, m_sessionHandle.c_str(), event.GetSelection()), GetEventHandler(), RESULT_ID_BREAKPOINT );
+			waitForPause( wxString::Format( m_commandSelectFrame, m_sessionHandle.c_str(), event.GetSelection()));
 	}
 }
 
@@ -1407,7 +1658,7 @@ void ctlCodeWindow::ResultTargetReady(  wxCommandEvent &event )
 	else
 	{
 		setTools(true);
-		m_dbgConn->startCommand( wxString::Format( m_commandWaitForBreakpoint, m_sessionHandle.c_str()), GetEventHandler(), RESULT_ID_BREAKPOINT );
+		waitForBreakpoint( wxString::Format( m_commandWaitForBreakpoint, m_sessionHandle.c_str()));
 	}
 }
 
@@ -1549,6 +1800,196 @@ void ctlCodeWindow::OnTimer( wxTimerEvent &event )
 	}
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// startProfiling()
+//
+//    This function starts a profile run: we step into the target, one line at a
+//  time, until it completes (or the user stops the run).  At each pause, we
+//  count a hit for the line the target paused at, and charge the time the
+//  step took to the line the target was paused at before.  The time is taken
+//  by the proxy (see m_commandProfileStep), so the network round trip to the
+//  proxy does not add to it.
+//
+//    We don't update the source, variable and stack windows while profiling -
+//  that would slow down the target far more than the profiling itself.
+
+void ctlCodeWindow::startProfiling()
+{
+	if( m_profiling || m_targetComplete || m_targetAborted || m_dbgConn == NULL )
+		return;
+
+	ctlProfileWindow *profile = getProfileWindow( true );
+
+	profile->clear();
+	clearProfileHeat();
+
+	m_profiling      = true;
+	m_profileStop    = false;
+	m_profileSteps   = 0;
+	m_profileFuncOid = m_focusFuncOid;
+	m_profileLine    = m_focusLine;
+
+	profile->addHit( m_profileFuncOid, getFunctionName( m_profileFuncOid ), m_profileLine );
+
+	m_parent->getStatusBar()->SetStatusText( _( "Profiling..." ), 1 );
+	unhilightCurrentLine();
+	disableTools();
+
+	m_dbgConn->startCommand( wxString::Format( m_commandProfileStep, m_sessionHandle.c_str()), GetEventHandler(), RESULT_ID_PROFILE_STEP );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// stopProfiling()
+//
+//    This function ends the current profile run (if any), and displays its
+//  result: the list of lines in the profile window, and the heat markers next
+//  to the source code.  It is called when the target completes, when the user
+//  stops the run, and when the connection to the proxy is lost.
+
+void ctlCodeWindow::stopProfiling()
+{
+	if( !m_profiling )
+		return;
+
+	m_profiling   = false;
+	m_profileStop = false;
+
+	m_parent->m_debugMenu->Check( MENU_ID_PROFILE, false );
+
+	getProfileWindow( true )->refresh();
+	m_tabWindow->selectTab( ID_PROFILE_PAGE );
+
+	showProfileHeat();
+
+	m_parent->getStatusBar()->SetStatusText( wxString::Format( _( "Profile complete (%ld steps)" ), m_profileSteps ), 1 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ResultProfileStep()
+//
+//    This event handler is called when the proxy completes a step while we are
+//  profiling the target.  We record the figures for this step and send the
+//  next one, unless the user asked us to stop - then this pause is shown just
+//  like a breakpoint.
+//
+//    If the target completes while we are profiling, the step fails (or never
+//  returns, when the target runs in our own session - see
+//  dlgDirectDbg::OnTargetComplete()).
+
+void ctlCodeWindow::ResultProfileStep( wxCommandEvent &event )
+{
+	dbgResultset  result((PGresult *)event.GetClientData());
+
+	// The profile run ended before this step completed
+	if( !m_profiling )
+	{
+		ResultBreakpoint( event );
+		return;
+	}
+
+	if( connectionLost( result ))
+	{
+		closeConnection();
+		return;
+	}
+
+	if( result.getCommandStatus() != PGRES_TUPLES_OK )
+	{
+		stopProfiling();
+		ResultBreakpoint( event );
+		return;
+	}
+
+	ctlProfileWindow *profile = getProfileWindow( true );
+
+	profile->addTime( m_profileFuncOid, m_profileLine, StrToDouble( result.getString( wxT( "elapsed" ))));
+
+	m_profileFuncOid = result.getString( wxT( "func" ));
+	m_profileLine    = result.getLong( wxT( "linenumber" ));
+
+	wxString funcName = getFunctionName( m_profileFuncOid );
+
+	if( funcName == m_profileFuncOid && result.columnExists( wxT( "targetname" )))
+		funcName = result.getString( wxT( "targetname" ));
+
+	profile->addHit( m_profileFuncOid, funcName, m_profileLine );
+
+	if( ++m_profileSteps % 100 == 0 )
+		m_parent->getStatusBar()->SetStatusText( wxString::Format( _( "Profiling (%ld steps)..." ), m_profileSteps ), 1 );
+
+	if( m_profileStop )
+	{
+		stopProfiling();
+		ResultBreakpoint( event );
+	}
+	else
+		m_dbgConn->startCommand( wxString::Format( m_commandProfileStep, m_sessionHandle.c_str()), GetEventHandler(), RESULT_ID_PROFILE_STEP );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// getFunctionName()
+//
+//    Returns the signature of the given function if we have its source code in
+//  the cache, or its OID otherwise.
+
+wxString ctlCodeWindow::getFunctionName( const wxString &funcOID )
+{
+	sourceHash::iterator match = m_sourceCodeMap.find( funcOID );
+
+	if( match == m_sourceCodeMap.end() || match->second.getSignature().IsEmpty())
+		return( funcOID );
+	else
+		return( match->second.getSignature());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// showProfileHeat()
+//
+//    Adds a heat marker next to each line of the displayed function that the
+//  target paused at during the last profile run.  The hotter the marker, the
+//  closer the time spent running the line is to the time of the slowest line.
+
+void ctlCodeWindow::showProfileHeat()
+{
+	clearProfileHeat();
+
+	ctlProfileWindow *profile = getProfileWindow( false );
+
+	if( profile == NULL )
+		return;
+
+	const dbgProfileLineArray &lines = profile->getLines();
+	double maxTime = profile->getMaxTime();
+
+	for( size_t i = 0; i < lines.GetCount(); ++i )
+	{
+		const dbgProfileLine &line = lines.Item( i );
+
+		if( line.m_funcOid != m_displayedFuncOid || line.m_lineNumber < 1 )
+			continue;
+
+		int level = 0;
+
+		if( maxTime > 0.0 )
+			level = (int)( line.m_time * HEAT_LEVELS / maxTime );
+		if( level >= HEAT_LEVELS )
+			level = HEAT_LEVELS - 1;
+
+		m_view->MarkerAdd( line.m_lineNumber - 1, MARKER_HEAT + level );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// clearProfileHeat()
+//
+//    Removes the heat markers from the source code window.
+
+void ctlCodeWindow::clearProfileHeat()
+{
+	for( int level = 0; level < HEAT_LEVELS; ++level )
+		m_view->MarkerDeleteAll( MARKER_HEAT + level );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // wsCodeCache constructor
 //
@@ -0,0 +1,295 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// ctlProfileWindow.cpp - debugger
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "pgAdmin3.h"
+
+// wxWindows headers
+#include <wx/wx.h>
+
+// App headers
+#include "debugger/ctlProfileWindow.h"
+
+#include <wx/arrimpl.cpp>
+WX_DEFINE_OBJARRAY( dbgProfileLineArray );
+
+IMPLEMENT_CLASS( ctlProfileWindow, wxListView )
+
+BEGIN_EVENT_TABLE( ctlProfileWindow, wxListView )
+	EVT_LIST_COL_CLICK( wxID_ANY, ctlProfileWindow::OnColumnClick )
+END_EVENT_TABLE()
+
+enum
+{
+	COL_FUNCTION = 0,	// Function name
+	COL_LINE,			// Line number
+	COL_HITS,			// Number of hits
+	COL_TIME,			// Total time
+	COL_AVERAGE,		// Time per hit
+	COL_PERCENT			// Share of the total time
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// ctlProfileWindow constructor
+//
+//  Initialize the list control and clear it out....
+//
+
+ctlProfileWindow::ctlProfileWindow( wxWindow *parent, wxWindowID id )
+	: wxListView( parent, id, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_VIRTUAL | wxLC_SINGLE_SEL ),
+	  m_totalTime( 0.0 ),
+	  m_sortColumn( COL_TIME ),
+	  m_sortAscending( false )
+{
+	wxWindowBase::SetFont(settings->GetSystemFont());
+
+	InsertColumn( COL_FUNCTION, _( "Function" ), wxLIST_FORMAT_LEFT, 200 );
+	InsertColumn( COL_LINE, _( "Line" ), wxLIST_FORMAT_RIGHT, 50 );
+	InsertColumn( COL_HITS, _( "Hits" ), wxLIST_FORMAT_RIGHT, 70 );
+	InsertColumn( COL_TIME, _( "Time (ms)" ), wxLIST_FORMAT_RIGHT, 90 );
+	InsertColumn( COL_AVERAGE, _( "Average (ms)" ), wxLIST_FORMAT_RIGHT, 90 );
+	InsertColumn( COL_PERCENT, _( "% of total" ), wxLIST_FORMAT_RIGHT, 70 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// clear()
+//
+//    Forget the figures of the previous profile run
+//
+
+void ctlProfileWindow::clear()
+{
+	m_lines.Clear();
+	m_lineMap.clear();
+	m_order.Clear();
+	m_totalTime = 0.0;
+
+	SetItemCount( 0 );
+	Refresh();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// findLine()
+//
+//    Returns the figures for the given line, or NULL if the target never
+//  paused at that line
+//
+
+dbgProfileLine *ctlProfileWindow::findLine( const wxString &funcOid, int lineNumber )
+{
+	wsLineHash::iterator match = m_lineMap.find( wxString::Format( wxT( "%s:%d" ), funcOid.c_str(), lineNumber ));
+
+	if( match == m_lineMap.end())
+		return( NULL );
+	else
+		return( &m_lines.Item( match->second ));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// addHit()
+//
+//    Counts one more pause of the target at the given line.  The display is
+//  not updated until refresh() is called.
+//
+
+void ctlProfileWindow::addHit( const wxString &funcOid, const wxString &funcName, int lineNumber )
+{
+	dbgProfileLine *line = findLine( funcOid, lineNumber );
+
+	if( line == NULL )
+	{
+		dbgProfileLine newLine;
+
+		newLine.m_funcOid    = funcOid;
+		newLine.m_funcName   = funcName;
+		newLine.m_lineNumber = lineNumber;
+		newLine.m_hits       = 0;
+		newLine.m_time       = 0.0;
+
+		m_lineMap[wxString::Format( wxT( "%s:%d" ), funcOid.c_str(), lineNumber )] = m_lines.GetCount();
+		m_lines.Add( newLine );
+
+		line = &m_lines.Last();
+	}
+
+	line->m_hits++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// addTime()
+//
+//    Adds the time the target spent running the given line (that is, the time
+//  between the pause at that line and the next pause).
+//
+
+void ctlProfileWindow::addTime( const wxString &funcOid, int lineNumber, double time )
+{
+	dbgProfileLine *line = findLine( funcOid, lineNumber );
+
+	if( line != NULL && time > 0.0 )
+	{
+		line->m_time += time;
+		m_totalTime += time;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// getMaxTime()
+//
+//    Returns the time spent running the slowest line, used to scale the heat
+//  markers in the source window
+//
+
+double ctlProfileWindow::getMaxTime()
+{
+	double maxTime = 0.0;
+
+	for( size_t i = 0; i < m_lines.GetCount(); ++i )
+	{
+		if( m_lines.Item( i ).m_time > maxTime )
+			maxTime = m_lines.Item( i ).m_time;
+	}
+
+	return( maxTime );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// refresh()
+//
+//    Sorts the lines on the selected column and redisplays them
+//
+
+// Sort state for the comparison function; only used on the GUI thread.
+static dbgProfileLineArray *profileSortLines = NULL;
+static int profileSortColumn = COL_TIME;
+static bool profileSortAscending = false;
+
+static int wxCMPFUNC_CONV profileCompare( int *first, int *second )
+{
+	dbgProfileLine &a = profileSortLines->Item( *first );
+	dbgProfileLine &b = profileSortLines->Item( *second );
+	double va = 0.0, vb = 0.0;
+
+	switch( profileSortColumn )
+	{
+		case COL_FUNCTION:
+		{
+			int rc = a.m_funcName.CmpNoCase( b.m_funcName );
+			if( rc )
+				return( profileSortAscending ? rc : -rc );
+			va = a.m_lineNumber;
+			vb = b.m_lineNumber;
+			break;
+		}
+		case COL_LINE:
+			va = a.m_lineNumber;
+			vb = b.m_lineNumber;
+			break;
+		case COL_HITS:
+			va = a.m_hits;
+			vb = b.m_hits;
+			break;
+		case COL_TIME:
+		case COL_PERCENT:
+			va = a.m_time;
+			vb = b.m_time;
+			break;
+		case COL_AVERAGE:
+			va = a.m_time / a.m_hits;
+			vb = b.m_time / b.m_hits;
+			break;
+	}
+
+	if( va != vb )
+	{
+		int rc = va < vb ? -1 : 1;
+		return( profileSortAscending ? rc : -rc );
+	}
+
+	// Keep the order the lines were first seen in for equal values
+	return( *first - *second );
+}
+
+void ctlProfileWindow::refresh()
+{
+	m_order.Clear();
+	m_order.Alloc( m_lines.GetCount());
+
+	for( size_t i = 0; i < m_lines.GetCount(); ++i )
+		m_order.Add( i );
+
+	profileSortLines = &m_lines;
+	profileSortColumn = m_sortColumn;
+	profileSortAscending = m_sortAscending;
+
+	m_order.Sort( profileCompare );
+
+	SetItemCount( m_order.GetCount());
+	Refresh();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// OnColumnClick()
+//
+//    Sorts the list on the column the user clicked.  Clicking the same column
+//  again reverses the order.
+//
+
+void ctlProfileWindow::OnColumnClick( wxListEvent &event )
+{
+	int col = event.GetColumn();
+
+	if( col < 0 )
+		return;
+
+	if( col == m_sortColumn )
+		m_sortAscending = !m_sortAscending;
+	else
+	{
+		m_sortColumn = col;
+
+		// Names and line numbers sort ascending first, figures descending
+		m_sortAscending = ( col == COL_FUNCTION || col == COL_LINE );
+	}
+
+	refresh();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// OnGetItemText()
+//
+//    Returns the text of the given cell of the (virtual) list
+//
+
+wxString ctlProfileWindow::OnGetItemText( long item, long col ) const
+{
+	if( item < 0 || item >= (long)m_order.GetCount())
+		return( wxEmptyString );
+
+	const dbgProfileLine &line = m_lines.Item( m_order.Item( item ));
+
+	switch( col )
+	{
+		case COL_FUNCTION:
+			return( line.m_funcName );
+		case COL_LINE:
+			return( wxString::Format( wxT( "%d" ), line.m_lineNumber ));
+		case COL_HITS:
+			return( wxString::Format( wxT( "%ld" ), line.m_hits ));
+		case COL_TIME:
+			return( wxString::Format( wxT( "%.3f" ), line.m_time ));
+		case COL_AVERAGE:
+			return( wxString::Format( wxT( "%.3f" ), line.m_time / line.m_hits ));
+		case COL_PERCENT:
+			return( wxString::Format( wxT( "%.1f" ), m_totalTime > 0.0 ? line.m_time * 100.0 / m_totalTime : 0.0 ));
+	}
+
+	return( wxEmptyString );
+}
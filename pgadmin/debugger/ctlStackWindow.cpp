@@ -46,14 +46,24 @@ void ctlStackWindow::clear()
 ////////////////////////////////////////////////////////////////////////////////
 // setStack()
 //
-//    Add an array of stack frames to the display
+//    Replace the stack frames in the display with the given ones. Only the
+//  frames that changed are written, so the list doesn't flicker while
+//  stepping through a function.
 //
 
-
 void ctlStackWindow::setStack(const wxArrayString &stack )
 {
-	for(size_t i = 0; i < stack.GetCount(); ++i)
+	size_t i;
+
+	for(i = 0; i < stack.GetCount() && i < GetCount(); ++i)
 	{
-		Append(stack[i]);
+		if (GetString(i) != stack[i])
+			SetString(i, stack[i]);
 	}
+
+	for(; i < stack.GetCount(); ++i)
+		Append(stack[i]);
+
+	while(GetCount() > stack.GetCount())
+		Delete(GetCount() - 1);
 }
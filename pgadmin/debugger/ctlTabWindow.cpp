@@ -37,7 +37,8 @@ ctlTabWindow::ctlTabWindow( wxWindow *parent, wxWindowID id, const wxPoint &pos,
 	  m_pkgVarWindow( 0 ),
 	  m_stackWindow( 0 ),
 	  m_paramWindow( 0 ),
-	  m_messageWindow( 0 )
+	  m_messageWindow( 0 ),
+	  m_profileWindow( 0 )
 {
 	wxWindowBase::SetFont(settings->GetSystemFont());
 	m_tabMap   = new wsTabHash();
@@ -179,3 +180,24 @@ ctlStackWindow *ctlTabWindow::getStackWindow( )
 	return( m_stackWindow );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// getProfileWindow()
+//
+//    This function returns a pointer to our child profile window
+//  (m_profileWindow) and creates that window when we first need it.
+//
+
+ctlProfileWindow *ctlTabWindow::getProfileWindow( bool create )
+{
+	if(( m_profileWindow == NULL ) && create )
+	{
+		// We don't have a profile window yet - go ahead and create one
+
+		(*m_tabMap)[ID_PROFILE_PAGE] = GetPageCount();
+
+		m_profileWindow = new ctlProfileWindow( this, ID_PROFILE_PAGE );
+		AddPage( m_profileWindow, _( "Profile" ), true );
+	}
+
+	return( m_profileWindow );
+}
@@ -99,6 +99,7 @@ void ctlVarWindow::addVar( wxString name, wxString value, wxString type, bool re
 		newCell.m_row   = m_cells->size();
 		newCell.m_type  = type;
 		newCell.m_value = value;
+		newCell.m_changed = false;
 
 		AppendRows( 1 );
 
@@ -120,15 +121,25 @@ void ctlVarWindow::addVar( wxString name, wxString value, wxString type, bool re
 	{
 		// This variable is already in the grid, update the value
 		// and hilite it so the user knows that it has changed.
+		// Cells that stay the same are left alone, to avoid
+		// repainting the whole grid after each step.
+
+		bool changed = !GetCellValue( cell->second.m_row, COL_VALUE ).IsSameAs( value );
 
 		cell->second.m_value = value;
 
-		if( GetCellValue( cell->second.m_row, COL_VALUE ).IsSameAs( value ))
-			SetCellTextColour( cell->second.m_row, COL_VALUE, *wxBLACK );
-		else
+		if( changed )
+		{
 			SetCellTextColour( cell->second.m_row, COL_VALUE, *wxRED );
+			SetCellValue( cell->second.m_row, COL_VALUE, value );
+		}
+		else if( cell->second.m_changed )
+		{
+			SetCellTextColour( cell->second.m_row, COL_VALUE, *wxBLACK );
+			SetCellValue( cell->second.m_row, COL_VALUE, value );
+		}
 
-		SetCellValue( cell->second.m_row, COL_VALUE, value );
+		cell->second.m_changed = changed;
 
 		// FIXME: why is this part conditional?
 		// FIXME: why do we need this code? can the type ever change?
@@ -13,9 +13,11 @@
 
 // wxWindows headers
 #include <wx/wx.h>
+#include <wx/stopwatch.h>
 
 // App headers
 #include "debugger/dbgPgConn.h"
+#include "db/pgQueryStats.h"
 #include "utils/sysLogger.h"
 
 #include <stdexcept>
@@ -336,11 +338,48 @@ void dbgPgConn::startCommand( const wxString &command, wxEvtHandler *caller, wxE
 	m_workerThread->startCommand(command, caller, eventType, params);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// startCommand()
+//
+//     Same as above, for a command that leaves the target paused at a
+//    breakpoint.  If the condition of that breakpoint does not hold, the worker
+//    thread runs resumeCommand (which has to pause the target again, the same
+//    way) instead of reporting the pause, until one does.
+
+void dbgPgConn::startCommand( const wxString &command, const wxString &resumeCommand, wxEvtHandler *caller, wxEventType eventType )
+{
+	wxLogSql(wxT("%s"), command.c_str());
+
+	m_workerThread->startCommand(command, caller, eventType, NULL, resumeCommand);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// setBreakCondition()
+//
+//     Sets the condition and the hit count of the breakpoint at the given line.
+//    The worker thread keeps them, as it is the one that evaluates them.
+
+void dbgPgConn::setBreakCondition( const wxString &funcOid, int lineNumber, const wxString &expression, long hitCount )
+{
+	if (m_workerThread)
+		m_workerThread->setBreakCondition(funcOid, lineNumber, expression, hitCount);
+}
+
+bool dbgPgConn::getBreakCondition( const wxString &funcOid, int lineNumber, dbgBreakCondition &condition )
+{
+	if (m_workerThread)
+		return m_workerThread->getBreakCondition(funcOid, lineNumber, condition);
+
+	return false;
+}
+
 PGresult *dbgPgConn::waitForCommand( const wxString &command )
 {
 	wxLogSql(wxT("%s"), command.c_str());
 
+	wxStopWatch sw;
 	PGresult *result = PQexec( m_pgConn, command.mb_str( wxConvUTF8 ));
+	pgQueryStats::Record(PGCONN_SUB_DEBUGGER, command, sw.Time(), result);
 
 	return( result );
 }
@@ -15,6 +15,7 @@
 #include <wx/wx.h>
 #include <wx/app.h>
 #include <wx/tokenzr.h>
+#include <wx/stopwatch.h>
 #include <wx/listimpl.cpp>
 
 // App headers
@@ -22,11 +23,18 @@
 #include "debugger/dbgDbResult.h"
 #include "debugger/frmDebugger.h"
 #include "debugger/dbgPgConn.h"
+#include "db/pgQueryStats.h"
 
 #include <libpq-fe.h>
 
 WX_DEFINE_LIST( ThreadCommandList );
 
+dbgPgResults::~dbgPgResults()
+{
+	for( size_t i = 0; i < m_results.GetCount(); ++i )
+		PQclear( Item( i ));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // dbgPgThread constructor
 //
@@ -55,7 +63,7 @@ dbgPgThread::dbgPgThread( dbgPgConn &owner )
 //     separate thread to interact with the PostgreSQL server. This function
 //  wakes up the worker thread.
 
-void dbgPgThread::startCommand( const wxString &command, wxEvtHandler *caller, wxEventType eventType, dbgPgParams *params )
+void dbgPgThread::startCommand( const wxString &command, wxEvtHandler *caller, wxEventType eventType, dbgPgParams *params, const wxString &resumeCommand )
 {
 	// Save the command text (and the event handler that we should
 	// notify on completion) in the command queue and then wake up the
@@ -63,7 +71,7 @@ void dbgPgThread::startCommand( const wxString &command, wxEvtHandler *caller, w
 	// m_queueCounter
 
 	m_queueMutex.Lock();
-	m_commandQueue.Append( new dbgPgThreadCommand( command, caller, eventType, params ));
+	m_commandQueue.Append( new dbgPgThreadCommand( command, caller, eventType, params, resumeCommand ));
 
 	wxLogInfo( wxT( "Queueing: %s" ), command.c_str());
 
@@ -115,6 +123,8 @@ void *dbgPgThread::Entry( void )
 		// This call to PQexec() will hang until we've received
 		// a complete result set from the server.
 		PGresult *result = 0;
+		dbgPgResults *results = 0;
+		wxStopWatch sw;
 
 #if defined (__WXMSW__) || (EDB_LIBPQ)
 		// If we have a set of params, and we have the required functions...
@@ -204,49 +214,33 @@ void *dbgPgThread::Entry( void )
 #endif
 			// This is the normal case for a pl/pgsql function, or if we don't
 			// have access to PQgetOutResult.
-			// Note that this is all async code as far as libpq is concerned to
-			// ensure we can always bail out when required, without leaving threads
-			// hanging around.
-			int ret = PQsendQuery(m_owner.getConnection(), command.mb_str(wxConvUTF8));
-
-			if (ret != 1)
-			{
-				wxLogError(_( "Couldn't execute the query (%s): %s" ), command.c_str(), wxString(PQerrorMessage(m_owner.getConnection()), *conv).c_str());
+			if (!execute(command, &result, &results))
 				return this;
-			}
 
-			PGresult *part;
-			while(true)
+			// If the target paused at a breakpoint whose condition does not
+			// hold, resume it right away - the user interface only hears about
+			// the pause where the target finally stays.
+			while (result && !m_currentCommand->getResumeCommand().IsEmpty() && !breakConditionHolds(result, results))
 			{
-				if (die || TestDestroy())
-				{
-					PQrequestCancel(m_owner.getConnection());
-					return this;
-				}
-
-				PQconsumeInput(m_owner.getConnection());
+				PQclear(result);
+				result = 0;
 
-				if (PQisBusy(m_owner.getConnection()))
+				if (results)
 				{
-					Yield();
-					wxMilliSleep(10);
-					continue;
+					delete results;
+					results = 0;
 				}
 
-				// In theory we should only get one result here, but we'll loop
-				// anyway until we get the last one.
-				part = PQgetResult(m_owner.getConnection());
-
-				if (!part)
-					break;
-
-				result = part;
+				if (!execute(m_currentCommand->getResumeCommand(), &result, &results))
+					return this;
 			}
 
 #if defined (__WXMSW__) || (EDB_LIBPQ)
 		}
 #endif
 
+		pgQueryStats::Record(PGCONN_SUB_DEBUGGER, command, sw.Time(), result);
+
 		if(!result)
 		{
 			wxLogInfo(wxT( "NULL PGresult - user abort?" ));
@@ -261,12 +255,14 @@ void *dbgPgThread::Entry( void )
 		{
 			wxCommandEvent resultEvent( wxEVT_COMMAND_MENU_SELECTED, RESULT_ID_DIRECT_TARGET_COMPLETE );
 			resultEvent.SetClientData( result );
+			resultEvent.SetClientObject( results );
 			m_currentCommand->getCaller()->AddPendingEvent( resultEvent );
 		}
 		else
 		{
 			wxCommandEvent resultEvent( wxEVT_COMMAND_MENU_SELECTED, m_currentCommand->getEventType());
 			resultEvent.SetClientData( result );
+			resultEvent.SetClientObject( results );
 			m_currentCommand->getCaller()->AddPendingEvent( resultEvent );
 		}
 	}
@@ -343,6 +339,264 @@ void dbgPgThread::noticeHandler( void *arg, const char *message )
 	}
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// execute()
+//
+//    Sends a command to the server and waits for its results.  The result of
+//  the first statement is stored in *result, and the results of the following
+//  statements (if any) are added to *results.  Returns false if the command
+//  could not be sent, or if we were told to die in the meantime.
+//
+//    Note that this is all async code as far as libpq is concerned to ensure we
+//  can always bail out when required, without leaving threads hanging around.
+
+bool dbgPgThread::execute( const wxString &command, PGresult **result, dbgPgResults **results )
+{
+	int ret = PQsendQuery(m_owner.getConnection(), command.mb_str(wxConvUTF8));
+
+	if (ret != 1)
+	{
+		wxLogError(_( "Couldn't execute the query (%s): %s" ), command.c_str(), wxString(PQerrorMessage(m_owner.getConnection()), *conv).c_str());
+		return false;
+	}
+
+	PGresult *part;
+	while(true)
+	{
+		if (die || TestDestroy())
+		{
+			PQrequestCancel(m_owner.getConnection());
+			return false;
+		}
+
+		PQconsumeInput(m_owner.getConnection());
+
+		if (PQisBusy(m_owner.getConnection()))
+		{
+			Yield();
+			wxMilliSleep(10);
+			continue;
+		}
+
+		// There is one result for each statement of the command. The
+		// first one is reported as usual, and the following ones are
+		// handed over with it.
+		part = PQgetResult(m_owner.getConnection());
+
+		if (!part)
+			break;
+
+		if (!*result)
+			*result = part;
+		else
+		{
+			if (!*results)
+				*results = new dbgPgResults;
+			(*results)->Add(part);
+		}
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// setBreakCondition()
+//
+//    Called by the GUI thread to attach a condition to the breakpoint at the
+//  given line (or to remove it, if expression is empty and hitCount is 0).
+//  Setting a condition restarts its hit count.
+
+void dbgPgThread::setBreakCondition( const wxString &funcOid, int lineNumber, const wxString &expression, long hitCount )
+{
+	wxString key = wxString::Format( wxT( "%s:%d" ), funcOid.c_str(), lineNumber );
+
+	wxMutexLocker locker( m_conditionMutex );
+
+	if( expression.IsEmpty() && hitCount <= 1 )
+		m_conditions.erase( key );
+	else
+	{
+		// wxString may share its buffer between copies, so the worker
+		// thread only gets strings nobody else refers to
+		m_conditions[key] = dbgBreakCondition( wxString( expression.c_str()), hitCount );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// getBreakCondition()
+//
+//    Called by the GUI thread to read the condition (and the hit count so far)
+//  of the breakpoint at the given line.  Returns false if it has none.
+
+bool dbgPgThread::getBreakCondition( const wxString &funcOid, int lineNumber, dbgBreakCondition &condition )
+{
+	wxMutexLocker locker( m_conditionMutex );
+
+	dbgBreakConditionHash::iterator match = m_conditions.find( wxString::Format( wxT( "%s:%d" ), funcOid.c_str(), lineNumber ));
+
+	if( match == m_conditions.end())
+		return( false );
+
+	condition = dbgBreakCondition( wxString( match->second.m_expression.c_str()), match->second.m_hitCount );
+	condition.m_hits = match->second.m_hits;
+
+	return( true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// breakConditionHolds()
+//
+//    Given the result of a command that leaves the target paused (and the
+//  results of the state queries sent with it, the variable list first), this
+//  function counts a hit for the breakpoint at that line and returns true if
+//  the target should stay paused there.  Pauses that are not at a breakpoint
+//  with a condition always stay.
+
+bool dbgPgThread::breakConditionHolds( PGresult *pause, dbgPgResults *state )
+{
+	if( PQresultStatus( pause ) != PGRES_TUPLES_OK || PQntuples( pause ) != 1 )
+		return( true );
+
+	int funcColumn = PQfnumber( pause, "func" );
+	int lineColumn = PQfnumber( pause, "linenumber" );
+
+	if( funcColumn < 0 || lineColumn < 0 )
+		return( true );
+
+	wxString key = wxString( PQgetvalue( pause, 0, funcColumn ), wxConvUTF8 ) + wxT( ":" ) + wxString( PQgetvalue( pause, 0, lineColumn ), wxConvUTF8 );
+	wxString expression;
+
+	{
+		wxMutexLocker locker( m_conditionMutex );
+
+		dbgBreakConditionHash::iterator match = m_conditions.find( key );
+
+		if( match == m_conditions.end())
+			return( true );
+
+		if( ++match->second.m_hits < match->second.m_hitCount )
+			return( false );
+
+		expression = wxString( match->second.m_expression.c_str());
+	}
+
+	if( expression.IsEmpty())
+		return( true );
+
+	// We can't tell without the variables - let the user have a look
+	if( state == NULL || state->GetCount() < 1 )
+		return( true );
+
+	return( evaluateCondition( expression, state->Item( 0 )));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// evaluateCondition()
+//
+//    Evaluates a breakpoint condition, given the variable list of the target
+//  (name, varclass, value and dtype columns, as sent by pldbg_get_variables()).
+//  Each variable becomes a column (of its own type) of a one-row subquery, and
+//  the condition is evaluated against that row by the proxy's server.
+//
+//    If the condition can't be evaluated, the target stays paused and the
+//  error is shown in the DBMS messages window.
+
+bool dbgPgThread::evaluateCondition( const wxString &expression, PGresult *vars )
+{
+	if( PQresultStatus( vars ) != PGRES_TUPLES_OK )
+		return( true );
+
+	int nameColumn  = PQfnumber( vars, "name" );
+	int classColumn = PQfnumber( vars, "varclass" );
+	int valueColumn = PQfnumber( vars, "value" );
+	int typeColumn  = PQfnumber( vars, "dtype" );
+
+	if( nameColumn < 0 || valueColumn < 0 || typeColumn < 0 )
+		return( true );
+
+	PGconn *conn = m_owner.getConnection();
+	wxArrayString names;
+	wxString columns;
+
+	for( int row = 0; row < PQntuples( vars ); ++row )
+	{
+		// Package variables are not in scope by their plain names
+		if( classColumn >= 0 && PQgetvalue( vars, row, classColumn )[0] == 'P' )
+			continue;
+
+		wxString name = wxString( PQgetvalue( vars, row, nameColumn ), wxConvUTF8 );
+
+		// Only the first of several variables of the same name is visible
+		if( names.Index( name ) != wxNOT_FOUND )
+			continue;
+		names.Add( name );
+
+		wxString type = wxString( PQgetvalue( vars, row, typeColumn ), wxConvUTF8 );
+		wxString value;
+
+		if( PQgetisnull( vars, row, valueColumn ))
+			value = wxT( "NULL" );
+		else
+		{
+			const char *raw = PQgetvalue( vars, row, valueColumn );
+			size_t length = strlen( raw );
+			char *escaped = new char[length * 2 + 1];
+
+			PQescapeStringConn( conn, escaped, raw, length, NULL );
+			value = wxT( "'" ) + wxString( escaped, wxConvUTF8 ) + wxT( "'" );
+
+			delete [] escaped;
+		}
+
+		// Anonymous records can't be read back from their text form
+		if( type != wxT( "record" ))
+			value += wxT( "::" ) + type;
+
+		name.Replace( wxT( "\"" ), wxT( "\"\"" ));
+
+		if( !columns.IsEmpty())
+			columns += wxT( ", " );
+		columns += value + wxT( " AS \"" ) + name + wxT( "\"" );
+	}
+
+	wxString query = wxT( "SELECT (" ) + expression + wxT( ")::boolean" );
+
+	if( !columns.IsEmpty())
+		query += wxT( " FROM (SELECT " ) + columns + wxT( ") AS vars" );
+
+	PGresult *result = 0;
+	dbgPgResults *results = 0;
+
+	if( !execute( query, &result, &results ))
+		return( true );
+
+	bool holds = true;
+
+	if( PQresultStatus( result ) == PGRES_TUPLES_OK && PQntuples( result ) == 1 )
+		holds = ( PQgetvalue( result, 0, 0 )[0] == 't' );
+	else
+		postMessage( wxString::Format( _( "Could not evaluate the breakpoint condition %s: %s" ), expression.c_str(), wxString( PQresultErrorMessage( result ), wxConvUTF8 ).c_str()));
+
+	PQclear( result );
+	if( results )
+		delete results;
+
+	return( holds );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// postMessage()
+//
+//    Sends a message to the DBMS messages window of the caller.
+
+void dbgPgThread::postMessage( const wxString &message )
+{
+	wxCommandEvent buttonEvent( wxEVT_COMMAND_BUTTON_CLICKED, MENU_ID_NOTICE_RECEIVED );
+
+	buttonEvent.SetString( message + wxT( "\n" ));
+	m_currentCommand->getCaller()->AddPendingEvent( buttonEvent );
+}
+
 dbgPgThreadCommand *dbgPgThread::getNextCommand()
 {
 	dbgPgThreadCommand *result;
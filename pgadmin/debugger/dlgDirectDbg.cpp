@@ -20,6 +20,7 @@
 #include "debugger/frmDebugger.h"
 #include "debugger/dbgTargetInfo.h"
 #include "debugger/dbgPgConn.h"
+#include "debugger/dbgPgThread.h"
 #include "debugger/ctlResultGrid.h"
 #include "debugger/dbgResultset.h"
 #include "debugger/dbgConst.h"
@@ -792,6 +793,10 @@ void dlgDirectDbg::OnTargetComplete( wxCommandEvent &event )
 
 	PGresult    *result = (PGresult *)event.GetClientData();
 
+	// Only the first result is shown; the event owns the others, if the
+	// target returned more than one
+	delete (dbgPgResults *)event.GetClientObject();
+
 	wxLogInfo( wxT( "OnTargetComplete() called\n" ));
 	wxLogInfo( wxT( "%s\n" ), wxString(PQresStatus( PQresultStatus( result )), wxConvUTF8).c_str());
 
@@ -836,6 +841,9 @@ void dlgDirectDbg::OnTargetComplete( wxCommandEvent &event )
 
 	if (m_codeWindow)
 	{
+		// A profile run ends with the target (the last step only returns
+		// when the target is invoked again)
+		m_codeWindow->stopProfiling();
 		m_codeWindow->m_targetComplete = true;
 		m_codeWindow->disableTools( );
 	}
@@ -327,8 +327,10 @@ wxMenuBar *frmDebugger::setupMenuBar(void)
 	m_debugMenu->Append(MENU_ID_STEP_INTO,          _( "Step into\tCtrl+F11" ));
 	m_debugMenu->Append(MENU_ID_STEP_OVER,          _( "Step over\tCtrl+F10" ));
 	m_debugMenu->Append(MENU_ID_CONTINUE,           _( "Continue\tCtrl+F5" ));
+	m_debugMenu->AppendCheckItem(MENU_ID_PROFILE,   _( "Profile\tCtrl+F6" ), _( "Run the function to the end, counting and timing each line." ));
 	m_debugMenu->AppendSeparator();
 	m_debugMenu->Append(MENU_ID_TOGGLE_BREAK,       _( "Toggle breakpoint\tCtrl+F9" ));
+	m_debugMenu->Append(MENU_ID_BREAK_CONDITION,    _( "Breakpoint condition..." ), _( "Stop at the breakpoint on this line only when a condition holds, or after a number of hits." ));
 	m_debugMenu->Append(MENU_ID_CLEAR_ALL_BREAK,    _( "Clear all breakpoints\tCtrl+Shift+F9" ));
 	m_debugMenu->AppendSeparator();
 	m_debugMenu->Append(MENU_ID_STOP,               _( "Stop debugging\tCtrl+F8" ));
@@ -336,8 +338,10 @@ wxMenuBar *frmDebugger::setupMenuBar(void)
 	m_debugMenu->Append(MENU_ID_STEP_INTO,          _( "Step into\tF11" ));
 	m_debugMenu->Append(MENU_ID_STEP_OVER,          _( "Step over\tF10" ));
 	m_debugMenu->Append(MENU_ID_CONTINUE,           _( "Continue\tF5" ));
+	m_debugMenu->AppendCheckItem(MENU_ID_PROFILE,   _( "Profile\tF6" ), _( "Run the function to the end, counting and timing each line." ));
 	m_debugMenu->AppendSeparator();
 	m_debugMenu->Append(MENU_ID_TOGGLE_BREAK,       _( "Toggle breakpoint\tF9" ));
+	m_debugMenu->Append(MENU_ID_BREAK_CONDITION,    _( "Breakpoint condition..." ), _( "Stop at the breakpoint on this line only when a condition holds, or after a number of hits." ));
 	m_debugMenu->Append(MENU_ID_CLEAR_ALL_BREAK,    _( "Clear all breakpoints\tCtrl+Shift+F9" ));
 	m_debugMenu->AppendSeparator();
 	m_debugMenu->Append(MENU_ID_STOP,               _( "Stop debugging\tF8" ));
@@ -345,7 +349,9 @@ wxMenuBar *frmDebugger::setupMenuBar(void)
 	m_debugMenu->Enable(MENU_ID_STEP_INTO,   	    false);
 	m_debugMenu->Enable(MENU_ID_STEP_OVER,   	    false);
 	m_debugMenu->Enable(MENU_ID_CONTINUE,    	    false);
+	m_debugMenu->Enable(MENU_ID_PROFILE,    	    false);
 	m_debugMenu->Enable(MENU_ID_TOGGLE_BREAK,   	false);
+	m_debugMenu->Enable(MENU_ID_BREAK_CONDITION,    false);
 	m_debugMenu->Enable(MENU_ID_CLEAR_ALL_BREAK,    false);
 	m_debugMenu->Enable(MENU_ID_STOP,			    false);
 	m_menuBar->Append(m_debugMenu, _("&Debug"));
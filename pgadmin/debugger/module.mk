@@ -12,6 +12,7 @@
 pgadmin3_SOURCES += \
 	debugger/ctlCodeWindow.cpp \
 	debugger/ctlMessageWindow.cpp \
+	debugger/ctlProfileWindow.cpp \
 	debugger/ctlResultGrid.cpp \
 	debugger/ctlStackWindow.cpp \
 	debugger/ctlTabWindow.cpp \
@@ -58,6 +58,7 @@
 #include "schema/pgTrigger.h"
 #include "schema/pgGroup.h"
 #include "schema/pgUser.h"
+#include "db/pgConnPool.h"
 
 
 void dataType::SetOid(OID id)
@@ -955,6 +956,7 @@ bool dlgProperty::apply(const wxString &sql, const wxString &sql2)
 	{
 		myConn = database->GetServer()->GetConnection();
 		database->Disconnect();
+		database->GetServer()->GetConnPool()->Clear();
 	}
 
 	if (!sql.IsEmpty())
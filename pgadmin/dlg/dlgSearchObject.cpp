@@ -20,25 +20,42 @@
 #include "utils/sysSettings.h"
 #include "utils/misc.h"
 #include "ctl/ctlListView.h"
+#include "frm/menu.h"
+
+#include <wx/arrimpl.cpp>
+WX_DEFINE_OBJARRAY(searchObjectResultArray);
+
+// Number of rows fetched from the search cursor per round trip
+#define SEARCH_BATCH_SIZE    500
+
+// Completed searches kept to answer later ones, and for how many seconds
+#define SEARCH_MAX_INDEXES   10
+#define SEARCH_INDEX_SECONDS 60
 
 #define txtPattern        CTRL_TEXT("txtPattern")
 #define cbType          CTRL_COMBOBOX("cbType")
-#define lcResults         CTRL_LISTCTRL("lcResults")
 #define btnSearch             CTRL_BUTTON("btnSearch")
 
 BEGIN_EVENT_TABLE(dlgSearchObject, pgDialog)
 	EVT_BUTTON(wxID_HELP,                      dlgSearchObject::OnHelp)
 	EVT_BUTTON(XRCID("btnSearch"),			   dlgSearchObject::OnSearch)
 	EVT_BUTTON(wxID_CANCEL,                    dlgSearchObject::OnCancel)
+	EVT_CLOSE(                                 dlgSearchObject::OnClose)
 	EVT_TEXT(XRCID("txtPattern"),              dlgSearchObject::OnChange)
 	EVT_LIST_ITEM_SELECTED(XRCID("lcResults"), dlgSearchObject::OnSelSearchResult)
+	EVT_MENU(SEARCHOBJECT_BATCH,               dlgSearchObject::OnSearchBatch)
+	EVT_MENU(SEARCHOBJECT_COMPLETE,            dlgSearchObject::OnSearchComplete)
 END_EVENT_TABLE()
 
 dlgSearchObject::dlgSearchObject(frmMain *p, pgDatabase *db)
 {
 	parent = p;
-	header = wxT("");
 	currentdb = db;
+	searchConn = 0;
+	thread = 0;
+	currentIndex = 0;
+	searchGeneration = 0;
+	columnsSized = false;
 
 	wxWindowBase::SetFont(settings->GetSystemFont());
 	LoadResource(p, wxT("dlgSearchObject"));
@@ -49,6 +66,9 @@ dlgSearchObject::dlgSearchObject(frmMain *p, pgDatabase *db)
 
 	btnSearch->Disable();
 
+	lcResults = new searchObjectResultList(this, &results);
+	wxXmlResource::Get()->AttachUnknownControl(wxT("lcResults"), lcResults);
+
 	lcResults->InsertColumn(0, _("Type"));
 	lcResults->InsertColumn(1, _("Name"));
 	lcResults->InsertColumn(2, _("Path"));
@@ -137,12 +157,31 @@ dlgSearchObject::dlgSearchObject(frmMain *p, pgDatabase *db)
 	}
 	cbType->SetSelection(0);
 
+	// Everything the worker thread needs from the locale and the settings
+	// is looked up once here, so it never has to touch them itself.
+	searchObjectLngMap::iterator it;
+	for (it = aMap.begin(); it != aMap.end(); ++it)
+		pathTranslations[it->second] = it->first;
+
+	const wxChar *pathTokens[] =
+	{
+		wxT("Tablespaces"), wxT("Catalogs"), wxT("Catalog Objects"), 0
+	};
+	for (int i = 0 ; pathTokens[i] ; i++)
+		pathTranslations[pathTokens[i]] = wxGetTranslation(pathTokens[i]);
+
 	txtPattern->SetFocus();
 }
 
 
 dlgSearchObject::~dlgSearchObject()
 {
+	StopSearch();
+
+	WX_CLEAR_ARRAY(indexes);
+
+	if (searchConn)
+		delete searchConn;
 }
 
 void dlgSearchObject::OnHelp(wxCommandEvent &ev)
@@ -155,29 +194,16 @@ void dlgSearchObject::OnSelSearchResult(wxListEvent &ev)
 
 	long row_number = ev.GetIndex();
 
-	if(lcResults->GetItemTextColour(row_number) == wxColour(128, 128, 128))
+	if (row_number < 0 || row_number >= (long)results.GetCount())
+		return;
+
+	if(!results.Item(row_number).enabled)
 	{
 		/* Result type is not enabled in settings, so we don't search for it in the tree */
 		return;
 	}
 
-	//Taken from: http://wiki.wxwidgets.org/WxListCtrl#Get_the_String_Contents_of_a_.22cell.22_in_a_LC_REPORT_wxListCtrl
-	wxListItem     row_info;
-	wxString       path;
-
-	// Set what row it is (m_itemId is a member of the regular wxListCtrl class)
-	row_info.m_itemId = row_number;
-	// Set what column of that row we want to query for information.
-	row_info.m_col = 2;
-	// Set text mask
-	row_info.m_mask = wxLIST_MASK_TEXT;
-
-	// Get the info and store it in row_info variable.
-	lcResults->GetItem(row_info);
-
-	// Extract the text out that cell
-	path = row_info.m_text;
-
+	wxString path = results.Item(row_number).path;
 
 	if(!parent->SetCurrentNode(parent->GetBrowser()->GetRootItem(), path))
 	{
@@ -188,6 +214,10 @@ void dlgSearchObject::OnSelSearchResult(wxListEvent &ev)
 
 void dlgSearchObject::OnChange(wxCommandEvent &ev)
 {
+	/* While a search is running the button is used to stop it */
+	if (thread)
+		return;
+
 	/* When someone searches for operators, the limit of 3 characters is ignored */
 	if(aMap[cbType->GetValue()] != wxT("Operators") && txtPattern->GetValue().Length() < 3)
 		btnSearch->Disable();
@@ -196,6 +226,46 @@ void dlgSearchObject::OnChange(wxCommandEvent &ev)
 }
 
 void dlgSearchObject::OnSearch(wxCommandEvent &ev)
+{
+	if (thread)
+	{
+		StopSearch();
+		ShowResults(true);
+		return;
+	}
+
+	searchPattern = txtPattern->GetValue().Lower();
+	searchType = aMap[cbType->GetValue()];
+
+	results.Empty();
+	columnsSized = false;
+
+	/* Repeating a search asks the server again, in case the objects changed */
+	size_t i = indexes.GetCount();
+	while (i-- > 0)
+	{
+		if (indexes.Item(i)->IsExpired() || indexes.Item(i)->IsSearch(searchPattern, searchType))
+		{
+			delete indexes.Item(i);
+			indexes.RemoveAt(i);
+		}
+	}
+
+	/* A previous search for a substring of this pattern already holds every hit */
+	for (i = 0 ; i < indexes.GetCount() ; i++)
+	{
+		if (indexes.Item(i)->Covers(searchPattern, searchType))
+		{
+			indexes.Item(i)->Search(searchPattern, searchType, results);
+			ShowResults(true);
+			return;
+		}
+	}
+
+	StartSearch();
+}
+
+wxString dlgSearchObject::GetSearchSql()
 {
 
 	/*
@@ -206,7 +276,6 @@ void dlgSearchObject::OnSearch(wxCommandEvent &ev)
 	Parts of the path which has to be translated to the local langauge (because of tree path) must begin with a colon.
 	Append the type to the combobox and the mapping table in the constructor. */
 
-	wxString databasePath = parent->GetNodePath(currentdb->GetDatabase()->GetId());
 	wxString searchSQL = wxT("SELECT * FROM (  ")
 	                     wxT("	SELECT  ")
 	                     wxT("	CASE   ")
@@ -279,7 +348,7 @@ void dlgSearchObject::OnSearch(wxCommandEvent &ev)
 		searchSQL += wxT(" tr.tgisconstraint = false ");
 	}
 	searchSQL += wxT("	union ")
-	             wxT("	SELECT 'Types', t.typname, ':Schemas/' || n.nspname || '/:Types' || t.typname ")
+	             wxT("	SELECT 'Types', t.typname, ':Schemas/' || n.nspname || '/:Types/' || t.typname ")
 	             wxT("	FROM pg_type t ")
 	             wxT("	LEFT OUTER JOIN pg_type e ON e.oid=t.typelem ")
 	             wxT("	LEFT OUTER JOIN pg_class ct ON ct.oid=t.typrelid AND ct.relkind <> 'c' ")
@@ -374,95 +443,481 @@ void dlgSearchObject::OnSearch(wxCommandEvent &ev)
 	}
 
 	searchSQL += wxT(") i ")
-	             wxT("where lower(i.objectname) like '%") + txtPattern->GetValue().Lower() + wxT("%' ");
-	if(cbType->GetValue() != _("All types"))
+	             wxT("where lower(i.objectname) like ") + currentdb->GetConnection()->qtDbString(wxT("%") + searchPattern + wxT("%")) + wxT(" ");
+	if(searchType != wxT("All types"))
 	{
-		searchSQL += wxT("AND i.type = '") + aMap[cbType->GetValue()] + wxT("' ");
+		searchSQL += wxT("AND i.type = ") + currentdb->GetConnection()->qtDbString(searchType) + wxT(" ");
 	}
 	searchSQL += wxT("ORDER BY 1, 2");
 
-	pgSet *set = currentdb->GetConnection()->ExecuteSet(searchSQL);
-	int i = 0;
-	if(set)
+	return searchSQL;
+}
+
+void dlgSearchObject::StartSearch()
+{
+	/* The search runs on a connection of its own, so the browser stays usable */
+	if (!searchConn || searchConn->GetStatus() != PGCONN_OK)
 	{
-		lcResults->DeleteAllItems();
+		if (searchConn)
+			delete searchConn;
 
-		while(!set->Eof())
+		searchConn = currentdb->GetConnection()->Duplicate();
+		if (searchConn->GetStatus() != PGCONN_OK)
 		{
-			wxString objectType = set->GetVal(wxT("type"));
-			wxString objectName = set->GetVal(wxT("objectname"));
-			wxString ItemPath;
+			wxLogError(_("Could not open a connection for the search:\n%s"), searchConn->GetLastError().c_str());
+			delete searchConn;
+			searchConn = 0;
+			return;
+		}
+	}
+
+	searchObjectEnabledMap enabled;
+	searchObjectLngMap::iterator it;
+	for (it = pathTranslations.begin(); it != pathTranslations.end(); ++it)
+	{
+		/* Check if viewing of the specified object is enabled in settings */
+		enabled[it->first] = settings->GetDisplayOption(it->second);
+	}
 
+	wxString databasePath = parent->GetNodePath(currentdb->GetDatabase()->GetId());
+	thread = new searchObjectThread(searchConn, GetSearchSql(), databasePath, pathTranslations, enabled, this, ++searchGeneration);
+	if (thread->Create() != wxTHREAD_NO_ERROR)
+	{
+		delete thread;
+		thread = 0;
+		return;
+	}
 
-			/* Login Roles, Group Roles and Tablespaces are "outside" the database, so we have to adjust the path */
-			if(objectType == wxT("Login Roles") || objectType == wxT("Group Roles") || objectType == wxT("Tablespaces"))
-			{
-				wxStringTokenizer tkz(databasePath, wxT("/"));
-				wxString newPath;
-				while(tkz.HasMoreTokens())
-				{
-					wxString token = tkz.GetNextToken();
-					if(token == _("Databases"))
-						break;
-					ItemPath += token + wxT("/");
-				}
-				ItemPath += set->GetVal(wxT("path"));
-			}
-			else
-			{
-				ItemPath = databasePath + wxT("/") + set->GetVal(wxT("path"));
-			}
+	currentIndex = new searchObjectIndex(searchPattern, searchType);
 
-			if(ItemPath.Contains(wxT("Schemas/information_schema")))
-			{
-				/* In information Schema only views and columns are displayed, nothing else */
-				if(objectType == wxT("Views") || objectType == wxT("Columns"))
-				{
-					ItemPath.Replace(wxT(":Schemas/information_schema"), wxT(":Catalogs/ANSI/:Catalog Objects"));
-					ItemPath.Replace(wxT(":Views/"), wxT(""));
-				}
-				else
-				{
-					set->MoveNext();
-					continue;
-				}
-			}
+	lcResults->SetItemCount(0);
+	btnSearch->SetLabel(_("Stop"));
+	btnSearch->Enable();
+	cbType->Disable();
+	if (statusBar)
+		statusBar->SetStatusText(_("Searching..."));
 
-			if(ItemPath.Contains(wxT("Schemas/pg_catalog")))
-			{
-				ItemPath.Replace(wxT(":Schemas/pg_catalog"), wxT(":Catalogs/PostgreSQL"));
-			}
+	thread->Run();
+}
+
+void dlgSearchObject::StopSearch()
+{
+	if (!thread)
+		return;
 
-			wxListItem item;
-			item.SetId(i);
-			lcResults->InsertItem(item);
+	thread->Cancel();
+	thread->Delete();
+	delete thread;
+	thread = 0;
+
+	/* Drop whatever the stopped thread had already queued */
+	searchGeneration++;
+
+	/* An interrupted search is not complete, so it can't serve later ones */
+	if (currentIndex)
+	{
+		delete currentIndex;
+		currentIndex = 0;
+	}
 
-			wxString locTypeStr = wxGetTranslation(set->GetVal(wxT("type")));
+	btnSearch->SetLabel(_("Find"));
+	cbType->Enable();
 
-			/* Check if viewing of the specified object is enabled in settings */
-			if(!settings->GetDisplayOption(locTypeStr))
+	wxCommandEvent ev;
+	OnChange(ev);
+}
+
+void dlgSearchObject::OnSearchBatch(wxCommandEvent &ev)
+{
+	if (!thread || ev.GetInt() != searchGeneration)
+		return;
+
+	size_t first = results.GetCount();
+	thread->GetResults(results);
+
+	if (currentIndex)
+	{
+		for (size_t i = first ; i < results.GetCount() ; i++)
+			currentIndex->Add(results.Item(i));
+	}
+
+	ShowResults(false);
+}
+
+void dlgSearchObject::OnSearchComplete(wxCommandEvent &ev)
+{
+	if (!thread || ev.GetInt() != searchGeneration)
+		return;
+
+	/* The event is the thread's last action; until it has returned, look again later rather than wait for it */
+	if (thread->IsAlive())
+	{
+#if wxCHECK_VERSION(2, 9, 0)
+		GetEventHandler()->AddPendingEvent(ev);
+#else
+		AddPendingEvent(ev);
+#endif
+		return;
+	}
+
+	thread->Wait();
+	OnSearchBatch(ev);
+
+	bool failed = thread->Failed();
+	wxString error = thread->GetError();
+	delete thread;
+	thread = 0;
+
+	if (currentIndex)
+	{
+		if (failed)
+			delete currentIndex;
+		else
+			AddIndex(currentIndex);
+		currentIndex = 0;
+	}
+
+	btnSearch->SetLabel(_("Find"));
+	cbType->Enable();
+	OnChange(ev);
+
+	if (failed)
+	{
+		if (statusBar)
+			statusBar->SetStatusText(_("The search failed."));
+		wxLogError(_("The search failed:\n%s"), error.c_str());
+		return;
+	}
+
+	ShowResults(true);
+}
+
+void dlgSearchObject::AddIndex(searchObjectIndex *index)
+{
+	if (indexes.GetCount() >= SEARCH_MAX_INDEXES)
+	{
+		delete indexes.Item(0);
+		indexes.RemoveAt(0);
+	}
+	indexes.Add(index);
+}
+
+void dlgSearchObject::ShowResults(bool complete)
+{
+	lcResults->SetItemCount(results.GetCount());
+	lcResults->Refresh();
+
+	if (!columnsSized && results.GetCount() > 0)
+	{
+		/* A virtual list can't autosize, so size the columns from the first rows only */
+		int widths[3];
+		int w, h;
+		wxListItem header;
+		for (int col = 0 ; col < 3 ; col++)
+		{
+			lcResults->GetColumn(col, header);
+			lcResults->GetTextExtent(header.GetText(), &widths[col], &h);
+		}
+		for (size_t row = 0 ; row < results.GetCount() && row < SEARCH_BATCH_SIZE ; row++)
+		{
+			for (int col = 0 ; col < 3 ; col++)
 			{
-				lcResults->SetItemTextColour(i, wxColour(128, 128, 128));
+				lcResults->GetTextExtent(lcResults->OnGetItemText(row, col), &w, &h);
+				if (w > widths[col])
+					widths[col] = w;
 			}
+		}
+		for (int col = 0 ; col < 3 ; col++)
+			lcResults->SetColumnWidth(col, widths[col] + 16);
+
+		columnsSized = true;
+	}
+
+	if (statusBar)
+	{
+		if (complete)
+			statusBar->SetStatusText(wxString::Format(wxPLURAL("%d object found.", "%d objects found.", results.GetCount()), (int)results.GetCount()));
+		else
+			statusBar->SetStatusText(wxString::Format(_("Searching... %d objects found so far."), (int)results.GetCount()));
+	}
+}
+
+void dlgSearchObject::OnCancel(wxCommandEvent &ev)
+{
+	StopSearch();
+
+	if (IsModal())
+		EndModal(wxID_CANCEL);
+	else
+		Destroy();
+}
+
+void dlgSearchObject::OnClose(wxCloseEvent &ev)
+{
+	StopSearch();
+
+	if (IsModal())
+		EndModal(wxID_CANCEL);
+	else
+		Destroy();
+}
+
+
+searchObjectResultList::searchObjectResultList(wxWindow *parent, searchObjectResultArray *res)
+	: wxListView(parent, XRCID("lcResults"), wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_VIRTUAL | wxLC_SINGLE_SEL)
+{
+	results = res;
+	disabledAttr = new wxListItemAttr();
+	disabledAttr->SetTextColour(wxColour(128, 128, 128));
+}
+
+wxString searchObjectResultList::OnGetItemText(long item, long col) const
+{
+	if (item < 0 || item >= (long)results->GetCount())
+		return wxEmptyString;
+
+	const searchObjectResult &res = results->Item(item);
+	switch (col)
+	{
+		case 0:
+			return res.type;
+		case 1:
+			return res.name;
+		default:
+			return res.path;
+	}
+}
+
+wxListItemAttr *searchObjectResultList::OnGetItemAttr(long item) const
+{
+	if (item >= 0 && item < (long)results->GetCount() && !results->Item(item).enabled)
+		return disabledAttr;
+
+	return NULL;
+}
+
+
+searchObjectIndex::searchObjectIndex(const wxString &pattern, const wxString &type)
+{
+	indexPattern = pattern;
+	indexType = type;
+	created = wxGetLocalTime();
+}
+
+bool searchObjectIndex::IsExpired() const
+{
+	return wxGetLocalTime() - created > SEARCH_INDEX_SECONDS;
+}
+
+void searchObjectIndex::Add(const searchObjectResult &res)
+{
+	wxString lower = res.name.Lower();
+	size_t row = rows.GetCount();
+
+	rows.Add(res);
+	lowerNames.Add(lower);
+
+	/* Every distinct trigram of the name points back to the row */
+	wxArrayString seen;
+	for (size_t i = 0 ; i + 3 <= lower.Length() ; i++)
+	{
+		wxString trigram = lower.Mid(i, 3);
+		if (seen.Index(trigram) != wxNOT_FOUND)
+			continue;
+		seen.Add(trigram);
+		trigrams[trigram].Add(row);
+	}
+}
+
+bool searchObjectIndex::Covers(const wxString &pattern, const wxString &type) const
+{
+	if (indexType != wxT("All types") && indexType != type)
+		return false;
+
+	return pattern.Contains(indexPattern);
+}
+
+void searchObjectIndex::Search(const wxString &pattern, const wxString &type, searchObjectResultArray &hits) const
+{
+	const searchObjectPostingList *candidates = NULL;
+
+	/* Use the shortest posting list of the pattern's trigrams as candidates */
+	for (size_t i = 0 ; i + 3 <= pattern.Length() ; i++)
+	{
+		searchObjectTrigramMap::const_iterator it = trigrams.find(pattern.Mid(i, 3));
+		if (it == trigrams.end())
+			return;
+		if (!candidates || it->second.GetCount() < candidates->GetCount())
+			candidates = &it->second;
+	}
+
+	wxString locType;
+	if (type != wxT("All types"))
+		locType = wxGetTranslation(type);
+
+	size_t count = candidates ? candidates->GetCount() : rows.GetCount();
+	for (size_t i = 0 ; i < count ; i++)
+	{
+		size_t row = candidates ? candidates->Item(i) : i;
+
+		if (!lowerNames.Item(row).Contains(pattern))
+			continue;
+		if (!locType.IsEmpty() && rows.Item(row).type != locType)
+			continue;
 
-			lcResults->SetItem(i, 0, locTypeStr);
-			lcResults->SetItem(i, 1, objectName);
-			lcResults->SetItem(i, 2, TranslatePath(ItemPath));
-			set->MoveNext();
-			i++;
+		hits.Add(rows.Item(row));
+	}
+}
+
+
+searchObjectThread::searchObjectThread(pgConn *_conn, const wxString &_sql, const wxString &_databasePath,
+                                       const searchObjectLngMap &_translations, const searchObjectEnabledMap &_enabled,
+                                       wxWindow *_caller, int _generation)
+	: wxThread(wxTHREAD_JOINABLE)
+{
+	conn = _conn;
+	sql = _sql;
+	databasePath = _databasePath;
+	translations = _translations;
+	enabled = _enabled;
+	caller = _caller;
+	generation = _generation;
+	failed = false;
+
+	/* Login Roles, Group Roles and Tablespaces are "outside" the database, so their path is rooted at the server */
+	wxStringTokenizer tkz(databasePath, wxT("/"));
+	while(tkz.HasMoreTokens())
+	{
+		wxString token = tkz.GetNextToken();
+		if(token == _("Databases"))
+			break;
+		serverPath += token + wxT("/");
+	}
+}
+
+void searchObjectThread::Cancel()
+{
+	if (conn->connection())
+		PQrequestCancel(conn->connection());
+}
+
+void searchObjectThread::GetResults(searchObjectResultArray &target)
+{
+	wxCriticalSectionLocker cs(criticalSection);
+
+	for (size_t i = 0 ; i < pending.GetCount() ; i++)
+		target.Add(pending.Item(i));
+	pending.Empty();
+}
+
+void *searchObjectThread::Entry()
+{
+	PGconn *pgconn = conn->connection();
+
+	/* The cursor is only visible in its own transaction */
+	PGresult *res = PQexec(pgconn, "BEGIN");
+	PQclear(res);
+
+	wxString declare = wxT("DECLARE pga_searchobject NO SCROLL CURSOR FOR ") + sql;
+	wxString fetch = wxString::Format(wxT("FETCH %d FROM pga_searchobject"), SEARCH_BATCH_SIZE);
+
+	wxLogSql(wxT("Search query (%s:%d): %s"), conn->GetHost().c_str(), conn->GetPort(), declare.c_str());
+	res = PQexec(pgconn, declare.mb_str(*conn->GetConv()));
+	if (PQresultStatus(res) != PGRES_COMMAND_OK)
+	{
+		failed = true;
+		error = wxString(PQresultErrorMessage(res), *conn->GetConv());
+	}
+	PQclear(res);
+
+	while (!failed && !TestDestroy())
+	{
+		res = PQexec(pgconn, fetch.mb_str(*conn->GetConv()));
+		if (PQresultStatus(res) != PGRES_TUPLES_OK)
+		{
+			failed = true;
+			error = wxString(PQresultErrorMessage(res), *conn->GetConv());
+			PQclear(res);
+			break;
 		}
-		delete set;
+
+		int rows = PQntuples(res);
+		searchObjectResultArray batch;
+		for (int row = 0 ; row < rows ; row++)
+		{
+			searchObjectResult item;
+			if (BuildResult(res, row, item))
+				batch.Add(item);
+		}
+		PQclear(res);
+
+		if (batch.GetCount())
+		{
+			wxCriticalSectionLocker cs(criticalSection);
+			for (size_t i = 0 ; i < batch.GetCount() ; i++)
+				pending.Add(batch.Item(i));
+		}
+
+		if (rows < SEARCH_BATCH_SIZE)
+			break;
+
+		RaiseEvent(SEARCHOBJECT_BATCH);
+	}
+
+	if (TestDestroy())
+		failed = true;
+
+	res = PQexec(pgconn, "ROLLBACK");
+	PQclear(res);
+
+	if (!TestDestroy())
+		RaiseEvent(SEARCHOBJECT_COMPLETE);
+
+	return NULL;
+}
+
+bool searchObjectThread::BuildResult(PGresult *res, int row, searchObjectResult &item)
+{
+	wxMBConv &conv = *conn->GetConv();
+	wxString objectType(PQgetvalue(res, row, 0), conv);
+	wxString objectName(PQgetvalue(res, row, 1), conv);
+	wxString path(PQgetvalue(res, row, 2), conv);
+	wxString ItemPath;
+
+	if(objectType == wxT("Login Roles") || objectType == wxT("Group Roles") || objectType == wxT("Tablespaces"))
+		ItemPath = serverPath + path;
+	else
+		ItemPath = databasePath + wxT("/") + path;
+
+	if(ItemPath.Contains(wxT("Schemas/information_schema")))
+	{
+		/* In information Schema only views and columns are displayed, nothing else */
+		if(objectType == wxT("Views") || objectType == wxT("Columns"))
+		{
+			ItemPath.Replace(wxT(":Schemas/information_schema"), wxT(":Catalogs/ANSI/:Catalog Objects"));
+			ItemPath.Replace(wxT(":Views/"), wxT(""));
+		}
+		else
+			return false;
 	}
 
-	if(lcResults->GetItemCount() > 0)
+	if(ItemPath.Contains(wxT("Schemas/pg_catalog")))
 	{
-		lcResults->SetColumnWidth(0, wxLIST_AUTOSIZE);
-		lcResults->SetColumnWidth(1, wxLIST_AUTOSIZE);
-		lcResults->SetColumnWidth(2, wxLIST_AUTOSIZE);
+		ItemPath.Replace(wxT(":Schemas/pg_catalog"), wxT(":Catalogs/PostgreSQL"));
 	}
+
+	searchObjectLngMap::iterator it = translations.find(objectType);
+	item.type = (it != translations.end() ? it->second : objectType);
+	item.name = objectName;
+	item.path = TranslatePath(ItemPath);
+
+	searchObjectEnabledMap::iterator en = enabled.find(objectType);
+	item.enabled = (en == enabled.end() || en->second);
+
+	return true;
 }
 
-wxString dlgSearchObject::TranslatePath(wxString &path)
+wxString searchObjectThread::TranslatePath(const wxString &path)
 {
 	/* Translate a path, but only word that start's with a colon (:) */
 	wxStringTokenizer tkz(path, wxT("/"));
@@ -472,20 +927,25 @@ wxString dlgSearchObject::TranslatePath(wxString &path)
 		wxString token = tkz.GetNextToken();
 		if(token.StartsWith(wxT(":")))
 		{
-			token = wxGetTranslation(token.AfterFirst(':'));
+			token = token.AfterFirst(':');
+			searchObjectLngMap::iterator it = translations.find(token);
+			if (it != translations.end())
+				token = it->second;
 		}
-		newPath = newPath + token.Trim() + wxT("/");
+		newPath += token.Trim() + wxT("/");
 	}
 	return newPath.BeforeLast('/');
-
 }
 
-void dlgSearchObject::OnCancel(wxCommandEvent &ev)
+void searchObjectThread::RaiseEvent(int id)
 {
-	if (IsModal())
-		EndModal(wxID_CANCEL);
-	else
-		Destroy();
+	wxCommandEvent resultEvent(wxEVT_COMMAND_MENU_SELECTED, id);
+	resultEvent.SetInt(generation);
+#if wxCHECK_VERSION(2, 9, 0)
+	caller->GetEventHandler()->AddPendingEvent(resultEvent);
+#else
+	caller->AddPendingEvent(resultEvent);
+#endif
 }
 
 searchObjectFactory::searchObjectFactory(menuFactoryList *list, wxMenu *mnu, ctlMenuToolbar *toolbar) : contextActionFactory(list)
@@ -33,6 +33,7 @@
 #include "schema/pgDatabase.h"
 #include "db/pgSet.h"
 #include "schema/pgServer.h"
+#include "schema/pgServerConnector.h"
 #include "schema/pgObject.h"
 #include "schema/pgCollection.h"
 #include "schema/pgTable.h"
@@ -54,6 +55,7 @@ BEGIN_EVENT_TABLE(frmMain, pgFrame)
 	EVT_MENU(MNU_TOOLBAR,                   frmMain::OnToggleToolBar)
 	EVT_MENU(MNU_DEFAULTVIEW,               frmMain::OnDefaultView)
 	EVT_MENU(MNU_CHECKALIVE,                frmMain::OnCheckAlive)
+	EVT_MENU(SERVERCONNECT_COMPLETE,        frmMain::OnServerConnected)
 	EVT_MENU(MNU_CONTEXTMENU,               frmMain::OnContextMenu)
 
 	EVT_AUINOTEBOOK_PAGE_CHANGED(wxID_ANY,	frmMain::OnPageChange)
@@ -274,6 +276,21 @@ void frmMain::OnCheckAlive(wxCommandEvent &event)
 }
 
 
+void frmMain::OnServerConnected(wxCommandEvent &event)
+{
+	if (!serverConnector)
+		return;
+
+	serverConnector->Complete((pgServerConnectJob *)event.GetClientData());
+
+	if (serverConnector->IsDone())
+	{
+		delete serverConnector;
+		serverConnector = 0;
+	}
+}
+
+
 
 void frmMain::OnPropSelChanged(wxListEvent &event)
 {
@@ -31,6 +31,7 @@
 #define txtFilename             CTRL_TEXT("txtFilename")
 #define btnFilename             CTRL_BUTTON("btnFilename")
 #define txtCompressRatio        CTRL_TEXT("txtCompressRatio")
+#define txtNumberOfJobs         CTRL_TEXT("txtNumberOfJobs")
 #define cbEncoding              CTRL_COMBOBOX("cbEncoding")
 #define cbFormat                CTRL_COMBOBOX("cbFormat")
 #define cbRolename              CTRL_COMBOBOX("cbRolename")
@@ -261,6 +262,14 @@ frmBackup::frmBackup(frmMain *form, pgObject *obj) : ExternProcessDialog(form)
 	if (pgAppMinimumVersion(backupExecutable, 9, 1))
 		cbFormat->Append(_("Directory"));
 
+	// Parallel dumps need 9.3+ on both sides, and only work with the directory format
+	canParallel = pgAppMinimumVersion(backupExecutable, 9, 3) && object->GetConnection()->BackendMinimumVersion(9, 3);
+	if (canParallel)
+	{
+		settings->Read(wxT("frmBackup/NumberOfJobs"), &val, wxEmptyString);
+		txtNumberOfJobs->SetValue(val);
+	}
+
 	wxCommandEvent ev;
 	OnChangePlain(ev);
 }
@@ -343,6 +352,7 @@ void frmBackup::OnChangePlain(wxCommandEvent &ev)
 	chkDisableTrigger->Enable(chkOnlyData->GetValue());
 
 	btnFilename->Enable(!isDirectory);
+	txtNumberOfJobs->Enable(isDirectory && canParallel);
 
 	wxCommandEvent nullEvent;
 	OnChange(nullEvent);
@@ -436,6 +446,8 @@ wxString frmBackup::getCmdPart2()
 		case 3: // directory
 		{
 			cmd.Append(wxT(" --format directory"));
+			if (canParallel && StrToLong(txtNumberOfJobs->GetValue()) > 1)
+				cmd.Append(wxT(" --jobs ") + NumToStr(StrToLong(txtNumberOfJobs->GetValue())));
 			break;
 		}
 	}
@@ -581,6 +593,8 @@ void frmBackup::OnOK(wxCommandEvent &ev)
 	}
 
 	settings->Write(wxT("frmBackup/LastFile"), txtFilename->GetValue());
+	if (canParallel)
+		settings->Write(wxT("frmBackup/NumberOfJobs"), txtNumberOfJobs->GetValue());
 	ExternProcessDialog::OnOK(ev);
 }
 
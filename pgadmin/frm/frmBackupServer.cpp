@@ -19,6 +19,9 @@
 #include "frm/frmMain.h"
 #include "frm/frmBackupServer.h"
 #include "utils/sysLogger.h"
+#include "utils/sysProcessQueue.h"
+#include "frm/menu.h"
+#include "ctl/ctlListView.h"
 #include "schema/pgSchema.h"
 #include "schema/pgTable.h"
 
@@ -32,13 +35,24 @@
 #define cbRolename              CTRL_COMBOBOX("cbRolename")
 #define chkVerbose              CTRL_CHECKBOX("chkVerbose")
 #define chkForceQuoteForIdent   CTRL_CHECKBOX("chkForceQuoteForIdent")
+#define chkPerDatabase          CTRL_CHECKBOX("chkPerDatabase")
+#define stNumberOfJobs          CTRL_STATIC("stNumberOfJobs")
+#define txtNumberOfJobs         CTRL_TEXT("txtNumberOfJobs")
+#define txtNote                 CTRL_STATIC("txtNote")
+#define gaProgress              CTRL_GAUGE("gaProgress")
+#define lstJobs                 CTRL_LISTVIEW("lstJobs")
+#define txtJobLog               CTRL_TEXT("txtJobLog")
 
 
 BEGIN_EVENT_TABLE(frmBackupServer, ExternProcessDialog)
 	EVT_TEXT(XRCID("txtFilename"),          frmBackupServer::OnChange)
 	EVT_BUTTON(XRCID("btnFilename"),        frmBackupServer::OnSelectFilename)
 	EVT_BUTTON(wxID_OK,                     frmBackupServer::OnOK)
-	EVT_CLOSE(                              ExternProcessDialog::OnClose)
+	EVT_BUTTON(wxID_CANCEL,                 frmBackupServer::OnCancel)
+	EVT_CHECKBOX(XRCID("chkPerDatabase"),   frmBackupServer::OnChangePerDatabase)
+	EVT_LIST_ITEM_SELECTED(XRCID("lstJobs"), frmBackupServer::OnSelectJob)
+	EVT_MENU(BACKUPQUEUE_UPDATE,            frmBackupServer::OnQueueUpdate)
+	EVT_CLOSE(                              frmBackupServer::OnClose)
 END_EVENT_TABLE()
 
 
@@ -55,11 +69,23 @@ frmBackupServer::frmBackupServer(frmMain *form, pgObject *obj) : ExternProcessDi
 
 	pgServer *server = (pgServer *)object;
 	if (server->GetConnection()->EdbMinimumVersion(8, 0))
+	{
 		backupExecutable = edbBackupAllExecutable;
+		dumpExecutable = edbBackupExecutable;
+	}
 	else if (server->GetConnection()->GetIsGreenplum())
+	{
 		backupExecutable = gpBackupAllExecutable;
+		dumpExecutable = gpBackupExecutable;
+	}
 	else
+	{
 		backupExecutable = pgBackupAllExecutable;
+		dumpExecutable = pgBackupExecutable;
+	}
+
+	queue = new sysProcessQueue(this, BACKUPQUEUE_UPDATE);
+	queueReported = false;
 
 	wxString val;
 	settings->Read(wxT("frmBackupServer/LastFile"), &val, wxEmptyString);
@@ -106,13 +132,24 @@ frmBackupServer::frmBackupServer(frmMain *form, pgObject *obj) : ExternProcessDi
 		chkForceQuoteForIdent->Disable();
 	}
 
+	// Per-database backups run pg_dump once for each database, several
+	// at a time, and dump the globals with pg_dumpall --globals-only.
+	chkPerDatabase->Enable(!dumpExecutable.IsEmpty());
+	settings->Read(wxT("frmBackupServer/NumberOfJobs"), &val, wxT("4"));
+	txtNumberOfJobs->SetValue(val);
+
+	lstJobs->AddColumn(_("Job"), 80);
+	lstJobs->AddColumn(_("Status"), 50);
+	lstJobs->AddColumn(_("Time"), 50);
+
 	wxCommandEvent ev;
-	OnChange(ev);
+	OnChangePerDatabase(ev);
 }
 
 
 frmBackupServer::~frmBackupServer()
 {
+	delete queue;
 	SavePosition();
 }
 
@@ -129,6 +166,17 @@ void frmBackupServer::OnSelectFilename(wxCommandEvent &ev)
 {
 	wxString title, prompt, FilenameOnly;
 
+	if (chkPerDatabase->GetValue())
+	{
+		wxDirDialog dir(this, _("Select the backup directory"), txtFilename->GetValue());
+		if (dir.ShowModal() == wxID_OK)
+		{
+			txtFilename->SetValue(dir.GetPath());
+			OnChange(ev);
+		}
+		return;
+	}
+
 	title  = _("Select output file");
 #ifdef __WXMSW__
 	prompt = _("Query files (*.sql)|*.sql|All files (*.*)|*.*");
@@ -149,13 +197,29 @@ void frmBackupServer::OnSelectFilename(wxCommandEvent &ev)
 
 void frmBackupServer::OnChange(wxCommandEvent &ev)
 {
-	if (!process && !done)
+	if (!process && !done && !queue->IsRunning())
 		btnOK->Enable(!txtFilename->GetValue().IsEmpty());
 }
 
+
+void frmBackupServer::OnChangePerDatabase(wxCommandEvent &ev)
+{
+	bool perDatabase = chkPerDatabase->GetValue();
+
+	stNumberOfJobs->Enable(perDatabase);
+	txtNumberOfJobs->Enable(perDatabase);
+
+	if (perDatabase)
+		txtNote->SetLabel(_("Note: Databases are backed up in CUSTOM format, globals in PLAIN format."));
+	else
+		txtNote->SetLabel(_("Note: The backup format will be PLAIN."));
+
+	OnChange(ev);
+}
+
 wxString frmBackupServer::GetCmd(int step)
 {
-	wxString cmd = getCmdPart1();
+	wxString cmd = getCmdPart1(backupExecutable);
 
 	return cmd + getCmdPart2();
 }
@@ -163,17 +227,17 @@ wxString frmBackupServer::GetCmd(int step)
 
 wxString frmBackupServer::GetDisplayCmd(int step)
 {
-	wxString cmd = getCmdPart1();
+	wxString cmd = getCmdPart1(backupExecutable);
 
 	return cmd + getCmdPart2();
 }
 
 
-wxString frmBackupServer::getCmdPart1()
+wxString frmBackupServer::getCmdPart1(const wxString &executable)
 {
 	pgServer *server = (pgServer *)object;
 
-	wxString cmd = backupExecutable;
+	wxString cmd = executable;
 
 	if (!server->GetName().IsEmpty())
 		cmd += wxT(" --host ") + server->GetName();
@@ -184,14 +248,14 @@ wxString frmBackupServer::getCmdPart1()
 	if (!cbRolename->GetValue().IsEmpty())
 		cmd += wxT(" --role ") + commandLineCleanOption(qtIdent(cbRolename->GetValue()));
 
-	if (pgAppMinimumVersion(backupExecutable, 8, 4))
+	if (pgAppMinimumVersion(executable, 8, 4))
 		cmd += wxT(" --no-password ");
 
 	return cmd;
 }
 
 
-wxString frmBackupServer::getCmdPart2()
+wxString frmBackupServer::getCmdOptions()
 {
 	wxString cmd;
 
@@ -202,12 +266,184 @@ wxString frmBackupServer::getCmdPart2()
 	if (chkForceQuoteForIdent->GetValue())
 		cmd.Append(wxT(" --quote-all-identifiers"));
 
+	return cmd;
+}
+
+
+wxString frmBackupServer::getCmdPart2()
+{
+	wxString cmd = getCmdOptions();
+
 	cmd.Append(wxT(" --file \"") + txtFilename->GetValue() + wxT("\""));
 
 	return cmd;
 }
 
 
+void frmBackupServer::StartQueue()
+{
+	pgServer *server = (pgServer *)object;
+	wxString dir = txtFilename->GetValue();
+
+	if (!wxDirExists(dir) && !wxMkdir(dir))
+	{
+		wxLogError(_("Could not create the directory \"%s\"."), dir.c_str());
+		return;
+	}
+
+	long maxJobs = StrToLong(txtNumberOfJobs->GetValue());
+	if (maxJobs < 1)
+		maxJobs = 1;
+
+	queue->Clear();
+	queue->SetEnvironment(environment);
+	queue->SetMaxJobs(maxJobs);
+	queueReported = false;
+
+	queue->AddJob(_("Globals"), getCmdPart1(backupExecutable) + getCmdOptions()
+	              + wxT(" --globals-only --file \"") + wxFileName(dir, wxT("globals.sql")).GetFullPath() + wxT("\""));
+
+	// Start with the largest databases, so the long jobs don't end up last
+	wxString sql = wxT("SELECT oid, datname FROM pg_database WHERE datallowconn AND NOT datistemplate");
+	if (server->GetConnection()->BackendMinimumVersion(8, 1))
+		sql += wxT(" ORDER BY pg_database_size(oid) DESC");
+	else
+		sql += wxT(" ORDER BY datname");
+
+	// File names in use, in lower case for file systems that ignore case
+	wxArrayString usedNames;
+	usedNames.Add(wxT("globals.sql"));
+
+	pgSetIterator set(server->GetConnection(), sql);
+	while (set.RowsLeft())
+	{
+		wxString dbName = set.GetVal(wxT("datname"));
+
+		// Keep the file name portable, whatever the database is called
+		wxString baseName;
+		size_t i;
+		for (i = 0 ; i < dbName.Length() ; i++)
+		{
+			wxChar c = dbName.GetChar(i);
+			baseName += (wxIsalnum(c) || c == '-' || c == '_') ? c : wxT('_');
+		}
+
+		// Names that had to be changed, or that clash with another one, get
+		// the database's OID, so no two jobs write the same file
+		if (baseName != dbName || usedNames.Index((baseName + wxT(".backup")).Lower()) != wxNOT_FOUND)
+			baseName += wxT("_") + set.GetVal(wxT("oid"));
+
+		wxString fileName = baseName + wxT(".backup");
+		int n = 1;
+		while (usedNames.Index(fileName.Lower()) != wxNOT_FOUND)
+			fileName = baseName + wxString::Format(wxT("_%d.backup"), n++);
+		usedNames.Add(fileName.Lower());
+
+		queue->AddJob(dbName, getCmdPart1(dumpExecutable) + wxT(" --format custom") + getCmdOptions()
+		              + wxT(" --file \"") + wxFileName(dir, fileName).GetFullPath() + wxT("\" ")
+		              + commandLineCleanOption(qtIdent(dbName)));
+	}
+
+	lstJobs->DeleteAllItems();
+	txtJobLog->Clear();
+	size_t i;
+	for (i = 0 ; i < queue->GetCount() ; i++)
+		lstJobs->AppendItem(-1, queue->GetJob(i)->name, queue->GetJob(i)->GetStateName());
+
+	gaProgress->SetRange(queue->GetCount());
+	gaProgress->SetValue(0);
+
+	txtMessages->AppendText(wxString::Format(_("Backing up %d databases and the globals to \"%s\", %ld at a time."),
+	                        (int)queue->GetCount() - 1, dir.c_str(), maxJobs) + END_OF_LINE);
+
+	btnOK->Disable();
+	nbNotebook->SetSelection(1);
+
+	queue->Start();
+}
+
+
+void frmBackupServer::OnQueueUpdate(wxCommandEvent &ev)
+{
+	size_t i;
+	for (i = 0 ; i < queue->GetCount() && (long)i < lstJobs->GetItemCount() ; i++)
+	{
+		sysProcessJob *job = queue->GetJob(i);
+		wxString state = job->GetStateName();
+
+		if (lstJobs->GetText(i, 1) != state)
+		{
+			lstJobs->SetItem(i, 1, state);
+			if (job->state >= JOB_SUCCEEDED)
+				txtMessages->AppendText(job->name + wxT(": ") + state
+				                        + wxString::Format(_(" (exit code %d)"), job->exitCode) + END_OF_LINE);
+		}
+		if (job->state != JOB_WAITING)
+			lstJobs->SetItem(i, 2, job->GetElapsed().ToString() + wxT(" ms"));
+	}
+
+	gaProgress->SetValue(queue->GetFinishedCount());
+
+	long sel = lstJobs->GetSelection();
+	if (sel >= 0 && sel < (long)queue->GetCount() && txtJobLog->GetValue().Length() != queue->GetJob(sel)->log.Length())
+	{
+		txtJobLog->SetValue(queue->GetJob(sel)->log);
+		txtJobLog->ShowPosition(txtJobLog->GetLastPosition());
+	}
+
+	if (!queue->IsRunning() && queue->GetCount() && !queueReported)
+	{
+		queueReported = true;
+
+		size_t failed = queue->GetFailedCount();
+		if (failed)
+			txtMessages->AppendText(wxString::Format(_("%d of %d backup jobs failed."), (int)failed, (int)queue->GetCount()) + END_OF_LINE);
+		else if (queue->GetFinishedCount() == queue->GetCount() && queue->GetJob(0)->state == JOB_SUCCEEDED)
+		{
+			txtMessages->AppendText(_("All backup jobs completed successfully.") + wxString(END_OF_LINE));
+			btnOK->SetLabel(_("Done"));
+			done = true;
+		}
+
+		btnOK->Enable();
+		btnCancel->Enable();
+	}
+}
+
+
+void frmBackupServer::OnSelectJob(wxListEvent &ev)
+{
+	long sel = ev.GetIndex();
+	if (sel >= 0 && sel < (long)queue->GetCount())
+	{
+		txtJobLog->SetValue(queue->GetJob(sel)->log);
+		txtJobLog->ShowPosition(txtJobLog->GetLastPosition());
+	}
+}
+
+
+void frmBackupServer::OnCancel(wxCommandEvent &ev)
+{
+	if (queue->IsRunning())
+	{
+		queue->Abort();
+		txtMessages->AppendText(END_OF_LINE + wxString(_("Cancelled on user request.")) + END_OF_LINE + END_OF_LINE);
+
+		wxCommandEvent nullEvent;
+		OnQueueUpdate(nullEvent);
+	}
+	else
+		ExternProcessDialog::OnCancel(ev);
+}
+
+
+void frmBackupServer::OnClose(wxCloseEvent &ev)
+{
+	queue->Abort();
+	ExternProcessDialog::OnClose(ev);
+}
+
+
 void frmBackupServer::Go()
 {
 	txtFilename->SetFocus();
@@ -235,6 +471,17 @@ void frmBackupServer::OnOK(wxCommandEvent &ev)
 	}
 
 	settings->Write(wxT("frmBackupServer/LastFile"), txtFilename->GetValue());
+
+	if (chkPerDatabase->GetValue())
+	{
+		settings->Write(wxT("frmBackupServer/NumberOfJobs"), txtNumberOfJobs->GetValue());
+		if (!done)
+		{
+			StartQueue();
+			return;
+		}
+	}
+
 	ExternProcessDialog::OnOK(ev);
 }
 
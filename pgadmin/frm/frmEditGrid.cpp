@@ -19,6 +19,7 @@
 #include "frm/frmMain.h"
 #include "frm/menu.h"
 #include "db/pgQueryThread.h"
+#include "db/pgConnPool.h"
 
 #include <wx/generic/gridctrl.h>
 #include <wx/clipbrd.h>
@@ -96,6 +97,8 @@ frmEditGrid::frmEditGrid(frmMain *form, const wxString &_title, pgConn *_conn, p
 	dlgName = wxT("frmEditGrid");
 	RestorePosition(-1, -1, 600, 500, 300, 350);
 	connection = _conn;
+	if (connection)
+		connection->SetSubsystem(PGCONN_SUB_EDITGRID);
 	mainForm = form;
 	thread = 0;
 	relkind = 0;
@@ -1508,7 +1511,7 @@ frmEditGrid::~frmEditGrid()
 	manager.UnInit();
 
 	if (connection)
-		delete connection;
+		pgConnPool::Release(connection);
 }
 
 
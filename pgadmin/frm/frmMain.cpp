@@ -46,6 +46,7 @@
 #include "agent/pgaJob.h"
 #include "schema/pgDatabase.h"
 #include "schema/pgServer.h"
+#include "schema/pgServerConnector.h"
 #include "schema/pgObject.h"
 #include "schema/pgCollection.h"
 #include "frm/frmOptions.h"
@@ -62,6 +63,7 @@
 #include "frm/frmReport.h"
 #include "frm/frmMaintenance.h"
 #include "frm/frmStatus.h"
+#include "frm/frmQueryStats.h"
 #include "frm/frmPassword.h"
 #ifdef DATABASEDESIGNER
 #include "frm/frmDatabaseDesigner.h"
@@ -214,6 +216,8 @@ frmMain::frmMain(const wxString &title)
 	// tell the manager to "commit" all the changes just made
 	manager.Update();
 
+	serverConnector = 0;
+
 	// Add the root node
 	serversObj = new pgServerCollection(serverFactory.GetCollectionFactory());
 	wxTreeItemId root = browser->AddRoot(_("Server Groups"), serversObj->GetIconId(), -1, serversObj);
@@ -227,6 +231,9 @@ frmMain::frmMain(const wxString &title)
 
 	browser->Expand(root);
 	browser->SortChildren(root);
+
+	if (settings->GetReconnectOnStartup())
+		ReconnectServers();
 }
 
 
@@ -235,6 +242,9 @@ frmMain::~frmMain()
 	// Store the servers, to ensure we store the last database/schema etc
 	StoreServers();
 
+	if (serverConnector)
+		delete serverConnector;
+
 	settings->Write(wxT("frmMain/Perspective-") + wxString(FRMMAIN_PERSPECTIVE_VER), manager.SavePerspective());
 	manager.UnInit();
 
@@ -434,6 +444,7 @@ void frmMain::CreateMenus()
 
 	new propertyFactory(menuFactories, editMenu, 0);
 	new serverStatusFactory(menuFactories, toolsMenu, 0);
+	new queryStatsFactory(menuFactories, toolsMenu, 0);
 
 	// Add the plugin toolbar button/menu
 	new pluginButtonMenuFactory(menuFactories, pluginsMenu, toolBar, pluginUtilityCount);
@@ -830,7 +841,7 @@ bool frmMain::CheckAlive()
 									pgDatabase *db = (pgDatabase *)browser->GetObject(item);
 									if (db && db->IsCreatedBy(databaseFactory))
 									{
-										pgConn *conn = db->GetConnection();
+										pgConn *conn = db->connection(false);
 										if (conn)
 										{
 											if (!conn->IsAlive() && (conn->GetStatus() == PGCONN_BROKEN || conn->GetStatus() == PGCONN_BAD))
@@ -1018,6 +1029,12 @@ wxTreeItemId frmMain::RestoreEnvironment(pgServer *server)
 
 int frmMain::ReconnectServer(pgServer *server, bool restore)
 {
+	if (server->GetConnecting())
+	{
+		statusBar->SetStatusText(wxString::Format(_("Still connecting to server %s in the background"), server->GetDescription().c_str()), 1);
+		return PGCONN_ABORTED;
+	}
+
 	// Create a server object and connect it.
 	wxBusyInfo waiting(wxString::Format(_("Connecting to server %s (%s:%d)"),
 	                                    server->GetDescription().c_str(), server->GetName().c_str(), server->GetPort()), this);
@@ -1185,6 +1202,7 @@ void frmMain::StoreServers()
 					settings->WriteBool(key + wxT("StorePwd"), server->GetStorePwd());
 					settings->Write(key + wxT("Rolename"), server->GetRolename());
 					settings->WriteBool(key + wxT("Restore"), server->GetRestore());
+					settings->WriteBool(key + wxT("Reconnect"), server->GetConnected() || server->GetConnecting());
 					settings->Write(key + wxT("Database"), server->GetDatabaseName());
 					settings->Write(key + wxT("Username"), server->GetUsername());
 					settings->Write(key + wxT("LastDatabase"), server->GetLastDatabase());
@@ -1247,6 +1265,46 @@ void frmMain::RetrieveServers()
 	}
 }
 
+// Connects the servers that were connected when pgAdmin was closed, in the
+// background; each tree node is updated as its server becomes available
+void frmMain::ReconnectServers()
+{
+	pgServerConnector *connector = new pgServerConnector(this, settings->GetConnectTimeout());
+	int count = 0;
+
+	wxTreeItemIdValue foldercookie;
+	wxTreeItemId folderitem = browser->GetFirstChild(browser->GetRootItem(), foldercookie);
+	while (folderitem)
+	{
+		if (browser->ItemHasChildren(folderitem))
+		{
+			wxTreeItemIdValue servercookie;
+			wxTreeItemId serveritem = browser->GetFirstChild(folderitem, servercookie);
+			while (serveritem)
+			{
+				pgServer *server = (pgServer *)browser->GetItemData(serveritem);
+				if (server != NULL && server->IsCreatedBy(serverFactory) && server->GetReconnect())
+				{
+					connector->Add(server);
+					count++;
+				}
+				serveritem = browser->GetNextChild(folderitem, servercookie);
+			}
+		}
+		folderitem = browser->GetNextChild(browser->GetRootItem(), foldercookie);
+	}
+
+	if (!count)
+	{
+		delete connector;
+		return;
+	}
+
+	serverConnector = connector;
+	serverConnector->Start();
+}
+
+
 pgServer *frmMain::ConnectToServer(const wxString &servername, bool restore)
 {
 	wxTreeItemIdValue foldercookie, servercookie;
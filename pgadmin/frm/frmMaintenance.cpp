@@ -23,6 +23,9 @@
 #include "frm/frmMain.h"
 #include "utils/sysLogger.h"
 #include "schema/pgIndex.h"
+#include "schema/pgSchema.h"
+#include "db/pgQueryThread.h"
+#include "ctl/ctlListView.h"
 
 // Icons
 #include "images/vacuum.pngc"
@@ -30,6 +33,10 @@
 
 BEGIN_EVENT_TABLE(frmMaintenance, ExecutionDialog)
 	EVT_RADIOBOX(XRCID("rbxAction"),    frmMaintenance::OnAction)
+	EVT_CHECKBOX(XRCID("chkPerTable"),  frmMaintenance::OnAction)
+	EVT_BUTTON (wxID_OK,                frmMaintenance::OnOK)
+	EVT_BUTTON (wxID_CANCEL,            frmMaintenance::OnCancel)
+	EVT_CLOSE(                          frmMaintenance::OnClose)
 END_EVENT_TABLE()
 
 #define nbNotebook              CTRL_NOTEBOOK("nbNotebook")
@@ -38,6 +45,13 @@ END_EVENT_TABLE()
 #define chkFreeze               CTRL_CHECKBOX("chkFreeze")
 #define chkAnalyze              CTRL_CHECKBOX("chkAnalyze")
 #define chkVerbose              CTRL_CHECKBOX("chkVerbose")
+#define chkPerTable             CTRL_CHECKBOX("chkPerTable")
+#define stOrder                 CTRL_STATIC("stOrder")
+#define chcOrder                CTRL_CHOICE("chcOrder")
+#define stConnections           CTRL_STATIC("stConnections")
+#define txtConnections          CTRL_TEXT("txtConnections")
+#define gaProgress              CTRL_GAUGE("gaProgress")
+#define lstTables               CTRL_LISTVIEW("lstTables")
 
 #define stBitmap                CTRL("stBitmap", wxStaticBitmap)
 
@@ -68,6 +82,20 @@ frmMaintenance::frmMaintenance(frmMain *form, pgObject *obj) : ExecutionDialog(f
 		rbxAction->Enable(0, false);
 		rbxAction->Enable(1, false);
 	}
+
+	running = false;
+	perTableDone = false;
+	cancelRequested = false;
+	closeRequested = false;
+
+	long connections;
+	settings->Read(wxT("frmMaintenance/Connections"), &connections, 4L);
+	txtConnections->SetValue(NumToStr(connections));
+
+	lstTables->AddColumn(_("Table"), 110);
+	lstTables->AddColumn(_("Status"), 45);
+	lstTables->AddColumn(_("Time"), 45);
+
 	wxCommandEvent ev;
 	OnAction(ev);
 }
@@ -110,6 +138,20 @@ void frmMaintenance::OnAction(wxCommandEvent &ev)
 	chkFreeze->Enable(isVacuum);
 	chkAnalyze->Enable(isVacuum);
 
+	bool perTableAllowed = CanRunPerTable();
+	chkPerTable->Enable(perTableAllowed);
+	if (!perTableAllowed)
+		chkPerTable->SetValue(false);
+
+	bool perTable = chkPerTable->GetValue();
+	stOrder->Enable(perTable);
+	chcOrder->Enable(perTable);
+	stConnections->Enable(perTable);
+	txtConnections->Enable(perTable);
+
+	if (ev.GetEventType() == wxEVT_COMMAND_CHECKBOX_CLICKED)
+		return;
+
 	bool isReindex = (rbxAction->GetSelection() == 2);
 	bool isCluster = (rbxAction->GetSelection() == 3);
 	if (isReindex || (isCluster && !conn->BackendMinimumVersion(8, 4)))
@@ -141,16 +183,7 @@ wxString frmMaintenance::GetSql()
 				if (frmHint::ShowHint(this, HINT_VACUUM_FULL) == wxID_CANCEL)
 					return wxEmptyString;
 			}
-			sql = wxT("VACUUM ");
-
-			if (chkFull->GetValue())
-				sql += wxT("FULL ");
-			if (chkFreeze->GetValue())
-				sql += wxT("FREEZE ");
-			if (chkVerbose->GetValue())
-				sql += wxT("VERBOSE ");
-			if (chkAnalyze->GetValue())
-				sql += wxT("ANALYZE ");
+			sql = GetVacuumOptions();
 
 			if (object->GetMetaType() != PGM_DATABASE)
 				sql += object->GetQuotedFullIdentifier();
@@ -210,6 +243,310 @@ wxString frmMaintenance::GetSql()
 
 
 
+wxString frmMaintenance::GetVacuumOptions()
+{
+	wxString sql = wxT("VACUUM ");
+
+	if (chkFull->GetValue())
+		sql += wxT("FULL ");
+	if (chkFreeze->GetValue())
+		sql += wxT("FREEZE ");
+	if (chkVerbose->GetValue())
+		sql += wxT("VERBOSE ");
+	if (chkAnalyze->GetValue())
+		sql += wxT("ANALYZE ");
+
+	return sql;
+}
+
+
+wxString frmMaintenance::GetTableSql(const wxString &table)
+{
+	switch (rbxAction->GetSelection())
+	{
+		case 0:
+			return GetVacuumOptions() + table;
+		case 1:
+			return wxT("ANALYZE ") + wxString(chkVerbose->GetValue() ? wxT("VERBOSE ") : wxT("")) + table;
+		case 2:
+			return wxT("REINDEX TABLE ") + table;
+	}
+	return wxEmptyString;
+}
+
+
+// Only VACUUM, ANALYZE and REINDEX of a whole database or schema can be
+// split into independent per-table statements.
+bool frmMaintenance::CanRunPerTable()
+{
+	if (object->GetMetaType() != PGM_DATABASE && object->GetMetaType() != PGM_SCHEMA)
+		return false;
+
+	return rbxAction->GetSelection() <= 2;
+}
+
+
+void frmMaintenance::OnOK(wxCommandEvent &ev)
+{
+#ifdef __WXGTK__
+	if (!btnOK->IsEnabled())
+		return;
+#endif
+	if (perTableDone)
+	{
+		delete conn;
+		Destroy();
+		return;
+	}
+
+	if (!thread && !running && CanRunPerTable() && chkPerTable->GetValue())
+	{
+		RunPerTable();
+		return;
+	}
+
+	ExecutionDialog::OnOK(ev);
+}
+
+
+void frmMaintenance::OnCancel(wxCommandEvent &ev)
+{
+	if (running)
+	{
+		btnCancel->Disable();
+		cancelRequested = true;
+		return;
+	}
+
+	ExecutionDialog::OnCancel(ev);
+}
+
+
+void frmMaintenance::OnClose(wxCloseEvent &ev)
+{
+	// The runner loop owns the worker connections; let it clean up first
+	if (running && ev.CanVeto())
+	{
+		cancelRequested = true;
+		closeRequested = true;
+		ev.Veto();
+		return;
+	}
+
+	ExecutionDialog::OnClose(ev);
+}
+
+
+// A worker connection, and the statement currently running on it
+class maintenanceWorker
+{
+public:
+	pgConn *conn;
+	pgQueryThread *thread;
+	long table;
+	wxLongLong startTime;
+};
+
+WX_DEFINE_ARRAY_PTR(maintenanceWorker *, maintenanceWorkerArray);
+
+
+void frmMaintenance::RunPerTable()
+{
+	// Show the VACUUM FULL hint once, not for every table
+	if (GetSql().IsEmpty())
+		return;
+
+	bool byDeadTuples = chcOrder->GetSelection() == 1 && conn->BackendMinimumVersion(8, 3);
+
+	wxString sizeExpr = conn->BackendMinimumVersion(8, 1) ? wxT("pg_total_relation_size(c.oid)") : wxT("c.relpages::int8 * 8192");
+	wxString sql = wxT("SELECT quote_ident(n.nspname) || '.' || quote_ident(c.relname) AS tabname\n")
+	               wxT("  FROM pg_class c\n")
+	               wxT("  JOIN pg_namespace n ON n.oid = c.relnamespace\n");
+	if (byDeadTuples)
+		sql += wxT("  LEFT JOIN pg_stat_user_tables s ON s.relid = c.oid\n");
+	sql += wxT(" WHERE c.relkind = 'r'\n")
+	       wxT("   AND n.nspname NOT LIKE 'pg_%' AND n.nspname <> 'information_schema'\n");
+	if (object->GetMetaType() == PGM_SCHEMA)
+		sql += wxT("   AND n.oid = ") + ((pgSchema *)object)->GetOidStr() + wxT("\n");
+	if (byDeadTuples)
+		sql += wxT(" ORDER BY COALESCE(s.n_dead_tup, 0)::float8 / GREATEST(COALESCE(s.n_live_tup, 0) + COALESCE(s.n_dead_tup, 0), 1) DESC, ")
+		       + sizeExpr + wxT(" DESC");
+	else
+		sql += wxT(" ORDER BY ") + sizeExpr + wxT(" DESC");
+
+	wxArrayString tables;
+	pgSetIterator set(conn, sql);
+	while (set.RowsLeft())
+		tables.Add(set.GetVal(wxT("tabname")));
+
+	if (tables.IsEmpty())
+	{
+		txtMessages->AppendText(_("No tables to process.") + wxString(wxT("\n")));
+		return;
+	}
+
+	long maxConnections = StrToLong(txtConnections->GetValue());
+	if (maxConnections < 1)
+		maxConnections = 1;
+	if (maxConnections > (long)tables.GetCount())
+		maxConnections = tables.GetCount();
+	settings->WriteLong(wxT("frmMaintenance/Connections"), maxConnections);
+
+	// Open the worker connections; the dialogue's own connection is the first one
+	maintenanceWorkerArray workers;
+	long i;
+	for (i = 0 ; i < maxConnections ; i++)
+	{
+		pgConn *workerConn = i ? conn->Duplicate() : conn;
+		if (!workerConn || workerConn->GetStatus() != PGCONN_OK)
+		{
+			if (workerConn && workerConn != conn)
+				delete workerConn;
+			break;
+		}
+		maintenanceWorker *worker = new maintenanceWorker;
+		worker->conn = workerConn;
+		worker->thread = 0;
+		worker->table = -1;
+		workers.Add(worker);
+	}
+
+	if (workers.IsEmpty())
+	{
+		txtMessages->AppendText(conn->GetLastError());
+		return;
+	}
+
+	lstTables->DeleteAllItems();
+	for (i = 0 ; i < (long)tables.GetCount() ; i++)
+		lstTables->AppendItem(-1, tables.Item(i), _("Waiting"));
+
+	gaProgress->SetRange(tables.GetCount());
+	gaProgress->SetValue(0);
+	nbNotebook->SetSelection(1);
+
+	running = true;
+	cancelRequested = false;
+	btnOK->Disable();
+
+	wxLongLong startTime = wxGetLocalTimeMillis();
+	long nextTable = 0, finished = 0, failed = 0;
+	size_t w;
+
+	while (finished < (long)tables.GetCount())
+	{
+		for (w = 0 ; w < workers.GetCount() ; w++)
+		{
+			maintenanceWorker *worker = workers.Item(w);
+
+			if (worker->thread)
+			{
+				if (txtMessages)
+				{
+					wxString msg = worker->thread->GetMessagesAndClear();
+					if (!msg.IsEmpty())
+						txtMessages->AppendText(msg + wxT("\n"));
+				}
+
+				if (worker->thread->IsRunning())
+					continue;
+
+				worker->thread->Wait();
+				bool isOk = (worker->thread->ReturnCode() == PGRES_COMMAND_OK || worker->thread->ReturnCode() == PGRES_TUPLES_OK);
+				txtMessages->AppendText(worker->thread->GetMessagesAndClear());
+				delete worker->thread;
+				worker->thread = 0;
+
+				lstTables->SetItem(worker->table, 1, isOk ? _("Done") : _("Failed"));
+				lstTables->SetItem(worker->table, 2, (wxGetLocalTimeMillis() - worker->startTime).ToString() + wxT(" ms"));
+				if (!isOk)
+				{
+					txtMessages->AppendText(tables.Item(worker->table) + wxT(": ") + worker->conn->GetLastError());
+					failed++;
+				}
+				finished++;
+				gaProgress->SetValue(finished);
+			}
+
+			if (!cancelRequested && nextTable < (long)tables.GetCount())
+			{
+				worker->table = nextTable++;
+				worker->thread = new pgQueryThread(worker->conn, GetTableSql(tables.Item(worker->table)));
+				if (worker->thread->Create() != wxTHREAD_NO_ERROR)
+				{
+					delete worker->thread;
+					worker->thread = 0;
+					lstTables->SetItem(worker->table, 1, _("Failed"));
+					finished++;
+					failed++;
+					continue;
+				}
+				worker->startTime = wxGetLocalTimeMillis();
+				worker->thread->Run();
+				lstTables->SetItem(worker->table, 1, _("Running"));
+				lstTables->EnsureVisible(worker->table);
+			}
+		}
+
+		if (cancelRequested)
+		{
+			// Deleting a running query thread cancels its statement
+			for (w = 0 ; w < workers.GetCount() ; w++)
+			{
+				maintenanceWorker *worker = workers.Item(w);
+				if (worker->thread)
+				{
+					if (worker->thread->IsRunning())
+						worker->thread->Delete();
+					delete worker->thread;
+					worker->thread = 0;
+					lstTables->SetItem(worker->table, 1, _("Cancelled"));
+				}
+			}
+			for ( ; nextTable < (long)tables.GetCount() ; nextTable++)
+				lstTables->SetItem(nextTable, 1, _("Cancelled"));
+			break;
+		}
+
+		wxMilliSleep(10);
+		wxTheApp->Yield(true);
+	}
+
+	int workerCount = workers.GetCount();
+	for (w = 0 ; w < workers.GetCount() ; w++)
+	{
+		if (workers.Item(w)->conn != conn)
+			delete workers.Item(w)->conn;
+	}
+	WX_CLEAR_ARRAY(workers);
+
+	running = false;
+
+	if (cancelRequested)
+		txtMessages->AppendText(_("\nCancelled.\n"));
+	else
+	{
+		txtMessages->AppendText(wxString::Format(_("%ld tables processed on %d connections, %ld failed."),
+		                        finished, workerCount, failed) + wxT("\n"));
+		txtMessages->AppendText(_("Total query runtime: ")
+		                        + (wxGetLocalTimeMillis() - startTime).ToString() + wxT(" ms."));
+		if (!failed)
+		{
+			btnOK->SetLabel(_("Done"));
+			btnCancel->Disable();
+			perTableDone = true;
+		}
+	}
+
+	btnOK->Enable();
+	if (!perTableDone)
+		btnCancel->Enable();
+
+	if (closeRequested)
+		Close();
+}
+
+
 void frmMaintenance::Go()
 {
 	chkFull->SetFocus();
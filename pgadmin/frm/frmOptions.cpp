@@ -89,6 +89,7 @@
 #define chkAutoRollback             CTRL_CHECKBOX("chkAutoRollback")
 #define chkDoubleClickProperties    CTRL_CHECKBOX("chkDoubleClickProperties")
 #define chkShowNotices			    CTRL_CHECKBOX("chkShowNotices")
+#define chkReconnectOnStartup       CTRL_CHECKBOX("chkReconnectOnStartup")
 #define cbLanguage                  CTRL_COMBOBOX("cbLanguage")
 #define pickerSqlFont               CTRL_FONTPICKER("pickerSqlFont")
 #define chkSuppressHints            CTRL_CHECKBOX("chkSuppressHints")
@@ -142,7 +143,11 @@
 #define pnlMiscGuruHints          	CTRL_PANEL("pnlMiscGuruHints")
 #define pnlMiscLogging          	CTRL_PANEL("pnlMiscLogging")
 #define cbRefreshOnClick			CTRL_COMBOBOX("cbRefreshOnClick")
+#define txtConnectTimeout           CTRL_TEXT("txtConnectTimeout")
+#define txtConnPoolMax              CTRL_TEXT("txtConnPoolMax")
+#define txtConnPoolTimeout          CTRL_TEXT("txtConnPoolTimeout")
 #define pickerFontDD                CTRL_FONTPICKER("pickerFontDD")
+#define chkDDValidateModels         CTRL_CHECKBOX("chkDDValidateModels")
 
 
 BEGIN_EVENT_TABLE(frmOptions, pgDialog)
@@ -272,6 +277,9 @@ frmOptions::frmOptions(frmMain *parent)
 
 	wxTextValidator numval(wxFILTER_NUMERIC);
 	txtMaxRows->SetValidator(numval);
+	txtConnectTimeout->SetValidator(numval);
+	txtConnPoolMax->SetValidator(numval);
+	txtConnPoolTimeout->SetValidator(numval);
 	txtMaxColSize->SetValidator(numval);
 	txtAutoRowCount->SetValidator(numval);
 	txtIndent->SetValidator(numval);
@@ -291,6 +299,9 @@ frmOptions::frmOptions(frmMain *parent)
 	cbCopyQuote->SetSelection(settings->GetCopyQuoting());
 	cbCopyQuoteChar->SetValue(settings->GetCopyQuoteChar());
 	cbRefreshOnClick->SetSelection(settings->GetRefreshOnClick());
+	txtConnectTimeout->SetValue(NumToStr(settings->GetConnectTimeout()));
+	txtConnPoolMax->SetValue(NumToStr(settings->GetConnPoolMaxConnections()));
+	txtConnPoolTimeout->SetValue(NumToStr(settings->GetConnPoolTimeout()));
 
 	wxString copySeparator = settings->GetCopyColSeparator();
 	if (copySeparator == wxT("\t"))
@@ -303,6 +314,7 @@ frmOptions::frmOptions(frmMain *parent)
 	chkAutoRollback->SetValue(settings->GetAutoRollback());
 	chkDoubleClickProperties->SetValue(settings->GetDoubleClickProperties());
 	chkShowNotices->SetValue(settings->GetShowNotices());
+	chkReconnectOnStartup->SetValue(settings->GetReconnectOnStartup());
 
 	txtPgHelpPath->SetValue(settings->GetPgHelpPath());
 	txtEdbHelpPath->SetValue(settings->GetEdbHelpPath());
@@ -371,6 +383,7 @@ frmOptions::frmOptions(frmMain *parent)
 	pickerFont->SetSelectedFont(settings->GetSystemFont());
 	pickerSqlFont->SetSelectedFont(settings->GetSQLFont());
 	pickerFontDD->SetSelectedFont(settings->GetDDFont());
+	chkDDValidateModels->SetValue(settings->GetDDValidateModels());
 
 	// Load the display options
 	lstDisplay->Append(_("Databases"));
@@ -653,6 +666,9 @@ void frmOptions::OnOK(wxCommandEvent &ev)
 	settings->SetHistoryMaxQueries(StrToLong(txtHistoryMaxQueries->GetValue()));
 	settings->SetHistoryMaxQuerySize(StrToLong(txtHistoryMaxQuerySize->GetValue()));
 	settings->SetRefreshOnClick(cbRefreshOnClick->GetSelection());
+	settings->SetConnectTimeout(StrToLong(txtConnectTimeout->GetValue()));
+	settings->SetConnPoolMaxConnections(StrToLong(txtConnPoolMax->GetValue()));
+	settings->SetConnPoolTimeout(StrToLong(txtConnPoolTimeout->GetValue()));
 
 	wxString copySeparator = cbCopySeparator->GetValue();
 	if (copySeparator == _("Tab"))
@@ -665,12 +681,14 @@ void frmOptions::OnOK(wxCommandEvent &ev)
 	settings->SetAutoRollback(chkAutoRollback->GetValue());
 	settings->SetDoubleClickProperties(chkDoubleClickProperties->GetValue());
 	settings->SetShowNotices(chkShowNotices->GetValue());
+	settings->SetReconnectOnStartup(chkReconnectOnStartup->GetValue());
 
 	settings->SetUnicodeFile(chkUnicodeFile->GetValue());
 	settings->SetWriteBOM(chkWriteBOM->GetValue());
 	settings->SetSystemFont(pickerFont->GetSelectedFont());
 	settings->SetSQLFont(pickerSqlFont->GetSelectedFont());
 	settings->SetDDFont(pickerFontDD->GetSelectedFont());
+	settings->SetDDValidateModels(chkDDValidateModels->GetValue());
 	settings->SetSuppressGuruHints(chkSuppressHints->GetValue());
 	settings->SetSlonyPath(pickerSlonyPath->GetPath());
 	settings->SetPostgresqlPath(pickerPostgresqlPath->GetPath());
@@ -31,7 +31,10 @@
 #include "frm/frmQuery.h"
 #include "frm/menu.h"
 #include "ctl/explainCanvas.h"
+#include "ctl/explainPlan.h"
+#include "ctl/explainHotNodes.h"
 #include "db/pgConn.h"
+#include "db/pgConnPool.h"
 
 #include "ctl/ctlMenuToolbar.h"
 #include "ctl/ctlSQLResult.h"
@@ -53,6 +56,7 @@
 #include "schema/pgServer.h"
 #include "utils/favourites.h"
 #include "utils/sysLogger.h"
+#include "utils/sysQueryHistory.h"
 #include "utils/sysSettings.h"
 #include "utils/utffile.h"
 #include "pgscript/pgsApplication.h"
@@ -82,15 +86,8 @@
 #define CTRLID_CONNECTION       4200
 #define CTRLID_DATABASELABEL    4201
 
-#define XML_FROM_WXSTRING(s) ((const xmlChar *)(const char *)s.mb_str(wxConvUTF8))
-#define WXSTRING_FROM_XML(s) wxString((char *)s, wxConvUTF8)
-#define XML_STR(s) ((const xmlChar *)s)
-
-// Initialize execution 'mutex'. As this will always run in the
-// main thread, there aren't any real concurrency issues, so
-// a simple flag will suffice.
-// Required because the pgScript parser isn't currently thread-safe :-(
-bool    frmQuery::ms_pgScriptRunning = false;
+// Result tabs shown by one run of Execute statements
+#define MAX_STATEMENT_RESULTS   20
 
 BEGIN_EVENT_TABLE(frmQuery, pgFrame)
 	EVT_ERASE_BACKGROUND(           frmQuery::OnEraseBackground)
@@ -117,10 +114,12 @@ BEGIN_EVENT_TABLE(frmQuery, pgFrame)
 	EVT_MENU(MNU_EXECUTE,           frmQuery::OnExecute)
 	EVT_MENU(MNU_EXECPGS,           frmQuery::OnExecScript)
 	EVT_MENU(MNU_EXECFILE,          frmQuery::OnExecFile)
+	EVT_MENU(MNU_EXECSTATEMENTS,    frmQuery::OnExecStatements)
 	EVT_MENU(MNU_EXPLAIN,           frmQuery::OnExplain)
 	EVT_MENU(MNU_EXPLAINANALYZE,    frmQuery::OnExplain)
 	EVT_MENU(MNU_CANCEL,            frmQuery::OnCancel)
 	EVT_MENU(MNU_AUTOROLLBACK,      frmQuery::OnAutoRollback)
+	EVT_MENU(MNU_STOPONERROR,       frmQuery::OnStopOnError)
 	EVT_MENU(MNU_CONTENTS,          frmQuery::OnContents)
 	EVT_MENU(MNU_HELP,              frmQuery::OnHelp)
 	EVT_MENU(MNU_CLEARHISTORY,      frmQuery::OnClearHistory)
@@ -161,10 +160,13 @@ BEGIN_EVENT_TABLE(frmQuery, pgFrame)
 // These fire when the queries complete
 	EVT_MENU(QUERY_COMPLETE,        frmQuery::OnQueryComplete)
 	EVT_MENU(PGSCRIPT_COMPLETE,     frmQuery::OnScriptComplete)
+	EVT_MENU(STATEMENT_COMPLETE,    frmQuery::OnStatementComplete)
 	EVT_AUINOTEBOOK_PAGE_CHANGED(CTL_NTBKCENTER, frmQuery::OnChangeNotebook)
 	EVT_SPLITTER_SASH_POS_CHANGED(GQB_HORZ_SASH, frmQuery::OnResizeHorizontally)
 	EVT_BUTTON(CTL_DELETECURRENTBTN, frmQuery::OnDeleteCurrent)
 	EVT_BUTTON(CTL_DELETEALLBTN,     frmQuery::OnDeleteAll)
+	EVT_TEXT(CTL_HISTORYFILTER,      frmQuery::OnHistoryFilter)
+	EVT_MENU(QUERYHISTORY_CHANGED,   frmQuery::OnHistoryChanged)
 END_EVENT_TABLE()
 
 class DnDFile : public wxFileDropTarget
@@ -223,6 +225,14 @@ frmQuery::frmQuery(frmMain *form, const wxString &_title, pgConn *_conn, const w
 
 	mainForm = form;
 	conn = _conn;
+	if (conn)
+		conn->SetSubsystem(PGCONN_SUB_QUERYTOOL);
+
+	scriptNext = 0;
+	scriptErrors = 0;
+	scriptSucceeded = 0;
+	scriptResult = NULL;
+	scriptRunning = false;
 
 	loading = true;
 	closing = false;
@@ -232,6 +242,7 @@ frmQuery::frmQuery(frmMain *form, const wxString &_title, pgConn *_conn, const w
 	RestorePosition(100, 100, 600, 500, 450, 300);
 
 	explainCanvas = NULL;
+	explainHotNodes = NULL;
 
 	// notify wxAUI which frame to use
 	manager.SetManagedWindow(this);
@@ -298,6 +309,7 @@ frmQuery::frmQuery(frmMain *form, const wxString &_title, pgConn *_conn, const w
 	queryMenu->Append(MNU_EXECUTE, _("&Execute\tF5"), _("Execute query"));
 	queryMenu->Append(MNU_EXECPGS, _("Execute &pgScript\tF6"), _("Execute pgScript"));
 	queryMenu->Append(MNU_EXECFILE, _("Execute to file"), _("Execute query, write result to file"));
+	queryMenu->Append(MNU_EXECSTATEMENTS, _("Execute &statements\tShift-F5"), _("Execute the statements one by one, showing the result of each"));
 	queryMenu->Append(MNU_EXPLAIN, _("E&xplain\tF7"), _("Explain query"));
 	queryMenu->Append(MNU_EXPLAINANALYZE, _("Explain analyze\tShift-F7"), _("Explain and analyze query"));
 
@@ -307,12 +319,15 @@ frmQuery::frmQuery(frmMain *form, const wxString &_title, pgConn *_conn, const w
 	eo->Append(MNU_COSTS, _("Costs"), _("Explain analyze query with (or without) costs"), wxITEM_CHECK);
 	eo->Append(MNU_BUFFERS, _("Buffers"), _("Explain analyze query with (or without) buffers"), wxITEM_CHECK);
 	eo->Append(MNU_TIMING, _("Timing"), _("Explain analyze query with (or without) timing"), wxITEM_CHECK);
+	eo->AppendSeparator();
+	eo->Append(MNU_EXPLAINXML, _("Structured output"), _("Request the plan in XML format and analyse it per node (PostgreSQL 9.0 and later)"), wxITEM_CHECK);
 	queryMenu->Append(MNU_EXPLAINOPTIONS, _("Explain &options"), eo, _("Options modifying Explain output"));
 	queryMenu->AppendSeparator();
 	queryMenu->Append(MNU_SAVEHISTORY, _("Save history"), _("Save history of executed commands."));
 	queryMenu->Append(MNU_CLEARHISTORY, _("Clear history"), _("Clear history window."));
 	queryMenu->AppendSeparator();
 	queryMenu->Append(MNU_AUTOROLLBACK, _("&Auto-Rollback"), _("Rollback the current transaction if an error is detected"), wxITEM_CHECK);
+	queryMenu->Append(MNU_STOPONERROR, _("S&top statements on error"), _("Stop executing statements one by one at the first error"), wxITEM_CHECK);
 	queryMenu->AppendSeparator();
 	queryMenu->Append(MNU_CANCEL, _("&Cancel\tAlt-Break"), _("Cancel query"));
 	menuBar->Append(queryMenu, _("&Query"));
@@ -368,6 +383,7 @@ frmQuery::frmQuery(frmMain *form, const wxString &_title, pgConn *_conn, const w
 	queryMenu->Check(MNU_COSTS, settings->GetExplainCosts());
 	queryMenu->Check(MNU_BUFFERS, settings->GetExplainBuffers());
 	queryMenu->Check(MNU_TIMING, settings->GetExplainTiming());
+	queryMenu->Check(MNU_EXPLAINXML, settings->GetExplainXml());
 
 	UpdateRecentFiles();
 
@@ -452,9 +468,13 @@ frmQuery::frmQuery(frmMain *form, const wxString &_title, pgConn *_conn, const w
 	// Query combobox
 	sqlQueries = new wxComboBox(pnlQuery, CTL_SQLQUERYCBOX, wxT(""), wxDefaultPosition, wxDefaultSize, wxArrayString(), wxCB_DROPDOWN | wxCB_READONLY);
 	sqlQueries->SetToolTip(_("Previous queries"));
-	LoadQueries();
 	boxHistory->Add(sqlQueries, 1, wxEXPAND | wxALL | wxALIGN_CENTER_VERTICAL, 1);
 
+	// History search
+	txtHistoryFilter = new wxTextCtrl(pnlQuery, CTL_HISTORYFILTER, wxT(""), wxDefaultPosition, wxSize(150, -1));
+	txtHistoryFilter->SetToolTip(_("Only list previous queries containing all these words"));
+	boxHistory->Add(txtHistoryFilter, 0, wxALL | wxALIGN_CENTER_VERTICAL, 1);
+
 	// Delete Current button
 	btnDeleteCurrent = new wxButton(pnlQuery, CTL_DELETECURRENTBTN, _("Delete"));
 	btnDeleteCurrent->Enable(false);
@@ -462,9 +482,11 @@ frmQuery::frmQuery(frmMain *form, const wxString &_title, pgConn *_conn, const w
 
 	// Delete All button
 	btnDeleteAll = new wxButton(pnlQuery, CTL_DELETEALLBTN, _("Delete All"));
-	btnDeleteAll->Enable(sqlQueries->GetCount() > 0);
 	boxHistory->Add(btnDeleteAll, 0, wxALL | wxALIGN_CENTER_VERTICAL, 1);
 
+	FillHistory();
+	queryHistory->AddListener(this);
+
 	boxQuery->Add(boxHistory, 0, wxEXPAND | wxALL, 1);
 
 	// Create the other inner box sizer
@@ -489,6 +511,7 @@ frmQuery::frmQuery(frmMain *form, const wxString &_title, pgConn *_conn, const w
 	outputPane = new ctlAuiNotebook(this, CTL_NTBKGQB, wxDefaultPosition, wxSize(500, 300), wxAUI_NB_TOP | wxAUI_NB_TAB_SPLIT | wxAUI_NB_TAB_MOVE | wxAUI_NB_SCROLL_BUTTONS | wxAUI_NB_WINDOWLIST_BUTTON);
 	sqlResult = new ctlSQLResult(outputPane, conn, CTL_SQLRESULT, wxDefaultPosition, wxDefaultSize);
 	explainCanvas = new ExplainCanvas(outputPane);
+	explainHotNodes = new ExplainHotNodes(outputPane);
 	msgResult = new wxTextCtrl(outputPane, CTL_MSGRESULT, wxT(""), wxDefaultPosition, wxDefaultSize, wxTE_MULTILINE | wxTE_READONLY | wxTE_DONTWRAP);
 	msgResult->SetFont(settings->GetSQLFont());
 	msgHistory = new wxTextCtrl(outputPane, CTL_MSGHISTORY, wxT(""), wxDefaultPosition, wxDefaultSize, wxTE_MULTILINE | wxTE_READONLY | wxTE_DONTWRAP);
@@ -511,6 +534,7 @@ frmQuery::frmQuery(frmMain *form, const wxString &_title, pgConn *_conn, const w
 	outputPane->AddPage(explainCanvas, _("Explain"));
 	outputPane->AddPage(msgResult, _("Messages"));
 	outputPane->AddPage(msgHistory, _("History"));
+	outputPane->AddPage(explainHotNodes, _("Hot Nodes"));
 
 	sqlQuery->Connect(wxID_ANY, wxEVT_SET_FOCUS, wxFocusEventHandler(frmQuery::OnFocus));
 	sqlQuery->Connect(wxID_ANY, wxEVT_KILL_FOCUS, wxFocusEventHandler(frmQuery::OnFocus));
@@ -556,6 +580,10 @@ frmQuery::frmQuery(frmMain *form, const wxString &_title, pgConn *_conn, const w
 	settings->Read(wxT("frmQuery/AutoRollback"), &bVal, false);
 	queryMenu->Check(MNU_AUTOROLLBACK, bVal);
 
+	// Stop statements on error
+	settings->Read(wxT("frmQuery/StopOnError"), &bVal, true);
+	queryMenu->Check(MNU_STOPONERROR, bVal);
+
 	// Auto indent
 	settings->Read(wxT("frmQuery/AutoIndent"), &bVal, true);
 	editMenu->Check(MNU_AUTOINDENT, bVal);
@@ -635,6 +663,8 @@ frmQuery::~frmQuery()
 {
 	closing = true;
 
+	queryHistory->RemoveListener(this);
+
 	// Save frmQuery Perspective
 	settings->Write(wxT("frmQuery/Perspective-") + wxString(FRMQUERY_PERSPECTIVE_VER), manager.SavePerspective());
 
@@ -664,7 +694,7 @@ frmQuery::~frmQuery()
 
 	while (cbConnection->GetCount() > 1)
 	{
-		delete (pgConn *)cbConnection->GetClientData(0);
+		pgConnPool::Release((pgConn *)cbConnection->GetClientData(0));
 		cbConnection->Delete(0);
 	}
 
@@ -809,6 +839,14 @@ void frmQuery::OnAutoRollback(wxCommandEvent &event)
 }
 
 
+void frmQuery::OnStopOnError(wxCommandEvent &event)
+{
+	queryMenu->Check(MNU_STOPONERROR, event.IsChecked());
+
+	settings->WriteBool(wxT("frmQuery/StopOnError"), queryMenu->IsChecked(MNU_STOPONERROR));
+}
+
+
 void frmQuery::OnAutoIndent(wxCommandEvent &event)
 {
 	editMenu->Check(MNU_AUTOINDENT, event.IsChecked());
@@ -1035,6 +1073,7 @@ void frmQuery::OnChangeConnection(wxCommandEvent &ev)
 	else
 	{
 		conn = (pgConn *)cbConnection->GetClientData(sel);
+		conn->SetSubsystem(PGCONN_SUB_QUERYTOOL);
 		sqlResult->SetConnection(conn);
 		pgScript->SetConnection(conn);
 		title = wxT("Query - ") + cbConnection->GetValue();
@@ -1269,6 +1308,14 @@ wxWindow *frmQuery::currentControl()
 			case 3:
 				wnd = msgHistory;
 				break;
+			case 4:
+				wnd = explainHotNodes;
+				break;
+			default:
+				// Results of Execute statements
+				if (outputPane->GetSelection() > 4)
+					wnd = outputPane->GetPage(outputPane->GetSelection());
+				break;
 		}
 	}
 	return wnd;
@@ -1299,6 +1346,11 @@ void frmQuery::OnCopy(wxCommandEvent &ev)
 				sqlResult->Copy();
 				break;
 			}
+			if (scriptPages.Index(obj) != wxNOT_FOUND)
+			{
+				((ctlSQLResult *)obj)->Copy();
+				break;
+			}
 			obj = obj->GetParent();
 		}
 	}
@@ -1425,8 +1477,13 @@ void frmQuery::updateMenu(bool allowUpdateModelSize)
 	wxWindow *wnd = currentControl();
 	if (wnd != NULL)
 	{
+		bool isStatementResult = false;
+		for (size_t i = 0 ; i < scriptPages.GetCount() && !isStatementResult ; i++)
+			isStatementResult = relatesToWindow(wnd, (wxWindow *)scriptPages.Item(i));
+
 		if (   relatesToWindow(wnd, sqlQuery)
 		        || relatesToWindow(wnd, sqlResult)
+		        || isStatementResult
 		        || relatesToWindow(wnd, msgResult)
 		        || relatesToWindow(wnd, msgHistory)
 		        || relatesToWindow(wnd, scratchPad)   )
@@ -1655,6 +1712,8 @@ void frmQuery::OnClose(wxCloseEvent &event)
 
 	sqlQuery->Disconnect(wxID_ANY, wxEVT_SET_FOCUS, wxFocusEventHandler(frmQuery::OnFocus));
 	sqlResult->Disconnect(wxID_ANY, wxEVT_SET_FOCUS, wxFocusEventHandler(frmQuery::OnFocus));
+	for (size_t i = 0 ; i < scriptPages.GetCount() ; i++)
+		((wxWindow *)scriptPages.Item(i))->Disconnect(wxID_ANY, wxEVT_SET_FOCUS, wxFocusEventHandler(frmQuery::OnFocus));
 	msgResult->Disconnect(wxID_ANY, wxEVT_SET_FOCUS, wxFocusEventHandler(frmQuery::OnFocus));
 	msgHistory->Disconnect(wxID_ANY, wxEVT_SET_FOCUS, wxFocusEventHandler(frmQuery::OnFocus));
 
@@ -1664,6 +1723,7 @@ void frmQuery::OnClose(wxCloseEvent &event)
 	settings->SetExplainCosts(queryMenu->IsChecked(MNU_COSTS));
 	settings->SetExplainBuffers(queryMenu->IsChecked(MNU_BUFFERS));
 	settings->SetExplainTiming(queryMenu->IsChecked(MNU_TIMING));
+	settings->SetExplainXml(queryMenu->IsChecked(MNU_EXPLAINXML));
 
 	sqlResult->Abort();                           // to make sure conn is unused
 
@@ -2012,6 +2072,13 @@ void frmQuery::OnCancel(wxCommandEvent &event)
 
 	if (sqlResult->RunStatus() == CTLSQL_RUNNING)
 		sqlResult->Abort();
+	else if (scriptRunning)
+	{
+		// The completion event of the aborted statement is ignored
+		scriptResult->Abort();
+		showMessage(_("Execution of the statements cancelled."));
+		completeStatements();
+	}
 	else if (pgScript->IsRunning())
 		pgScript->Terminate();
 
@@ -2053,6 +2120,7 @@ void frmQuery::OnExplain(wxCommandEvent &event)
 		bool costs = queryMenu->IsChecked(MNU_COSTS);
 		bool buffers = queryMenu->IsChecked(MNU_BUFFERS) && analyze;
 		bool timing = queryMenu->IsChecked(MNU_TIMING) && analyze;
+		bool xml = queryMenu->IsChecked(MNU_EXPLAINXML);
 
 		sql += wxT("(");
 		if (analyze)
@@ -2078,6 +2146,8 @@ void frmQuery::OnExplain(wxCommandEvent &event)
 			else
 				sql += wxT(", TIMING off ");
 		}
+		if (xml)
+			sql += wxT(", FORMAT XML");
 		sql += wxT(")");
 	}
 	else
@@ -2198,14 +2268,10 @@ void frmQuery::OnExecScript(wxCommandEvent &event)
 	if (query.IsNull())
 		return;
 
-	// Make sure pgScript is not already running
-	// Required because the pgScript parser isn't currently thread-safe :-(
-	if (frmQuery::ms_pgScriptRunning == true)
-	{
-		wxMessageBox(_("pgScript already running."), _("Concurrent execution of pgScripts is not supported at this time."), wxICON_WARNING | wxOK);
+	// Each query tool has its own pgScript application, only this one
+	// needs to be idle
+	if (pgScript->IsRunning())
 		return;
-	}
-	frmQuery::ms_pgScriptRunning = true;
 
 	// Clear markers and indicators
 	sqlQuery->MarkerDeleteAll(0);
@@ -2219,6 +2285,7 @@ void frmQuery::OnExecScript(wxCommandEvent &event)
 
 	// Window stuff
 	explainCanvas->Clear();
+	explainHotNodes->Clear();
 	msgResult->Clear();
 	msgResult->SetFont(settings->GetSQLFont());
 	outputPane->SetSelection(2);
@@ -2269,6 +2336,78 @@ void frmQuery::OnExecFile(wxCommandEvent &event)
 }
 
 
+void frmQuery::OnExecStatements(wxCommandEvent &event)
+{
+	if(sqlNotebook->GetSelection() == 1)
+	{
+		if (!updateFromGqb(true))
+			return;
+	}
+
+	wxString query = sqlQuery->GetSelectedText();
+	if (query.IsNull())
+		query = sqlQuery->GetText();
+
+	if (query.IsNull())
+		return;
+
+	scriptStatements.Empty();
+	scriptOffsets.Empty();
+	SplitStatements(query, scriptStatements, scriptOffsets, conn->GetStandardConformingStrings());
+	if (scriptStatements.IsEmpty())
+		return;
+
+	// Keep the positions of the statements in the editor, to mark errors
+	int selStart = sqlQuery->GetSelectionStart(), selEnd = sqlQuery->GetSelectionEnd();
+	if (selStart == selEnd)
+		selStart = 0;
+	for (size_t i = 0 ; i < scriptOffsets.GetCount() ; i++)
+		scriptOffsets[i] += selStart;
+
+	setTools(true);
+	queryMenu->Enable(MNU_SAVEHISTORY, true);
+	queryMenu->Enable(MNU_CLEARHISTORY, true);
+
+	explainCanvas->Clear();
+	explainHotNodes->Clear();
+	sqlResult->ClearResult();
+	clearStatementResults();
+
+	// Clear markers and indicators
+	sqlQuery->MarkerDeleteAll(0);
+	sqlQuery->StartStyling(0, wxSTC_INDICS_MASK);
+	sqlQuery->SetStyling(sqlQuery->GetText().Length(), 0);
+
+	if (!changed)
+		setExtendedTitle();
+
+	aborted = false;
+
+	SetStatusText(wxT(""), STATUSPOS_SECS);
+	SetStatusText(wxT(""), STATUSPOS_ROWS);
+	msgResult->Clear();
+	msgResult->SetFont(settings->GetSQLFont());
+	outputPane->SetSelection(2);
+
+	msgHistory->AppendText(_("-- Executing statements:\n"));
+	msgHistory->AppendText(query);
+	msgHistory->AppendText(wxT("\n"));
+	Update();
+	wxTheApp->Yield(true);
+
+	scriptNext = 0;
+	scriptErrors = 0;
+	scriptSucceeded = 0;
+	scriptRunning = true;
+
+	startTimeQuery = wxGetLocalTimeMillis();
+	timer.Start(10);
+
+	execNextStatement();
+	sqlQuery->SetFocus();
+}
+
+
 void frmQuery::OnMacroManage(wxCommandEvent &event)
 {
 	int r = dlgManageMacros(this, mainForm, macros).ManageMacros();
@@ -2323,6 +2462,7 @@ void frmQuery::setTools(const bool running)
 	queryMenu->Enable(MNU_EXECUTE, !running);
 	queryMenu->Enable(MNU_EXECPGS, !running);
 	queryMenu->Enable(MNU_EXECFILE, !running);
+	queryMenu->Enable(MNU_EXECSTATEMENTS, !running);
 	queryMenu->Enable(MNU_EXPLAIN, !running);
 	queryMenu->Enable(MNU_EXPLAINANALYZE, !running);
 	queryMenu->Enable(MNU_CANCEL, running);
@@ -2354,6 +2494,7 @@ void frmQuery::execQuery(const wxString &query, int resultToRetrieve, bool singl
 	queryMenu->Enable(MNU_CLEARHISTORY, true);
 
 	explainCanvas->Clear();
+	explainHotNodes->Clear();
 
 	// Clear markers and indicators
 	sqlQuery->MarkerDeleteAll(0);
@@ -2402,7 +2543,18 @@ void frmQuery::execQuery(const wxString &query, int resultToRetrieve, bool singl
 	startTimeQuery = wxGetLocalTimeMillis();
 	timer.Start(10);
 
-	if (sqlResult->Execute(query, resultToRetrieve, this, QUERY_COMPLETE, qi) >= 0)
+	// An export of a single statement reads numbers and timestamps in
+	// binary format, which saves the server formatting them as text
+	bool binaryResults = false;
+	if (toFile && !explain)
+	{
+		wxArrayString statements;
+		wxArrayInt offsets;
+		SplitStatements(query, statements, offsets, conn->GetStandardConformingStrings());
+		binaryResults = (statements.GetCount() == 1);
+	}
+
+	if (sqlResult->Execute(query, resultToRetrieve, this, QUERY_COMPLETE, qi, binaryResults) >= 0)
 	{
 		// Return and wait for the result
 		return;
@@ -2514,32 +2666,7 @@ void frmQuery::OnQueryComplete(wxCommandEvent &ev)
 
 				errPos -= qi->queryOffset;        // do not count EXPLAIN or similar
 
-				// Set an indicator on the error word (break on any kind of bracket, a space or full stop)
-				int sPos = errPos + selStart - 1, wEnd = 1;
-				sqlQuery->StartStyling(sPos, wxSTC_INDICS_MASK);
-				int c = sqlQuery->GetCharAt(sPos + wEnd);
-				size_t len = sqlQuery->GetText().Length();
-				while(c != ' ' && c != '(' && c != '{' && c != '[' && c != '.' &&
-				        (unsigned int)(sPos + wEnd) < len)
-				{
-					wEnd++;
-					c = sqlQuery->GetCharAt(sPos + wEnd);
-				}
-				sqlQuery->SetStyling(wEnd, wxSTC_INDIC0_MASK);
-
-				int line = 0, maxLine = sqlQuery->GetLineCount();
-				while (line < maxLine && sqlQuery->GetLineEndPosition(line) < errPos + selStart + 1)
-					line++;
-				if (line < maxLine)
-				{
-					sqlQuery->GotoPos(sPos);
-					sqlQuery->MarkerAdd(line, 0);
-
-					if (!changed)
-						setExtendedTitle();
-
-					sqlQuery->EnsureVisible(line);
-				}
+				markError(errPos + selStart);
 			}
 		}
 	}
@@ -2607,54 +2734,226 @@ void frmQuery::OnQueryComplete(wxCommandEvent &ev)
 		if (executedQuery.IsNull())
 			executedQuery = sqlQuery->GetText();
 
-		// Same query, but without return feeds and carriage returns
-		wxString executedQueryWithoutReturns = executedQuery;
-		executedQueryWithoutReturns.Replace(wxT("\n"), wxT(" "));
-		executedQueryWithoutReturns.Replace(wxT("\r"), wxT(" "));
-		executedQueryWithoutReturns = executedQueryWithoutReturns.Trim();
-
+		// The history moves a known query to the end and notifies all
+		// query tools, this one included
 		if (executedQuery.Len() < (unsigned int)settings->GetHistoryMaxQuerySize())
-		{
-			// We put in the combo box the query without returns...
-			sqlQueries->Append(executedQueryWithoutReturns);
+			queryHistory->Add(executedQuery);
+	}
+
+	completeQuery(done, qi->explain, qi->verbose);
+	delete qi;
+}
 
-			// .. but we save the query with returns in the array
-			// (so that we have the real query in the file)
-			histoQueries.Add(executedQuery);
 
-			// Finally, we save the queries
-			SaveQueries();
-		}
+// Run the next statement of Execute statements, or complete the run. Each
+// statement runs in the background like a query, so the window stays
+// responsive and shows the progress in between.
+void frmQuery::execNextStatement()
+{
+	if (scriptNext >= scriptStatements.GetCount())
+	{
+		completeStatements();
+		return;
+	}
+
+	// The result of the previous statement can be reused if it is not shown
+	if (!scriptResult)
+	{
+		scriptResult = new ctlSQLResult(outputPane, conn, wxID_ANY);
+		scriptResult->Hide();
+	}
+
+	SetStatusText(wxString::Format(_("Running statement %d of %d."), (int)scriptNext + 1, (int)scriptStatements.GetCount()), STATUSPOS_MSGS);
+	startTimeStatement = wxGetLocalTimeMillis();
+
+	if (scriptResult->Execute(scriptStatements.Item(scriptNext++), 0, this, STATEMENT_COMPLETE, scriptResult) < 0)
+	{
+		showMessage(_("The statement could not be executed."));
+		completeStatements();
+	}
+}
+
+
+void frmQuery::OnStatementComplete(wxCommandEvent &ev)
+{
+	// Statements that were cancelled meanwhile are ignored
+	if (!scriptRunning || ev.GetClientData() != scriptResult)
+		return;
+
+	while (scriptResult->RunStatus() == CTLSQL_RUNNING)
+	{
+		wxTheApp->Yield(true);
+	}
+
+	if (!scriptRunning)
+		return;
+
+	wxLongLong elapsed = wxGetLocalTimeMillis() - startTimeStatement;
+	int offset = scriptOffsets.Item(scriptNext - 1);
+	bool stop = false;
+
+	wxString str = scriptResult->GetMessagesAndClear();
+	msgResult->AppendText(str);
+	msgHistory->AppendText(str);
+
+	wxString header = wxString::Format(_("Statement %d of %d (line %d): "), (int)scriptNext, (int)scriptStatements.GetCount(),
+	                                   sqlQuery->LineFromPosition(offset) + 1);
 
-		// Search a matching old query
-		unsigned int index = 0;
-		bool found = false;
-		while (!found && index < sqlQueries->GetCount())
+	if (scriptResult->RunStatus() == PGRES_TUPLES_OK)
+	{
+		long rows = scriptResult->NumRows();
+		scriptSucceeded++;
+
+		if (scriptPages.GetCount() < MAX_STATEMENT_RESULTS)
 		{
-			found = sqlQueries->GetString(index) == executedQueryWithoutReturns;
-			if (!found)
-				index++;
+			// The result gets a tab of its own, and the next statement a
+			// new result
+			scriptResult->DisplayData();
+			scriptResult->Connect(wxID_ANY, wxEVT_SET_FOCUS, wxFocusEventHandler(frmQuery::OnFocus));
+			outputPane->AddPage(scriptResult, wxString::Format(_("Result %d"), (int)scriptNext));
+			scriptPages.Add(scriptResult);
+			scriptResult = NULL;
+
+			showMessage(header + wxString::Format(wxPLURAL("%ld row retrieved, %s ms execution time.", "%ld rows retrieved, %s ms execution time.", rows),
+			                                      rows, elapsed.ToString().c_str()));
 		}
+		else
+			showMessage(header + wxString::Format(wxPLURAL("%ld row retrieved (not shown), %s ms execution time.", "%ld rows retrieved (not shown), %s ms execution time.", rows),
+			                                      rows, elapsed.ToString().c_str()));
+	}
+	else if (scriptResult->RunStatus() == PGRES_COMMAND_OK)
+	{
+		long insertedCount = scriptResult->InsertedCount();
+		scriptSucceeded++;
 
-		// If we found one, delete it from the combobox and the array
-		if (found && index < (unsigned int)sqlQueries->GetCount() - 1)
+		if (insertedCount < 0)
+			showMessage(header + wxString::Format(_("Query returned successfully with no result in %s ms."), elapsed.ToString().c_str()));
+		else
+			showMessage(header + wxString::Format(wxPLURAL("%ld row affected, %s ms execution time.", "%ld rows affected, %s ms execution time.", insertedCount),
+			                                      insertedCount, elapsed.ToString().c_str()));
+	}
+	else
+	{
+		long errPos = 0;
+		pgError err = scriptResult->GetResultError();
+		wxLogQuietError(wxT("%s"), conn->GetLastError().Trim().c_str());
+		err.statement_pos.ToLong(&errPos);
+		scriptErrors++;
+
+		showMessage(header + wxString::Format(wxT("********** %s **********\n"), _("Error")));
+		showMessage(err.formatted_msg);
+
+		if (errPos > 0)
+			markError(offset + errPos);
+
+		if (err.sql_state.IsEmpty())
+		{
+			// The connection is lost, whatever the setting
+			stop = true;
+
+			if (wxMessageBox(_("Do you want to attempt to reconnect to the database?"),
+			                 wxString::Format(_("Connection to database %s lost."), conn->GetDbname().c_str()),
+			                 wxICON_EXCLAMATION | wxYES_NO) == wxYES)
+			{
+				conn->Reset();
+				showMessage(_("Connection reset."));
+			}
+		}
+		else if (queryMenu->IsChecked(MNU_STOPONERROR))
+			stop = true;
+		else if (settings->GetAutoRollback() && conn->GetTxStatus() == PGCONN_TXSTATUS_INERROR)
 		{
-			histoQueries.RemoveAt(index);
-			sqlQueries->Delete(index);
+			// Otherwise all of the following statements would fail as well
+			conn->ExecuteVoid(wxT("ROLLBACK;"));
+			showMessage(_("Transaction rolled back."));
 		}
 	}
 
-	// Make sure only the maximum query number is enforced
-	while (sqlQueries->GetCount() > (unsigned int)settings->GetHistoryMaxQueries())
+	if (stop)
+		completeStatements();
+	else
+		execNextStatement();
+}
+
+
+void frmQuery::completeStatements()
+{
+	scriptRunning = false;
+	timer.Stop();
+
+	elapsedQuery = wxGetLocalTimeMillis() - startTimeQuery;
+	SetStatusText(elapsedQuery.ToString() + wxT(" ms"), STATUSPOS_SECS);
+
+	showMessage(wxString::Format(_("%d of %d statements executed, %d failed, total runtime %s ms."),
+	                             scriptSucceeded + scriptErrors, (int)scriptStatements.GetCount(), scriptErrors, elapsedQuery.ToString().c_str()),
+	            scriptErrors ? wxString::Format(wxPLURAL("%d statement failed.", "%d statements failed.", scriptErrors), scriptErrors) : wxString(_("OK.")));
+
+	if (!scriptErrors && scriptPages.GetCount())
+		outputPane->SetSelection(outputPane->GetPageIndex((wxWindow *)scriptPages.Item(0)));
+	else
+		outputPane->SetSelection(2);
+
+	if (scriptSucceeded)
+	{
+		wxString executedQuery = sqlQuery->GetSelectedText();
+		if (executedQuery.IsNull())
+			executedQuery = sqlQuery->GetText();
+
+		if (executedQuery.Len() < (unsigned int)settings->GetHistoryMaxQuerySize())
+			queryHistory->Add(executedQuery);
+	}
+
+	completeQuery(false, false, false);
+}
+
+
+// Remove the result tabs of the previous run of Execute statements
+void frmQuery::clearStatementResults()
+{
+	while (scriptPages.GetCount())
+	{
+		wxWindow *page = (wxWindow *)scriptPages.Last();
+		page->Disconnect(wxID_ANY, wxEVT_SET_FOCUS, wxFocusEventHandler(frmQuery::OnFocus));
+
+		int index = outputPane->GetPageIndex(page);
+		if (index != wxNOT_FOUND)
+			outputPane->DeletePage(index);
+
+		scriptPages.RemoveAt(scriptPages.GetCount() - 1);
+	}
+}
+
+
+// Set an indicator on the word at the given position of the editor (counted
+// from 1, as the server reports it) and mark its line
+void frmQuery::markError(int errPos)
+{
+	// Set an indicator on the error word (break on any kind of bracket, a space or full stop)
+	int sPos = errPos - 1, wEnd = 1;
+	sqlQuery->StartStyling(sPos, wxSTC_INDICS_MASK);
+	int c = sqlQuery->GetCharAt(sPos + wEnd);
+	size_t len = sqlQuery->GetText().Length();
+	while(c != ' ' && c != '(' && c != '{' && c != '[' && c != '.' &&
+	        (unsigned int)(sPos + wEnd) < len)
 	{
-		histoQueries.RemoveAt(0);
-		sqlQueries->Delete(0);
+		wEnd++;
+		c = sqlQuery->GetCharAt(sPos + wEnd);
 	}
+	sqlQuery->SetStyling(wEnd, wxSTC_INDIC0_MASK);
 
-	SaveQueries();
+	int line = 0, maxLine = sqlQuery->GetLineCount();
+	while (line < maxLine && sqlQuery->GetLineEndPosition(line) < errPos + 1)
+		line++;
+	if (line < maxLine)
+	{
+		sqlQuery->GotoPos(sPos);
+		sqlQuery->MarkerAdd(line, 0);
 
-	completeQuery(done, qi->explain, qi->verbose);
-	delete qi;
+		if (!changed)
+			setExtendedTitle();
+
+		sqlQuery->EnsureVisible(line);
+	}
 }
 
 
@@ -2670,9 +2969,6 @@ void frmQuery::OnScriptComplete(wxCommandEvent &ev)
 	// Reset tools
 	setTools(false);
 
-	// Unlock our pseudo-mutex thingy
-	frmQuery::ms_pgScriptRunning = false;
-
 	// Manage timer
 	elapsedQuery = wxGetLocalTimeMillis() - startTimeQuery;
 	SetStatusText(elapsedQuery.ToString() + wxT(" ms"), STATUSPOS_SECS);
@@ -2788,7 +3084,19 @@ void frmQuery::completeQuery(bool done, bool explain, bool verbose)
 					str.Append(sqlResult->OnGetItemText(i, 0));
 				}
 			}
-			explainCanvas->SetExplainString(str);
+			if (ExplainPlan::IsXmlPlan(str))
+			{
+				ExplainPlan *plan = new ExplainPlan();
+				if (plan->Parse(str))
+				{
+					explainHotNodes->SetExplainPlan(plan);
+					explainCanvas->SetExplainPlan(plan);
+				}
+				else
+					delete plan;
+			}
+			else
+				explainCanvas->SetExplainString(str);
 			outputPane->SetSelection(1);
 		}
 		updateMenu();
@@ -2803,7 +3111,11 @@ void frmQuery::OnTimer(wxTimerEvent &event)
 	elapsedQuery = wxGetLocalTimeMillis() - startTimeQuery;
 	SetStatusText(elapsedQuery.ToString() + wxT(" ms"), STATUSPOS_SECS);
 
-	wxString str = sqlResult->GetMessagesAndClear();
+	wxString str;
+	if (scriptRunning && scriptResult)
+		str = scriptResult->GetMessagesAndClear();
+	else
+		str = sqlResult->GetMessagesAndClear();
 	if (!str.IsEmpty())
 	{
 		msgResult->AppendText(str + wxT("\n"));
@@ -2955,114 +3267,117 @@ wxColour frmQuery::GetServerColour(pgConn *connection)
 	return tmp;
 }
 
-void frmQuery::LoadQueries()
+// Most matches listed when searching the history
+#define MAX_HISTORY_MATCHES 500
+
+// The combo box shows the queries without returns
+static wxString HistoryItem(const wxString &query)
 {
-	xmlDocPtr doc;
-	xmlNodePtr cur;
-	xmlChar *key;
+	wxString tmp = query;
+	tmp.Replace(wxT("\n"), wxT(" "));
+	tmp.Replace(wxT("\r"), wxT(" "));
+	return tmp;
+}
 
-	if (!wxFile::Access(settings->GetHistoryFile(), wxFile::read))
-		return;
+void frmQuery::FillHistory()
+{
+	wxString filter = txtHistoryFilter->GetValue();
+	filter.Trim(true).Trim(false);
 
-	doc = xmlParseFile((const char *)settings->GetHistoryFile().mb_str(wxConvUTF8));
-	if (doc == NULL)
-	{
-		wxMessageBox(_("Failed to load the history file!"));
-		::wxRemoveFile(settings->GetHistoryFile());
-		return;
-	}
+	histoQueries.Clear();
+	if (filter.IsEmpty())
+		queryHistory->GetQueries(histoQueries);
+	else
+		queryHistory->Search(filter, histoQueries, MAX_HISTORY_MATCHES);
 
-	cur = xmlDocGetRootElement(doc);
-	if (cur == NULL)
-	{
-		xmlFreeDoc(doc);
-		return;
-	}
+	wxArrayString items;
+	items.Alloc(histoQueries.GetCount());
+	size_t i;
+	for (i = 0 ; i < histoQueries.GetCount() ; i++)
+		items.Add(HistoryItem(histoQueries.Item(i)));
 
-	if (xmlStrcmp(cur->name, (const xmlChar *) "histoqueries"))
+	sqlQueries->Freeze();
+	sqlQueries->Clear();
+	sqlQueries->Append(items);
+	sqlQueries->SetValue(wxT(""));
+	sqlQueries->Thaw();
+
+	btnDeleteCurrent->Enable(false);
+	btnDeleteAll->Enable(queryHistory->GetCount() > 0);
+}
+
+
+// Only the entry that changed is updated, the whole list is built again
+// when the filter changes or the history was cleared
+void frmQuery::OnHistoryChanged(wxCommandEvent &event)
+{
+	switch (event.GetInt())
 	{
-		wxMessageBox(_("Failed to load the history file!"));
-		xmlFreeDoc(doc);
-		::wxRemoveFile(settings->GetHistoryFile());
-		return;
+		case QUERYHISTORY_ADDED:
+			HistoryAdded(event.GetString());
+			break;
+		case QUERYHISTORY_REMOVED:
+			HistoryRemoved(event.GetString());
+			break;
+		default:
+			FillHistory();
+			break;
 	}
+}
 
-	cur = cur->xmlChildrenNode;
-	while (cur != NULL)
-	{
-		if ((!xmlStrcmp(cur->name, (const xmlChar *)"histoquery")))
-		{
-			key = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
 
-			if (key)
-			{
-				if (WXSTRING_FROM_XML(key) != wxT(""))
-				{
-					wxString query = WXSTRING_FROM_XML(key);
-					wxString tmp = query;
-					tmp.Replace(wxT("\n"), wxT(" "));
-					tmp.Replace(wxT("\r"), wxT(" "));
-					sqlQueries->Append(tmp);
-					histoQueries.Add(query);
-				}
-				xmlFree(key);
-			}
-		}
+void frmQuery::HistoryAdded(const wxString &query)
+{
+	wxString filter = txtHistoryFilter->GetValue();
+	filter.Trim(true).Trim(false);
 
-		cur = cur->next;
-	}
+	if (!filter.IsEmpty() && !sysQueryHistory::Matches(filter, query))
+		return;
 
-	xmlFreeDoc(doc);
+	// A repeated query moves away from its old place
+	HistoryRemoved(query);
 
-	// Make sure only the maximum query number is enforced
-	if (sqlQueries->GetCount() > (unsigned int)settings->GetHistoryMaxQueries())
+	// The full history is listed oldest first, matches newest first
+	if (filter.IsEmpty())
 	{
-		while (sqlQueries->GetCount() > (unsigned int)settings->GetHistoryMaxQueries())
+		histoQueries.Add(query);
+		sqlQueries->Append(HistoryItem(query));
+	}
+	else
+	{
+		histoQueries.Insert(query, 0);
+		sqlQueries->Insert(HistoryItem(query), 0);
+
+		if (histoQueries.GetCount() > MAX_HISTORY_MATCHES)
 		{
-			histoQueries.RemoveAt(0);
-			sqlQueries->Delete(0);
+			histoQueries.RemoveAt(MAX_HISTORY_MATCHES);
+			sqlQueries->Delete(MAX_HISTORY_MATCHES);
 		}
-		SaveQueries();
 	}
 
-	return;
+	btnDeleteAll->Enable(true);
 }
 
 
-void frmQuery::SaveQueries()
+void frmQuery::HistoryRemoved(const wxString &query)
 {
-	size_t i;
-	xmlTextWriterPtr writer;
-
-	writer = xmlNewTextWriterFilename((const char *)settings->GetHistoryFile().mb_str(wxConvUTF8), 0);
-	if (!writer)
+	int n = histoQueries.Index(query);
+	if (n != wxNOT_FOUND)
 	{
-		wxMessageBox(_("Failed to write to history file!"));
-		return;
-	}
-	xmlTextWriterSetIndent(writer, 1);
+		if (n == sqlQueries->GetSelection())
+			btnDeleteCurrent->Enable(false);
 
-	if ((xmlTextWriterStartDocument(writer, NULL, "UTF-8", NULL) < 0) ||
-	        (xmlTextWriterStartElement(writer, XML_STR("histoqueries")) < 0))
-	{
-		wxMessageBox(_("Failed to write to history file!"));
-		xmlFreeTextWriter(writer);
-		return;
+		histoQueries.RemoveAt(n);
+		sqlQueries->Delete(n);
 	}
 
-	for (i = 0; i < histoQueries.GetCount(); i++)
-	{
-		xmlTextWriterStartElement(writer, XML_STR("histoquery"));
-		xmlTextWriterWriteString(writer, XML_FROM_WXSTRING(histoQueries.Item(i)));
-		xmlTextWriterEndElement(writer);
-	}
+	btnDeleteAll->Enable(queryHistory->GetCount() > 0);
+}
 
-	if (xmlTextWriterEndDocument(writer) < 0)
-	{
-		wxMessageBox(_("Failed to write to history file!"));
-	}
 
-	xmlFreeTextWriter(writer);
+void frmQuery::OnHistoryFilter(wxCommandEvent &event)
+{
+	FillHistory();
 }
 
 
@@ -3079,7 +3394,7 @@ void frmQuery::OnChangeQuery(wxCommandEvent &event)
 		SetLineEndingStyle();
 		btnDeleteCurrent->Enable(true);
 	}
-	btnDeleteAll->Enable(sqlQueries->GetCount() > 0);
+	btnDeleteAll->Enable(queryHistory->GetCount() > 0);
 }
 
 
@@ -3091,12 +3406,8 @@ void frmQuery::OnDeleteCurrent(wxCommandEvent &event)
 	                     _("Confirm deletion"),
 	                     wxYES_NO | wxNO_DEFAULT | wxICON_EXCLAMATION).ShowModal() == wxID_YES )
 	{
-		histoQueries.RemoveAt(sqlQueries->GetSelection());
-		sqlQueries->Delete(sqlQueries->GetSelection());
-		sqlQueries->SetValue(wxT(""));
-		btnDeleteCurrent->Enable(false);
-		btnDeleteAll->Enable(sqlQueries->GetCount() > 0);
-		SaveQueries();
+		// The history tells every query tool, this one included
+		queryHistory->Remove(histoQueries.Item(sqlQueries->GetSelection()));
 	}
 }
 
@@ -3109,12 +3420,7 @@ void frmQuery::OnDeleteAll(wxCommandEvent &event)
 	                     _("Confirm deletion"),
 	                     wxYES_NO | wxNO_DEFAULT | wxICON_EXCLAMATION).ShowModal() == wxID_YES )
 	{
-		histoQueries.Clear();
-		sqlQueries->Clear();
-		sqlQueries->SetValue(wxT(""));
-		btnDeleteCurrent->Enable(false);
-		btnDeleteAll->Enable(false);
-		SaveQueries();
+		queryHistory->Clear();
 	}
 }
 
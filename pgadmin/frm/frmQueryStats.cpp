@@ -0,0 +1,180 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// frmQueryStats.cpp - Connection diagnostics window
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "pgAdmin3.h"
+
+// wxWindows headers
+#include <wx/wx.h>
+
+// App headers
+#include "frm/frmMain.h"
+#include "frm/frmQueryStats.h"
+#include "ctl/ctlListView.h"
+#include "db/pgQueryStats.h"
+
+// Icons
+#include "images/statistics.pngc"
+
+// Number of statements shown
+#define QUERYSTATS_TOP  100
+
+
+enum
+{
+	CTL_STATSSUBSYSTEM = 1000,
+	CTL_STATSREFRESH,
+	CTL_STATSRESET
+};
+
+
+BEGIN_EVENT_TABLE(frmQueryStats, pgFrame)
+	EVT_CHOICE(CTL_STATSSUBSYSTEM,          frmQueryStats::OnRefresh)
+	EVT_BUTTON(CTL_STATSREFRESH,            frmQueryStats::OnRefresh)
+	EVT_BUTTON(CTL_STATSRESET,              frmQueryStats::OnReset)
+	EVT_CLOSE(                              frmQueryStats::OnClose)
+END_EVENT_TABLE()
+
+
+frmQueryStats::frmQueryStats(frmMain *form) : pgFrame(NULL, _("Connection Diagnostics"))
+{
+	dlgName = wxT("frmQueryStats");
+	mainForm = form;
+
+	SetIcon(*statistics_png_ico);
+
+	wxPanel *panel = new wxPanel(this);
+
+	cbSubsystem = new wxChoice(panel, CTL_STATSSUBSYSTEM);
+	cbSubsystem->Append(_("All"));
+	int sub;
+	for (sub = 0 ; sub < PGCONN_SUB_COUNT ; sub++)
+		cbSubsystem->Append(pgQueryStats::GetSubsystemName(sub));
+	cbSubsystem->SetSelection(0);
+
+	wxBoxSizer *top = new wxBoxSizer(wxHORIZONTAL);
+	top->Add(new wxStaticText(panel, wxID_ANY, _("Subsystem")), 0, wxALIGN_CENTER_VERTICAL | wxALL, 5);
+	top->Add(cbSubsystem, 0, wxALIGN_CENTER_VERTICAL | wxALL, 5);
+	top->AddStretchSpacer();
+	top->Add(new wxButton(panel, CTL_STATSREFRESH, _("&Refresh")), 0, wxALL, 5);
+	top->Add(new wxButton(panel, CTL_STATSRESET, _("R&eset")), 0, wxALL, 5);
+
+	lstStatements = new ctlListView(panel, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxSUNKEN_BORDER | wxLC_REPORT | wxLC_SINGLE_SEL);
+	lstStatements->AddColumn(_("Subsystem"), 90);
+	lstStatements->AddColumn(_("Calls"), 60, wxLIST_FORMAT_RIGHT);
+	lstStatements->AddColumn(_("Total (ms)"), 80, wxLIST_FORMAT_RIGHT);
+	lstStatements->AddColumn(_("Average (ms)"), 80, wxLIST_FORMAT_RIGHT);
+	lstStatements->AddColumn(_("Max (ms)"), 70, wxLIST_FORMAT_RIGHT);
+	lstStatements->AddColumn(_("Rows"), 70, wxLIST_FORMAT_RIGHT);
+	lstStatements->AddColumn(_("Bytes"), 80, wxLIST_FORMAT_RIGHT);
+	lstStatements->AddColumn(_("Statement"), 600);
+
+	lstHistogram = new ctlListView(panel, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxSUNKEN_BORDER | wxLC_REPORT | wxLC_SINGLE_SEL);
+	lstHistogram->AddColumn(_("Latency"), 120);
+	lstHistogram->AddColumn(_("Calls"), 80, wxLIST_FORMAT_RIGHT);
+	lstHistogram->AddColumn(_("Percent"), 70, wxLIST_FORMAT_RIGHT);
+
+	wxBoxSizer *sizer = new wxBoxSizer(wxVERTICAL);
+	sizer->Add(top, 0, wxEXPAND);
+	sizer->Add(lstStatements, 3, wxEXPAND | wxLEFT | wxRIGHT, 5);
+	sizer->Add(lstHistogram, 2, wxEXPAND | wxALL, 5);
+	panel->SetSizer(sizer);
+
+	RestorePosition(-1, -1, 800, 600, 400, 300);
+
+	FillLists();
+}
+
+
+frmQueryStats::~frmQueryStats()
+{
+	if (mainForm)
+		mainForm->RemoveFrame(this);
+}
+
+
+void frmQueryStats::FillLists()
+{
+	int subsystem = cbSubsystem->GetSelection() - 1;
+
+	pgQueryStatsArray entries;
+	pgQueryStats::GetTopEntries(entries, subsystem, QUERYSTATS_TOP);
+
+	lstStatements->Freeze();
+	lstStatements->DeleteAllItems();
+
+	size_t i;
+	for (i = 0 ; i < entries.GetCount() ; i++)
+	{
+		const pgQueryStatsEntry &entry = entries.Item(i);
+
+		long pos = lstStatements->InsertItem(i, pgQueryStats::GetSubsystemName(entry.subsystem));
+		lstStatements->SetItem(pos, 1, NumToStr(entry.calls));
+		lstStatements->SetItem(pos, 2, wxString::Format(wxT("%.0f"), entry.totalTime));
+		lstStatements->SetItem(pos, 3, wxString::Format(wxT("%.1f"), entry.totalTime / entry.calls));
+		lstStatements->SetItem(pos, 4, wxString::Format(wxT("%.0f"), entry.maxTime));
+		lstStatements->SetItem(pos, 5, wxString::Format(wxT("%.0f"), entry.rows));
+		lstStatements->SetItem(pos, 6, wxString::Format(wxT("%.0f"), entry.bytes));
+		lstStatements->SetItem(pos, 7, entry.sql);
+	}
+	lstStatements->Thaw();
+
+	long counts[PGSTATS_BUCKETS];
+	pgQueryStats::GetHistogram(subsystem, counts);
+
+	long total = 0;
+	int bucket;
+	for (bucket = 0 ; bucket < PGSTATS_BUCKETS ; bucket++)
+		total += counts[bucket];
+
+	lstHistogram->Freeze();
+	lstHistogram->DeleteAllItems();
+	for (bucket = 0 ; bucket < PGSTATS_BUCKETS ; bucket++)
+	{
+		long pos = lstHistogram->InsertItem(bucket, pgQueryStats::GetBucketName(bucket));
+		lstHistogram->SetItem(pos, 1, NumToStr(counts[bucket]));
+		if (total)
+			lstHistogram->SetItem(pos, 2, wxString::Format(wxT("%.1f"), counts[bucket] * 100.0 / total));
+	}
+	lstHistogram->Thaw();
+}
+
+
+void frmQueryStats::OnRefresh(wxCommandEvent &ev)
+{
+	FillLists();
+}
+
+
+void frmQueryStats::OnReset(wxCommandEvent &ev)
+{
+	pgQueryStats::Reset();
+	FillLists();
+}
+
+
+void frmQueryStats::OnClose(wxCloseEvent &ev)
+{
+	Destroy();
+}
+
+
+queryStatsFactory::queryStatsFactory(menuFactoryList *list, wxMenu *mnu, ctlMenuToolbar *toolbar) : actionFactory(list)
+{
+	mnu->Append(id, _("Connection &Diagnostics"), _("Show the queries pgAdmin has executed and how long they took."));
+}
+
+
+wxWindow *queryStatsFactory::StartDialog(frmMain *form, pgObject *obj)
+{
+	frmQueryStats *frm = new frmQueryStats(form);
+	frm->Show();
+	return frm;
+}
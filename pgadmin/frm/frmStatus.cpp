@@ -28,6 +28,7 @@
 #include "frm/frmHint.h"
 #include "frm/frmMain.h"
 #include "db/pgConn.h"
+#include "db/pgConnPool.h"
 #include "frm/frmQuery.h"
 #include "utils/pgfeatures.h"
 #include "schema/pgServer.h"
@@ -183,6 +184,7 @@ frmStatus::frmStatus(frmMain *form, const wxString &_title, pgConn *conn) : pgFr
 	mainForm = form;
 	connection = conn;
 	locks_connection = conn;
+	connection->SetSubsystem(PGCONN_SUB_STATUS);
 
 	statusTimer = 0;
 	locksTimer = 0;
@@ -431,7 +433,7 @@ frmStatus::~frmStatus()
 	if (connection)
 	{
 		if (connection->IsAlive())
-			delete connection;
+			pgConnPool::Release(connection);
 	}
 }
 
@@ -499,6 +501,7 @@ void frmStatus::OnChangeDatabase(wxCommandEvent &ev)
 	                              connection->GetUser(), connection->GetPassword(), connection->GetPort(), connection->GetRole(), connection->GetSslMode(),
 	                              0, connection->GetApplicationName(), connection->GetSSLCert(), connection->GetSSLKey(), connection->GetSSLRootCert(), connection->GetSSLCrl(),
 	                              connection->GetSSLCompression());
+	locks_connection->SetSubsystem(PGCONN_SUB_STATUS);
 
 	pgUser *user = new pgUser(locks_connection->GetUser());
 	if (user)
@@ -1781,7 +1784,7 @@ void frmStatus::OnRefreshLogTimer(wxTimerEvent &event)
 	if (isCurrent)
 	{
 		// check if the current logfile changed
-		pgSet *set = connection->ExecuteSet(wxT("SELECT pg_file_length(") + connection->qtDbString(logfileName) + wxT(") AS len"));
+		pgSet *set = connection->ExecuteSet(wxT("SELECT pg_file_length(") + connection->qtDbString(logfileName) + wxT(") AS len"), true);
 		if (set)
 		{
 			newlen = set->GetLong(wxT("len"));
@@ -2416,7 +2419,7 @@ int frmStatus::fillLogfileCombo()
 	pgSet *set = connection->ExecuteSet(
 	                 wxT("SELECT filename, filetime\n")
 	                 wxT("  FROM pg_logdir_ls() AS A(filetime timestamp, filename text)\n")
-	                 wxT(" ORDER BY filetime DESC"));
+	                 wxT(" ORDER BY filetime DESC"), true);
 	if (set)
 	{
 		if (set->NumRows() <= count)
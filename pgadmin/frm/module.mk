@@ -30,6 +30,7 @@ pgadmin3_SOURCES += \
 	frm/frmPassword.cpp \
 	frm/frmPgpassConfig.cpp \
 	frm/frmQuery.cpp \
+	frm/frmQueryStats.cpp \
 	frm/frmReport.cpp \
 	frm/frmRestore.cpp \
 	frm/frmSplash.cpp \
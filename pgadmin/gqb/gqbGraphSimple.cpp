@@ -49,13 +49,58 @@ gqbGraphSimple::gqbGraphSimple()
 
 // NOTES:(1) store values of width & height at queryTable.
 // (2)Need to set a font for the device context before get font metrics with GetTextExtent
+// (3)Table is drawn once to a bitmap kept at queryTable, and the bitmap is reused until
+// the table shows something different (selection, alias or selected columns)
 void gqbGraphSimple::drawTable(wxMemoryDC &bdc, wxPoint *origin, gqbQueryObject *queryTable)
 {
+	wxString state = getTableState(queryTable);
 
+	if(!queryTable->cachedImage.Ok() || queryTable->cachedState != state)
+	{
+		int width, height;
+		measureTable(bdc, queryTable, width, height);
+
+		wxBitmap image(width + 2, height + 2);
+		wxMemoryDC imageDC;
+		imageDC.SelectObject(image);
+		wxPoint imageOrigin(0, 0);
+		paintTable(imageDC, &imageOrigin, queryTable, width, height);
+		imageDC.SelectObject(wxNullBitmap);
+
+		queryTable->cachedImage = image;
+		queryTable->cachedState = state;
+	}
+
+	bdc.DrawBitmap(queryTable->cachedImage, origin->x, origin->y, false);
+}
+
+
+// Everything that changes the way a table looks
+wxString gqbGraphSimple::getTableState(gqbQueryObject *queryTable)
+{
+	wxString state = queryTable->getSelected() ? wxT("1") : wxT("0");
+
+	gqbIteratorBase *iterator = queryTable->parent->createColumnsIterator();
+	while(iterator->HasNext())
+	{
+		gqbColumn *tmp = (gqbColumn *)iterator->Next();
+		state += queryTable->existsColumn(tmp) ? wxT("1") : wxT("0");
+	}
+	delete iterator;
+
+	return state + queryTable->getAlias();
+}
+
+
+// Set table Size in ObjectModel (Temporary Values for object representation,
+// and for this reason the view can modified model without using the controller
+// because this values are used by controller when use object's size in internal operations)
+void gqbGraphSimple::measureTable(wxMemoryDC &bdc, gqbQueryObject *queryTable, int &width, int &height)
+{
 #if wxCHECK_VERSION(2, 9, 0)
-	wxCoord  w = 0, h = 0, height = 0, width = 0, margin = 5;
+	wxCoord  w = 0, h = 0;
 #else
-	long  w = 0, h = 0, height = 0, width = 0, margin = 5;
+	long  w = 0, h = 0;
 #endif
 
 	// Get Value for row Height
@@ -68,7 +113,7 @@ void gqbGraphSimple::drawTable(wxMemoryDC &bdc, wxPoint *origin, gqbQueryObject
 
 	// Get Title Metrics
 	bdc.SetFont(TableTitleFont);
-	height += rowHeight + rowTopMargin;
+	height = rowHeight + rowTopMargin;
 
 	// Calculate font metrics for table title with/without alias
 	if(queryTable->getAlias().length() > 0)
@@ -90,12 +135,8 @@ void gqbGraphSimple::drawTable(wxMemoryDC &bdc, wxPoint *origin, gqbQueryObject
 		if((rowLeftMargin + w + rowRightMargin) > width)
 			width = rowLeftMargin + w + rowRightMargin;
 	}
+	delete iterator;
 
-	//Don't delete iterator because will be use below;
-
-	// Set table Size in ObjectModel (Temporary Values for object representation,
-	// and for this reason the view can modified model without using the controller
-	// because this values are used by controller when use object's size in internal operations)
 	if( (height + 2) < minTableHeight) // +2 from BackgroundLayers addition
 	{
 		queryTable->setHeight(minTableHeight);
@@ -111,6 +152,12 @@ void gqbGraphSimple::drawTable(wxMemoryDC &bdc, wxPoint *origin, gqbQueryObject
 	}
 	else
 		queryTable->setWidth(width + 2);
+}
+
+
+void gqbGraphSimple::paintTable(wxDC &bdc, wxPoint *origin, gqbQueryObject *queryTable, int width, int height)
+{
+	int margin = 5;
 
 	//Decorate Table
 	bdc.SetPen(*wxTRANSPARENT_PEN);
@@ -150,7 +197,7 @@ void gqbGraphSimple::drawTable(wxMemoryDC &bdc, wxPoint *origin, gqbQueryObject
 
 	// Draw Columns
 	height = rowHeight + rowTopMargin;
-	iterator->ResetIterator();
+	gqbIteratorBase *iterator = queryTable->parent->createColumnsIterator();
 	while(iterator->HasNext())
 	{
 		gqbColumn *tmp = (gqbColumn *)iterator->Next();
@@ -169,8 +216,7 @@ void gqbGraphSimple::drawTable(wxMemoryDC &bdc, wxPoint *origin, gqbQueryObject
 		bdc.SetTextForeground( *wxBLACK);
 		height += rowHeight + rowTopMargin;
 	}
-	delete iterator;                              //now if delete because it's not needed anymore
-
+	delete iterator;
 }
 
 
@@ -283,6 +329,10 @@ void gqbGraphSimple::drawJoin(wxMemoryDC &bdc, wxPoint &origin, wxPoint &dest, w
 bool gqbGraphSimple::clickOnJoin(gqbQueryJoin *join, wxPoint &pt, wxPoint &origin, wxPoint &dest)
 {
 
+	// Most joins are far from the point, discard them without measuring distances
+	if(!getJoinBounds(origin, dest).Contains(pt))
+		return false;
+
 	wxPoint origin2 = origin;
 	wxPoint dest2 = dest;
 
@@ -320,6 +370,24 @@ bool gqbGraphSimple::clickOnJoin(gqbQueryJoin *join, wxPoint &pt, wxPoint &origi
 }
 
 
+// Tables are drawn with a shadow two pixels wide at the right and the bottom
+wxRect gqbGraphSimple::getTableBounds(gqbQueryObject *queryTable)
+{
+	return wxRect(queryTable->position, wxSize(queryTable->getWidth() + 2, queryTable->getHeight() + 2));
+}
+
+
+// Joins go out 20 pixels from both anchors, and have the kind of join written at the middle
+wxRect gqbGraphSimple::getJoinBounds(wxPoint &origin, wxPoint &dest)
+{
+	int left = wxMin(origin.x, dest.x), right = wxMax(origin.x, dest.x);
+	int top = wxMin(origin.y, dest.y), bottom = wxMax(origin.y, dest.y);
+	int margin = 20 + rowHeight + lineClickThreshold;
+
+	return wxRect(left - margin, top - margin, right - left + 2 * margin, bottom - top + 2 * margin);
+}
+
+
 bool gqbGraphSimple::insideLine(wxPoint &pt, wxPoint &p1, wxPoint &p2, int threshold = 7)
 {
 	bool value = false;
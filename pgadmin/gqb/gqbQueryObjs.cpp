@@ -79,6 +79,8 @@ gqbQueryObject::gqbQueryObject(gqbTable *table)
 {
 	selected = false;
 	parent = table;
+	width = 0;
+	height = 0;
 
 	//GQB-TODO: Calculate a good initial position
 	position.x = 20;
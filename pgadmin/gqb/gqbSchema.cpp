@@ -45,6 +45,7 @@ void gqbSchema::createTables(gqbBrowser *tablesBrowser, wxTreeItemId parentNode,
 
 	pgSet *tables = conn->ExecuteSet(query);
 	wxTreeItemId parent;
+	gqbTablesOidMap tablesByOid;
 
 	if (tables)
 	{
@@ -70,9 +71,8 @@ void gqbSchema::createTables(gqbBrowser *tablesBrowser, wxTreeItemId parentNode,
 				parent = tablesBrowser->AppendItem(parentNode, tables->GetVal(wxT("relname")), xTableImage, xTableImage, table);
 			}
 
-			// Create columns inside this table.
 			if (table)
-				table->createObjects(tablesBrowser, conn, tables->GetOid(wxT("oid")), parent);
+				tablesByOid[table->getOid()] = table;
 
 			tables->MoveNext();
 		}
@@ -80,5 +80,42 @@ void gqbSchema::createTables(gqbBrowser *tablesBrowser, wxTreeItemId parentNode,
 		delete tables;
 	}
 
+	if (!tablesByOid.empty())
+		createColumns(tablesByOid, oidVal);
+
 	tablesBrowser->SortChildren(parentNode);
 }
+
+
+// Columns of all the relations of the schema are read with a single query,
+// ordered by relation so each table takes its own rows in turn.
+void gqbSchema::createColumns(gqbTablesOidMap &tablesByOid, OID oidVal)
+{
+	wxString systemRestriction;
+	if (!settings->GetShowSystemObjects())
+		systemRestriction = wxT("\n   AND attnum > 0");
+
+	wxString sql =
+	    wxT("SELECT attrelid, attname FROM pg_attribute att\n")
+	    wxT("  JOIN pg_class cl ON cl.oid = att.attrelid\n")
+	    wxT(" WHERE cl.relnamespace = ") + NumToStr(oidVal) + wxT("\n")
+	    wxT("   AND cl.relkind IN ('r','v','x')")
+	    + systemRestriction + wxT("\n")
+	    wxT("   AND attisdropped IS FALSE\n")
+	    wxT(" ORDER BY attrelid, attnum");
+
+	pgSet *columns = conn->ExecuteSet(sql);
+	if (columns)
+	{
+		while (!columns->Eof())
+		{
+			gqbTablesOidMap::iterator it = tablesByOid.find(columns->GetOid(0));
+			if (it != tablesByOid.end())
+				it->second->createColumns(columns);
+			else
+				columns->MoveNext();
+		}
+
+		delete columns;
+	}
+}
@@ -40,44 +40,17 @@ void gqbTable::addColumn(gqbColumn *column)
 }
 
 
-void gqbTable::createObjects(gqbBrowser *_tablesBrowser,  pgConn *_conn, OID oidVal,  wxTreeItemId parentNode)
+// Adds the columns at the current row of the set and the following ones,
+// while they belong to this table. The set has the relation oid as first
+// column and the column name as second one.
+void gqbTable::createColumns(pgSet *columns)
 {
-	createColumns(_conn, _tablesBrowser, parentNode, oidVal);
-}
-
-void gqbTable::createColumns(pgConn *conn, gqbBrowser *tablesBrowser, wxTreeItemId parentNode,  OID oidVal)
-{
-
-	wxString systemRestriction;
-	if (!settings->GetShowSystemObjects())
-		systemRestriction = wxT("\n   AND attnum > 0");
-
-	wxString sql =
-	    wxT("SELECT attname FROM pg_attribute att\n")
-	    wxT(" WHERE attrelid = ")
-	    + NumToStr(oidVal)
-	    + systemRestriction + wxT("\n")
-	    wxT("   AND attisdropped IS FALSE\n")
-	    wxT(" ORDER BY attnum");
-
-	pgSet *columns = conn->ExecuteSet(sql);
-	if (columns)
+	OID oidVal = getOid();
+	while (!columns->Eof() && columns->GetOid(0) == oidVal)
 	{
-		while (!columns->Eof())
-		{
-			if (tablesBrowser)
-			{
-				//Disable, Column SHOULDN'T be added to tree only use for debug purposes tablesBrowser->AppendItem(parentNode, columns->GetVal(wxT("attname")) , -1, -1);
-				wxString tmpname = wxString(columns->GetVal(wxT("attname")));
-				gqbColumn *column = new gqbColumn(this, tmpname, conn);
-				this->addColumn(column);
-				columns->MoveNext();
-			}
-			else
-				break;
-		}
-
-		delete columns;
+		gqbColumn *column = new gqbColumn(this, columns->GetVal(1), conn);
+		this->addColumn(column);
+		columns->MoveNext();
 	}
 }
 
@@ -142,8 +142,9 @@ void gqbView::onEraseBackGround(wxEraseEvent &event)
 void gqbView::onPaint(wxPaintEvent &event)
 {
 	wxPaintDC dcc(this);                          // Prepare Context for Buffered Draw
-	wxBufferedDC dc(&dcc, canvasSize);
-	drawAll(dc, true);                            // Call Function to draw all
+	wxBufferedDC dc(&dcc, GetClientSize());
+	wxRect damaged = GetUpdateRegion().GetBox();
+	drawAll(dc, true, &damaged);                  // Call Function to draw all inside damaged area
 }
 
 
@@ -301,6 +302,7 @@ void gqbView::onMotion(wxMouseEvent &event)
 {
 	static int refresh = 1;                       // refresh counter, everytime this values reaches
 	// "refreshRate" value then Refresh while dragging
+	wxPoint lastPos = pos;
 	// Discover area where event ocurrs
 	pos.x = event.GetPosition().x;
 	pos.y = event.GetPosition().y;
@@ -499,13 +501,16 @@ void gqbView::onMotion(wxMouseEvent &event)
 				// GQB-TODO: same as gqbGraphBehavior.h [find a way to not hard code the 17 default value]
 				if((pos.x > collectionSelected->position.x + 17) || (pos.x < collectionSelected->position.x) )
 				{
+					dragDamage.Union(getTableDamage(collectionSelected));
 					graphBehavior->UpdatePosObject(collectionSelected, pos.x, pos.y, 40);
+					dragDamage.Union(getTableDamage(collectionSelected));
 				}
 
 				// Don't draw too much when dragging table around canvas [lower cpu use]
 				if(refresh % refreshRate == 0)
 				{
-					this->Refresh();
+					refreshModelRect(dragDamage);
+					dragDamage = wxRect();
 					refresh = 1;
 				}
 				else
@@ -517,7 +522,10 @@ void gqbView::onMotion(wxMouseEvent &event)
 		{
 			if(joinSource && !joinDest)
 			{
-				this->Refresh();
+				// Temporary join line is drawn from jpos to the pointer
+				wxRect lineDamage = graphBehavior->getJoinBounds(jpos, lastPos);
+				lineDamage.Union(graphBehavior->getJoinBounds(jpos, pos));
+				refreshModelRect(lineDamage);
 			}
 
 		}
@@ -548,8 +556,17 @@ void gqbView::OnKeyDown(wxKeyEvent &event)
 }
 
 
-void gqbView::drawAll(wxMemoryDC &bdc, bool adjustScrolling)
+// When damaged is given (in scrolled coordinates) only the tables and joins
+// inside it are drawn
+void gqbView::drawAll(wxMemoryDC &bdc, bool adjustScrolling, wxRect *damaged)
 {
+	wxRect area;
+	if (damaged)
+	{
+		area = *damaged;
+		this->CalcUnscrolledPosition(area.x, area.y, &area.x, &area.y);
+	}
+
 	bdc.Clear();
 	if(!iterator)
 		// Get an iterator for the objects (tables/views) in the model.
@@ -561,6 +578,11 @@ void gqbView::drawAll(wxMemoryDC &bdc, bool adjustScrolling)
 	while(iterator->HasNext())
 	{
 		gqbQueryObject *tmp = (gqbQueryObject *)iterator->Next();
+
+		// Tables not drawn yet have no size, they are always drawn to get it
+		if (damaged && tmp->getWidth() > 0 && !area.Intersects(graphBehavior->getTableBounds(tmp)))
+			continue;
+
 		wxPoint pt = wxPoint(tmp->position);      // Use a copy because I don't want to store the modified
 		// version of point after CalcScrolledPosition was called
 
@@ -587,6 +609,9 @@ void gqbView::drawAll(wxMemoryDC &bdc, bool adjustScrolling)
 				wxPoint o = join->getSourceAnchor();
 				wxPoint d = join->getDestAnchor();
 
+				if (damaged && !area.Intersects(graphBehavior->getJoinBounds(o, d)))
+					continue;
+
 				if (adjustScrolling)
 				{
 					// adjust coordinates origin
@@ -618,6 +643,48 @@ void gqbView::drawAll(wxMemoryDC &bdc, bool adjustScrolling)
 }
 
 
+// Area of the model covered by a table and all the joins that start or end at it
+wxRect gqbView::getTableDamage(gqbQueryObject *queryTable)
+{
+	wxRect damage = graphBehavior->getTableBounds(queryTable);
+
+	if (queryTable->getHaveJoins())
+	{
+		gqbIteratorBase *j = queryTable->createJoinsIterator();
+		while (j->HasNext())
+		{
+			gqbQueryJoin *tmp = (gqbQueryJoin *)j->Next();
+			damage.Union(graphBehavior->getJoinBounds(tmp->getSourceAnchor(), tmp->getDestAnchor()));
+		}
+		delete j;
+	}
+
+	if (queryTable->getHaveRegJoins())
+	{
+		gqbIteratorBase *r = queryTable->createRegJoinsIterator();
+		while (r->HasNext())
+		{
+			gqbQueryJoin *tmp = (gqbQueryJoin *)r->Next();
+			damage.Union(graphBehavior->getJoinBounds(tmp->getSourceAnchor(), tmp->getDestAnchor()));
+		}
+		delete r;
+	}
+
+	return damage;
+}
+
+
+void gqbView::refreshModelRect(const wxRect &area)
+{
+	if (area.IsEmpty())
+		return;
+
+	wxRect scrolled = area;
+	this->CalcScrolledPosition(scrolled.x, scrolled.y, &scrolled.x, &scrolled.y);
+	RefreshRect(scrolled, false);
+}
+
+
 void gqbView::setPointerMode(pointerMode pm)
 {
 	mode = pm;
@@ -21,6 +21,10 @@
 #include "hotdraw/utilities/hdArrayCollection.h"
 #include "hotdraw/utilities/hdRect.h"
 #include "hotdraw/figures/hdIFigure.h"
+#include "hotdraw/handles/hdIHandle.h"
+
+//Space around a figure display box that its drawing can use (line terminals)
+#define HD_EXTENT_MARGIN 16
 
 
 hdDrawing::hdDrawing(hdDrawingEditor *owner)
@@ -30,6 +34,8 @@ hdDrawing::hdDrawing(hdDrawingEditor *owner)
 	usedView = NULL;
 	ownerEditor = owner;
 	drawingName = wxEmptyString;
+	indexPosIdx = -1;
+	indexValid = false;
 }
 
 hdDrawing::~hdDrawing()
@@ -57,6 +63,7 @@ void hdDrawing::add(hdIFigure *figure)
 {
 	if(figures)
 		figures->addItem(figure);
+	invalidateIndex();
 }
 
 void hdDrawing::remove(hdIFigure *figure)
@@ -67,6 +74,7 @@ void hdDrawing::remove(hdIFigure *figure)
 		if(usedView)
 			figure->moveTo(usedView->getIdx(), -1, -1);
 	}
+	invalidateIndex();
 }
 
 bool hdDrawing::includes(hdIFigure *figure)
@@ -78,21 +86,102 @@ bool hdDrawing::includes(hdIFigure *figure)
 
 hdIFigure *hdDrawing::findFigure(int posIdx, int x, int y)
 {
-	hdIFigure *tmp = NULL, *out = NULL;
-	hdIteratorBase *iterator = figures->createIterator();
-	while(iterator->HasNext())
+	hdIFigure *tmp = NULL;
+
+	validateIndex(posIdx);
+
+	//Candidates are sorted by position at collection, same order of a full scan
+	wxArrayInt &candidates = figuresIndex.itemsAt(x, y);
+	for(size_t i = 0; i < candidates.GetCount(); i++)
 	{
-		tmp = (hdIFigure *)iterator->Next();
+		tmp = (hdIFigure *)figures->getItemAt(candidates[i]);
 		if(tmp->containsPoint(posIdx, x, y))
+			return tmp;
+	}
+
+	return NULL;
+}
+
+//Area where a figure is drawn, including handles when selected
+hdRect hdDrawing::figureExtent(int posIdx, hdIFigure *figure)
+{
+	hdRect extent = figure->displayBox().gethdRect(posIdx);
+	extent.Inflate(HD_EXTENT_MARGIN, HD_EXTENT_MARGIN);
+
+	if(figure->isSelected(posIdx))
+	{
+		hdIteratorBase *iterator = figure->handlesEnumerator()->createIterator();
+		while(iterator->HasNext())
+			extent.add(((hdIHandle *)iterator->Next())->getDisplayBox(posIdx));
+		delete iterator;
+	}
+
+	return extent;
+}
+
+//Should be called when figures are added, removed or reordered
+void hdDrawing::invalidateIndex()
+{
+	indexValid = false;
+}
+
+void hdDrawing::validateIndex(int posIdx)
+{
+	if(indexValid && indexPosIdx == posIdx)
+		return;
+
+	hdRectArray extents;
+	hdRect area;
+	int i, count = figures->count();
+	for(i = 0; i < count; i++)
+	{
+		extents.Add(figureExtent(posIdx, (hdIFigure *)figures->getItemAt(i)));
+		if(i == 0)
+			area = extents[i];
+		else
+			area.add(extents[i]);
+	}
+
+	figuresIndex.reset(area);
+	for(i = 0; i < count; i++)
+		figuresIndex.append(extents[i]);
+
+	indexPosIdx = posIdx;
+	indexValid = true;
+}
+
+//Update bounds of figures changed since last call, damaged returns area
+//covered by them before and after the change. If index needs to be built
+//again changes are unknown and false is returned.
+bool hdDrawing::updateIndex(int posIdx, hdRect &damaged)
+{
+	if(!indexValid || indexPosIdx != posIdx || figuresIndex.count() != figures->count())
+	{
+		invalidateIndex();
+		validateIndex(posIdx);
+		return false;
+	}
+
+	bool first = true;
+	damaged = hdRect();
+	int i, count = figures->count();
+	for(i = 0; i < count; i++)
+	{
+		hdRect extent = figureExtent(posIdx, (hdIFigure *)figures->getItemAt(i));
+		hdRect &old = figuresIndex.getBounds(i);
+		if(extent != old)
 		{
-			out = tmp;
-			break;
+			if(first)
+				damaged = old;
+			else
+				damaged.add(old);
+			damaged.add(extent);
+			first = false;
+			figuresIndex.update(i, extent);
 		}
 	}
 
-	delete iterator;;
-
-	return out;
+	return true;
 }
 
 void hdDrawing::recalculateDisplayBox(int posIdx)
@@ -123,6 +212,7 @@ void hdDrawing::bringToFront(hdIFigure *figure)
 	//To bring to front this figure need to be at last position when is draw
 	//because this reason sendToBack (last position) is used.
 	figures->sendToBack(figure);
+	invalidateIndex();
 }
 
 void hdDrawing::sendToBack(hdIFigure *figure)
@@ -130,6 +220,7 @@ void hdDrawing::sendToBack(hdIFigure *figure)
 	//To send to back this figure need to be at first position when is draw
 	//because this reason bringToFront (1st position) is used.
 	figures->bringToFront(figure);
+	invalidateIndex();
 }
 
 hdRect &hdDrawing::DisplayBox()
@@ -158,6 +249,7 @@ void hdDrawing::deleteAllFigures()
 		figures->removeItemAt(0);
 		delete tmp;
 	}
+	invalidateIndex();
 	//handles delete it together with figures
 }
 
@@ -173,6 +265,7 @@ void hdDrawing::removeAllFigures()
 		if(usedView)
 			tmp->moveTo(usedView->getIdx(), -1, -1);
 	}
+	invalidateIndex();
 }
 
 void hdDrawing::deleteSelectedFigures()
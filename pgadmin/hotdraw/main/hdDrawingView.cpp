@@ -91,16 +91,29 @@ hdDrawingView::~hdDrawingView()
 
 void hdDrawingView::onPaint(wxPaintEvent &event)
 {
-	// Prepare Context for Buffered Draw
+	// Prepare Context for Buffered Draw, only visible area is needed because
+	// figures are drawn at scrolled position
 	wxPaintDC dcc(this);
-	wxBufferedDC dc(&dcc, canvasSize);
+	wxBufferedDC dc(&dcc, GetClientSize());
 	dc.Clear();
+
+	// Paint dc is clipped to invalidated area, skip figures outside of it
+	wxRect updateBox = GetUpdateRegion().GetBox();
+	hdRect damaged(updateBox.x, updateBox.y, updateBox.width, updateBox.height);
+	CalcUnscrolledPosition(damaged.x, damaged.y, &damaged.x, &damaged.y);
+
+	// A repaint of whole window follows changes to model made anywhere
+	if(updateBox.Contains(wxRect(wxPoint(0, 0), GetClientSize())))
+		drawing->invalidateIndex();
+
 	hdIFigure *toDraw = NULL;
 	hdIteratorBase *iterator = drawing->figuresEnumerator();
 
 	while(iterator->HasNext())
 	{
 		toDraw = (hdIFigure *)iterator->Next();
+		if(!damaged.Intersects(drawing->figureExtent(diagramIndex, toDraw)))
+			continue;
 		if(toDraw->isSelected(diagramIndex))
 			toDraw->drawSelected(dc, this);
 		else
@@ -246,8 +259,18 @@ void hdDrawingView::onMotion(wxMouseEvent &event)
 		hdMouseEvent ddEvent = hdMouseEvent(event, this);
 		if(event.Dragging())
 		{
+			//only a dragging event on montion will change model, repaint just
+			//the area of figures changed by it
+			hdRect damaged;
+			drawing->validateIndex(diagramIndex);
 			_tool->mouseDrag(ddEvent);
-			this->Refresh();			//only a dragging event on montion will change model
+			if(drawSelRect || !drawing->updateIndex(diagramIndex, damaged))
+				this->Refresh();
+			else if(!damaged.IsEmpty())
+			{
+				CalcScrolledPosition(damaged.x, damaged.y, &damaged.x, &damaged.y);
+				this->RefreshRect(damaged, false);
+			}
 		}
 		else
 		{
@@ -0,0 +1,139 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// hdSpatialIndex.cpp - Grid of figure bounds used to find figures by position
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "pgAdmin3.h"
+
+// wxWindows headers
+#include <wx/wx.h>
+
+// App headers
+#include "hotdraw/utilities/hdSpatialIndex.h"
+
+#include <wx/arrimpl.cpp>
+WX_DEFINE_OBJARRAY(hdRectArray);
+
+// Smallest size of a cell side, and most cells allowed at grid
+#define HD_INDEX_CELLSIZE   128
+#define HD_INDEX_MAXCELLS   4096
+
+hdSpatialIndex::hdSpatialIndex()
+{
+	cellSize = HD_INDEX_CELLSIZE;
+	columns = 0;
+	rows = 0;
+	cells = NULL;
+}
+
+hdSpatialIndex::~hdSpatialIndex()
+{
+	if(cells)
+		delete [] cells;
+}
+
+void hdSpatialIndex::reset(hdRect area)
+{
+	if(cells)
+		delete [] cells;
+	itemsBounds.Clear();
+
+	//Bigger cells for big drawings to keep grid size bounded
+	gridArea = area;
+	cellSize = HD_INDEX_CELLSIZE;
+	do
+	{
+		columns = gridArea.width / cellSize + 1;
+		rows = gridArea.height / cellSize + 1;
+		if(columns * rows > HD_INDEX_MAXCELLS)
+			cellSize *= 2;
+	}
+	while(columns * rows > HD_INDEX_MAXCELLS);
+
+	cells = new wxArrayInt[columns * rows];
+}
+
+void hdSpatialIndex::append(hdRect bounds)
+{
+	int item = itemsBounds.GetCount();
+	itemsBounds.Add(bounds);
+	addToCells(item, bounds);
+}
+
+void hdSpatialIndex::update(int item, hdRect bounds)
+{
+	if(itemsBounds[item] == bounds)
+		return;
+
+	removeFromCells(item, itemsBounds[item]);
+	itemsBounds[item] = bounds;
+	addToCells(item, bounds);
+}
+
+hdRect &hdSpatialIndex::getBounds(int item)
+{
+	return itemsBounds[item];
+}
+
+int hdSpatialIndex::count()
+{
+	return itemsBounds.GetCount();
+}
+
+wxArrayInt &hdSpatialIndex::itemsAt(int x, int y)
+{
+	return cells[cellRow(y) * columns + cellColumn(x)];
+}
+
+int hdSpatialIndex::cellColumn(int x)
+{
+	int column = (x - gridArea.x) / cellSize;
+	if(column < 0)
+		return 0;
+	if(column >= columns)
+		return columns - 1;
+	return column;
+}
+
+int hdSpatialIndex::cellRow(int y)
+{
+	int row = (y - gridArea.y) / cellSize;
+	if(row < 0)
+		return 0;
+	if(row >= rows)
+		return rows - 1;
+	return row;
+}
+
+void hdSpatialIndex::addToCells(int item, hdRect &bounds)
+{
+	int row, column, lastRow = cellRow(bounds.GetBottom()), lastColumn = cellColumn(bounds.GetRight());
+	for(row = cellRow(bounds.y); row <= lastRow; row++)
+	{
+		for(column = cellColumn(bounds.x); column <= lastColumn; column++)
+		{
+			//keep items sorted, usually item is added at end
+			wxArrayInt &cell = cells[row * columns + column];
+			size_t pos = cell.GetCount();
+			while(pos > 0 && cell[pos - 1] > item)
+				pos--;
+			cell.Insert(item, pos);
+		}
+	}
+}
+
+void hdSpatialIndex::removeFromCells(int item, hdRect &bounds)
+{
+	int row, column, lastRow = cellRow(bounds.GetBottom()), lastColumn = cellColumn(bounds.GetRight());
+	for(row = cellRow(bounds.y); row <= lastRow; row++)
+	{
+		for(column = cellColumn(bounds.x); column <= lastColumn; column++)
+			cells[row * columns + column].Remove(item);
+	}
+}
@@ -18,6 +18,7 @@ pgadmin3_SOURCES += \
 	hotdraw/utilities/hdMultiPosRect.cpp \
 	hotdraw/utilities/hdPoint.cpp \
 	hotdraw/utilities/hdRect.cpp \
+	hotdraw/utilities/hdSpatialIndex.cpp \
 	hotdraw/utilities/hdRemoveDeleteDialog.cpp
 
 EXTRA_DIST += \
@@ -14,7 +14,10 @@
 
 // wxWindows headers
 #include <wx/grid.h>
+#include <wx/thread.h>
+#include <wx/hashmap.h>
 
+WX_DECLARE_STRING_HASH_MAP(int, ctlSQLGridExtentMap);
 
 class ctlSQLGrid : public wxGrid
 {
@@ -31,6 +34,10 @@ public:
 	}
 	int Copy();
 
+	// The selected rows and columns; the cell at the cursor if nothing
+	// is selected
+	void GetSelectedRange(wxArrayInt &rows, wxArrayInt &cols);
+
 	virtual bool CheckRowPresent(int row)
 	{
 		return true;
@@ -38,10 +45,45 @@ public:
 	wxSize GetBestSize(int row, int col);
 	void OnLabelDoubleClick(wxGridEvent &event);
 
+	// The width a column needs, estimated from its label and a bounded
+	// sample of its rows: the first and last few and some in between
+	int GetSampledColWidth(int col);
+
+	// Formats rows first to last of the given row list for the clipboard.
+	// Returns false if the copy thread was asked to stop.
+	bool FormatCopyRows(wxString &str, const wxArrayInt &rows, size_t first, size_t last, const wxArrayInt &cols, wxThread *thread);
+
 	DECLARE_DYNAMIC_CLASS(ctlSQLGrid)
 	DECLARE_EVENT_TABLE()
 
+protected:
+	// Reads the copy settings once before a copy starts
+	virtual void PrepareCopy(const wxArrayInt &cols);
+
+	// The text of one cell as it is copied. The default goes through the
+	// grid table, grids with direct access to their data override it.
+	virtual wxString GetCopyValue(int row, int col)
+	{
+		return GetCellValue(row, col);
+	}
+
+	// Whether GetCopyValue may be called from a worker thread
+	virtual bool CanCopyInBackground()
+	{
+		return false;
+	}
+
+	wxString copySeparator, copyQuoteChar;
+	wxArrayInt copyQuote;           // per copied column
+
 private:
+	int GetTextWidth(wxDC &dc, const wxString &text);
+
+	// Text widths measured with the cell font named by extentFont
+	wxString extentFont;
+	ctlSQLGridExtentMap extentCache;
+
+	bool CopyInBackground(wxString &str, const wxArrayInt &rows, const wxArrayInt &cols);
 	void OnCopy(wxCommandEvent &event);
 	void OnMouseWheel(wxMouseEvent &event);
 };
@@ -18,10 +18,14 @@
 #include "db/pgSet.h"
 #include "db/pgConn.h"
 #include "ctlSQLGrid.h"
+#include "ctlSQLResultView.h"
 #include "frm/frmExport.h"
 
 #define CTLSQL_RUNNING 100  // must be greater than ExecStatusType PGRES_xxx values
 
+// Column widths by the column headers of a result
+WX_DECLARE_STRING_HASH_MAP(wxArrayInt, ctlSQLResultWidthMap);
+
 class ctlSQLResult : public ctlSQLGrid
 {
 public:
@@ -29,13 +33,14 @@ public:
 	~ctlSQLResult();
 
 
-	int Execute(const wxString &query, int resultToDisplay = 0, wxWindow *caller = 0, long eventId = 0, void *data = 0); // > 0: resultset to display, <=0: last result
+	int Execute(const wxString &query, int resultToDisplay = 0, wxWindow *caller = 0, long eventId = 0, void *data = 0, bool binaryResults = false); // > 0: resultset to display, <=0: last result
 	void SetConnection(pgConn *conn);
 	long NumRows() const;
 	long InsertedCount() const;
 	OID  InsertedOid() const;
 
 	int Abort();
+	void ClearResult();
 
 	bool Export();
 	bool ToFile();
@@ -68,6 +73,9 @@ public:
 	void ResultsFinished();
 	void OnGridSelect(wxGridRangeSelectEvent &event);
 
+	// Whether the rows can be sorted and filtered in the grid
+	bool CanChangeView();
+
 	wxArrayString colNames;
 	wxArrayString colTypes;
 	wxArrayLong colTypClasses;
@@ -75,10 +83,40 @@ public:
 	wxArrayInt  colSizes;
 	wxArrayString colHeaders;
 
+protected:
+	void PrepareCopy(const wxArrayInt &cols);
+	wxString GetCopyValue(int row, int col);
+	bool CanCopyInBackground();
+
 private:
 	pgQueryThread *thread;
 	pgConn *conn;
 	bool rowcountSuppressed;
+
+	// Order and filters of the rows chosen in the grid
+	sqlResultView view;
+	int viewCol;                    // column the context menu is for
+	void RefreshView(long oldRows);
+
+	void OnCellRightClick(wxGridEvent &event);
+	void OnLabelRightClick(wxGridEvent &event);
+	void OnAscSort(wxCommandEvent &event);
+	void OnDescSort(wxCommandEvent &event);
+	void OnRemoveSort(wxCommandEvent &event);
+	void OnIncludeFilter(wxCommandEvent &event);
+	void OnExcludeFilter(wxCommandEvent &event);
+	void OnConditionFilter(wxCommandEvent &event);
+	void OnRemoveFilters(wxCommandEvent &event);
+	void OnAggregate(wxCommandEvent &event);
+
+	// Copy settings, see PrepareCopy()
+	bool copyIndicateNull;
+	wxString copyThousandsSeparator;
+	wxArrayInt copyNumeric;         // per result column
+
+	// Widths of the columns of recent result shapes
+	ctlSQLResultWidthMap shapeWidths;
+	static wxString GetShapeKey(const wxArrayString &headers);
 };
 
 class sqlResultTable : public wxGridTableBase
@@ -101,6 +139,10 @@ public:
 	{
 		thread = t;
 	}
+	void SetView(sqlResultView *v)
+	{
+		view = v;
+	}
 	bool DeleteRows(size_t pos = 0, size_t numRows = 1)
 	{
 		return true;
@@ -112,6 +154,7 @@ public:
 
 private:
 	pgQueryThread *thread;
+	sqlResultView *view;
 };
 
 #endif
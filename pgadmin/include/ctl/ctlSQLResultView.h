@@ -0,0 +1,173 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// ctlSQLResultView.h - Sorted and filtered view of a query result
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef CTLSQLRESULTVIEW_H
+#define CTLSQLRESULTVIEW_H
+
+// wxWindows headers
+#include <wx/wx.h>
+#include <wx/thread.h>
+
+#include "db/pgSet.h"
+
+// Conditions of a filter on the rows of a result
+enum
+{
+	RESULTFILTER_EQUAL = 0,
+	RESULTFILTER_NOTEQUAL,
+	RESULTFILTER_LESS,
+	RESULTFILTER_LESSEQUAL,
+	RESULTFILTER_GREATER,
+	RESULTFILTER_GREATEREQUAL,
+	RESULTFILTER_CONTAINS,
+	RESULTFILTER_NOTCONTAINS,
+	RESULTFILTER_ISNULL,
+	RESULTFILTER_ISNOTNULL
+};
+
+
+// The values of one column of a result, copied out of the result once so
+// that they compare without any conversion. Numeric, boolean and date/time
+// columns are kept as numbers, all others as the text the server sent.
+class sqlResultKeys
+{
+public:
+	sqlResultKeys(pgSet *set, int col);
+	~sqlResultKeys();
+
+	// Reads rows first to last - 1; may run on a worker thread
+	void Build(long first, long last);
+
+	bool IsNull(long row) const
+	{
+		return nulls[row] != 0;
+	}
+	bool IsNumber() const
+	{
+		return numbers != 0;
+	}
+	double GetNumber(long row) const
+	{
+		return numbers[row];
+	}
+	const char *GetText(long row) const
+	{
+		return texts[row];
+	}
+	int GetTypClass() const
+	{
+		return typClass;
+	}
+
+	// Orders two rows of the set, nulls last
+	int Compare(long row1, long row2) const;
+
+	// Turns a value typed by the user into a number the way Build() does
+	double ParseValue(const char *value) const;
+
+private:
+	pgSet *set;
+	int col, typClass;
+	double *numbers;
+	const char **texts;
+	char *nulls;
+};
+
+
+// A condition the rows of the view must meet
+class sqlResultFilter
+{
+public:
+	int col, op;
+	wxString value;
+};
+
+WX_DECLARE_OBJARRAY(sqlResultFilter, sqlResultFilterArray);
+
+
+// The rows of a result in the order and with the filters the user chose in
+// the grid, worked out on the client without querying the server again.
+// The work is split among a few threads for large results.
+class sqlResultView
+{
+public:
+	sqlResultView();
+	~sqlResultView();
+
+	// Back to all rows of the set, in the order the server sent them
+	void Reset(pgSet *set = 0);
+
+	bool IsActive() const
+	{
+		return set && (sortCol >= 0 || filters.GetCount() > 0);
+	}
+	long GetCount() const;
+	long GetRow(long row) const
+	{
+		return IsActive() ? rows.Item(row) : row;
+	}
+
+	void Sort(int col, bool ascending);
+	void RemoveSort();
+	void AddFilter(int col, int op, const wxString &value);
+	void RemoveFilters();
+
+	int GetSortCol() const
+	{
+		return sortCol;
+	}
+	size_t GetFilterCount() const
+	{
+		return filters.GetCount();
+	}
+
+	// Count, distinct count, sum, average, minimum and maximum of the given
+	// rows of the set in one column, as text to show to the user
+	wxString Aggregate(const wxArrayInt &setRows, int col);
+
+	// Called by the worker threads
+	void RunTask(int task, long first, long middle, long last);
+
+private:
+	void Apply();
+	sqlResultKeys *GetKeys(int col);
+	void SortRows(wxArrayInt &list, sqlResultKeys *keys, bool ascending);
+	void SortRange(long first, long last);
+	void MergeRange(long first, long middle, long last);
+	bool Matches(long row) const;
+	int CompareRows(int row1, int row2) const
+	{
+		int rc = taskKeys->Compare(row1, row2);
+		return taskAscending ? rc : -rc;
+	}
+	void RunJobs(int task, const wxArrayLong &firsts, const wxArrayLong &middles, const wxArrayLong &lasts);
+	void GetChunks(long count, wxArrayLong &firsts, wxArrayLong &lasts);
+
+	pgSet *set;
+	long colCount;
+	sqlResultKeys **keys;           // per column, built when first needed
+	wxArrayInt rows;                // rows of the set, in view order
+
+	int sortCol;
+	bool sortAscending;
+	sqlResultFilterArray filters;
+
+	// State of the task the worker threads run
+	sqlResultKeys *taskKeys;
+	int *taskRows, *taskScratch;
+	bool taskAscending;
+	char *taskMatches;
+	const sqlResultFilter *taskFilter;
+	const char *taskText;
+	double taskNumber;
+};
+
+#endif
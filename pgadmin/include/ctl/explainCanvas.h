@@ -32,6 +32,8 @@
 
 class ExplainShape;
 class ExplainPopup;
+class ExplainPlan;
+class ExplainNode;
 class ExplainText;
 
 class ExplainCanvas : public wxShapeCanvas
@@ -42,14 +44,22 @@ public:
 
 	void ShowPopup(ExplainShape *s);
 	void SetExplainString(const wxString &str);
+	void SetExplainPlan(ExplainPlan *newPlan);
 	void Clear();
 	void SaveAsImage(const wxString &fileName, wxBitmapType imageType);
 
+	ExplainPlan *GetExplainPlan()
+	{
+		return plan;
+	}
+
 private:
 	void OnMouseMotion(wxMouseEvent &ev);
+	void LayoutShapes(int maxLevel);
 
 	ExplainShape *rootShape;
 	ExplainPopup *popup;
+	ExplainPlan *plan;
 
 	DECLARE_EVENT_TABLE()
 };
@@ -60,6 +70,7 @@ class ExplainShape : public wxBitmapShape
 public:
 	ExplainShape(const wxImage &bmp, const wxString &description, long tokenNo = -1, long detailNo = -1);
 	static ExplainShape *Create(long level, ExplainShape *last, const wxString &str);
+	static ExplainShape *Create(ExplainShape *last, ExplainNode *node, double totalTime);
 
 	void SetCondition(const wxString &str)
 	{
@@ -96,12 +107,13 @@ protected:
 
 	long level;
 	wxString description, detail, condition, label;
-	wxString cost, actual;
+	wxString cost, actual, analysis;
 	double costLow, costHigh;
 	long rows, width;
 	int kidCount, kidNo;
 	int totalShapes; // horizontal space usage by shape and its kids
 	int usedShapes;
+	ExplainNode *node; // only set for plans read from structured output
 
 	friend class ExplainCanvas;
 	friend class ExplainText;
@@ -0,0 +1,56 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// explainHotNodes.h - Sortable list of the plan nodes of an explain
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef EXPLAINHOTNODES_H
+#define EXPLAINHOTNODES_H
+
+#include <wx/listctrl.h>
+
+class ExplainPlan;
+
+// A copy of the figures of one plan node, so the list does not depend on
+// the lifetime of the plan it was filled from.
+class explainHotNode
+{
+public:
+	long nodeNo;
+	wxString name;
+	bool hasActual, hasTiming, hasBuffers;
+	double exclusiveTime, inclusiveTime, percent;
+	double actualRows, planRows, loops, estimateError;
+	long sharedHit, sharedRead;
+};
+
+WX_DECLARE_OBJARRAY(explainHotNode, explainHotNodeArray);
+
+
+class ExplainHotNodes : public wxListView
+{
+public:
+	ExplainHotNodes(wxWindow *parent);
+
+	void SetExplainPlan(const ExplainPlan *plan);
+	void Clear();
+
+	wxString OnGetItemText(long item, long col) const;
+
+private:
+	void OnColumnClick(wxListEvent &ev);
+	void SortNodes();
+
+	explainHotNodeArray nodes;
+	int sortColumn;
+	bool sortAscending;
+
+	DECLARE_EVENT_TABLE()
+};
+
+#endif
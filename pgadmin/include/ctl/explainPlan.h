@@ -0,0 +1,214 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// explainPlan.h - Structured (FORMAT XML) explain plan model
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef EXPLAINPLAN_H
+#define EXPLAINPLAN_H
+
+#include <wx/hashmap.h>
+#include <libxml/tree.h>
+
+class ExplainNode;
+
+WX_DEFINE_ARRAY_PTR(ExplainNode *, ExplainNodeArray);
+WX_DECLARE_STRING_HASH_MAP(wxString, ExplainPropertyMap);
+
+// A single plan node, as reported by EXPLAIN (FORMAT XML).
+// All derived values (exclusive time, estimate error, exclusive buffers)
+// are computed once by ExplainPlan after the whole tree has been read.
+class ExplainNode
+{
+public:
+	ExplainNode(ExplainNode *parentNode, long nodeLevel);
+
+	wxString GetProperty(const wxString &name) const;
+	bool HasProperty(const wxString &name) const
+	{
+		return properties.find(name) != properties.end();
+	}
+
+	// The node headline as the text format would print it, e.g.
+	// "Index Scan Backward using foo_pkey on foo f  (cost=...) (actual ...)"
+	wxString GetDescription() const;
+	// The node headline without cost and timing information
+	wxString GetName() const;
+	// "Hash Cond: (...)" style lines, in the order the text format uses
+	wxArrayString GetConditions() const;
+
+	ExplainNode *GetParent() const
+	{
+		return parent;
+	}
+	const ExplainNodeArray &GetChildren() const
+	{
+		return children;
+	}
+	long GetLevel() const
+	{
+		return level;
+	}
+
+	bool HasCosts() const
+	{
+		return hasCosts;
+	}
+	bool HasActual() const
+	{
+		return hasActual;
+	}
+	bool HasTiming() const
+	{
+		return hasTiming;
+	}
+	bool HasBuffers() const
+	{
+		return hasBuffers;
+	}
+
+	double GetStartupCost() const
+	{
+		return startupCost;
+	}
+	double GetTotalCost() const
+	{
+		return totalCost;
+	}
+	double GetPlanRows() const
+	{
+		return planRows;
+	}
+	long GetPlanWidth() const
+	{
+		return planWidth;
+	}
+	double GetActualStartupTime() const
+	{
+		return actualStartupTime;
+	}
+	double GetActualTotalTime() const
+	{
+		return actualTotalTime;
+	}
+	double GetActualRows() const
+	{
+		return actualRows;
+	}
+	double GetActualLoops() const
+	{
+		return actualLoops;
+	}
+
+	// Time spent in this node and all its children, over all loops
+	double GetInclusiveTime() const
+	{
+		return inclusiveTime;
+	}
+	// Time spent in this node alone, over all loops
+	double GetExclusiveTime() const
+	{
+		return exclusiveTime;
+	}
+	// max(actual, estimated) / min(actual, estimated) rows per loop, >= 1
+	double GetEstimateError() const
+	{
+		return estimateError;
+	}
+	// True if the planner overestimated the row count
+	bool IsOverestimated() const
+	{
+		return planRows > actualRows;
+	}
+
+	long GetSharedHitBlocks() const
+	{
+		return sharedHit;
+	}
+	long GetSharedReadBlocks() const
+	{
+		return sharedRead;
+	}
+	long GetExclusiveSharedHitBlocks() const
+	{
+		return exclusiveSharedHit;
+	}
+	long GetExclusiveSharedReadBlocks() const
+	{
+		return exclusiveSharedRead;
+	}
+	long GetTempReadBlocks() const
+	{
+		return tempRead;
+	}
+	long GetTempWrittenBlocks() const
+	{
+		return tempWritten;
+	}
+
+private:
+	void ReadValues();
+	void Analyze();
+
+	ExplainNode *parent;
+	ExplainNodeArray children;
+	ExplainPropertyMap properties;
+	long level;
+
+	bool hasCosts, hasActual, hasTiming, hasBuffers;
+	double startupCost, totalCost, planRows;
+	long planWidth;
+	double actualStartupTime, actualTotalTime, actualRows, actualLoops;
+	double inclusiveTime, exclusiveTime, estimateError;
+	long sharedHit, sharedRead, tempRead, tempWritten;
+	long exclusiveSharedHit, exclusiveSharedRead;
+
+	friend class ExplainPlan;
+};
+
+
+class ExplainPlan
+{
+public:
+	ExplainPlan();
+	~ExplainPlan();
+
+	// Returns true if the string looks like EXPLAIN (FORMAT XML) output
+	static bool IsXmlPlan(const wxString &str);
+
+	// Parses the document; returns false (and logs an error) if it
+	// could not be read.
+	bool Parse(const wxString &xml);
+
+	ExplainNode *GetRoot() const
+	{
+		return root;
+	}
+	// All nodes, in the order they appear in the plan (pre-order)
+	const ExplainNodeArray &GetNodes() const
+	{
+		return nodes;
+	}
+	double GetTotalRuntime() const
+	{
+		return totalRuntime;
+	}
+	double GetPlanningTime() const
+	{
+		return planningTime;
+	}
+
+private:
+	ExplainNode *root;
+	ExplainNodeArray nodes;
+	double totalRuntime, planningTime;
+
+	ExplainNode *ReadNode(xmlNodePtr planNode, ExplainNode *parent, long level);
+};
+
+#endif
@@ -23,8 +23,11 @@ pgadmin3_SOURCES += \
 	include/ctl/ctlSQLBox.h \
 	include/ctl/ctlSQLGrid.h \
 	include/ctl/ctlSQLResult.h \
+	include/ctl/ctlSQLResultView.h \
 	include/ctl/ctlTree.h \
 	include/ctl/explainCanvas.h \
+	include/ctl/explainHotNodes.h \
+	include/ctl/explainPlan.h \
 	include/ctl/timespin.h \
 	include/ctl/wxgridsel.h \
 	include/ctl/xh_calb.h \
@@ -12,6 +12,8 @@
 pgadmin3_SOURCES += \
 	  include/db/pgConn.h \
 	  include/db/pgQueryThread.h \
+	  include/db/pgQueryStats.h \
+	  include/db/pgConnPool.h \
 	  include/db/pgSet.h
 
 
@@ -14,18 +14,22 @@
 
 // wxWindows headers
 #include <wx/wx.h>
+#include <wx/hashmap.h>
 
 // PostgreSQL headers
 #include <libpq-fe.h>
 
 // App headers
 #include "pgSet.h"
+#include "pgQueryStats.h"
 
 class pgTypeCache;
+class pgConnPool;
 
 class pgDatatype;
 class pgDatatypeCache;
 
+WX_DECLARE_STRING_HASH_MAP(int, pgResultFormatMap);
 
 // status enums
 enum
@@ -85,6 +89,18 @@ typedef struct pgError
 	wxString formatted_msg;
 } pgError;
 
+// What the connected database offers, read by a single query the first
+// time any of it is needed; see pgConn::GetCapabilities()
+typedef struct pgCapabilities
+{
+	bool viewdefPretty;             // pg_get_viewdef(oid, bool)
+	bool debuggerTargetInfo;        // pldbg_get_target_info()
+	bool plpgsqlDebug, edbsplDebug; // plpgsql_oid_debug(), edb_oid_debug()
+	wxString searchPath, currentSchema;
+	wxString preloadLibraries;      // superusers only
+	wxString defPrivsOnTables, defPrivsOnSeqs, defPrivsOnFuncs, defPrivsOnTypes;
+} pgCapabilities;
+
 
 class pgConn
 {
@@ -94,12 +110,13 @@ public:
 	       int port = 5432, const wxString &rolename = wxT(""), int sslmode = 0, OID oid = 0,
 	       const wxString &applicationname = wxT("pgAdmin"),
 	       const wxString &sslcert = wxT(""), const wxString &sslkey = wxT(""), const wxString &sslrootcert = wxT(""), const wxString &sslcrl = wxT(""),
-	       const bool sslcompression = true);
+	       const bool sslcompression = true, int connectTimeout = 0);
 	~pgConn();
 
 	bool IsSuperuser();
 	bool HasPrivilege(const wxString &objTyp, const wxString &objName, const wxString &priv);
 	bool HasFeature(int feature = 0, bool forceCheck = false);
+	const pgCapabilities &GetCapabilities(bool forceCheck = false);
 	bool BackendMinimumVersion(int major, int minor);
 	bool BackendMinimumVersion(int major, int minor, int patch);
 	bool EdbMinimumVersion(int major, int minor);
@@ -131,9 +148,29 @@ public:
 
 	void Close();
 	bool Reconnect();
+
+	// A suspended connection has been closed to save server resources and
+	// is re-established by Resume(), which the Execute functions call.
+	void Suspend();
+	bool Resume();
+	bool IsSuspended() const
+	{
+		return suspended;
+	}
+	time_t GetLastUsed() const
+	{
+		return lastUsed;
+	}
+	// Discards all session state, such as temporary tables and settings,
+	// and sets up the session as a new connection
+	bool ResetSession();
+
 	bool ExecuteVoid(const wxString &sql, bool reportError = true);
 	wxString ExecuteScalar(const wxString &sql);
-	pgSet *ExecuteSet(const wxString &sql);
+	// With binaryResults, a single statement whose columns are all numbers,
+	// booleans, timestamps or text is read in binary format, see pgSet;
+	// GetVal() then writes a timestamp with time zone in UTC
+	pgSet *ExecuteSet(const wxString &sql, bool binaryResults = false);
 	wxString GetHostAddr() const
 	{
 		return save_hostaddr;
@@ -191,6 +228,13 @@ public:
 		return save_sslcompression;
 	}
 	wxString GetName() const;
+	// Whether backslashes are plain characters in '' strings; servers
+	// before 8.1 don't report it and always treat them as escapes
+	bool GetStandardConformingStrings() const
+	{
+		const char *setting = conn ? PQparameterStatus(conn, "standard_conforming_strings") : 0;
+		return setting && !strcmp(setting, "on");
+	}
 	bool GetNeedUtfConnectString()
 	{
 		return utfConnectString;
@@ -267,6 +311,17 @@ public:
 
 	bool TableHasColumn(wxString schemaname, wxString tblname, const wxString &colname);
 
+	// The subsystem the queries on this connection are counted for in
+	// pgQueryStats; copied by Duplicate()
+	int GetSubsystem() const
+	{
+		return subsystem;
+	}
+	void SetSubsystem(int sub)
+	{
+		subsystem = sub;
+	}
+
 protected:
 	PGconn *conn;
 	int lastResultStatus;
@@ -281,12 +336,15 @@ protected:
 	wxString dbRole, dbHost, dbHostName;
 	OID lastSystemOID;
 	OID dbOid;
+	int subsystem;
 
 	void *noticeArg;
 	PQnoticeProcessor noticeProc;
 	static double libpqVersion;
 
 	friend class pgQueryThread;
+	friend class pgConnPool;
+	friend class pgConnBusy;
 
 private:
 	// This class can not be copied.
@@ -294,10 +352,23 @@ private:
 	const pgConn &operator=(const pgConn &rhs);
 
 	bool DoConnect();
+	void Touch();
+	void ReadCapabilities();
 
 	wxString qtString(const wxString &value);
 
+	// Picks the format of the results described by desc: binary if pgSet
+	// can read every column. forText leaves out the types pgSet cannot
+	// write as the server would.
+	int ChooseResultFormat(PGresult *desc, bool forText);
+	// Prepares the query as the unnamed statement and picks the format of
+	// its results. Returns the result of the failing step, or 0.
+	PGresult *PrepareBinary(const char *query, int &resultFormat);
+	PGresult *ExecuteBinary(const wxString &sql, bool &refused);
+
 	bool features[32];
+	pgCapabilities capabilities;
+	wxString versionString;
 	int minorVersion, majorVersion, patchVersion;
 	bool isEdb;
 	bool isGreenplum;
@@ -313,6 +384,29 @@ private:
 	int save_port, save_sslmode;
 	bool save_sslcompression;
 	OID save_oid;
+
+	wxString sessionSetup;      // the SET commands DoConnect() ran
+	pgConnPool *pool;
+	bool suspended;
+	time_t lastUsed;
+	int busy;                   // queries running, guarded by the pool
+
+	// The result format chosen for the queries run with ExecuteBinary()
+	pgResultFormatMap resultFormats;
+};
+
+
+// Marks a query as running on the connection for as long as it exists, so
+// that the pool doesn't suspend the connection under it. A suspended
+// connection is resumed first.
+class pgConnBusy
+{
+public:
+	pgConnBusy(pgConn *_conn);
+	~pgConnBusy();
+
+private:
+	pgConn *conn;
 };
 
 #endif
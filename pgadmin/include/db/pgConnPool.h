@@ -0,0 +1,74 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// pgConnPool.h - Pool of the connections opened to one server
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef PGCONNPOOL_H
+#define PGCONNPOOL_H
+
+#include <wx/wx.h>
+#include <wx/timer.h>
+#include <wx/thread.h>
+
+class pgConn;
+
+WX_DEFINE_ARRAY_PTR(pgConn *, pgConnArray);
+
+
+// Keeps track of the connections a pgServer creates for its databases.
+//
+// Connections handed back with Release() are reset and kept for reuse by
+// the next window opened on the same database, until they have been idle
+// for the configured timeout. Browser connections still in use by a
+// pgDatabase are suspended when they have been idle that long, or when
+// the server has more open connections than the configured maximum; the
+// connection is then re-established by pgConn::Resume() the next time it
+// is used.
+//
+// Connections may be used and released on other threads, so the lists
+// are guarded by a lock. Connections are only suspended on the GUI thread,
+// and never while a pgConnBusy marks them as running a query.
+class pgConnPool : public wxEvtHandler
+{
+public:
+	pgConnPool();
+	~pgConnPool();
+
+	// Returns an idle connection to the database, or NULL
+	pgConn *Lease(const wxString &dbName, const wxString &applicationName);
+	// Registers a new connection created for this server
+	void Add(pgConn *conn);
+	// Closes all the idle connections
+	void Clear();
+
+	// Keeps the connection for reuse if it came from a pool and can be
+	// reset, otherwise deletes it
+	static void Release(pgConn *conn);
+
+private:
+	void Put(pgConn *conn);
+	void Forget(pgConn *conn);
+	void Reclaim(pgConn *keep = 0);
+	void SetBusy(pgConn *conn, bool busy);
+
+	void OnTimer(wxTimerEvent &ev);
+
+	pgConnArray leased, idle;
+	wxTimer *timer;
+
+	// Recursive, deleting an idle connection calls Forget()
+	wxMutex lock;
+
+	friend class pgConn;
+	friend class pgConnBusy;
+
+	DECLARE_EVENT_TABLE()
+};
+
+#endif
@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// pgQueryStats.h - Timing statistics of the queries pgAdmin executes
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef PGQUERYSTATS_H
+#define PGQUERYSTATS_H
+
+// wxWindows headers
+#include <wx/wx.h>
+#include <wx/dynarray.h>
+
+// PostgreSQL headers
+#include <libpq-fe.h>
+
+// The part of pgAdmin a connection works for
+enum pgConnSubsystem
+{
+	PGCONN_SUB_BROWSER = 0,
+	PGCONN_SUB_STATUS,
+	PGCONN_SUB_QUERYTOOL,
+	PGCONN_SUB_EDITGRID,
+	PGCONN_SUB_DEBUGGER,
+
+	PGCONN_SUB_COUNT
+};
+
+// Latency histogram buckets: below 1ms, below 2ms, below 4ms ... and
+// everything from 2^(PGSTATS_BUCKETS-2)ms up in the last one.
+#define PGSTATS_BUCKETS 16
+
+
+class pgQueryStatsEntry
+{
+public:
+	pgQueryStatsEntry();
+
+	wxString sql;               // with literals replaced by '?'
+	int subsystem;
+	long calls;
+	double totalTime, maxTime;  // ms
+	double rows, bytes;
+};
+
+WX_DECLARE_OBJARRAY(pgQueryStatsEntry, pgQueryStatsArray);
+
+
+// Every query executed through pgConn, pgQueryThread or the debugger
+// connection is recorded here, grouped by subsystem and by statement text
+// with its literals removed, so that the same catalog query run for
+// different objects adds up. Each call is a single round trip to the
+// server. All functions may be called from any thread.
+class pgQueryStats
+{
+public:
+	// Records a finished query; res may be NULL if it failed to run
+	static void Record(int subsystem, const wxString &sql, long elapsed, PGresult *res);
+
+	// The statements with the highest total time, at most maxEntries.
+	// subsystem may be -1 to include all of them.
+	static void GetTopEntries(pgQueryStatsArray &entries, int subsystem, size_t maxEntries);
+	// Fills counts[PGSTATS_BUCKETS] with the calls per latency bucket
+	static void GetHistogram(int subsystem, long *counts);
+	static void Reset();
+
+	static wxString GetSubsystemName(int subsystem);
+	static wxString GetBucketName(int bucket);
+
+private:
+	static wxString NormaliseQuery(const wxString &sql);
+};
+
+#endif
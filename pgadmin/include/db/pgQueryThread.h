@@ -44,8 +44,16 @@ public:
 	wxString GetMessagesAndClear();
 	void appendMessage(const wxString &str);
 
+	// Read the results in binary format where pgSet can write them as
+	// text again; only for queries holding a single statement
+	void SetBinaryResults(bool binary)
+	{
+		binaryResults = binary;
+	}
+
 private:
 	int rc;
+	bool binaryResults;
 	int resultToRetrieve;
 	long rowsInserted;
 	OID insertedOid;
@@ -62,6 +70,8 @@ private:
 	long eventId;
 
 	int execute();
+	int prepareBinary(const char *queryBuf, int &resultFormat, PGresult *&failed);
+	int waitForResult(PGresult *&res);
 	int raiseEvent(int retval = 0);
 
 	void appendMessageRaw(const wxString &str);
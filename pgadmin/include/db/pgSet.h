@@ -23,6 +23,9 @@
 
 class pgConn;
 
+// Room for the text of a value read in binary format
+#define PGSET_BINARY_TEXT 64
+
 // Class declarations
 class pgSet
 {
@@ -92,6 +95,36 @@ public:
 	{
 		return (PQgetisnull(res, pos - 1, col) != 0);
 	}
+	// Read any row without moving the current position, so the grid can
+	// be painted while another thread reads the same set
+	bool IsNullAt(const long row, const int col) const
+	{
+		return (PQgetisnull(res, row, col) != 0);
+	}
+	wxString GetValAt(const long row, const int col) const
+	{
+		if (binary)
+			return GetBinaryValAt(row, col);
+		return wxString(PQgetvalue(res, row, col), conv);
+	}
+	const char *GetCharPtrAt(const long row, const int col) const
+	{
+		return PQgetvalue(res, row, col);
+	}
+
+	// Results read in binary format; see pgConn::ExecuteSet()
+	bool IsBinary(const int col) const
+	{
+		return binary && PQfformat(res, col) == 1;
+	}
+	// The value as the server would send it as text: a pointer to the
+	// value itself for text columns, to buf for binary ones, which must
+	// hold PGSET_BINARY_TEXT bytes
+	const char *GetTextAt(const long row, const int col, char *buf) const;
+	// A binary number, boolean or timestamp, the latter in seconds since
+	// 2000-01-01
+	double GetBinaryNumberAt(const long row, const int col) const;
+
 	int ColScale(const int col) const;
 	int ColNumber(const wxString &colName) const;
 	bool HasColumn(const wxString &colname) const;
@@ -130,6 +163,12 @@ protected:
 	wxString ExecuteScalar(const wxString &sql) const;
 	wxMBConv &conv;
 	bool needColQuoting;
+
+	// Binary values, and how the server writes floats as text
+	bool binary, shortestFloats;
+	wxString GetBinaryValAt(const long row, const int col) const;
+	wxInt64 GetBinaryIntAt(const long row, const int col) const;
+	wxDateTime GetBinaryDateTimeAt(const long row, const int col) const;
 };
 
 
@@ -44,6 +44,7 @@ public:
 	static bool processResult(int value);
 
 	//Generic node processing functions
+	static bool isNode(xmlTextReaderPtr reader, const char *name);
 	static wxString getNodeName(xmlTextReaderPtr reader);
 	static int getNodeType(xmlTextReaderPtr reader);
 	static wxString getNodeValue(xmlTextReaderPtr reader);
@@ -56,11 +57,11 @@ public:
 	static ddRelationshipFigure *getRelationship(xmlTextReaderPtr reader);
 	static ddRelationshipItem *getRelationshipItem(xmlTextReaderPtr reader, ddRelationshipFigure *itemOwner, ddTableFigure *source, ddTableFigure *destination);
 	static void initDiagrams(xmlTextReaderPtr reader);
-	static void initialModelParse(xmlTextReaderPtr reader);
 
 private:
 
 	static ddDatabaseDesign *design;
 	static ctlAuiNotebook *tabs;
+	static wxString readError;
 };
 #endif
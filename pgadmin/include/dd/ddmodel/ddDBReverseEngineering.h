@@ -22,6 +22,7 @@ class SelSchemaPage;
 class SelTablesPage;
 class ReportPage;
 class ddStubTable;
+class ddImportDBThread;
 
 enum
 {
@@ -31,10 +32,13 @@ enum
     DDADD,
     DDADDALL,
     DDREMOVE,
-    DDREMOVEALL
+    DDREMOVEALL,
+    DDIMPORTERROR
 };
 
 WX_DECLARE_STRING_HASH_MAP( ddStubTable *, stubTablesHashMap);
+WX_DECLARE_HASH_MAP( OID, ddStubTable *, wxIntegerHash, wxIntegerEqual, stubTablesOidHashMap);
+WX_DECLARE_STRING_HASH_MAP( OID, oidsHashMap);
 WX_DEFINE_SORTED_ARRAY_INT(int, wxSortedArrayInt);
 
 // Stub tables related classes
@@ -44,6 +48,7 @@ public:
 	// Implement and replace at this and other dd related classes as Generation Wizard static wxArrayString getSchemasNames(...);
 	static wxArrayString getTablesNames(pgConn *connection, wxString schemaName);
 	static ddStubTable *getTable(pgConn *connection, wxString tableName, OID tableOid);
+	static bool getTables(pgConn *connection, oidsHashMap &tableOids, stubTablesHashMap &tables, wxArrayString &inheritedTables, ddImportDBThread *thread = NULL);
 	static ddTableFigure *getTableFigure(ddStubTable *table);
 	static void getAllRelationships(pgConn *connection, stubTablesHashMap &tables, ddDatabaseDesign *design);
 	static int getPgColumnNum(pgConn *connection, wxString schemaName, wxString tableName, wxString columnName);
@@ -54,8 +59,10 @@ public:
 	static bool isModelSameDbFk(pgConn *connection, OID destTableOid, wxString schemaName, wxString fkName, wxString sourceTableName, wxString destTableName, ddStubTable *destStubTable, ddRelationshipFigure *relation);
 
 private:
-	static bool setUniqueConstraints(pgConn *connection, ddStubTable *table);
-	static bool setPkName(pgConn *connection, ddStubTable *table);
+	static wxString oidArray(stubTablesOidHashMap &tables);
+	static pgSet *executeSet(pgConn *connection, const wxString &sql, ddImportDBThread *thread);
+	static bool setColumns(pgConn *connection, stubTablesOidHashMap &tables, ddImportDBThread *thread);
+	static bool setKeys(pgConn *connection, stubTablesOidHashMap &tables, ddImportDBThread *thread);
 	static int sortFunc(int n1, int n2)
 	{
 		return n1 - n2;
@@ -96,6 +103,46 @@ public:
 	wxArrayString UniqueKeysNames;
 };
 
+// Loads the stubs of the selected tables away from the GUI thread, so the
+// wizard can show progress while the metadata is fetched. The thread owns
+// the connection it is given, which nothing else may use while it runs.
+class ddImportDBThread : public wxThread
+{
+public:
+	ddImportDBThread(pgConn *connection, oidsHashMap &tableOids, wxWindow *_caller);
+	~ddImportDBThread();
+	virtual void *Entry();
+
+	void SetProgress(int step, const wxString &message);
+	int GetProgress(wxString &message);
+	int GetSteps() const
+	{
+		return steps;
+	}
+
+	// Failed queries are collected here and announced to the caller with a
+	// DDIMPORTERROR event, which fetches them with GetErrors()
+	void AddError(const wxString &message);
+	wxArrayString GetErrors();
+	bool Failed() const
+	{
+		return failed;
+	}
+
+	stubTablesHashMap tables;
+	wxArrayString inheritedTables;
+
+private:
+	pgConn *conn;
+	wxWindow *caller;
+	oidsHashMap oids;
+	int steps, currentStep;
+	wxString currentMessage;
+	wxArrayString errors;
+	bool failed;
+	wxCriticalSection criticalSection;
+};
+
 //
 //
 // Wizard related classes
@@ -103,8 +150,6 @@ public:
 //
 //
 
-WX_DECLARE_STRING_HASH_MAP( OID, oidsHashMap);
-
 class ddDBReverseEngineering : public wxWizard
 {
 public:
@@ -206,12 +251,14 @@ public:
 	void OnButtonAddAll(wxCommandEvent &);
 	void OnButtonRemove(wxCommandEvent &);
 	void OnButtonRemoveAll(wxCommandEvent &);
+	void OnImportError(wxCommandEvent &);
 private:
 	void OnWizardPageChanging(wxWizardEvent &event);
 	wxStaticText *leftText, *rightText, *centerText;
 	wxWizardPage *m_prev, *m_next;
 	wxListBox *m_allTables, *m_selTables;
 	ddDBReverseEngineering *wparent;
+	ddImportDBThread *importThread;
 	wxArrayString tablesNames;
 	wxBitmapButton *buttonAdd, *buttonAddAll, *buttonRemove, *buttonRemoveAll;
 	wxBitmap addBitmap, addAllBitmap, removeBitmap, removeAllBitmap;
@@ -20,6 +20,7 @@
 #include "dd/dditems/figures/ddTableFigure.h"
 
 class ddModelBrowser;
+class ddTableFigure;
 
 enum
 {
@@ -30,6 +31,8 @@ enum
 };
 
 WX_DECLARE_STRING_HASH_MAP( wxString , tablesMappingHashMap );
+WX_DECLARE_STRING_HASH_MAP( ddTableFigure * , tablesRegistryHashMap );
+WX_DEFINE_ARRAY_PTR( ddTableFigure *, ddTableFigureArray );
 
 class ddDatabaseDesign : public wxObject
 {
@@ -54,6 +57,8 @@ public:
 	bool validateModel(wxString &errors);
 	ddTableFigure *getSelectedTable(int diagramIndex);
 	ddTableFigure *getTable(wxString tableName);
+	void registerTable(hdIFigure *figure);
+	void invalidateTables();
 	bool writeXmlModel(wxString file);
 	bool readXmlModel(wxString file, ctlAuiNotebook *notebook);
 
@@ -70,11 +75,17 @@ protected:
 	tablesMappingHashMap mappingNameToId;
 	tablesMappingHashMap mappingIdToName;
 private:
+	wxString generateTables(ddTableFigureArray &tables, wxArrayInt &options, wxString schemaName);
+	void rebuildTables();
+
 	ddModelBrowser *attachedBrowser;
 	int diagramCounter;
 	ddDrawingEditor *editor;
 	hdITool *tool;
 	xmlTextWriterPtr xmlWriter;
+	//Model tables by lowercase name, built again after changes
+	tablesRegistryHashMap tablesByName;
+	bool tablesValid;
 
 };
 #endif
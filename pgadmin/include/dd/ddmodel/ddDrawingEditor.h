@@ -28,6 +28,9 @@ public:
 	ddDrawingEditor(wxWindow *owner, wxWindow *frmOwner, ddDatabaseDesign *design);
 	virtual hdDrawing *createDiagram(wxWindow *owner, bool fromXml);
 	virtual void remOrDelSelFigures(int diagramIndex);
+	virtual void addModelFigure(hdIFigure *figure);
+	virtual void deleteModelFigure(hdIFigure *figure);
+	virtual void deleteAllModelFigures();
 	void checkRelationshipsConsistency(int diagramIndex);
 	void checkAllDigramsRelConsistency();
 	ddDatabaseDesign *getDesign()
@@ -36,6 +36,8 @@
 #include "debugger/dbgBreakPoint.h"
 #include "debugger/ctlTabWindow.h"
 
+class dbgPgResults;
+
 class dbgPgConn;
 class dbgResultset;
 class dbgConnProp;
@@ -44,6 +46,7 @@ class ctlStackWindow;
 class ctlMessageWindow;
 class ctlVarWindow;
 class ctlResultGrid;
+class ctlProfileWindow;
 
 
 #define MARKERINDEX_TO_MARKERMASK( MI ) ( 1 << MI )
@@ -90,6 +93,7 @@ public:
 	void processResult( wxString &result );		     // Handle a message from the debugger server
 	void OnNoticeReceived( wxCommandEvent &event );     // NOTICE received from server
 	void OnResultSet( PGresult *result );			     // Result set received from server
+	void stopProfiling();			                    // End a profile run and show its result
 	void disableTools();			                    // Disable toolbar tools
 	void enableTools();		 	                        // Enable toolbar tools
 
@@ -112,6 +116,7 @@ private:
 	}
 	void clearBreakpoint( int lineNumber, bool requestUpdate );
 	void setBreakpoint( int lineNumber );
+	void editBreakCondition( int lineNumber );
 
 	ctlStackWindow   *getStackWindow()
 	{
@@ -138,6 +143,10 @@ private:
 	{
 		return( m_tabWindow->getResultWindow());
 	}
+	ctlProfileWindow *getProfileWindow( bool create )
+	{
+		return( m_tabWindow->getProfileWindow( create ));
+	}
 
 	void	setTools(bool enable);		            // Enable/disable debugger options
 	void	OnIdle( wxIdleEvent &event );			// Idle processor
@@ -145,7 +154,14 @@ private:
 
 	int		getLineNo( );				                    // Compute line number for current cursor position
 	void 	closeConnection();								// Closes proxy connection
-	void	updateUI( dbgResultset &breakpoint );		     // Update the lazy parts of the UI
+	void	updateUI( dbgResultset &breakpoint, dbgPgResults *state );	// Update the lazy parts of the UI
+	wxString	getStateCommand();						// Queries for variables, stack and breakpoints
+	void	waitForPause( const wxString &command );	// Send a command that leaves the target paused
+	void	waitForBreakpoint( const wxString &command );	// Same, skipping breakpoints whose condition does not hold
+	void	showState( dbgPgResults *state );			// Show variables, stack and breakpoints
+	void	showVars( dbgResultset &result );
+	void	showStack( dbgResultset &result );
+	void	showBreakpoints( dbgResultset &result );
 	void	updateSourceCode( dbgResultset &breakpoint );	// Update the source code window
 	bool	connectionLost( dbgResultset &resultSet );	     // Returns true if proxy lost it's connection
 	bool	gotFatalError( dbgResultset &resultSet );	     // Returns true if result set indicates a fatal error has occurred
@@ -167,6 +183,7 @@ private:
 	void	ResultListenerCreated( wxCommandEvent &event );	// Global listener created, ready to wait for a target
 	void	ResultTargetReady( wxCommandEvent &event );		// Target session attached, ready to wait for a breakpoint
 	void	ResultLastBreakpoint( wxCommandEvent &event );		// Adding last breakpoint
+	void	ResultProfileStep( wxCommandEvent &event );		// Step complete while profiling
 
 	dbgPgConn	*m_dbgConn;	    // Network connection to debugger server
 	wxString	m_debugPort;	// Port at which debugger server is listening
@@ -189,19 +206,29 @@ private:
 	bool	m_updateVars;			    // Update variable window in next idle period?
 	bool    m_updateStack;			    // Update stack window in next idle period?
 	bool	m_updateBreakpoints;	    // Update breakpoints in next idle period?
+	dbgPgResults	*m_pendingState;	// State received with the last pause, shown with its source
+	bool	m_profiling;			    // Are we stepping through the target to profile it?
+	bool	m_profileStop;			    // Stop profiling at the next pause?
+	long	m_profileSteps;			    // Number of steps of the current profile run
+	wxString	m_profileFuncOid;	    // Function the target is paused in while profiling
+	int		m_profileLine;			    // Line the target is paused at while profiling
 	dbgBreakPointList    m_breakpoints;	// List of initial breakpoints to create
 
+	// Markers with higher numbers are drawn on top, so the heat markers come first
 	enum
 	{
-	    MARKER_CURRENT    = 0x02,		// Current line marker
-	    MARKER_CURRENT_BG = 0x04,		// Current line marker - background hilight
-	    MARKER_BREAKPOINT = 0x01,		// Breakpoint marker
+	    MARKER_HEAT       = 0x00,		// Profile heat markers, one per level (coolest first)
+	    HEAT_LEVELS       = 5,			// Number of heat levels
+	    MARKER_CURRENT    = 0x06,		// Current line marker
+	    MARKER_CURRENT_BG = 0x07,		// Current line marker - background hilight
+	    MARKER_BREAKPOINT = 0x05,		// Breakpoint marker
 	};
 
 	sourceHash	m_sourceCodeMap;
 
 	wxString	m_focusPackageOid;	    // Which package has the debug focus?
 	wxString	m_focusFuncOid;		    // Which function has the debug focus?
+	int		m_focusLine;			    // Which line (as numbered by the proxy) has the debug focus?
 	wxString	m_displayedFuncOid;	    // Which function are we currently displaying? (function OID component)
 	wxString	m_displayedPackageOid;	// Which function are we currently displaying? (package OID component)
 	wxString	m_sessionHandle;	    // Handle to proxy's server session
@@ -216,6 +243,10 @@ private:
 	void	displaySource(const wxString &packageOID, const wxString &funcID);
 	void	unhilightCurrentLine();
 	void	launchWaitingDialog();
+	void	startProfiling();
+	wxString	getFunctionName( const wxString &funcOID );
+	void	showProfileHeat();
+	void	clearProfileHeat();
 
 	void	clearAllBreakpoints();
 	void	clearBreakpointMarkers();
@@ -230,6 +261,7 @@ private:
 	static wxString m_commandGetSourceV2;
 	static wxString m_commandStepOver;
 	static wxString m_commandStepInto;
+	static wxString m_commandProfileStep;
 	static wxString m_commandContinue;
 	static wxString m_commandSetBreakpointV1;
 	static wxString m_commandSetBreakpointV2;
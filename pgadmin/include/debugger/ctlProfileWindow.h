@@ -0,0 +1,85 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// ctlProfileWindow.h - debugger
+//
+//////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+//	class ctlProfileWindow
+//
+//	This class implements the window that displays the result of a profile run
+//  at the bottom of the debugger window.  When we create a ctlProfileWindow,
+//  the parent is a ctlTabWindow (the ctlProfileWindow becomes a tab in a tab
+//  control).
+//
+//	It is a virtual list control with one row per line of code the target
+//  paused at: the function, the line number, the number of hits and the time
+//  spent running the line.  Clicking a column header sorts the list on that
+//  column.
+//
+//	The ctlProfileWindow also keeps the figures themselves - the code window
+//  adds the hits and times as they arrive, and reads them back to draw the
+//  heat markers next to the source code.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CTLPROFILEWINDOW_H
+#define CTLPROFILEWINDOW_H
+
+#include <wx/hashmap.h>
+#include <wx/listctrl.h>
+
+class dbgProfileLine
+{
+public:
+	wxString	m_funcOid;		// OID of the function this line belongs to
+	wxString	m_funcName;		// Name of that function
+	int		m_lineNumber;	// Line number, as reported by the debugger
+	long	m_hits;			// Number of times the target paused at this line
+	double	m_time;			// Time spent running this line (in ms)
+};
+
+WX_DECLARE_OBJARRAY( dbgProfileLine, dbgProfileLineArray );
+
+class ctlProfileWindow : public wxListView
+{
+	DECLARE_CLASS( ctlProfileWindow )
+
+public:
+	ctlProfileWindow( wxWindow *parent, wxWindowID id );
+
+	void	clear();														// Forget all of the figures
+	void	addHit( const wxString &funcOid, const wxString &funcName, int lineNumber );	// Count a pause at the given line
+	void	addTime( const wxString &funcOid, int lineNumber, double time );			// Add the time spent running the given line
+	void	refresh();														// Sort and redisplay the figures
+
+	const dbgProfileLineArray &getLines()
+	{
+		return( m_lines );
+	}
+	double	getMaxTime();													// Time of the slowest line
+
+	wxString OnGetItemText( long item, long col ) const;
+
+private:
+	void	OnColumnClick( wxListEvent &event );
+	dbgProfileLine *findLine( const wxString &funcOid, int lineNumber );
+
+	WX_DECLARE_STRING_HASH_MAP( size_t, wsLineHash );
+
+	dbgProfileLineArray	m_lines;	// Figures, in the order the lines were first seen
+	wsLineHash	m_lineMap;		// Maps "funcOid:lineNumber" to an index into m_lines
+	wxArrayInt	m_order;		// Indexes into m_lines, in display order
+	double	m_totalTime;		// Time spent running all of the lines
+	int		m_sortColumn;		// Column the list is sorted on
+	bool	m_sortAscending;	// Sort order
+
+	DECLARE_EVENT_TABLE()
+};
+
+#endif
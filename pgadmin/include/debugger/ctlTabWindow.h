@@ -31,6 +31,7 @@
 #include "debugger/ctlMessageWindow.h"
 #include "debugger/ctlStackWindow.h"
 #include "debugger/ctlResultGrid.h"
+#include "debugger/ctlProfileWindow.h"
 
 WX_DECLARE_HASH_MAP( int, int, wxIntegerHash, wxIntegerEqual, wsTabHash );
 
@@ -49,6 +50,7 @@ public:
 	ctlResultGrid	*getResultWindow( void );					// Returns a pointer to the result window (creates it if necessary)
 	ctlStackWindow	*getStackWindow( void );					// Returns a pointer to the stack-trace window (creates it if necessary)
 	ctlMessageWindow *getMessageWindow( void );					// Returns a pointer to the DBMS messages window (creates it if necessary)
+	ctlProfileWindow *getProfileWindow( bool create = true );	// Returns a pointer to the profile window (creates it if requested)
 	void	selectTab( wxWindowID id );
 
 private:
@@ -58,6 +60,7 @@ private:
 	ctlStackWindow	*m_stackWindow;		// Displays the current call stack
 	ctlVarWindow	*m_paramWindow;		// Displays the parameters when debugging a PL function
 	ctlMessageWindow	*m_messageWindow;	// Displays the DBMS messages when debugging a PL function
+	ctlProfileWindow	*m_profileWindow;	// Displays the result of a profile run
 
 	wsTabHash	*m_tabMap;		// Map window ID's to tab numbers;
 };
@@ -54,6 +54,7 @@ private:
 		int		m_row;	 // Row number for this variable/grid cell
 		wxString	m_value; // Variable value
 		wxString	m_type;	 // Variable type
+		bool		m_changed; // Value changed at last update?
 	} gridCell;
 
 	enum
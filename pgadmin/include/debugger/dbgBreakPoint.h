@@ -53,4 +53,28 @@ private:
 
 WX_DECLARE_LIST( dbgBreakPoint, dbgBreakPointList );
 
+////////////////////////////////////////////////////////////////////////////////
+// class dbgBreakCondition
+//
+//	A condition attached to the breakpoint at one line of code.  The target
+//  only stops at that breakpoint from the m_hitCount'th hit on, and only when
+//  the m_expression (if any) is true for the values of the variables at that
+//  point.  Conditions are evaluated by the worker thread (see dbgPgThread), so
+//  the hits that don't match never reach the user interface.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class dbgBreakCondition
+{
+public:
+	dbgBreakCondition() : m_hitCount( 0 ), m_hits( 0 ) {}
+	dbgBreakCondition( const wxString &expression, long hitCount ) : m_expression( expression ), m_hitCount( hitCount ), m_hits( 0 ) {}
+
+	wxString	m_expression;	// SQL boolean expression on the variables (may be empty)
+	long	m_hitCount;			// First hit to stop at (0 or 1 to stop at every hit)
+	long	m_hits;				// Number of hits so far
+};
+
+WX_DECLARE_STRING_HASH_MAP( dbgBreakCondition, dbgBreakConditionHash );
+
 #endif
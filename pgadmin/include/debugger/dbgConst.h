@@ -28,6 +28,7 @@ const int  	ID_PARAMGRID   = 1000;
 const int  	ID_VARGRID	   = 1001;
 const int 	ID_MSG_PAGE	   = 1002;
 const int	ID_PKGVARGRID  = 1003;
+const int	ID_PROFILE_PAGE = 1004;
 
 #endif
 
@@ -80,6 +80,9 @@ public:
 	void Cancel();                          // Cancel any ongoing queries
 
 	void startCommand( const wxString &command, wxEvtHandler *caller, wxEventType eventType = wxEVT_NULL, dbgPgParams *params = NULL );     // Starts executing a command
+	void startCommand( const wxString &command, const wxString &resumeCommand, wxEvtHandler *caller, wxEventType eventType );	// Starts a command that stops only where a breakpoint condition holds
+	void setBreakCondition( const wxString &funcOid, int lineNumber, const wxString &expression, long hitCount );	// Sets (or removes) the condition of a breakpoint
+	bool getBreakCondition( const wxString &funcOid, int lineNumber, dbgBreakCondition &condition );	// Reads the condition of a breakpoint
 	void setNoticeHandler( PQnoticeProcessor handler, void *arg );  // Registers a NOTICE handler
 	PGresult *waitForCommand( const wxString &command );            // Starts a command and waits for completion
 
@@ -29,19 +29,59 @@
 #ifndef DBGPGTHREAD_H
 #define DBGPGTHREAD_H
 
+#include <libpq-fe.h>
+
+#include "debugger/dbgBreakPoint.h"
+
 // #include "debugger/dbgPgConn.h"
 class dbgPgConn;
 class dbgPgParams;
 
+////////////////////////////////////////////////////////////////////////////////
+// class dbgPgResults
+//
+//    A command may hold several statements separated by semicolons, to get the
+//  results of all of them in a single round trip. The event posted for such a
+//  command still carries the first result as its client data, and a
+//  dbgPgResults object with the results of the following statements, in
+//  order, as its client object. The event handler owns that object - deleting
+//  it clears the results it holds.
+
+class dbgPgResults : public wxClientData
+{
+public:
+	~dbgPgResults();
+
+	void Add( PGresult *result )
+	{
+		m_results.Add( result );
+	}
+	size_t GetCount()
+	{
+		return( m_results.GetCount());
+	}
+	PGresult *Item( size_t index )
+	{
+		return((PGresult *)m_results.Item( index ));
+	}
+
+private:
+	wxArrayPtrVoid m_results;
+};
+
 class dbgPgThreadCommand
 {
 public:
-	dbgPgThreadCommand( const wxString &command, wxEvtHandler *caller, wxEventType eventType = wxEVT_NULL, dbgPgParams *params = NULL ) : m_command( command ), m_caller( caller ), m_eventType( eventType ), m_params( params ) {};
+	dbgPgThreadCommand( const wxString &command, wxEvtHandler *caller, wxEventType eventType = wxEVT_NULL, dbgPgParams *params = NULL, const wxString &resumeCommand = wxEmptyString ) : m_command( command ), m_caller( caller ), m_eventType( eventType ), m_params( params ), m_resumeCommand( resumeCommand ) {};
 
 	wxString    &getCommand()
 	{
 		return m_command;
 	}
+	wxString    &getResumeCommand()
+	{
+		return m_resumeCommand;
+	}
 	dbgPgParams *getParams()
 	{
 		return m_params;
@@ -61,6 +101,7 @@ private:
 	wxEvtHandler    *m_caller;    // Event handler that we post results to
 	wxEventType    m_eventType;    // Event to report when result set arrives
 	dbgPgParams *m_params;
+	wxString    m_resumeCommand;    // Command that resumes the target when a breakpoint condition does not hold
 };
 
 WX_DECLARE_LIST( dbgPgThreadCommand, ThreadCommandList );
@@ -72,14 +113,21 @@ public:
 	dbgPgThread(dbgPgConn &owner);
 
 	virtual void *Entry();
-	void startCommand( const wxString &command, wxEvtHandler *caller, wxEventType eventType = wxEVT_NULL, dbgPgParams *params = NULL );
+	void startCommand( const wxString &command, wxEvtHandler *caller, wxEventType eventType = wxEVT_NULL, dbgPgParams *params = NULL, const wxString &resumeCommand = wxEmptyString );
 	void Die();
 
+	void setBreakCondition( const wxString &funcOid, int lineNumber, const wxString &expression, long hitCount );
+	bool getBreakCondition( const wxString &funcOid, int lineNumber, dbgBreakCondition &condition );
+
 private:
 
 	static void noticeHandler( void *arg, const char *message );
 
 	dbgPgThreadCommand *getNextCommand();     // Grab next command from queue
+	bool execute( const wxString &command, PGresult **result, dbgPgResults **results );    // Run a command, wait for its results
+	bool breakConditionHolds( PGresult *pause, dbgPgResults *state );    // Should the target stay paused?
+	bool evaluateCondition( const wxString &expression, PGresult *vars );
+	void postMessage( const wxString &message );
 
 	dbgPgConn &m_owner;        // Connection to the PostgreSQL server
 	wxSemaphore m_queueCounter;        // Number of entries in queue (thread synchronizer)
@@ -87,6 +135,9 @@ private:
 	ThreadCommandList m_commandQueue;        // Queue of pending commands
 
 	dbgPgThreadCommand *m_currentCommand;    // Currently executing command
+
+	wxMutex m_conditionMutex;        // Mutex to serialize access to m_conditions
+	dbgBreakConditionHash m_conditions;        // Breakpoint conditions, by "funcOid:lineNumber"
 	wxMBConv *conv;
 	long run;
 	bool die;
@@ -51,9 +51,11 @@ enum
 
     MENU_ID_TOGGLE_BREAK,               // Set/Unset breakpoint
     MENU_ID_CLEAR_ALL_BREAK,            // Clear all breakpoints
+    MENU_ID_BREAK_CONDITION,            // Set the condition of a breakpoint
     MENU_ID_CONTINUE,                   // Continue
     MENU_ID_STEP_OVER,                  // Step over
     MENU_ID_STEP_INTO,                  // Step into
+    MENU_ID_PROFILE,                    // Profile (step to the end, timing each line)
     MENU_ID_STOP,                       // Stop debugging
 
     MENU_ID_SPAWN_DEBUGGER,             // Spawn a separate debugger process
@@ -86,6 +88,7 @@ enum
     RESULT_ID_LISTENER_CREATED,         // Debugger - global listener created
     RESULT_ID_TARGET_READY,             // Debugger - target session attached
     RESULT_ID_LAST_BREAKPOINT,          // Debugger - last breakpoint created
+    RESULT_ID_PROFILE_STEP,             // Debugger - step complete while profiling
 
     RESULT_ID_DIRECT_TARGET_COMPLETE,   // DirectDebug - target function complete
 
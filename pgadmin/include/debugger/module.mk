@@ -12,6 +12,7 @@
 pgadmin3_SOURCES += \
 	include/debugger/ctlCodeWindow.h \
 	include/debugger/ctlMessageWindow.h \
+	include/debugger/ctlProfileWindow.h \
 	include/debugger/ctlResultGrid.h \
 	include/debugger/ctlStackWindow.h \
 	include/debugger/ctlTabWindow.h \
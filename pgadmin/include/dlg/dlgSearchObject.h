@@ -17,6 +17,103 @@
 #include "schema/pgDatabase.h"
 #include "utils/sysSettings.h"
 
+WX_DECLARE_STRING_HASH_MAP(wxString, searchObjectLngMap);
+WX_DECLARE_STRING_HASH_MAP(bool, searchObjectEnabledMap);
+
+// One search hit, with the browser path already resolved and translated
+class searchObjectResult
+{
+public:
+	wxString type, name, path;
+	bool enabled;
+};
+
+WX_DECLARE_OBJARRAY(searchObjectResult, searchObjectResultArray);
+WX_DEFINE_ARRAY_SIZE_T(size_t, searchObjectPostingList);
+WX_DECLARE_STRING_HASH_MAP(searchObjectPostingList, searchObjectTrigramMap);
+
+// Client side trigram index over the results of a completed search. Any
+// later search whose pattern contains the indexed pattern (and whose type
+// is covered by it) can be answered from here without asking the server,
+// until the index is too old to trust after changes to the schema.
+class searchObjectIndex
+{
+public:
+	searchObjectIndex(const wxString &pattern, const wxString &type);
+
+	void Add(const searchObjectResult &res);
+	bool Covers(const wxString &pattern, const wxString &type) const;
+	bool IsSearch(const wxString &pattern, const wxString &type) const
+	{
+		return indexPattern == pattern && indexType == type;
+	}
+	bool IsExpired() const;
+	void Search(const wxString &pattern, const wxString &type, searchObjectResultArray &hits) const;
+
+private:
+	wxString indexPattern, indexType;
+	long created;
+	searchObjectResultArray rows;
+	wxArrayString lowerNames;
+	searchObjectTrigramMap trigrams;
+};
+
+WX_DEFINE_ARRAY_PTR(searchObjectIndex *, searchObjectIndexArray);
+
+// Virtual list, rows are only materialized when they are painted
+class searchObjectResultList : public wxListView
+{
+public:
+	searchObjectResultList(wxWindow *parent, searchObjectResultArray *res);
+
+	wxString OnGetItemText(long item, long col) const;
+	wxListItemAttr *OnGetItemAttr(long item) const;
+
+private:
+	searchObjectResultArray *results;
+	wxListItemAttr *disabledAttr;
+};
+
+// Runs the catalog query through a cursor on a private connection and
+// hands the rows over to the dialogue in batches.
+class searchObjectThread : public wxThread
+{
+public:
+	searchObjectThread(pgConn *_conn, const wxString &_sql, const wxString &_databasePath,
+	                   const searchObjectLngMap &_translations, const searchObjectEnabledMap &_enabled,
+	                   wxWindow *_caller, int _generation);
+
+	virtual void *Entry();
+	void Cancel();
+	void GetResults(searchObjectResultArray &target);
+	bool Failed() const
+	{
+		return failed;
+	}
+	// Only to be read once the thread has ended
+	wxString GetError() const
+	{
+		return error;
+	}
+
+private:
+	bool BuildResult(PGresult *res, int row, searchObjectResult &item);
+	wxString TranslatePath(const wxString &path);
+	void RaiseEvent(int id);
+
+	pgConn *conn;
+	wxString sql, databasePath, serverPath;
+	searchObjectLngMap translations;
+	searchObjectEnabledMap enabled;
+	wxWindow *caller;
+	int generation;
+
+	wxCriticalSection criticalSection;
+	searchObjectResultArray pending;
+	bool failed;
+	wxString error;
+};
+
 // Class declarations
 class dlgSearchObject : public pgDialog
 {
@@ -28,16 +125,32 @@ private:
 	void OnHelp(wxCommandEvent &ev);
 	void OnSearch(wxCommandEvent &ev);
 	void OnCancel(wxCommandEvent &ev);
+	void OnClose(wxCloseEvent &ev);
 	void OnChange(wxCommandEvent &ev);
 	void OnSelSearchResult(wxListEvent &ev);
-	wxString TranslatePath(wxString &path);
-	WX_DECLARE_STRING_HASH_MAP(wxString, LngMapping);
-	LngMapping aMap;
+	void OnSearchBatch(wxCommandEvent &ev);
+	void OnSearchComplete(wxCommandEvent &ev);
+
+	wxString GetSearchSql();
+	void StartSearch();
+	void StopSearch();
+	void ShowResults(bool complete);
+	void AddIndex(searchObjectIndex *index);
+
+	searchObjectLngMap aMap;
+	searchObjectLngMap pathTranslations;
 
 	pgDatabase *currentdb;
+	pgConn *searchConn;
 	frmMain *parent;
-	wxString header;
-	wxArrayString sectionName, sectionData, sectionTableHeader, sectionTableRows, sectionTableInfo, sectionSql;
+	searchObjectResultList *lcResults;
+	searchObjectResultArray results;
+	searchObjectThread *thread;
+	searchObjectIndex *currentIndex;
+	searchObjectIndexArray indexes;
+	int searchGeneration;           // events of older searches are ignored
+	wxString searchPattern, searchType;
+	bool columnsSized;
 
 	DECLARE_EVENT_TABLE()
 };
@@ -40,7 +40,7 @@ private:
 	pgObject *object;
 
 	wxString backupExecutable;
-	bool canBlob;
+	bool canBlob, canParallel;
 	wxString processedFile;
 
 	DECLARE_EVENT_TABLE()
@@ -17,6 +17,7 @@
 #include "utils/factory.h"
 
 class frmMain;
+class sysProcessQueue;
 
 class frmBackupServer : public ExternProcessDialog
 {
@@ -32,13 +33,23 @@ private:
 	wxString GetHelpPage() const;
 	void OnChange(wxCommandEvent &ev);
 	void OnSelectFilename(wxCommandEvent &ev);
-	wxString getCmdPart1();
+	void OnChangePerDatabase(wxCommandEvent &ev);
+	void OnSelectJob(wxListEvent &ev);
+	void OnQueueUpdate(wxCommandEvent &ev);
+	void OnCancel(wxCommandEvent &ev);
+	void OnClose(wxCloseEvent &ev);
+	wxString getCmdPart1(const wxString &executable);
+	wxString getCmdOptions();
 	wxString getCmdPart2();
 	void OnOK(wxCommandEvent &ev);
+	void StartQueue();
 
 	pgObject *object;
 	wxString processedFile;
-	wxString backupExecutable;
+	wxString backupExecutable, dumpExecutable;
+
+	sysProcessQueue *queue;
+	bool queueReported;
 
 	DECLARE_EVENT_TABLE()
 };
@@ -42,6 +42,7 @@
 #endif
 class pgServer;
 class pgServerCollection;
+class pgServerConnector;
 class ctlSQLBox;
 class ctlTree;
 class dlgProperty;
@@ -177,6 +178,7 @@ private:
 	wxMenu *newMenu, *debuggingMenu, *reportMenu, *toolsMenu, *pluginsMenu, *viewMenu,
 	       *treeContextMenu, *newContextMenu, *slonyMenu, *scriptingMenu, *viewDataMenu;
 	pgServerCollection *serversObj;
+	pgServerConnector *serverConnector;
 
 	pluginUtilityFactory *lastPluginUtility;
 	int pluginUtilityCount;
@@ -233,6 +235,7 @@ private:
 	void OnCopy(wxCommandEvent &ev);
 
 	void OnCheckAlive(wxCommandEvent &event);
+	void OnServerConnected(wxCommandEvent &event);
 
 	void OnPositionStc(wxStyledTextEvent &event);
 
@@ -241,6 +244,7 @@ private:
 	void doPopup(wxWindow *win, wxPoint point, pgObject *object);
 	void setDisplay(pgObject *data, ctlListView *props = 0, ctlSQLBox *sqlbox = 0);
 	void RetrieveServers();
+	void ReconnectServers();
 	bool reportError(const wxString &error, const wxString &msgToIdentify, const wxString &hint);
 	wxTreeItemId RestoreEnvironment(pgServer *server);
 
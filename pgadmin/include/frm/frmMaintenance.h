@@ -28,6 +28,16 @@ public:
 private:
 	wxString GetHelpPage() const;
 	void OnAction(wxCommandEvent &ev);
+	void OnOK(wxCommandEvent &ev);
+	void OnCancel(wxCommandEvent &ev);
+	void OnClose(wxCloseEvent &ev);
+
+	wxString GetVacuumOptions();
+	wxString GetTableSql(const wxString &table);
+	bool CanRunPerTable();
+	void RunPerTable();
+
+	bool running, perTableDone, cancelRequested, closeRequested;
 
 	DECLARE_EVENT_TABLE()
 };
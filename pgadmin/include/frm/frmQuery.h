@@ -47,6 +47,7 @@
 #endif
 
 class ExplainCanvas;
+class ExplainHotNodes;
 class ctlSQLResult;
 class pgsApplication;
 class pgScriptTimer;
@@ -114,13 +115,15 @@ private:
 	ctlAuiNotebook *outputPane;
 	ctlSQLResult *sqlResult;
 	ExplainCanvas *explainCanvas;
+	ExplainHotNodes *explainHotNodes;
 	wxTextCtrl *msgResult, *msgHistory;
 	wxBitmapComboBox *cbConnection;
 	wxTextCtrl *scratchPad;
 	wxComboBox *sqlQueries;
 	wxButton *btnDeleteCurrent;
 	wxButton *btnDeleteAll;
-	wxArrayString histoQueries;
+	wxTextCtrl *txtHistoryFilter;
+	wxArrayString histoQueries;     // the queries shown in sqlQueries
 
 	// Query timing/status update
 	wxTimer timer;
@@ -133,6 +136,16 @@ private:
 	wxTextOutputStream pgsOutput;
 	pgScriptTimer *pgsTimer;
 
+	// Statement by statement execution
+	wxArrayString scriptStatements;
+	wxArrayInt scriptOffsets;       // position of each statement in the editor
+	size_t scriptNext;              // next statement to run
+	int scriptErrors, scriptSucceeded;
+	ctlSQLResult *scriptResult;     // runs the current statement
+	wxArrayPtrVoid scriptPages;     // result tabs of the last run
+	wxLongLong startTimeStatement;
+	bool scriptRunning;
+
 	//GQB related
 	void OnChangeNotebook(wxAuiNotebookEvent &event);
 	void OnAdjustSizesTimer(wxTimerEvent &event);
@@ -166,6 +179,8 @@ private:
 	void OnExecute(wxCommandEvent &event);
 	void OnExecScript(wxCommandEvent &event);
 	void OnExecFile(wxCommandEvent &event);
+	void OnExecStatements(wxCommandEvent &event);
+	void OnStopOnError(wxCommandEvent &event);
 	void OnExplain(wxCommandEvent &event);
 	void OnBuffers(wxCommandEvent &event);
 	void OnTiming(wxCommandEvent &event);
@@ -225,6 +240,11 @@ private:
 	void OnQueryComplete(wxCommandEvent &ev);
 	void completeQuery(bool done, bool explain, bool verbose);
 	void OnScriptComplete(wxCommandEvent &ev);
+	void execNextStatement();
+	void OnStatementComplete(wxCommandEvent &ev);
+	void completeStatements();
+	void clearStatementResults();
+	void markError(int errPos);
 	void setTools(const bool running);
 	void showMessage(const wxString &msg, const wxString &msgShort = wxT(""));
 	int GetLineEndingStyle();
@@ -233,8 +253,11 @@ private:
 	void OnMacroInvoke(wxCommandEvent &event);
 	void OnMacroManage(wxCommandEvent &event);
 
-	void LoadQueries();
-	void SaveQueries();
+	void FillHistory();
+	void HistoryAdded(const wxString &query);
+	void HistoryRemoved(const wxString &query);
+	void OnHistoryChanged(wxCommandEvent &event);
+	void OnHistoryFilter(wxCommandEvent &event);
 	void OnChangeQuery(wxCommandEvent &event);
 
 	wxBitmap CreateBitmap(const wxColour &colour);
@@ -260,10 +283,6 @@ private:
 	bool lastFileFormat;
 	bool m_loadingfile;
 
-	// A simple mutex-like flag to prevent concurrent script execution.
-	// Required because the pgScript parser isn't currently thread-safe :-(
-	static bool    ms_pgScriptRunning;
-
 	DECLARE_EVENT_TABLE()
 };
 
@@ -292,7 +311,8 @@ enum
     CTL_SQLQUERYCBOX,
     CTL_DELETECURRENTBTN,
     CTL_DELETEALLBTN,
-    CTL_SCRATCHPAD
+    CTL_SCRATCHPAD,
+    CTL_HISTORYFILTER
 };
 
 ///////////////////////////////////////////////////////
@@ -0,0 +1,49 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// frmQueryStats.h - Connection diagnostics window
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef FRMQUERYSTATS_H
+#define FRMQUERYSTATS_H
+
+#include "dlg/dlgClasses.h"
+
+class ctlListView;
+
+// Shows the most expensive statements pgAdmin has executed and the
+// latency histogram, as recorded by pgQueryStats
+class frmQueryStats : public pgFrame
+{
+public:
+	frmQueryStats(frmMain *form);
+	~frmQueryStats();
+
+private:
+	void FillLists();
+
+	void OnRefresh(wxCommandEvent &ev);
+	void OnReset(wxCommandEvent &ev);
+	void OnClose(wxCloseEvent &ev);
+
+	frmMain *mainForm;
+	wxChoice *cbSubsystem;
+	ctlListView *lstStatements, *lstHistogram;
+
+	DECLARE_EVENT_TABLE()
+};
+
+
+class queryStatsFactory : public actionFactory
+{
+public:
+	queryStatsFactory(menuFactoryList *list, wxMenu *mnu, ctlMenuToolbar *toolbar);
+	wxWindow *StartDialog(frmMain *form, pgObject *obj);
+};
+
+#endif
@@ -54,6 +54,8 @@ enum
     MNU_ASCSORT,
     MNU_DESCSORT,
     MNU_REMOVESORT,
+    MNU_CONDITIONFILTER,
+    MNU_AGGREGATE,
     MNU_PASTE,
     MNU_CLEAR,
     MNU_FIND,
@@ -70,12 +72,15 @@ enum
     MNU_COSTS,
     MNU_BUFFERS,
     MNU_TIMING,
+    MNU_EXPLAINXML,
     MNU_AUTOROLLBACK,
     MNU_CLEARHISTORY,
     MNU_SAVEHISTORY,
     MNU_CHECKALIVE,
     MNU_SELECTALL,
     MNU_EXECPGS,
+    MNU_EXECSTATEMENTS,
+    MNU_STOPONERROR,
 
     MNU_CONTENTS,
     MNU_HELP,
@@ -136,6 +141,20 @@ enum
     // This is used by the Query Tool - the event is fired when the query completes
     QUERY_COMPLETE = MNU_MACROS_MANAGE + 100,
     PGSCRIPT_COMPLETE,
+    STATEMENT_COMPLETE,
+
+    // Fired by the object search thread for each batch of rows and at the end
+    SEARCHOBJECT_BATCH,
+    SEARCHOBJECT_COMPLETE,
+
+    // Fired by the backup queue whenever one of its jobs changes
+    BACKUPQUEUE_UPDATE,
+
+    // Fired by the shared query history whenever its content changes
+    QUERYHISTORY_CHANGED,
+
+    // Fired by the startup connection threads as each server is done
+    SERVERCONNECT_COMPLETE,
 
     // This is a dummy menu item
     MNU_DUMMY = QUERY_COMPLETE + 1000,
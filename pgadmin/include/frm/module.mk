@@ -29,6 +29,7 @@ pgadmin3_SOURCES += \
 	include/frm/frmPassword.h \
 	include/frm/frmPgpassConfig.h \
 	include/frm/frmQuery.h \
+	include/frm/frmQueryStats.h \
 	include/frm/frmReport.h \
 	include/frm/frmRestore.h \
 	include/frm/frmSplash.h \
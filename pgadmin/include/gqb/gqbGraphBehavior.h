@@ -32,6 +32,10 @@ public:
 	// GQB-TODO find a way to not hard code the 17 default value
 	virtual gqbColumn *getColumnAtPosition(wxPoint *clickPoint, gqbQueryObject *queryTable, int sensibility = 17) = 0;
 	virtual bool clickOnJoin(gqbQueryJoin *join, wxPoint &pt, wxPoint &origin, wxPoint &dest) = 0;
+
+	// Area covered by a table or a join when drawn, used to repaint only what changed
+	virtual wxRect getTableBounds(gqbQueryObject *queryTable) = 0;
+	virtual wxRect getJoinBounds(wxPoint &origin, wxPoint &dest) = 0;
 	virtual int getTitleRowHeight() = 0;
 private:
 
@@ -30,6 +30,8 @@ public:
 	void UpdatePosObject(gqbQueryObject *queryTable, int x, int y, int cursorAdjustment);
 	gqbColumn *getColumnAtPosition(wxPoint *clickPoint, gqbQueryObject *queryTable, int sensibility = 17);
 	bool clickOnJoin(gqbQueryJoin *join, wxPoint &pt, wxPoint &origin, wxPoint &dest);
+	wxRect getTableBounds(gqbQueryObject *queryTable);
+	wxRect getJoinBounds(wxPoint &origin, wxPoint &dest);
 	int getTitleRowHeight();
 
 private:
@@ -39,6 +41,9 @@ private:
 	int rowHeight, rowLeftMargin, rowRightMargin, rowTopMargin, lineClickThreshold;
 	wxPen selectedPen;
 	wxBitmap imgSelBoxEmpty, imgSelBoxSelected;
+	void measureTable(wxMemoryDC &bdc, gqbQueryObject *queryTable, int &width, int &height);
+	void paintTable(wxDC &dc, wxPoint *origin, gqbQueryObject *queryTable, int width, int height);
+	wxString getTableState(gqbQueryObject *queryTable);
 	bool insideLine(wxPoint &pt, wxPoint &p1, wxPoint &p2, int threshold);
 	double distanceToLine(wxPoint pt, wxPoint p1, wxPoint p2);
 	wxPoint findLineMiddle(wxPoint p1, wxPoint p2);
@@ -59,6 +59,9 @@ public:
 	~gqbQueryObject();
 	gqbTable *parent;
 	wxPoint position;
+	// Image of the table as last drawn by the view, and the state it shows
+	wxBitmap cachedImage;
+	wxString cachedState;
 	void setSelected(bool value);
 	bool getSelected();
 	void setWidth(int value);
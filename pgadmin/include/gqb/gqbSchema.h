@@ -16,6 +16,8 @@
 #include "gqb/gqbObject.h"
 #include "gqb/gqbTable.h"
 
+WX_DECLARE_HASH_MAP(OID, gqbTable *, wxIntegerHash, wxIntegerEqual, gqbTablesOidMap);
+
 class gqbSchema : public gqbObject
 {
 public:
@@ -24,5 +26,6 @@ public:
 
 private:
 	void createTables(gqbBrowser *tablesBrowser, wxTreeItemId parentNode, OID oidVal, int tableImage, int viewImage, int xTableImage);
+	void createColumns(gqbTablesOidMap &tablesByOid, OID oidVal);
 };
 #endif
@@ -24,7 +24,7 @@ class gqbTable : public gqbObjectCollection
 {
 public:
 	gqbTable(gqbObject *parent, wxString name, pgConn *connection, type_gqbObject type, OID oid);
-	void createObjects(gqbBrowser *_tablesBrowser,  pgConn *_conn, OID oidVal, wxTreeItemId parentNode);
+	void createColumns(pgSet *columns);
 	gqbIteratorBase *createColumnsIterator();
 	int countCols();
 	gqbColumn *getColumnAtIndex(int index);
@@ -32,7 +32,5 @@ public:
 
 private:
 	void addColumn(gqbColumn *column);    // Used only as synonym for gqbObjectCollection addObject
-	void createColumns(pgConn *conn, gqbBrowser *tablesBrowser, wxTreeItemId parentNode,  OID oidVal);
-
 };
 #endif
@@ -140,7 +140,7 @@ public:
 	~gqbView();
 	void SaveAsImage(const wxString &path, wxBitmapType imgType);
 	bool canSaveAsImage();
-	void drawAll(wxMemoryDC &bdc, bool adjustScrolling);
+	void drawAll(wxMemoryDC &bdc, bool adjustScrolling, wxRect *damaged = NULL);
 	void setPointerMode(pointerMode pm);
 
 	// Events for wxScrolledWindow
@@ -205,6 +205,7 @@ private:
 	gqbColumn *joinSCol, *joinDCol;
 	int pressed, selected, refreshRate;
 	wxPoint pos, jpos;            // Position of the last event of the mouse & the first event of a join event
+	wxRect dragDamage;            // Model area changed while dragging and not refreshed yet
 	pointerMode mode;             // pointer is used as normally or as in joins by example
 	wxImage joinCursorImage;
 	wxCursor joinCursor;
@@ -213,6 +214,8 @@ private:
 	void OnMenuTableDelete(wxCommandEvent &event);
 	void OnMenuTableSetAlias(wxCommandEvent &event);
 	void OnRefresh(wxCommandEvent &ev);
+	wxRect getTableDamage(gqbQueryObject *queryTable);
+	void refreshModelRect(const wxRect &area);
 
 	wxArrayString joinTypeChoices;
 
@@ -14,6 +14,7 @@
 
 #include "hotdraw/figures/hdIFigure.h"
 #include "hotdraw/utilities/hdRect.h"
+#include "hotdraw/utilities/hdSpatialIndex.h"
 
 
 // Main model of drawing
@@ -26,6 +27,10 @@ public:
 	virtual void remove(hdIFigure *figure);
 	virtual bool includes(hdIFigure *figure);
 	virtual hdIFigure *findFigure(int posIdx, int x, int y);
+	virtual hdRect figureExtent(int posIdx, hdIFigure *figure);
+	virtual void invalidateIndex();
+	virtual void validateIndex(int posIdx);
+	virtual bool updateIndex(int posIdx, hdRect &damaged);
 	virtual void recalculateDisplayBox(int posIdx);
 	virtual void bringToFront(hdIFigure *figure);
 	virtual void sendToBack(hdIFigure *figure);
@@ -81,5 +86,9 @@ private:
 	hdCollection *handles;
 	hdRect displayBox;
 	wxString drawingName;
+	//Bounds of figures to avoid testing all of them at each mouse event
+	hdSpatialIndex figuresIndex;
+	int indexPosIdx;
+	bool indexValid;
 };
 #endif
@@ -0,0 +1,46 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// hdSpatialIndex.h - Grid of figure bounds used to find figures by position
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef HDSPATIALINDEX_H
+#define HDSPATIALINDEX_H
+#include "hotdraw/utilities/hdRect.h"
+
+WX_DECLARE_OBJARRAY(hdRect, hdRectArray);
+
+// Uniform grid laid over the bounds of a list of items. Items are known by
+// their number (position at owner collection) and each cell keeps, in
+// ascending order, the numbers of the items whose bounds overlap it.
+// Bounds outside the grid area are stored at the nearest border cells, so
+// the grid stays valid when items move after it was built.
+class hdSpatialIndex
+{
+public:
+	hdSpatialIndex();
+	~hdSpatialIndex();
+	void reset(hdRect area);
+	void append(hdRect bounds);
+	void update(int item, hdRect bounds);
+	hdRect &getBounds(int item);
+	int count();
+	wxArrayInt &itemsAt(int x, int y);
+
+private:
+	int cellColumn(int x);
+	int cellRow(int y);
+	void addToCells(int item, hdRect &bounds);
+	void removeFromCells(int item, hdRect &bounds);
+
+	hdRect gridArea;
+	int cellSize, columns, rows;
+	wxArrayInt *cells;
+	hdRectArray itemsBounds;
+};
+#endif
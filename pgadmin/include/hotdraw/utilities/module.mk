@@ -19,6 +19,7 @@ pgadmin3_SOURCES += \
 	include/hotdraw/utilities/hdMouseEvent.h \
 	include/hotdraw/utilities/hdPoint.h \
 	include/hotdraw/utilities/hdRect.h \
+	include/hotdraw/utilities/hdSpatialIndex.h \
 	include/hotdraw/utilities/hdRemoveDeleteDialog.h
 
 EXTRA_DIST += \
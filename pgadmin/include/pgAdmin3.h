@@ -85,6 +85,9 @@ extern wxString settingsIni;            // The default settings file
 
 extern sysSettings *settings;           // The settings manager
 
+class sysQueryHistory;
+extern sysQueryHistory *queryHistory;   // The query tool history
+
 extern frmMain *winMain;                // The main app window
 
 extern wxLocale *locale;                // Application locale
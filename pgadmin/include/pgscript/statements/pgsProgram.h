@@ -17,6 +17,7 @@
 #include <wx/thread.h>
 
 class pgsStmtList;
+class pgsThread;
 
 class pgsProgram
 {
@@ -25,9 +26,11 @@ private:
 
 	pgsVarMap &m_vars;
 
+	pgsThread *m_app;
+
 public:
 
-	pgsProgram(pgsVarMap &vars);
+	pgsProgram(pgsVarMap &vars, pgsThread *app = 0);
 
 	~pgsProgram();
 
@@ -25,10 +25,6 @@ private:
 
 	pgsOutputStream &m_cout;
 
-public:
-
-	static bool m_exception_thrown;
-
 public:
 
 	pgsStmtList(pgsOutputStream &cout, pgsThread *app = 0);
@@ -68,28 +68,39 @@ extern "C" {
     "MAPM Library Version 4.9.5  Copyright (C) 1999-2007, Michael C. Ring"
 #define MAPM_LIB_SHORT_VERSION "4.9.5"
 
+	/*
+	 *	the constants and work areas of the library are kept per
+	 *	thread, so pgScript programs can run concurrently
+	 */
+
+#ifdef _MSC_VER
+#define M_THREAD_LOCAL __declspec(thread)
+#else
+#define M_THREAD_LOCAL __thread
+#endif
+
 
 	/*
 	 *	convienient predefined constants
 	 */
 
-	extern	M_APM	MM_Zero;
-	extern	M_APM	MM_One;
-	extern	M_APM	MM_Two;
-	extern	M_APM	MM_Three;
-	extern	M_APM	MM_Four;
-	extern	M_APM	MM_Five;
-	extern	M_APM	MM_Ten;
+	extern M_THREAD_LOCAL	M_APM	MM_Zero;
+	extern M_THREAD_LOCAL	M_APM	MM_One;
+	extern M_THREAD_LOCAL	M_APM	MM_Two;
+	extern M_THREAD_LOCAL	M_APM	MM_Three;
+	extern M_THREAD_LOCAL	M_APM	MM_Four;
+	extern M_THREAD_LOCAL	M_APM	MM_Five;
+	extern M_THREAD_LOCAL	M_APM	MM_Ten;
 
-	extern	M_APM	MM_PI;
-	extern	M_APM	MM_HALF_PI;
-	extern	M_APM	MM_2_PI;
-	extern	M_APM	MM_E;
+	extern M_THREAD_LOCAL	M_APM	MM_PI;
+	extern M_THREAD_LOCAL	M_APM	MM_HALF_PI;
+	extern M_THREAD_LOCAL	M_APM	MM_2_PI;
+	extern M_THREAD_LOCAL	M_APM	MM_E;
 
-	extern	M_APM	MM_LOG_E_BASE_10;
-	extern	M_APM	MM_LOG_10_BASE_E;
-	extern	M_APM	MM_LOG_2_BASE_E;
-	extern	M_APM	MM_LOG_3_BASE_E;
+	extern M_THREAD_LOCAL	M_APM	MM_LOG_E_BASE_10;
+	extern M_THREAD_LOCAL	M_APM	MM_LOG_10_BASE_E;
+	extern M_THREAD_LOCAL	M_APM	MM_LOG_2_BASE_E;
+	extern M_THREAD_LOCAL	M_APM	MM_LOG_3_BASE_E;
 
 
 	/*
@@ -196,7 +207,7 @@ extern
 #ifdef APM_CONVERT_FROM_C
 "C"
 #endif
-int MM_cpp_min_precision;
+M_THREAD_LOCAL int MM_cpp_min_precision;
 
 
 class MAPM
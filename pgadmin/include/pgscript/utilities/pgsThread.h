@@ -49,6 +49,10 @@ private:
 	/** Location of the last error if there was one otherwise -1 */
 	int m_last_error_line;
 
+	/** Whether the error of the current statement was already printed
+	 * by an inner statement list. */
+	bool m_error_reported;
+
 public:
 
 	/** Parses a file with the provided encoding. */
@@ -81,6 +85,12 @@ public:
 	/** Get the position (line) of the last error. */
 	int last_error_line() const;
 
+	/** Set whether the current error has been printed. */
+	void error_reported(bool reported);
+
+	/** Get whether the current error has been printed. */
+	bool error_reported() const;
+
 private:
 
 	pgsThread(const pgsThread &that);
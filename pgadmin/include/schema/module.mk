@@ -46,6 +46,7 @@ pgadmin3_SOURCES += \
 	include/schema/pgSchema.h \
 	include/schema/pgSequence.h \
 	include/schema/pgServer.h \
+	include/schema/pgServerConnector.h \
 	include/schema/pgTable.h \
 	include/schema/pgTablespace.h \
   	include/schema/pgTextSearchConfiguration.h \
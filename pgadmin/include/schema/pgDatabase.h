@@ -64,7 +64,6 @@ public:
 	pgSet *ExecuteSet(const wxString &sql);
 	wxString ExecuteScalar(const wxString &sql);
 	bool ExecuteVoid(const wxString &sql, bool reportError = true);
-	void UpdateDefaultSchema();
 
 	pgConn *CreateConn(const wxString &applicationname)
 	{
@@ -230,7 +229,7 @@ public:
 	{
 		return true;
 	}
-	pgConn *connection();
+	pgConn *connection(bool resume = true);
 	int Connect();
 	void Disconnect();
 	void CheckAlive();
@@ -17,6 +17,7 @@
 
 
 class frmMain;
+class pgConnPool;
 
 
 class pgServerFactory : public pgaFactory
@@ -51,6 +52,9 @@ public:
 	}
 	wxString GetTranslatedMessage(int kindOfMessage) const;
 	int Connect(frmMain *form, bool askPassword = true, const wxString &pwd = wxEmptyString, bool forceStorePassword = false);
+	int AttachConnection(frmMain *form, pgConn *newConn);
+	void ReadServerInfo(pgConn *newConn);
+	void ReadCatalogInfo(pgConn *newConn);
 	bool Disconnect(frmMain *form);
 	void StorePassword();
 	bool GetPasswordIsStored();
@@ -93,7 +97,7 @@ public:
 	}
 	wxString GetPassword() const
 	{
-		return (password == wxEmptyString ? conn->GetPassword() : password);
+		return (password == wxEmptyString && conn ? conn->GetPassword() : password);
 	}
 	bool GetStorePwd() const
 	{
@@ -267,6 +271,22 @@ public:
 	{
 		return connected;
 	}
+	bool GetConnecting() const
+	{
+		return connecting;
+	}
+	void iSetConnecting(const bool b)
+	{
+		connecting = b;
+	}
+	bool GetReconnect() const
+	{
+		return reconnect;
+	}
+	void iSetReconnect(const bool b)
+	{
+		reconnect = b;
+	}
 	void iSetService(const wxString &newVal)
 	{
 		service = newVal;
@@ -362,11 +382,11 @@ public:
 	bool GetCanHint();
 	bool CanEdit()
 	{
-		return true;
+		return !connecting;
 	}
 	bool CanDrop()
 	{
-		return true;
+		return !connecting;
 	}
 	bool CanBackupGlobals()
 	{
@@ -389,6 +409,10 @@ public:
 	{
 		return conn;
 	}
+	pgConnPool *GetConnPool()
+	{
+		return pool;
+	}
 
 
 	wxString GetSSLCert() const
@@ -438,10 +462,13 @@ public:
 
 private:
 	wxString passwordFilename();
+	void FinishConnect(frmMain *form);
 
 	pgConn *conn;
+	pgConnPool *pool;
 	long serverIndex;
-	bool connected, passwordValid, autovacuumRunning;
+	bool connected, connecting, reconnect, passwordValid, autovacuumRunning;
+	bool catalogInfoRead, pgAgentAvailable;
 	wxString service, hostaddr, database, username, password, rolename, ver, error;
 	wxString lastDatabase, lastSchema, description, serviceId, discoveryId;
 	wxDateTime upSince;
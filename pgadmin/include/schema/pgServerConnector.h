@@ -0,0 +1,88 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// pgServerConnector.h - Reconnect servers in the background at startup
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef PGSERVERCONNECTOR_H
+#define PGSERVERCONNECTOR_H
+
+#include <wx/wx.h>
+#include <wx/thread.h>
+#include <libpq-fe.h>
+
+class frmMain;
+class pgConn;
+class pgServer;
+class pgServerConnector;
+
+
+// A server to connect, with its connection settings copied on the GUI
+// thread so the worker never shares a string with it
+class pgServerConnectJob
+{
+public:
+	pgServer *server;
+	wxString host, hostaddr, service, database, username, password, rolename;
+	wxString applicationname, sslcert, sslkey, sslrootcert, sslcrl;
+	int port, ssl;
+	bool sslcompression;
+	pgConn *conn;
+	PGcancel *cancel;           // set while the probe queries run
+};
+
+WX_DEFINE_ARRAY_PTR(pgServerConnectJob *, pgServerConnectJobArray);
+
+
+class pgServerConnectThread : public wxThread
+{
+public:
+	pgServerConnectThread(pgServerConnector *_connector);
+	virtual void *Entry();
+
+private:
+	pgServerConnector *connector;
+};
+
+WX_DEFINE_ARRAY_PTR(pgServerConnectThread *, pgServerConnectThreadArray);
+
+
+// Connects a list of servers a few at a time, and runs the queries that
+// pgServer::Connect() and the first expansion of the server node need.
+// Each finished server is handed back to frmMain with a
+// SERVERCONNECT_COMPLETE event, and Complete() attaches the connection
+// to the server and adds its tree nodes. Servers that do not answer
+// within the timeout are left disconnected; the timeout also limits each
+// of the queries, and the destructor cancels the ones still running.
+class pgServerConnector
+{
+public:
+	pgServerConnector(frmMain *_form, int _timeout);
+	~pgServerConnector();
+
+	void Add(pgServer *server);
+	void Start();
+	void Complete(pgServerConnectJob *job);
+	bool IsDone();
+
+private:
+	pgServerConnectJob *Next();
+	void Connect(pgServerConnectJob *job);
+	void Finished(pgServerConnectJob *job);
+
+	frmMain *form;
+	int timeout;
+
+	wxMutex lock;
+	pgServerConnectJobArray queue, running, done;
+	pgServerConnectThreadArray threads;
+
+	friend class pgServerConnectThread;
+};
+
+#endif
@@ -160,6 +160,9 @@ private:
 // Get an array from a comma(,) separated list
 bool getArrayFromCommaSeparatedList(const wxString &str, wxArrayString &res);
 
+// Split a script into its statements, and the position of each in the script
+void SplitStatements(const wxString &str, wxArrayString &statements, wxArrayInt &offsets, bool standardStrings = true);
+
 // File handling including encoding according to sysSettings if format<0,
 // 0-> local charset, 1->utf8
 wxString FileRead(const wxString &filename, int format = -1);
@@ -20,6 +20,8 @@ pgadmin3_SOURCES += \
 	include/utils/registry.h \
 	include/utils/sysLogger.h \
 	include/utils/sysProcess.h \
+	include/utils/sysProcessQueue.h \
+	include/utils/sysQueryHistory.h \
 	include/utils/sysSettings.h \
 	include/utils/utffile.h \
 	include/utils/macros.h \
@@ -14,6 +14,8 @@
 
 // wxWindows headers
 #include <wx/wx.h>
+#include <wx/ffile.h>
+#include <wx/thread.h>
 
 // App headers
 
@@ -26,10 +28,25 @@ enum LOG_LEVEL
     LOG_DEBUG = 4
 };
 
+class sysLogWriter;
+
 // Class declarations
+//
+// Log lines are queued and written in batches to a log file that stays
+// open. Once StartWriter() has been called, a background thread writes the
+// queue every LOG_FLUSH_INTERVAL ms, or earlier when it grows large; errors
+// are always written before the logging call returns, so that they survive
+// a crash. Without the thread every line is written immediately.
 class sysLogger : public wxLog
 {
 public:
+	sysLogger();
+	~sysLogger();
+
+	void StartWriter();
+	// Writes whatever is queued and stops the thread
+	void StopWriter();
+
 #if wxCHECK_VERSION(2, 9, 0)
 	void DoLogTextAtLevel(wxLogLevel level, const wxString &msg);
 #else
@@ -40,8 +57,26 @@ public:
 	static wxString logFile;
 
 private:
-	void WriteLog(const wxString &msg);
+	void WriteLog(const wxString &msg, bool sync);
+	void WriteQueue();
+	bool OpenLogFile();
 	bool SilenceMessage(const wxString &msg);
+
+	// Lock order is fileLock before queueLock
+	wxMutex queueLock, fileLock;
+	wxCondition *wake;
+	wxArrayString queue;        // protected by queueLock
+	bool stopping;
+	sysLogWriter *writer;
+	unsigned long fileOwner;    // the thread holding fileLock, or 0
+
+	wxFFile file;               // protected by fileLock
+	wxString fileSetting;       // logFile when the file was opened, also
+	                            // protected by queueLock
+	wxString fileName;          // the same with %ID replaced
+
+	friend class sysLogWriter;
+	friend class sysLogFileLocker;
 };
 
 #define wxLOG_Notice (wxLOG_User+1)
@@ -0,0 +1,106 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// sysProcessQueue.h - Runs a list of external processes concurrently
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef SYSPROCESSQUEUE_H
+#define SYSPROCESSQUEUE_H
+
+#include <wx/wx.h>
+#include "utils/sysProcess.h"
+
+enum sysProcessJobState
+{
+	JOB_WAITING = 0,
+	JOB_RUNNING,
+	JOB_SUCCEEDED,
+	JOB_FAILED,
+	JOB_CANCELLED
+};
+
+class sysProcessJob
+{
+public:
+	sysProcessJob(const wxString &_name, const wxString &_cmd, const wxString &_displayCmd);
+
+	wxString GetStateName() const;
+	// Run time in milliseconds; still counting while the job runs
+	wxLongLong GetElapsed() const;
+
+	wxString name, cmd, displayCmd;
+	wxString log;       // stdout and stderr of this job only
+	sysProcessJobState state;
+	int exitCode;
+
+private:
+	sysProcess *process;
+	int pid;
+	wxLongLong startTime, endTime;
+
+	friend class sysProcessQueue;
+};
+
+WX_DEFINE_ARRAY_PTR(sysProcessJob *, sysProcessJobArray);
+
+
+// Keeps at most maxJobs of the queued processes running at any time.
+// The owner receives a wxEVT_COMMAND_MENU_SELECTED event with the given
+// id whenever a job starts, finishes or produces output.
+class sysProcessQueue : public wxEvtHandler
+{
+public:
+	sysProcessQueue(wxEvtHandler *_owner, int _notifyId);
+	~sysProcessQueue();
+
+	void SetEnvironment(const wxArrayString &env)
+	{
+		environment = env;
+	}
+	void SetMaxJobs(int n)
+	{
+		maxJobs = n < 1 ? 1 : n;
+	}
+
+	size_t AddJob(const wxString &name, const wxString &cmd, const wxString &displayCmd = wxEmptyString);
+	void Clear();
+
+	void Start();
+	void Abort();
+	bool IsRunning() const;
+
+	size_t GetCount() const
+	{
+		return jobs.GetCount();
+	}
+	sysProcessJob *GetJob(size_t n) const
+	{
+		return jobs.Item(n);
+	}
+	size_t GetFinishedCount() const;
+	size_t GetFailedCount() const;
+
+private:
+	void StartJobs();
+	void ReadOutput(sysProcessJob *job);
+	void Notify();
+
+	void OnEndProcess(wxProcessEvent &ev);
+	void OnPoll(wxTimerEvent &ev);
+
+	wxEvtHandler *owner;
+	int notifyId;
+	int maxJobs;
+	wxArrayString environment;
+	sysProcessJobArray jobs;
+	wxTimer *timer;
+
+	DECLARE_EVENT_TABLE()
+};
+
+#endif
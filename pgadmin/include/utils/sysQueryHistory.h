@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// sysQueryHistory.h - History of executed queries shared by the query tools
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef SYSQUERYHISTORY_H
+#define SYSQUERYHISTORY_H
+
+#include <wx/wx.h>
+#include <wx/hashmap.h>
+
+WX_DECLARE_STRING_HASH_MAP(long, queryHistoryIndex);
+WX_DEFINE_ARRAY_PTR(wxEvtHandler *, queryHistoryListenerArray);
+
+// What a QUERYHISTORY_CHANGED event reports in its int value
+enum
+{
+	QUERYHISTORY_ADDED,     // the string was added as the newest query
+	QUERYHISTORY_REMOVED,   // the string is no longer in the history
+	QUERYHISTORY_RELOADED   // anything may have changed
+};
+
+
+// The history is kept in memory, oldest query first, and written to the
+// history file as a journal: executing a query appends one record instead
+// of rewriting the whole file. Records are
+//
+//   + <bytes>\n<query>\n    add the query, or move it to the end
+//   - <serial>\n            delete the query added by the given record
+//
+// after a header line, where the serial of a query is the number of "+"
+// records before it. The file is rewritten from memory once obsolete
+// records outnumber the live ones, and when the history is cleared. A
+// history file in the old XML format is converted on first load.
+//
+// Listeners receive a wxEVT_COMMAND_MENU_SELECTED event with the id
+// QUERYHISTORY_CHANGED for every change, carrying the query concerned, so
+// that they can update their lists instead of reloading them. A query
+// moved to the end is only reported as added.
+class sysQueryHistory
+{
+public:
+	sysQueryHistory();
+
+	size_t GetCount();
+	// Copies all queries, oldest first
+	void GetQueries(wxArrayString &result);
+
+	// Adds a query as the newest entry, moving it there if it is known
+	void Add(const wxString &query);
+	void Remove(const wxString &query);
+	void Clear();
+
+	// Finds the queries containing all the words of the search text,
+	// ignoring case, newest first. At most maxResults are returned.
+	void Search(const wxString &text, wxArrayString &results, size_t maxResults);
+	// Whether a query would be found by Search()
+	static bool Matches(const wxString &text, const wxString &query);
+
+	void AddListener(wxEvtHandler *listener);
+	void RemoveListener(wxEvtHandler *listener);
+
+private:
+	void Load();
+	bool LoadJournal(const char *data, size_t len);
+	bool LoadXml();
+	void Compact();
+	void Trim();
+	void WriteRecord(const wxMemoryBuffer &record);
+	void Notify(int change, const wxString &query = wxEmptyString);
+	static void SplitWords(const wxString &text, wxArrayString &words);
+	static bool ContainsWords(const wxString &lower, const wxArrayString &words);
+
+	void AddEntry(const wxString &query);
+	void RemoveAt(size_t n);
+	int FindSerial(long serial) const;
+
+	wxString fileName;
+	bool loaded;
+
+	wxArrayString queries;      // oldest first
+	wxArrayString lowerQueries; // lower case copies for searching
+	wxArrayLong serials;        // ascending, parallel to queries
+	queryHistoryIndex index;    // query -> serial
+	long nextSerial;
+	long records;               // number of records in the journal
+
+	queryHistoryListenerArray listeners;
+};
+
+#endif
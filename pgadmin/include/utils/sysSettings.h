@@ -285,6 +285,16 @@ public:
 	{
 		WriteBool(wxT("frmQuery/ExplainTiming"), newval);
 	}
+	bool GetExplainXml() const
+	{
+		bool b;
+		Read(wxT("frmQuery/ExplainXml"), &b, true);
+		return b;
+	}
+	void SetExplainXml(const bool newval)
+	{
+		WriteBool(wxT("frmQuery/ExplainXml"), newval);
+	}
 
 	// Display options
 	wxString GetSystemSchemas() const
@@ -395,6 +405,18 @@ public:
 	void SetSQLFont(const wxFont &font);
 	wxFont GetDDFont();
 	void SetDDFont(const wxFont &font);
+
+	// Database Designer model files
+	bool GetDDValidateModels() const
+	{
+		bool b;
+		Read(wxT("DatabaseDesigner/ValidateModels"), &b, true);
+		return b;
+	}
+	void SetDDValidateModels(const bool newval)
+	{
+		WriteBool(wxT("DatabaseDesigner/ValidateModels"), newval);
+	}
 	int GetLineEndingType() const
 	{
 		int i;
@@ -702,6 +724,53 @@ public:
 		WriteInt(wxT("RefreshOnClick"), newval);
 	}
 
+	// Open connections per server, not counting the maintenance database
+	long GetConnPoolMaxConnections() const
+	{
+		long l;
+		Read(wxT("ConnectionPool/MaxConnections"), &l, 20L);
+		return l;
+	}
+	void SetConnPoolMaxConnections(const long newval)
+	{
+		WriteLong(wxT("ConnectionPool/MaxConnections"), newval);
+	}
+
+	// Minutes until an idle connection is closed
+	long GetConnPoolTimeout() const
+	{
+		long l;
+		Read(wxT("ConnectionPool/Timeout"), &l, 10L);
+		return l;
+	}
+	void SetConnPoolTimeout(const long newval)
+	{
+		WriteLong(wxT("ConnectionPool/Timeout"), newval);
+	}
+
+	bool GetReconnectOnStartup() const
+	{
+		bool b;
+		Read(wxT("ReconnectOnStartup"), &b, false);
+		return b;
+	}
+	void SetReconnectOnStartup(const bool newval)
+	{
+		WriteBool(wxT("ReconnectOnStartup"), newval);
+	}
+
+	// Seconds to wait for each server when reconnecting at startup
+	long GetConnectTimeout() const
+	{
+		long l;
+		Read(wxT("ConnectTimeout"), &l, 10L);
+		return l;
+	}
+	void SetConnectTimeout(const long newval)
+	{
+		WriteLong(wxT("ConnectTimeout"), newval);
+	}
+
 	bool GetShowNotices() const
 	{
 		bool b;
@@ -63,6 +63,7 @@
 #include "dlg/dlgSelectConnection.h"
 #include "db/pgConn.h"
 #include "utils/sysLogger.h"
+#include "utils/sysQueryHistory.h"
 #include "frm/frmHint.h"
 
 #include "ctl/xh_calb.h"
@@ -85,6 +86,7 @@ frmMain *winMain = 0;
 wxThread *updateThread = 0;
 
 sysSettings *settings;
+sysQueryHistory *queryHistory = 0;
 wxArrayInt existingLangs;
 wxArrayString existingLangNames;
 wxLocale *locale = 0;
@@ -111,7 +113,7 @@ wxString brandingPath;          // Where branding data is stored
 wxString pluginsDir;            // The plugins ini file directory
 wxString settingsIni;           // The settings.ini file
 
-wxLog *logger;
+sysLogger *logger;
 
 bool dialogTestMode = false;
 
@@ -216,6 +218,9 @@ bool pgAdmin3::OnInit()
 	// Setup additional helper paths etc. Requires settings!
 	InitXtraPaths();
 
+	// The history file is only read when a query tool needs it
+	queryHistory = new sysQueryHistory();
+
 	locale = new wxLocale();
 	locale->AddCatalogLookupPathPrefix(i18nPath);
 
@@ -824,9 +829,16 @@ int pgAdmin3::OnExit()
 		delete updateThread;
 	}
 
+	delete queryHistory;
+
 	// Delete the settings object to ensure settings are saved.
 	delete settings;
 
+	// Write out the queued log lines; anything logged later is written
+	// straight away.
+	if (logger)
+		logger->StopWriter();
+
 #ifdef __WXMSW__
 	WSACleanup();
 #endif
@@ -1640,6 +1652,7 @@ void pgAdmin3::InitLogger()
 	sysLogger::logLevel = settings->GetLogLevel();
 
 	logger = new sysLogger();
+	logger->StartWriter();
 	wxLog::SetActiveTarget(logger);
 	wxLog::Resume();
 }
@@ -13,9 +13,10 @@
 
 #include "pgscript/exceptions/pgsException.h"
 #include "pgscript/statements/pgsStmtList.h"
+#include "pgscript/utilities/pgsThread.h"
 
-pgsProgram::pgsProgram(pgsVarMap &vars) :
-	m_vars(vars)
+pgsProgram::pgsProgram(pgsVarMap &vars, pgsThread *app) :
+	m_vars(vars), m_app(app)
 {
 
 }
@@ -57,7 +58,10 @@ void pgsProgram::eval(pgsStmtList *stmt_list)
 
 	}
 
-	pgsStmtList::m_exception_thrown = false;
+	if (m_app != 0)
+	{
+		m_app->error_reported(false);
+	}
 
 	wxLogScript(wxT("Leaving  program"));
 }
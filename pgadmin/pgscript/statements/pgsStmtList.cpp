@@ -21,8 +21,6 @@
 #include <wx/listimpl.cpp>
 WX_DEFINE_LIST(pgsListStmt);
 
-bool pgsStmtList::m_exception_thrown = false;
-
 pgsStmtList::pgsStmtList(pgsOutputStream &cout, pgsThread *app) :
 	pgsStmt(app), m_cout(cout)
 {
@@ -54,7 +52,8 @@ void pgsStmtList::eval(pgsVarMap &vars) const
 		}
 		catch (const pgsException &e)
 		{
-			if (!m_exception_thrown && (typeid(e) != typeid(pgsBreakException))
+			if ((m_app == 0 || !m_app->error_reported())
+			        && (typeid(e) != typeid(pgsBreakException))
 			        && (typeid(e) != typeid(pgsContinueException)))
 			{
 				if (m_app != 0)
@@ -65,10 +64,10 @@ void pgsStmtList::eval(pgsVarMap &vars) const
 
 				m_cout << wx_static_cast(const wxString, e.message())
 				       << wxT(" on line ") << current->line() << wxT("\n");
-				m_exception_thrown = true;
 
 				if (m_app != 0)
 				{
+					m_app->error_reported(true);
 					m_app->UnlockOutput();
 				}
 			}
@@ -76,7 +75,7 @@ void pgsStmtList::eval(pgsVarMap &vars) const
 		}
 		catch (const std::exception &e)
 		{
-			if (!m_exception_thrown)
+			if (m_app == 0 || !m_app->error_reported())
 			{
 				if (m_app != 0)
 				{
@@ -87,10 +86,10 @@ void pgsStmtList::eval(pgsVarMap &vars) const
 				m_cout << PGSOUTERROR << _("Unknown exception:\n")
 				       << wx_static_cast(const wxString,
 				                         wxString(e.what(), wxConvUTF8));
-				m_exception_thrown = true;
 
 				if (m_app != 0)
 				{
+					m_app->error_reported(true);
 					m_app->UnlockOutput();
 				}
 			}
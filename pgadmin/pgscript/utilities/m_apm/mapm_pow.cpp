@@ -27,10 +27,10 @@
 #include "pgAdmin3.h"
 #include "pgscript/utilities/mapm-lib/m_apm_lc.h"
 
-static	M_APM   M_last_xx_input;
-static	M_APM   M_last_xx_log;
-static	int     M_last_log_digits;
-static	int     M_size_flag = 0;
+static M_THREAD_LOCAL	M_APM   M_last_xx_input;
+static M_THREAD_LOCAL	M_APM   M_last_xx_log;
+static M_THREAD_LOCAL	int     M_last_log_digits;
+static M_THREAD_LOCAL	int     M_size_flag = 0;
 
 /****************************************************************************/
 void	M_free_all_pow()
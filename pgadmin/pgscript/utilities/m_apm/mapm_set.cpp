@@ -29,8 +29,8 @@
 #include "pgAdmin3.h"
 #include "pgscript/utilities/mapm-lib/m_apm_lc.h"
 
-static	char *M_buf  = NULL;
-static  int   M_lbuf = 0;
+static M_THREAD_LOCAL	char *M_buf  = NULL;
+static M_THREAD_LOCAL  int   M_lbuf = 0;
 static  const char *M_set_string_error_msg = "\'m_apm_set_string\', Out of memory";
 
 /****************************************************************************/
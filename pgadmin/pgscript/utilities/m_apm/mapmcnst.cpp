@@ -28,39 +28,39 @@
 #include "pgAdmin3.h"
 #include "pgscript/utilities/mapm-lib/m_apm_lc.h"
 
-int	MM_lc_PI_digits = 0;
-int	MM_lc_log_digits;
-int     MM_cpp_min_precision;       /* only used in C++ wrapper */
+M_THREAD_LOCAL int	MM_lc_PI_digits = 0;
+M_THREAD_LOCAL int	MM_lc_log_digits;
+M_THREAD_LOCAL int     MM_cpp_min_precision;       /* only used in C++ wrapper */
 
-M_APM	MM_Zero          = NULL;
-M_APM	MM_One           = NULL;
-M_APM	MM_Two           = NULL;
-M_APM	MM_Three         = NULL;
-M_APM	MM_Four          = NULL;
-M_APM	MM_Five          = NULL;
-M_APM	MM_Ten           = NULL;
-M_APM	MM_0_5           = NULL;
-M_APM	MM_E             = NULL;
-M_APM	MM_PI            = NULL;
-M_APM	MM_HALF_PI       = NULL;
-M_APM	MM_2_PI          = NULL;
-M_APM	MM_lc_PI         = NULL;
-M_APM	MM_lc_HALF_PI    = NULL;
-M_APM	MM_lc_2_PI       = NULL;
-M_APM	MM_lc_log2       = NULL;
-M_APM	MM_lc_log10      = NULL;
-M_APM	MM_lc_log10R     = NULL;
-M_APM	MM_0_85          = NULL;
-M_APM	MM_5x_125R       = NULL;
-M_APM	MM_5x_64R        = NULL;
-M_APM	MM_5x_256R       = NULL;
-M_APM	MM_5x_Eight      = NULL;
-M_APM	MM_5x_Sixteen    = NULL;
-M_APM	MM_5x_Twenty     = NULL;
-M_APM	MM_LOG_E_BASE_10 = NULL;
-M_APM	MM_LOG_10_BASE_E = NULL;
-M_APM	MM_LOG_2_BASE_E  = NULL;
-M_APM	MM_LOG_3_BASE_E  = NULL;
+M_THREAD_LOCAL M_APM	MM_Zero          = NULL;
+M_THREAD_LOCAL M_APM	MM_One           = NULL;
+M_THREAD_LOCAL M_APM	MM_Two           = NULL;
+M_THREAD_LOCAL M_APM	MM_Three         = NULL;
+M_THREAD_LOCAL M_APM	MM_Four          = NULL;
+M_THREAD_LOCAL M_APM	MM_Five          = NULL;
+M_THREAD_LOCAL M_APM	MM_Ten           = NULL;
+M_THREAD_LOCAL M_APM	MM_0_5           = NULL;
+M_THREAD_LOCAL M_APM	MM_E             = NULL;
+M_THREAD_LOCAL M_APM	MM_PI            = NULL;
+M_THREAD_LOCAL M_APM	MM_HALF_PI       = NULL;
+M_THREAD_LOCAL M_APM	MM_2_PI          = NULL;
+M_THREAD_LOCAL M_APM	MM_lc_PI         = NULL;
+M_THREAD_LOCAL M_APM	MM_lc_HALF_PI    = NULL;
+M_THREAD_LOCAL M_APM	MM_lc_2_PI       = NULL;
+M_THREAD_LOCAL M_APM	MM_lc_log2       = NULL;
+M_THREAD_LOCAL M_APM	MM_lc_log10      = NULL;
+M_THREAD_LOCAL M_APM	MM_lc_log10R     = NULL;
+M_THREAD_LOCAL M_APM	MM_0_85          = NULL;
+M_THREAD_LOCAL M_APM	MM_5x_125R       = NULL;
+M_THREAD_LOCAL M_APM	MM_5x_64R        = NULL;
+M_THREAD_LOCAL M_APM	MM_5x_256R       = NULL;
+M_THREAD_LOCAL M_APM	MM_5x_Eight      = NULL;
+M_THREAD_LOCAL M_APM	MM_5x_Sixteen    = NULL;
+M_THREAD_LOCAL M_APM	MM_5x_Twenty     = NULL;
+M_THREAD_LOCAL M_APM	MM_LOG_E_BASE_10 = NULL;
+M_THREAD_LOCAL M_APM	MM_LOG_10_BASE_E = NULL;
+M_THREAD_LOCAL M_APM	MM_LOG_2_BASE_E  = NULL;
+M_THREAD_LOCAL M_APM	MM_LOG_3_BASE_E  = NULL;
 
 
 static char MM_cnst_PI[] =
@@ -27,16 +27,16 @@
 #include "pgAdmin3.h"
 #include "pgscript/utilities/mapm-lib/m_apm_lc.h"
 
-static  UCHAR	*M_mul_div = NULL;
-static  UCHAR   *M_mul_rem = NULL;
+static M_THREAD_LOCAL  UCHAR	*M_mul_div = NULL;
+static M_THREAD_LOCAL  UCHAR   *M_mul_rem = NULL;
 
-static  UCHAR   M_mul_div_10[100];
-static	UCHAR   M_mul_rem_10[100];
+static M_THREAD_LOCAL  UCHAR   M_mul_div_10[100];
+static M_THREAD_LOCAL	UCHAR   M_mul_rem_10[100];
 
-static	int	M_util_firsttime = TRUE;
-static	int     M_firsttime3 = TRUE;
+static M_THREAD_LOCAL	int	M_util_firsttime = TRUE;
+static M_THREAD_LOCAL	int     M_firsttime3 = TRUE;
 
-static	M_APM	M_work_0_5;
+static M_THREAD_LOCAL	M_APM	M_work_0_5;
 
 static  const char    *M_init_error_msg = "\'m_apm_init\', Out of memory";
 
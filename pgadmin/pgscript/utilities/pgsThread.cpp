@@ -15,13 +15,15 @@
 #include "pgscript/statements/pgsProgram.h"
 #include "pgscript/utilities/pgsContext.h"
 #include "pgscript/utilities/pgsDriver.h"
+#include "pgscript/utilities/pgsMapm.h"
 
 pgsThread::pgsThread(pgsVarMap &vars, wxSemaphore &mutex,
                      pgConn *connection, const wxString &file, pgsOutputStream &out,
                      pgsApplication &app, wxMBConv *conv) :
 	wxThread(wxTHREAD_DETACHED), m_vars(vars), m_mutex(mutex),
 	m_connection(connection), m_data(file), m_out(out),
-	m_app(app), m_conv(conv), m_last_error_line(-1)
+	m_app(app), m_conv(conv), m_last_error_line(-1),
+	m_error_reported(false)
 {
 	wxLogScript(wxT("Starting thread"));
 	m_mutex.Wait();
@@ -32,7 +34,8 @@ pgsThread::pgsThread(pgsVarMap &vars, wxSemaphore &mutex,
                      pgsApplication &app) :
 	wxThread(wxTHREAD_DETACHED), m_vars(vars), m_mutex(mutex),
 	m_connection(connection), m_data(string), m_out(out),
-	m_app(app), m_conv(0), m_last_error_line(-1)
+	m_app(app), m_conv(0), m_last_error_line(-1),
+	m_error_reported(false)
 {
 	wxLogScript(wxT("Starting thread"));
 	m_mutex.Wait();
@@ -48,23 +51,29 @@ pgsThread::~pgsThread()
 
 void *pgsThread::Entry()
 {
-	pgsProgram program(m_vars);
-	pgsContext context(m_out);
-	pgscript::pgsDriver driver(context, program, *this);
-
-	if (m_conv)
-	{
-		wxLogScript(wxT("Parsing file"));
-		driver.parse_file(m_data, *m_conv);
-		wxLogScript(wxT("File  parsed"));
-	}
-	else
 	{
-		wxLogScript(wxT("Parsing string"));
-		driver.parse_string(m_data);
-		wxLogScript(wxT("String  parsed"));
+		pgsProgram program(m_vars, this);
+		pgsContext context(m_out);
+		pgscript::pgsDriver driver(context, program, *this);
+
+		if (m_conv)
+		{
+			wxLogScript(wxT("Parsing file"));
+			driver.parse_file(m_data, *m_conv);
+			wxLogScript(wxT("File  parsed"));
+		}
+		else
+		{
+			wxLogScript(wxT("Parsing string"));
+			driver.parse_string(m_data);
+			wxLogScript(wxT("String  parsed"));
+		}
 	}
 
+	// The MAPM constants and work areas are allocated per thread, values
+	// left in the symbol table are plain allocations and remain valid
+	m_apm_free_all_mem();
+
 	return 0;
 }
 
@@ -92,3 +101,13 @@ int pgsThread::last_error_line() const
 {
 	return m_last_error_line;
 }
+
+void pgsThread::error_reported(bool reported)
+{
+	m_error_reported = reported;
+}
+
+bool pgsThread::error_reported() const
+{
+	return m_error_reported;
+}
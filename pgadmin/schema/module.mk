@@ -46,6 +46,7 @@ pgadmin3_SOURCES += \
         schema/pgSchema.cpp \
         schema/pgSequence.cpp \
         schema/pgServer.cpp \
+        schema/pgServerConnector.cpp \
         schema/pgTable.cpp \
         schema/pgTablespace.cpp \
         schema/pgTextSearchConfiguration.cpp \
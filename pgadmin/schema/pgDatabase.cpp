@@ -15,6 +15,7 @@
 // App headers
 #include "pgAdmin3.h"
 #include "utils/misc.h"
+#include "db/pgConnPool.h"
 #include "utils/pgfeatures.h"
 #include "frm/frmMain.h"
 #include "schema/edbSynonym.h"
@@ -177,23 +178,21 @@ int pgDatabase::Connect()
 
 		// Now we're connected.
 
+		// All of this comes from one query. The maintenance database's
+		// connection may have read it before, so read it again.
+		const pgCapabilities &caps = connection()->GetCapabilities(useServerConnection);
+
 		// check for extended ruleutils with pretty-print option
-		wxString exprname = connection()->ExecuteScalar(wxT("SELECT proname FROM pg_proc WHERE proname='pg_get_viewdef' AND proargtypes[1]=16"));
-		if (!exprname.IsEmpty())
+		if (caps.viewdefPretty)
 			prettyOption = wxT(", true");
 
-		UpdateDefaultSchema();
+		searchPath = caps.searchPath;
+		defaultSchema = caps.currentSchema;
 
-		if (connection()->BackendMinimumVersion(9, 0))
-		{
-			m_defPrivsOnTables = connection()->ExecuteScalar(wxT("SELECT defaclacl FROM pg_catalog.pg_default_acl dacl WHERE dacl.defaclnamespace = 0::OID AND defaclobjtype='r'"));
-			m_defPrivsOnSeqs   = connection()->ExecuteScalar(wxT("SELECT defaclacl FROM pg_catalog.pg_default_acl dacl WHERE dacl.defaclnamespace = 0::OID AND defaclobjtype='S'"));
-			m_defPrivsOnFuncs  = connection()->ExecuteScalar(wxT("SELECT defaclacl FROM pg_catalog.pg_default_acl dacl WHERE dacl.defaclnamespace = 0::OID AND defaclobjtype='f'"));
-		}
-		if (connection()->BackendMinimumVersion(9, 2))
-		{
-			m_defPrivsOnTypes = connection()->ExecuteScalar(wxT("SELECT defaclacl FROM pg_catalog.pg_default_acl dacl WHERE dacl.defaclnamespace = 0::OID AND defaclobjtype='T'"));
-		}
+		m_defPrivsOnTables = caps.defPrivsOnTables;
+		m_defPrivsOnSeqs   = caps.defPrivsOnSeqs;
+		m_defPrivsOnFuncs  = caps.defPrivsOnFuncs;
+		m_defPrivsOnTypes  = caps.defPrivsOnTypes;
 
 		connected = true;
 	}
@@ -202,10 +201,12 @@ int pgDatabase::Connect()
 }
 
 
-pgConn *pgDatabase::connection()
+pgConn *pgDatabase::connection(bool resume)
 {
 	if (useServerConnection)
 		return server->connection();
+	if (conn && resume && conn->IsSuspended())
+		conn->Resume();
 	return conn;
 
 }
@@ -213,7 +214,7 @@ pgConn *pgDatabase::connection()
 void pgDatabase::CheckAlive()
 {
 	if (connected)
-		connected = connection()->IsAlive();
+		connected = connection(false)->IsAlive();
 }
 
 void pgDatabase::Disconnect()
@@ -390,43 +391,6 @@ bool pgDatabase::ExecuteVoid(const wxString &sql, bool reportError)
 }
 
 
-void pgDatabase::UpdateDefaultSchema()
-{
-	searchPath = connection()->ExecuteScalar(wxT("SHOW search_path"));
-
-	if (!searchPath.IsEmpty())
-	{
-		wxStringTokenizer tk(searchPath, wxT(","));
-		pgSet *set = ExecuteSet(wxT("SELECT nspname, session_user=nspname AS isuser FROM pg_namespace"));
-		if (set)
-		{
-			while (tk.HasMoreTokens())
-			{
-				wxString str = tk.GetNextToken();
-				str.Strip(wxString::both);
-
-				if (str.IsEmpty())
-					continue;
-				long row;
-				for (row = 1 ; row <= set->NumRows() ; row++)
-				{
-					set->Locate(row);
-					defaultSchema = set->GetVal(wxT("nspname"));
-					if (str == defaultSchema ||
-					        ((str == wxT("$user") || str == wxT("\"$user\"")) && set->GetBool(wxT("isuser"))))
-					{
-						delete set;
-						return;
-					}
-				}
-			}
-			delete set;
-		}
-	}
-	defaultSchema = wxEmptyString;
-}
-
-
 wxString pgDatabase::GetSchemaPrefix(const wxString &name) const
 {
 	if (name.IsEmpty())
@@ -499,6 +463,9 @@ bool pgDatabase::DropObject(wxFrame *frame, ctlTree *browser, bool cascaded)
 	}
 	Disconnect();
 
+	// Idle pooled connections would make the drop fail
+	server->GetConnPool()->Clear();
+
 	bool done = server->ExecuteVoid(wxT("DROP DATABASE ") + GetQuotedIdentifier() + wxT(";"));
 	if (!done)
 		Connect();
@@ -992,37 +959,27 @@ bool pgDatabase::CanCreate()
 
 bool pgDatabase::CanDebugPlpgsql()
 {
-	wxString preload_option;
-
 	// Result cache - 0 = not tested, 1 = false, 2 = true.
 	if (canDebugPlpgsql == 1)
 		return false;
 	else if (canDebugPlpgsql == 2)
 		return true;
 
+	const pgCapabilities &caps = connection()->GetCapabilities();
+
 	// "show shared_preload_libraries" does not work for other than
-	// the super users.
+	// the super users. pgConn reads preload_libraries before 8.2.
 	if (GetServer()->GetSuperUser())
 	{
-		// Parameter's name depends of the backend's version
-		if (server->GetConnection()->BackendMinimumVersion(8, 2))
-		{
-			preload_option = wxT("shared_preload_libraries");
-		}
-		else
-		{
-			preload_option = wxT("preload_libraries");
-		}
-
 		// Check the appropriate plugin is loaded
-		if (!ExecuteScalar(wxT("SHOW ") + preload_option).Contains(wxT("plugin_debugger")))
+		if (!caps.preloadLibraries.Contains(wxT("plugin_debugger")))
 		{
 			canDebugPlpgsql = 1;
 			return false;
 		}
 	}
 
-	if (ExecuteScalar(wxT("SELECT count(*) FROM pg_proc WHERE proname = 'pldbg_get_target_info';")) == wxT("0"))
+	if (!caps.debuggerTargetInfo)
 	{
 		canDebugPlpgsql = 1;
 		return false;
@@ -1038,7 +995,7 @@ bool pgDatabase::CanDebugPlpgsql()
 
 	// On EDBAS82 and PostgreSQL, we need to check to make sure that
 	// the debugger library is also available.
-	if (ExecuteScalar(wxT("SELECT count(*) FROM pg_proc WHERE proname = 'plpgsql_oid_debug';")) == wxT("0"))
+	if (!caps.plpgsqlDebug)
 	{
 		canDebugPlpgsql = 1;
 		return false;
@@ -1060,6 +1017,8 @@ bool pgDatabase::CanDebugEdbspl()
 	else if (canDebugEdbspl == 2)
 		return true;
 
+	const pgCapabilities &caps = connection()->GetCapabilities();
+
 	// "show shared_preload_libraries" does not work for other than
 	// the super users.
 	if (GetServer()->GetSuperUser())
@@ -1076,14 +1035,14 @@ bool pgDatabase::CanDebugEdbspl()
 		else
 			library_name = wxT("plugin_spl_debugger");
 
-		if (!ExecuteScalar(wxT("SHOW shared_preload_libraries;")).Contains(library_name))
+		if (!caps.preloadLibraries.Contains(library_name))
 		{
 			canDebugEdbspl = 1;
 			return false;
 		}
 	}
 
-	if (ExecuteScalar(wxT("SELECT count(*) FROM pg_proc WHERE proname = 'pldbg_get_target_info';")) == wxT("0"))
+	if (!caps.debuggerTargetInfo)
 	{
 		canDebugEdbspl = 1;
 		return false;
@@ -1099,7 +1058,7 @@ bool pgDatabase::CanDebugEdbspl()
 
 	// On EDBAS82 and PostgreSQL, we need to check to make sure that
 	// the debugger library is also available.
-	if (ExecuteScalar(wxT("SELECT count(*) FROM pg_proc WHERE proname = 'edb_oid_debug';")) == wxT("0"))
+	if (!caps.edbsplDebug)
 	{
 		canDebugEdbspl = 1;
 		return false;
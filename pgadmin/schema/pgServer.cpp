@@ -37,6 +37,7 @@
 #include "utils/registry.h"
 #include "frm/frmReport.h"
 #include "dlg/dlgServer.h"
+#include "db/pgConnPool.h"
 
 #define DEFAULT_PG_DATABASE wxT("postgres")
 
@@ -56,9 +57,14 @@ pgServer::pgServer(const wxString &newName, const wxString &newHostAddr, const w
 	serverIndex = 0;
 
 	connected = false;
+	connecting = false;
+	reconnect = false;
+	catalogInfoRead = false;
+	pgAgentAvailable = false;
 	lastSystemOID = 0;
 
 	conn = NULL;
+	pool = new pgConnPool();
 	passwordValid = true;
 	storePwd = _storePwd;
 	rolename = newRolename;
@@ -73,6 +79,8 @@ pgServer::pgServer(const wxString &newName, const wxString &newHostAddr, const w
 
 pgServer::~pgServer()
 {
+	delete pool;
+
 	if (conn)
 		delete conn;
 
@@ -188,7 +196,12 @@ pgConn *pgServer::CreateConn(wxString dbName, OID oid, wxString applicationname)
 		dbName = GetDatabaseName();
 		oid = dbOid;
 	}
-	pgConn *conn = new pgConn(GetName(), service, hostaddr, dbName, username, password, port, rolename, ssl, oid, applicationname, sslcert, sslkey, sslrootcert, sslcrl, sslcompression);
+
+	pgConn *conn = pool->Lease(dbName, applicationname);
+	if (conn)
+		return conn;
+
+	conn = new pgConn(GetName(), service, hostaddr, dbName, username, password, port, rolename, ssl, oid, applicationname, sslcert, sslkey, sslrootcert, sslcrl, sslcompression);
 
 	if (conn && conn->GetStatus() != PGCONN_OK)
 	{
@@ -196,6 +209,7 @@ pgConn *pgServer::CreateConn(wxString dbName, OID oid, wxString applicationname)
 		delete conn;
 		return 0;
 	}
+	pool->Add(conn);
 	return conn;
 }
 
@@ -215,6 +229,8 @@ wxString pgServer::GetFullIdentifier()
 
 bool pgServer::Disconnect(frmMain *form)
 {
+	pool->Clear();
+
 	if (conn)
 	{
 		delete conn;
@@ -695,110 +711,190 @@ int pgServer::Connect(frmMain *form, bool askPassword, const wxString &pwd, bool
 	if (status == PGCONN_OK)
 	{
 		dbOid = conn->GetDbOid();
+		connected = true;
 
-		// Check the server version
-		if (!(conn->BackendMinimumVersion(SERVER_MIN_VERSION_N >> 8, SERVER_MIN_VERSION_N & 0x00FF)) ||
-		        (conn->BackendMinimumVersion(SERVER_MAX_VERSION_N >> 8, (SERVER_MAX_VERSION_N & 0x00FF) + 1)))
-		{
-			wxLogWarning(_("The server you are connecting to is not a version that is supported by this release of %s.\n\n%s may not function as expected.\n\nSupported server versions are %s to %s."),
-			             appearanceFactory->GetLongAppName().c_str(),
-			             appearanceFactory->GetLongAppName().c_str(),
-			             wxString(SERVER_MIN_VERSION_T).c_str(),
-			             wxString(SERVER_MAX_VERSION_T).c_str());
-		}
+		ReadServerInfo(conn);
+		FinishConnect(form);
 
-		connected = true;
-		bool hasUptime = false;
+		if (storePassword || forceStorePassword)
+			StorePassword();
+	}
+	else
+	{
+		connected = false;
+	}
 
-		wxString sql = wxT("SELECT usecreatedb, usesuper");
-		if (conn->BackendMinimumVersion(8, 1))
-		{
-			hasUptime = true;
-			sql += wxT(", CASE WHEN usesuper THEN pg_postmaster_start_time() ELSE NULL END as upsince");
-		}
-		else if (conn->HasFeature(FEATURE_POSTMASTER_STARTTIME))
-		{
-			hasUptime = true;
-			sql += wxT(", CASE WHEN usesuper THEN pg_postmaster_starttime() ELSE NULL END as upsince");
-		}
-		if (conn->BackendMinimumVersion(8, 4))
-		{
-			sql += wxT(", CASE WHEN usesuper THEN pg_conf_load_time() ELSE NULL END as confloadedsince");
-		}
-		if (conn->BackendMinimumVersion(8, 5))
+	form->EndMsg(connected && status == PGCONN_OK);
+
+	passwordValid = connected;
+	return status;
+}
+
+
+// Runs the queries that describe the server and the connected role. This
+// only sets members that are not shown before the server is connected, so
+// pgServerConnector calls it on its worker threads.
+void pgServer::ReadServerInfo(pgConn *newConn)
+{
+	bool hasUptime = false;
+
+	wxString sql = wxT("SELECT usecreatedb, usesuper");
+	if (newConn->BackendMinimumVersion(8, 1))
+	{
+		hasUptime = true;
+		sql += wxT(", CASE WHEN usesuper THEN pg_postmaster_start_time() ELSE NULL END as upsince");
+	}
+	else if (newConn->HasFeature(FEATURE_POSTMASTER_STARTTIME))
+	{
+		hasUptime = true;
+		sql += wxT(", CASE WHEN usesuper THEN pg_postmaster_starttime() ELSE NULL END as upsince");
+	}
+	if (newConn->BackendMinimumVersion(8, 4))
+	{
+		sql += wxT(", CASE WHEN usesuper THEN pg_conf_load_time() ELSE NULL END as confloadedsince");
+	}
+	if (newConn->BackendMinimumVersion(8, 5))
+	{
+		sql += wxT(", CASE WHEN usesuper THEN pg_is_in_recovery() ELSE NULL END as inrecovery");
+		sql += wxT(", CASE WHEN usesuper THEN pg_last_xlog_receive_location() ELSE NULL END as receiveloc");
+		sql += wxT(", CASE WHEN usesuper THEN pg_last_xlog_replay_location() ELSE NULL END as replayloc");
+	}
+	if (newConn->BackendMinimumVersion(9, 1))
+	{
+		sql += wxT(", CASE WHEN usesuper THEN pg_last_xact_replay_timestamp() ELSE NULL END as replay_timestamp");
+		sql += wxT(", CASE WHEN usesuper AND pg_is_in_recovery() THEN pg_is_xlog_replay_paused() ELSE NULL END as isreplaypaused");
+	}
+
+	pgSet *set = newConn->ExecuteSet(sql + wxT("\n  FROM pg_user WHERE usename=current_user"));
+	if (set)
+	{
+		iSetCreatePrivilege(set->GetBool(wxT("usecreatedb")));
+		iSetSuperUser(set->GetBool(wxT("usesuper")));
+		if (hasUptime)
+			iSetUpSince(set->GetDateTime(wxT("upsince")));
+		if (newConn->BackendMinimumVersion(8, 4))
+			iSetConfLoadedSince(set->GetDateTime(wxT("confloadedsince")));
+		if (newConn->BackendMinimumVersion(8, 5))
 		{
-			sql += wxT(", CASE WHEN usesuper THEN pg_is_in_recovery() ELSE NULL END as inrecovery");
-			sql += wxT(", CASE WHEN usesuper THEN pg_last_xlog_receive_location() ELSE NULL END as receiveloc");
-			sql += wxT(", CASE WHEN usesuper THEN pg_last_xlog_replay_location() ELSE NULL END as replayloc");
+			iSetInRecovery(set->GetBool(wxT("inrecovery")));
+			iSetReplayLoc(set->GetVal(wxT("replayloc")));
+			iSetReceiveLoc(set->GetVal(wxT("receiveloc")));
 		}
-		if (conn->BackendMinimumVersion(9, 1))
+		if (newConn->BackendMinimumVersion(9, 1))
 		{
-			sql += wxT(", CASE WHEN usesuper THEN pg_last_xact_replay_timestamp() ELSE NULL END as replay_timestamp");
-			sql += wxT(", CASE WHEN usesuper AND pg_is_in_recovery() THEN pg_is_xlog_replay_paused() ELSE NULL END as isreplaypaused");
+			iSetReplayTimestamp(set->GetVal(wxT("replay_timestamp")));
+			SetReplayPaused(set->GetBool(wxT("isreplaypaused")));
 		}
+		delete set;
+	}
+
+	if (newConn->BackendMinimumVersion(8, 1))
+	{
+		set = newConn->ExecuteSet(wxT("SELECT rolcreaterole, rolcreatedb FROM pg_roles WHERE rolname = current_user;"));
 
-		pgSet *set = ExecuteSet(sql + wxT("\n  FROM pg_user WHERE usename=current_user"));
 		if (set)
 		{
-			iSetCreatePrivilege(set->GetBool(wxT("usecreatedb")));
-			iSetSuperUser(set->GetBool(wxT("usesuper")));
-			if (hasUptime)
-				iSetUpSince(set->GetDateTime(wxT("upsince")));
-			if (conn->BackendMinimumVersion(8, 4))
-				iSetConfLoadedSince(set->GetDateTime(wxT("confloadedsince")));
-			if (conn->BackendMinimumVersion(8, 5))
-			{
-				iSetInRecovery(set->GetBool(wxT("inrecovery")));
-				iSetReplayLoc(set->GetVal(wxT("replayloc")));
-				iSetReceiveLoc(set->GetVal(wxT("receiveloc")));
-			}
-			if (conn->BackendMinimumVersion(9, 1))
-			{
-				iSetReplayTimestamp(set->GetVal(wxT("replay_timestamp")));
-				SetReplayPaused(set->GetBool(wxT("isreplaypaused")));
-			}
+			iSetCreatePrivilege(set->GetBool(wxT("rolcreatedb")));
+			iSetCreateRole(set->GetBool(wxT("rolcreaterole")));
 			delete set;
 		}
+	}
+	else
+		iSetCreateRole(false);
+}
 
-		if (conn->BackendMinimumVersion(8, 1))
-		{
-			set = ExecuteSet(wxT("SELECT rolcreaterole, rolcreatedb FROM pg_roles WHERE rolname = current_user;"));
 
-			if (set)
-			{
-				iSetCreatePrivilege(set->GetBool(wxT("rolcreatedb")));
-				iSetCreateRole(set->GetBool(wxT("rolcreaterole")));
-				delete set;
-			}
-		}
-		else
-			iSetCreateRole(false);
+// Checks for pgAgent and autovacuum, needed when the tree node is expanded
+void pgServer::ReadCatalogInfo(pgConn *newConn)
+{
+	pgAgentAvailable = false;
 
-		wxString version, allVersions;
-		version.Printf(wxT("%d.%d"), conn->GetMajorVersion(), conn->GetMinorVersion());
-		allVersions = settings->Read(wxT("Updates/pgsql-Versions"), wxEmptyString);
-		if (allVersions.Find(version) < 0)
-		{
-			if (!allVersions.IsEmpty())
-				allVersions += wxT(", ");
-			allVersions += version;
-			settings->Write(wxT("Updates/pgsql-Versions"), allVersions);
-		}
-		if (conn->IsSSLconnected())
-			settings->WriteBool(wxT("Updates/UseSSL"), true);
+	wxString exists = newConn->ExecuteScalar(
+	                      wxT("SELECT cl.oid FROM pg_class cl JOIN pg_namespace ns ON ns.oid=relnamespace\n")
+	                      wxT(" WHERE relname='pga_job' AND nspname='pgagent'"));
 
-		UpdateIcon(form->GetBrowser());
-		if (storePassword || forceStorePassword)
-			StorePassword();
+	if (!exists.IsNull())
+	{
+		exists = newConn->ExecuteScalar(wxT("SELECT has_schema_privilege('pgagent', 'USAGE')"));
+		pgAgentAvailable = (exists == wxT("t"));
 	}
+
+	autovacuumRunning = true;
+
+	wxString qry;
+	if (newConn->BackendMinimumVersion(8, 3))
+		qry = wxT("SELECT setting FROM pg_settings WHERE name IN ('autovacuum', 'track_counts')");
 	else
+		qry = wxT("SELECT setting FROM pg_settings WHERE name IN ('autovacuum', 'stats_start_collector', 'stats_row_level')");
+
+	pgSetIterator set(newConn, qry);
+
+	while (autovacuumRunning && set.RowsLeft())
+		autovacuumRunning = set.GetBool(wxT("setting"));
+
+	catalogInfoRead = true;
+}
+
+
+// The part of connecting that has to be done on the GUI thread
+void pgServer::FinishConnect(frmMain *form)
+{
+	// Check the server version
+	if (!(conn->BackendMinimumVersion(SERVER_MIN_VERSION_N >> 8, SERVER_MIN_VERSION_N & 0x00FF)) ||
+	        (conn->BackendMinimumVersion(SERVER_MAX_VERSION_N >> 8, (SERVER_MAX_VERSION_N & 0x00FF) + 1)))
 	{
-		connected = false;
+		wxLogWarning(_("The server you are connecting to is not a version that is supported by this release of %s.\n\n%s may not function as expected.\n\nSupported server versions are %s to %s."),
+		             appearanceFactory->GetLongAppName().c_str(),
+		             appearanceFactory->GetLongAppName().c_str(),
+		             wxString(SERVER_MIN_VERSION_T).c_str(),
+		             wxString(SERVER_MAX_VERSION_T).c_str());
 	}
 
-	form->EndMsg(connected && status == PGCONN_OK);
+	wxString version, allVersions;
+	version.Printf(wxT("%d.%d"), conn->GetMajorVersion(), conn->GetMinorVersion());
+	allVersions = settings->Read(wxT("Updates/pgsql-Versions"), wxEmptyString);
+	if (allVersions.Find(version) < 0)
+	{
+		if (!allVersions.IsEmpty())
+			allVersions += wxT(", ");
+		allVersions += version;
+		settings->Write(wxT("Updates/pgsql-Versions"), allVersions);
+	}
+	if (conn->IsSSLconnected())
+		settings->WriteBool(wxT("Updates/UseSSL"), true);
 
-	passwordValid = connected;
+	UpdateIcon(form->GetBrowser());
+}
+
+
+// Takes over a connection opened by pgServerConnector, on the GUI thread
+int pgServer::AttachConnection(frmMain *form, pgConn *newConn)
+{
+	connecting = false;
+
+	int status = newConn ? newConn->GetStatus() : PGCONN_BAD;
+	if (status != PGCONN_OK)
+	{
+		if (newConn)
+		{
+			wxLogInfo(wxT("Could not reconnect to server %s: %s"), GetName().c_str(), newConn->GetLastError().c_str());
+			delete newConn;
+		}
+		UpdateIcon(form->GetBrowser());
+		return status;
+	}
+
+	if (conn)
+		delete conn;
+	conn = newConn;
+
+	if (database.IsEmpty())
+		database = conn->GetDbname();
+	dbOid = conn->GetDbOid();
+	connected = true;
+	passwordValid = true;
+
+	FinishConnect(form);
 	return status;
 }
 
@@ -926,22 +1022,15 @@ void pgServer::ShowTreeDetail(ctlTree *browser, frmMain *form, ctlListView *prop
 			if (conn->BackendMinimumVersion(8, 0) && settings->GetDisplayOption(_("Tablespaces")))
 				browser->AppendCollection(this, tablespaceFactory);
 
+			// May have been read already when connecting in the background
+			if (!catalogInfoRead)
+				ReadCatalogInfo(conn);
+			catalogInfoRead = false;
+
 			// Jobs
 			// We only add the Jobs node if the appropriate objects are the initial DB.
-			if (settings->GetDisplayOption(_("pgAgent Jobs")))
-			{
-				wxString exists = conn->ExecuteScalar(
-				                      wxT("SELECT cl.oid FROM pg_class cl JOIN pg_namespace ns ON ns.oid=relnamespace\n")
-				                      wxT(" WHERE relname='pga_job' AND nspname='pgagent'"));
-
-				if (!exists.IsNull())
-				{
-					exists = conn->ExecuteScalar(wxT("SELECT has_schema_privilege('pgagent', 'USAGE')"));
-
-					if (exists == wxT("t"))
-						browser->AppendCollection(this, jobFactory);
-				}
-			}
+			if (settings->GetDisplayOption(_("pgAgent Jobs")) && pgAgentAvailable)
+				browser->AppendCollection(this, jobFactory);
 
 			if (conn->BackendMinimumVersion(8, 1))
 			{
@@ -962,19 +1051,6 @@ void pgServer::ShowTreeDetail(ctlTree *browser, frmMain *form, ctlListView *prop
 				if (settings->GetDisplayOption(_("Users/login Roles")))
 					browser->AppendCollection(this, userFactory);
 			}
-
-			autovacuumRunning = true;
-
-			wxString qry;
-			if (conn->BackendMinimumVersion(8, 3))
-				qry = wxT("SELECT setting FROM pg_settings WHERE name IN ('autovacuum', 'track_counts')");
-			else
-				qry = wxT("SELECT setting FROM pg_settings WHERE name IN ('autovacuum', 'stats_start_collector', 'stats_row_level')");
-
-			pgSetIterator set(conn, qry);
-
-			while (autovacuumRunning && set.RowsLeft())
-				autovacuumRunning = set.GetBool(wxT("setting"));
 		}
 	}
 
@@ -1287,7 +1363,7 @@ pgObject *pgServerFactory::CreateObjects(pgCollection *obj, ctlTree *browser, co
 
 	long loop, port, ssl = 0;
 	wxString key, servername, hostaddr, description, service, database, username, lastDatabase, lastSchema;
-	wxString storePwd, rolename, restore, serviceID, discoveryID, dbRestriction, colour;
+	wxString storePwd, rolename, restore, reconnect, serviceID, discoveryID, dbRestriction, colour;
 	wxString group, sslcert, sslkey, sslrootcert, sslcrl, sslcompression;
 	pgServer *server = 0;
 
@@ -1314,6 +1390,7 @@ pgObject *pgServerFactory::CreateObjects(pgCollection *obj, ctlTree *browser, co
 		settings->Read(key + wxT("StorePwd"), &storePwd, wxEmptyString);
 		settings->Read(key + wxT("Rolename"), &rolename, wxEmptyString);
 		settings->Read(key + wxT("Restore"), &restore, wxT("true"));
+		settings->Read(key + wxT("Reconnect"), &reconnect, wxT("false"));
 		settings->Read(key + wxT("Port"), &port, 0);
 		settings->Read(key + wxT("Database"), &database, wxEmptyString);
 		settings->Read(key + wxT("Username"), &username, wxEmptyString);
@@ -1377,6 +1454,7 @@ pgObject *pgServerFactory::CreateObjects(pgCollection *obj, ctlTree *browser, co
 		server->SetSSLRootCert(sslrootcert);
 		server->SetSSLCrl(sslcrl);
 		server->iSetSSLCompression(StrToBool(sslcompression));
+		server->iSetReconnect(StrToBool(reconnect));
 
 		found = false;
 		if (browser->ItemHasChildren(obj->GetId()))
@@ -0,0 +1,265 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// pgServerConnector.cpp - Reconnect servers in the background at startup
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "pgAdmin3.h"
+
+// wxWindows headers
+#include <wx/wx.h>
+
+// App headers
+#include "frm/menu.h"
+#include "frm/frmMain.h"
+#include "db/pgConn.h"
+#include "schema/pgServer.h"
+#include "schema/pgServerConnector.h"
+
+// Servers connected at the same time
+#define SERVERCONNECT_THREADS   8
+
+// Seconds to wait for a server when the connect timeout is set to wait
+// forever; the threads must end when the main window closes
+#define SERVERCONNECT_TIMEOUT   10
+
+
+// wxString may share its buffer between copies, so the worker threads
+// only get strings nobody else refers to
+static wxString UnsharedCopy(const wxString &str)
+{
+	return wxString(str.c_str());
+}
+
+
+pgServerConnectThread::pgServerConnectThread(pgServerConnector *_connector)
+	: wxThread(wxTHREAD_JOINABLE)
+{
+	connector = _connector;
+}
+
+
+void *pgServerConnectThread::Entry()
+{
+	pgServerConnectJob *job;
+	while (!TestDestroy() && (job = connector->Next()) != 0)
+	{
+		connector->Connect(job);
+		connector->Finished(job);
+	}
+	return 0;
+}
+
+
+pgServerConnector::pgServerConnector(frmMain *_form, int _timeout)
+{
+	form = _form;
+	timeout = _timeout > 0 ? _timeout : SERVERCONNECT_TIMEOUT;
+}
+
+
+pgServerConnector::~pgServerConnector()
+{
+	size_t i;
+
+	{
+		wxMutexLocker locker(lock);
+		while (queue.GetCount())
+		{
+			queue.Last()->server->iSetConnecting(false);
+			delete queue.Last();
+			queue.RemoveAt(queue.GetCount() - 1);
+		}
+
+		// The threads then take no new job; their queries are cancelled
+		// here, connection attempts end when the connect timeout expires
+		for (i = 0 ; i < running.GetCount() ; i++)
+		{
+			if (running.Item(i)->cancel)
+			{
+				char errbuf[256];
+				PQcancel(running.Item(i)->cancel, errbuf, sizeof(errbuf));
+			}
+		}
+	}
+
+	for (i = 0 ; i < threads.GetCount() ; i++)
+	{
+		threads.Item(i)->Delete();
+		delete threads.Item(i);
+	}
+
+	// Results whose event has not been handled yet
+	for (i = 0 ; i < done.GetCount() ; i++)
+	{
+		done.Item(i)->server->iSetConnecting(false);
+		if (done.Item(i)->conn)
+			delete done.Item(i)->conn;
+		delete done.Item(i);
+	}
+}
+
+
+void pgServerConnector::Add(pgServer *server)
+{
+	pgServerConnectJob *job = new pgServerConnectJob;
+
+	job->server = server;
+	job->host = UnsharedCopy(server->GetName());
+	job->hostaddr = UnsharedCopy(server->GetHostAddr());
+	job->service = UnsharedCopy(server->GetService());
+	job->database = UnsharedCopy(server->GetDatabaseName());
+	job->username = UnsharedCopy(server->GetUsername());
+	job->password = UnsharedCopy(server->GetPassword());
+	job->rolename = UnsharedCopy(server->GetRolename());
+	job->applicationname = UnsharedCopy(appearanceFactory->GetLongAppName() + _(" - Browser"));
+	job->sslcert = UnsharedCopy(server->GetSSLCert());
+	job->sslkey = UnsharedCopy(server->GetSSLKey());
+	job->sslrootcert = UnsharedCopy(server->GetSSLRootCert());
+	job->sslcrl = UnsharedCopy(server->GetSSLCrl());
+	job->port = server->GetPort();
+	job->ssl = server->GetSSL();
+	job->sslcompression = server->GetSSLCompression();
+	job->conn = 0;
+	job->cancel = 0;
+
+	// Keeps the GUI from connecting or dropping it meanwhile
+	server->iSetConnecting(true);
+
+	wxMutexLocker locker(lock);
+	queue.Add(job);
+}
+
+
+void pgServerConnector::Start()
+{
+	size_t count = queue.GetCount();
+	if (count > SERVERCONNECT_THREADS)
+		count = SERVERCONNECT_THREADS;
+
+	wxLogInfo(wxT("Reconnecting %d servers in the background"), (int)queue.GetCount());
+
+	while (threads.GetCount() < count)
+	{
+		pgServerConnectThread *thread = new pgServerConnectThread(this);
+		if (thread->Create() != wxTHREAD_NO_ERROR)
+		{
+			delete thread;
+			break;
+		}
+		threads.Add(thread);
+		thread->Run();
+	}
+
+	// Without threads, the servers stay disconnected
+	if (threads.IsEmpty())
+	{
+		wxMutexLocker locker(lock);
+		while (queue.GetCount())
+		{
+			queue.Last()->server->iSetConnecting(false);
+			delete queue.Last();
+			queue.RemoveAt(queue.GetCount() - 1);
+		}
+	}
+}
+
+
+pgServerConnectJob *pgServerConnector::Next()
+{
+	wxMutexLocker locker(lock);
+
+	if (queue.IsEmpty())
+		return 0;
+
+	pgServerConnectJob *job = queue.Item(0);
+	queue.RemoveAt(0);
+	running.Add(job);
+	return job;
+}
+
+
+// Runs on a worker thread
+void pgServerConnector::Connect(pgServerConnectJob *job)
+{
+	// Same choice of maintenance database as pgServer::Connect()
+	wxString dbName = job->database;
+	if (dbName.IsEmpty())
+		dbName = wxT("postgres");
+
+	job->conn = new pgConn(job->host, job->service, job->hostaddr, dbName, job->username, job->password, job->port,
+	                       job->rolename, job->ssl, 0, job->applicationname, job->sslcert, job->sslkey,
+	                       job->sslrootcert, job->sslcrl, job->sslcompression, timeout);
+
+	if (job->database.IsEmpty() && job->conn->GetStatus() == PGCONN_BAD &&
+	        job->conn->GetLastError().Find(wxT("database \"postgres\" does not exist")) >= 0)
+	{
+		delete job->conn;
+		job->conn = new pgConn(job->host, job->service, job->hostaddr, wxT("template1"), job->username, job->password, job->port,
+		                       job->rolename, job->ssl, 0, job->applicationname, job->sslcert, job->sslkey,
+		                       job->sslrootcert, job->sslcrl, job->sslcompression, timeout);
+	}
+
+	if (job->conn->GetStatus() == PGCONN_OK)
+	{
+		{
+			wxMutexLocker locker(lock);
+			job->cancel = PQgetCancel(job->conn->connection());
+		}
+
+		job->conn->ExecuteVoid(wxString::Format(wxT("SET statement_timeout = %ld;"), timeout * 1000L), false);
+		job->server->ReadServerInfo(job->conn);
+		job->server->ReadCatalogInfo(job->conn);
+		job->conn->ExecuteVoid(wxT("RESET statement_timeout;"), false);
+
+		wxMutexLocker locker(lock);
+		PQfreeCancel(job->cancel);
+		job->cancel = 0;
+	}
+}
+
+
+void pgServerConnector::Finished(pgServerConnectJob *job)
+{
+	{
+		wxMutexLocker locker(lock);
+		running.Remove(job);
+		done.Add(job);
+	}
+
+	wxCommandEvent ev(wxEVT_COMMAND_MENU_SELECTED, SERVERCONNECT_COMPLETE);
+	ev.SetClientData(job);
+	form->GetEventHandler()->AddPendingEvent(ev);
+}
+
+
+// Called on the GUI thread for each SERVERCONNECT_COMPLETE event
+void pgServerConnector::Complete(pgServerConnectJob *job)
+{
+	{
+		wxMutexLocker locker(lock);
+		if (done.Index(job) == wxNOT_FOUND)
+			return;
+		done.Remove(job);
+	}
+
+	pgServer *server = job->server;
+	if (server->AttachConnection(form, job->conn) == PGCONN_OK)
+	{
+		wxLogInfo(wxT("Reconnected to server %s"), server->GetName().c_str());
+		server->ShowTreeDetail(form->GetBrowser());
+	}
+	delete job;
+}
+
+
+bool pgServerConnector::IsDone()
+{
+	wxMutexLocker locker(lock);
+	return queue.IsEmpty() && running.IsEmpty() && done.IsEmpty();
+}
@@ -1353,3 +1353,133 @@ bool getArrayFromCommaSeparatedList(const wxString &str, wxArrayString &res)
 	return true;
 }
 
+
+static bool IsIdentChar(wxChar c)
+{
+	return wxIsalnum(c) || c == '_' || c == '$' || c > 127;
+}
+
+// The script is split at the semicolons that are outside of quotes, comments
+// and brackets, the same way the server's scanner sees them (E'' strings,
+// dollar quotes and nested comments included). standardStrings is the
+// server's standard_conforming_strings: when it is off, backslashes escape
+// in plain '' strings as well. Comments before a statement and empty
+// statements are dropped; offsets gives the position of the first character
+// of each statement in str.
+void SplitStatements(const wxString &str, wxArrayString &statements, wxArrayInt &offsets, bool standardStrings)
+{
+	size_t len = str.Len(), index = 0, nBracketLevel = 0;
+	int start = -1;
+
+	while (index < len)
+	{
+		wxChar curr = str.GetChar(index);
+		wxChar next = index + 1 < len ? str.GetChar(index + 1) : (wxChar)0;
+
+		if (curr == '-' && next == '-')
+		{
+			while (index < len && str.GetChar(index) != '\n')
+				index++;
+			continue;
+		}
+		if (curr == '/' && next == '*')
+		{
+			int nCommentLevel = 0;
+			while (index < len)
+			{
+				if (str.GetChar(index) == '/' && index + 1 < len && str.GetChar(index + 1) == '*')
+				{
+					nCommentLevel++;
+					index += 2;
+				}
+				else if (str.GetChar(index) == '*' && index + 1 < len && str.GetChar(index + 1) == '/')
+				{
+					index += 2;
+					if (--nCommentLevel == 0)
+						break;
+				}
+				else
+					index++;
+			}
+			continue;
+		}
+		if (wxIsspace(curr))
+		{
+			index++;
+			continue;
+		}
+		if (curr == ';' && nBracketLevel == 0)
+		{
+			if (start >= 0)
+			{
+				statements.Add(str.Mid(start, index - start).Trim(true));
+				offsets.Add(start);
+				start = -1;
+			}
+			index++;
+			continue;
+		}
+
+		if (start < 0)
+			start = index;
+
+		if (curr == '\'')
+		{
+			// E'' strings always use backslash escapes, the others only
+			// without standard_conforming_strings
+			bool escapes = !standardStrings ||
+			               (index > 0 && (str.GetChar(index - 1) == 'E' || str.GetChar(index - 1) == 'e') &&
+			                (index < 2 || !IsIdentChar(str.GetChar(index - 2))));
+			index++;
+			while (index < len)
+			{
+				wxChar c = str.GetChar(index);
+				if (escapes && c == '\\')
+					index += 2;
+				else if (c == '\'')
+				{
+					if (index + 1 < len && str.GetChar(index + 1) == '\'')
+						index += 2;
+					else
+						break;
+				}
+				else
+					index++;
+			}
+			index++;
+			continue;
+		}
+		if (curr == '"')
+		{
+			size_t close = str.find(wxT('"'), index + 1);
+			index = (close == wxString::npos ? len : close + 1);
+			continue;
+		}
+		if (curr == '$' && (index == 0 || !IsIdentChar(str.GetChar(index - 1))) && !wxIsdigit(next))
+		{
+			size_t tagEnd = index + 1;
+			while (tagEnd < len && str.GetChar(tagEnd) != '$' && IsIdentChar(str.GetChar(tagEnd)))
+				tagEnd++;
+			if (tagEnd < len && str.GetChar(tagEnd) == '$')
+			{
+				wxString tag = str.Mid(index, tagEnd - index + 1);
+				size_t close = str.find(tag, tagEnd + 1);
+				index = (close == wxString::npos ? len : close + tag.Len());
+				continue;
+			}
+		}
+
+		if (curr == '(')
+			nBracketLevel++;
+		else if (curr == ')' && nBracketLevel > 0)
+			nBracketLevel--;
+		index++;
+	}
+
+	if (start >= 0)
+	{
+		statements.Add(str.Mid(start).Trim(true));
+		offsets.Add(start);
+	}
+}
+
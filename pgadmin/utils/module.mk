@@ -18,6 +18,8 @@ pgadmin3_SOURCES += \
 	utils/registry.cpp \
 	utils/sysLogger.cpp \
 	utils/sysProcess.cpp \
+	utils/sysProcessQueue.cpp \
+	utils/sysQueryHistory.cpp \
 	utils/sysSettings.cpp \
 	utils/tabcomplete.c \
 	utils/utffile.cpp \
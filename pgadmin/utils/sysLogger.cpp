@@ -27,6 +27,67 @@
 wxLogLevel sysLogger::logLevel = LOG_ERRORS;
 wxString sysLogger::logFile = wxT("debug.log");
 
+// How long the writer thread lets lines collect, in ms
+#define LOG_FLUSH_INTERVAL  500
+// Wake the writer early once this many lines are queued
+#define LOG_BATCH_SIZE      256
+// Move the log file to <logfile>.1 when it grows beyond this
+#define LOG_MAX_SIZE        (10 * 1024 * 1024)
+
+
+class sysLogWriter : public wxThread
+{
+public:
+	sysLogWriter(sysLogger *_logger) : wxThread(wxTHREAD_JOINABLE)
+	{
+		logger = _logger;
+	}
+	void *Entry();
+
+private:
+	sysLogger *logger;
+};
+
+
+// Holds fileLock and remembers the thread holding it, so that errors logged
+// by the file operations are dropped instead of coming back for the lock
+class sysLogFileLocker
+{
+public:
+	sysLogFileLocker(sysLogger *_logger) : locker(_logger->fileLock)
+	{
+		logger = _logger;
+		logger->fileOwner = wxThread::GetCurrentId();
+	}
+	~sysLogFileLocker()
+	{
+		logger->fileOwner = 0;
+	}
+
+private:
+	wxMutexLocker locker;
+	sysLogger *logger;
+};
+
+
+void *sysLogWriter::Entry()
+{
+	bool stop = false;
+	while (!stop)
+	{
+		{
+			wxMutexLocker locker(logger->queueLock);
+			if (!logger->stopping)
+				logger->wake->WaitTimeout(LOG_FLUSH_INTERVAL);
+			stop = logger->stopping;
+		}
+
+		sysLogFileLocker locker(logger);
+		logger->WriteQueue();
+	}
+	return 0;
+}
+
 #if !wxCHECK_VERSION(2, 9, 0)
 
 // IMPLEMENT_LOG_FUNCTION(Sql) from wx../common/log.c
@@ -132,12 +193,67 @@ void wxLogScriptVerbose(const wxChar *szFormat, ...)
 
 #endif
 
+sysLogger::sysLogger()
+{
+	wake = new wxCondition(queueLock);
+	stopping = false;
+	writer = 0;
+	fileOwner = 0;
+}
+
+
+sysLogger::~sysLogger()
+{
+	StopWriter();
+	delete wake;
+}
+
+
+void sysLogger::StartWriter()
+{
+	if (writer)
+		return;
+
+	stopping = false;
+	writer = new sysLogWriter(this);
+	if (writer->Create() != wxTHREAD_NO_ERROR || writer->Run() != wxTHREAD_NO_ERROR)
+	{
+		delete writer;
+		writer = 0;
+	}
+}
+
+
+void sysLogger::StopWriter()
+{
+	if (writer)
+	{
+		{
+			wxMutexLocker locker(queueLock);
+			stopping = true;
+			wake->Signal();
+		}
+		writer->Wait();
+		delete writer;
+		writer = 0;
+	}
+
+	sysLogFileLocker locker(this);
+	WriteQueue();
+}
+
+
 #if wxCHECK_VERSION(2, 9, 0)
 void sysLogger::DoLogTextAtLevel(wxLogLevel level, const wxString &msg)
 #else
 void sysLogger::DoLog(wxLogLevel level, const wxChar *msg, time_t timestamp)
 #endif
 {
+	// Writing the log file failed, and that got logged as well. Only this
+	// thread can have set fileOwner to its own id.
+	if (fileOwner == wxThread::GetCurrentId())
+		return;
+
 	wxString msgtype, preamble;
 	int icon = 0;
 
@@ -226,6 +342,11 @@ void sysLogger::DoLog(wxLogLevel level, const wxChar *msg, time_t timestamp)
 	delete time;
 #endif
 
+	// Errors are written at once, in case we are about to crash
+	bool sync = (level == wxLOG_FatalError ||
+	             level == wxLOG_Error ||
+	             level == wxLOG_QuietError);
+
 	// Display the message if required
 	switch (logLevel)
 	{
@@ -236,7 +357,7 @@ void sysLogger::DoLog(wxLogLevel level, const wxChar *msg, time_t timestamp)
 			if (level == wxLOG_FatalError ||
 			        level == wxLOG_Error ||
 			        level == wxLOG_QuietError)
-				WriteLog(fullmsg);
+				WriteLog(fullmsg, sync);
 			break;
 
 		case LOG_NOTICE:
@@ -244,7 +365,7 @@ void sysLogger::DoLog(wxLogLevel level, const wxChar *msg, time_t timestamp)
 			        level == wxLOG_Error ||
 			        level == wxLOG_QuietError ||
 			        level == wxLOG_Notice)
-				WriteLog(fullmsg);
+				WriteLog(fullmsg, sync);
 			break;
 
 		case LOG_SQL:
@@ -256,11 +377,11 @@ void sysLogger::DoLog(wxLogLevel level, const wxChar *msg, time_t timestamp)
 			        level == wxLOG_Notice ||
 			        level == wxLOG_Sql ||
 			        level == wxLOG_Script)
-				WriteLog(fullmsg);
+				WriteLog(fullmsg, sync);
 			break;
 
 		case LOG_DEBUG:
-			WriteLog(fullmsg);
+			WriteLog(fullmsg, sync);
 			break;
 	}
 
@@ -272,29 +393,97 @@ void sysLogger::DoLog(wxLogLevel level, const wxChar *msg, time_t timestamp)
 }
 
 
-void sysLogger::WriteLog(const wxString &msg)
+void sysLogger::WriteLog(const wxString &msg, bool sync)
 {
-	wxString pid, logfile;
+	bool reopen;
+	{
+		wxMutexLocker locker(queueLock);
+		reopen = (logFile != fileSetting);
+	}
 
-	// Disable logging to prevent recursion in the event of a problem
-	wxLogNull foo;
+	// The log file was changed in the options; write what was queued for
+	// the old one before switching.
+	if (reopen)
+	{
+		bool opened;
+		{
+			sysLogFileLocker locker(this);
+			WriteQueue();
+			opened = OpenLogFile();
+		}
+
+#if !defined(PGSCLI)
+		if (!opened)
+			wxMessageBox(_("Cannot open the logfile!"), _("FATAL"), wxOK | wxCENTRE | wxICON_ERROR);
+#endif // PGSCLI
+	}
 
-	pid.Printf(wxT("%ld"), wxGetProcessId());
-	logfile.Printf(wxT("%s"), logFile.c_str());
-	logfile.Replace(wxT("%ID"), pid);
+	{
+		wxMutexLocker locker(queueLock);
+		// Avoid shared storage issues with strings, the writer thread
+		// frees the queued lines
+		queue.Add(wxString(msg.c_str()));
+
+		if (writer && !sync)
+		{
+			if (queue.GetCount() >= LOG_BATCH_SIZE)
+				wake->Signal();
+			return;
+		}
+	}
 
-	wxFFile file(logfile, wxT("a"));
+	sysLogFileLocker locker(this);
+	WriteQueue();
+}
+
+
+// Called with fileLock held
+bool sysLogger::OpenLogFile()
+{
+	if (file.IsOpened())
+		file.Close();
 
-#if !defined(PGSCLI)
-	if (!file.IsOpened())
 	{
-		wxMessageBox(_("Cannot open the logfile!"), _("FATAL"), wxOK | wxCENTRE | wxICON_ERROR);
-		return;
+		wxMutexLocker locker(queueLock);
+		fileSetting = logFile.c_str();
 	}
-#endif // PGSCLI
+	fileName = fileSetting;
+	fileName.Replace(wxT("%ID"), wxString::Format(wxT("%ld"), wxGetProcessId()));
 
-	file.Write(msg + wxT("\n"));
-	file.Close();
+	return file.Open(fileName, wxT("a"));
+}
+
+
+// Called with fileLock held. Lines queued while the log file can't be
+// opened are dropped.
+void sysLogger::WriteQueue()
+{
+	wxArrayString lines;
+	{
+		wxMutexLocker locker(queueLock);
+		if (queue.IsEmpty())
+			return;
+		lines = queue;
+		queue.Clear();
+	}
+
+	if (!file.IsOpened())
+		return;
+
+	wxString text;
+	size_t i;
+	for (i = 0 ; i < lines.GetCount() ; i++)
+		text << lines.Item(i) << wxT("\n");
+
+	file.Write(text);
+	file.Flush();
+
+	if (file.Length() > LOG_MAX_SIZE)
+	{
+		file.Close();
+		wxRenameFile(fileName, fileName + wxT(".1"), true);
+		file.Open(fileName, wxT("a"));
+	}
 }
 
 // Check to see if a message should be silenced (because it's meaningless
@@ -0,0 +1,274 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// sysProcessQueue.cpp - Runs a list of external processes concurrently
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+// wxWindows headers
+#include <wx/wx.h>
+
+
+// App headers
+#include "pgAdmin3.h"
+#include "utils/sysProcessQueue.h"
+
+
+#define QUEUE_TIMER_ID 4443
+
+
+sysProcessJob::sysProcessJob(const wxString &_name, const wxString &_cmd, const wxString &_displayCmd)
+{
+	name = _name;
+	cmd = _cmd;
+	displayCmd = _displayCmd.IsEmpty() ? _cmd : _displayCmd;
+	state = JOB_WAITING;
+	exitCode = 0;
+	process = 0;
+	pid = 0;
+	startTime = 0;
+	endTime = 0;
+}
+
+
+wxString sysProcessJob::GetStateName() const
+{
+	switch (state)
+	{
+		case JOB_WAITING:
+			return _("Waiting");
+		case JOB_RUNNING:
+			return _("Running");
+		case JOB_SUCCEEDED:
+			return _("Done");
+		case JOB_FAILED:
+			return _("Failed");
+		case JOB_CANCELLED:
+			return _("Cancelled");
+	}
+	return wxEmptyString;
+}
+
+
+wxLongLong sysProcessJob::GetElapsed() const
+{
+	if (startTime == 0)
+		return 0;
+	if (state == JOB_RUNNING)
+		return wxGetLocalTimeMillis() - startTime;
+	return endTime - startTime;
+}
+
+
+
+BEGIN_EVENT_TABLE(sysProcessQueue, wxEvtHandler)
+	EVT_END_PROCESS(-1,                     sysProcessQueue::OnEndProcess)
+	EVT_TIMER(QUEUE_TIMER_ID,               sysProcessQueue::OnPoll)
+END_EVENT_TABLE()
+
+
+sysProcessQueue::sysProcessQueue(wxEvtHandler *_owner, int _notifyId)
+{
+	owner = _owner;
+	notifyId = _notifyId;
+	maxJobs = 1;
+	timer = new wxTimer(this, QUEUE_TIMER_ID);
+}
+
+
+sysProcessQueue::~sysProcessQueue()
+{
+	Abort();
+	delete timer;
+	WX_CLEAR_ARRAY(jobs);
+}
+
+
+size_t sysProcessQueue::AddJob(const wxString &name, const wxString &cmd, const wxString &displayCmd)
+{
+	jobs.Add(new sysProcessJob(name, cmd, displayCmd));
+	return jobs.GetCount() - 1;
+}
+
+
+void sysProcessQueue::Clear()
+{
+	Abort();
+	WX_CLEAR_ARRAY(jobs);
+}
+
+
+void sysProcessQueue::Start()
+{
+	StartJobs();
+	timer->Start(250L);
+	Notify();
+}
+
+
+bool sysProcessQueue::IsRunning() const
+{
+	size_t i;
+	for (i = 0 ; i < jobs.GetCount() ; i++)
+	{
+		if (jobs.Item(i)->state == JOB_WAITING || jobs.Item(i)->state == JOB_RUNNING)
+			return true;
+	}
+	return false;
+}
+
+
+size_t sysProcessQueue::GetFinishedCount() const
+{
+	size_t i, count = 0;
+	for (i = 0 ; i < jobs.GetCount() ; i++)
+	{
+		if (jobs.Item(i)->state >= JOB_SUCCEEDED)
+			count++;
+	}
+	return count;
+}
+
+
+size_t sysProcessQueue::GetFailedCount() const
+{
+	size_t i, count = 0;
+	for (i = 0 ; i < jobs.GetCount() ; i++)
+	{
+		if (jobs.Item(i)->state == JOB_FAILED)
+			count++;
+	}
+	return count;
+}
+
+
+void sysProcessQueue::StartJobs()
+{
+	int running = 0;
+	size_t i;
+
+	for (i = 0 ; i < jobs.GetCount() ; i++)
+	{
+		if (jobs.Item(i)->state == JOB_RUNNING)
+			running++;
+	}
+
+	for (i = 0 ; i < jobs.GetCount() && running < maxJobs ; i++)
+	{
+		sysProcessJob *job = jobs.Item(i);
+		if (job->state != JOB_WAITING)
+			continue;
+
+		job->log = job->displayCmd + END_OF_LINE;
+		job->startTime = wxGetLocalTimeMillis();
+
+		job->process = new sysProcess(this);
+		job->process->SetEnvironment(environment);
+
+		job->pid = wxExecute(job->cmd, wxEXEC_ASYNC, job->process);
+		if (job->pid)
+		{
+			job->state = JOB_RUNNING;
+			running++;
+		}
+		else
+		{
+			delete job->process;
+			job->process = 0;
+			job->state = JOB_FAILED;
+			job->endTime = wxGetLocalTimeMillis();
+			job->log += _("Could not start the process.") + wxString(END_OF_LINE);
+		}
+	}
+}
+
+
+void sysProcessQueue::ReadOutput(sysProcessJob *job)
+{
+	if (job->process)
+	{
+		job->log += job->process->ReadErrorStream();
+		job->log += job->process->ReadInputStream();
+	}
+}
+
+
+void sysProcessQueue::Notify()
+{
+	wxCommandEvent ev(wxEVT_COMMAND_MENU_SELECTED, notifyId);
+	owner->AddPendingEvent(ev);
+}
+
+
+void sysProcessQueue::OnPoll(wxTimerEvent &event)
+{
+	size_t i;
+	for (i = 0 ; i < jobs.GetCount() ; i++)
+	{
+		if (jobs.Item(i)->state == JOB_RUNNING)
+			ReadOutput(jobs.Item(i));
+	}
+	Notify();
+}
+
+
+void sysProcessQueue::OnEndProcess(wxProcessEvent &ev)
+{
+	size_t i;
+	for (i = 0 ; i < jobs.GetCount() ; i++)
+	{
+		sysProcessJob *job = jobs.Item(i);
+		if (job->state != JOB_RUNNING || job->pid != ev.GetPid())
+			continue;
+
+		ReadOutput(job);
+		delete job->process;
+		job->process = 0;
+		job->pid = 0;
+
+		job->exitCode = ev.GetExitCode();
+		job->state = job->exitCode ? JOB_FAILED : JOB_SUCCEEDED;
+		job->endTime = wxGetLocalTimeMillis();
+		job->log += END_OF_LINE
+		            + wxString::Format(_("Process returned exit code %d."), job->exitCode)
+		            + END_OF_LINE;
+		break;
+	}
+
+	StartJobs();
+	if (!IsRunning())
+		timer->Stop();
+
+	Notify();
+}
+
+
+void sysProcessQueue::Abort()
+{
+	timer->Stop();
+
+	size_t i;
+	for (i = 0 ; i < jobs.GetCount() ; i++)
+	{
+		sysProcessJob *job = jobs.Item(i);
+
+		if (job->state == JOB_RUNNING)
+		{
+			// The process object deletes itself once the child is gone
+			job->process->Detach();
+			wxKill(job->pid, wxSIGTERM);
+			job->process = 0;
+			job->pid = 0;
+			job->endTime = wxGetLocalTimeMillis();
+			job->log += END_OF_LINE + wxString(_("Cancelled on user request.")) + END_OF_LINE;
+			job->state = JOB_CANCELLED;
+		}
+		else if (job->state == JOB_WAITING)
+			job->state = JOB_CANCELLED;
+	}
+}
@@ -0,0 +1,456 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// pgAdmin III - PostgreSQL Tools
+//
+// Copyright (C) 2002 - 2012, The pgAdmin Development Team
+// This software is released under the PostgreSQL Licence
+//
+// sysQueryHistory.cpp - History of executed queries shared by the query tools
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+// wxWindows headers
+#include <wx/wx.h>
+#include <wx/file.h>
+#include <wx/tokenzr.h>
+
+// libxml2 headers
+#include <libxml/parser.h>
+
+// App headers
+#include "pgAdmin3.h"
+#include "frm/menu.h"
+#include "utils/sysQueryHistory.h"
+
+#define JOURNAL_HEADER "pgAdmin query history 1\n"
+
+// Don't bother compacting small files
+#define JOURNAL_SLACK 64
+
+// libxml convenience macros
+#define WXSTRING_FROM_XML(s) wxString((char *)s, wxConvUTF8)
+
+
+sysQueryHistory::sysQueryHistory()
+{
+	loaded = false;
+	nextSerial = 0;
+	records = 0;
+}
+
+
+size_t sysQueryHistory::GetCount()
+{
+	Load();
+	return queries.GetCount();
+}
+
+
+void sysQueryHistory::GetQueries(wxArrayString &result)
+{
+	Load();
+	result = queries;
+}
+
+
+void sysQueryHistory::Add(const wxString &query)
+{
+	Load();
+
+	if (query.IsEmpty())
+		return;
+
+	queryHistoryIndex::iterator it = index.find(query);
+	if (it != index.end())
+	{
+		// Already the newest entry, nothing changes
+		if (it->second == serials.Last())
+			return;
+		RemoveAt(FindSerial(it->second));
+	}
+	AddEntry(query);
+
+	wxCharBuffer text = query.mb_str(wxConvUTF8);
+	size_t len = strlen(text);
+
+	wxMemoryBuffer record(len + 16);
+	wxCharBuffer head = wxString::Format(wxT("+ %ld\n"), (long)len).mb_str(wxConvUTF8);
+	record.AppendData(head, strlen(head));
+	record.AppendData(text, len);
+	record.AppendByte('\n');
+	WriteRecord(record);
+	Notify(QUERYHISTORY_ADDED, query);
+
+	Trim();
+
+	if (records > (long)queries.GetCount() * 2 + JOURNAL_SLACK)
+		Compact();
+}
+
+
+void sysQueryHistory::Remove(const wxString &query)
+{
+	Load();
+
+	queryHistoryIndex::iterator it = index.find(query);
+	if (it == index.end())
+		return;
+
+	long serial = it->second;
+	RemoveAt(FindSerial(serial));
+
+	wxMemoryBuffer record(32);
+	wxCharBuffer data = wxString::Format(wxT("- %ld\n"), serial).mb_str(wxConvUTF8);
+	record.AppendData(data, strlen(data));
+	WriteRecord(record);
+
+	Notify(QUERYHISTORY_REMOVED, query);
+}
+
+
+void sysQueryHistory::Clear()
+{
+	Load();
+
+	queries.Clear();
+	lowerQueries.Clear();
+	serials.Clear();
+	index.clear();
+
+	Compact();
+	Notify(QUERYHISTORY_RELOADED);
+}
+
+
+void sysQueryHistory::Search(const wxString &text, wxArrayString &results, size_t maxResults)
+{
+	Load();
+
+	wxArrayString words;
+	SplitWords(text, words);
+
+	size_t i = queries.GetCount();
+	while (i > 0 && results.GetCount() < maxResults)
+	{
+		i--;
+		if (ContainsWords(lowerQueries.Item(i), words))
+			results.Add(queries.Item(i));
+	}
+}
+
+
+bool sysQueryHistory::Matches(const wxString &text, const wxString &query)
+{
+	wxArrayString words;
+	SplitWords(text, words);
+	return ContainsWords(query.Lower(), words);
+}
+
+
+void sysQueryHistory::SplitWords(const wxString &text, wxArrayString &words)
+{
+	wxStringTokenizer tokens(text.Lower(), wxT(" \t\r\n"), wxTOKEN_STRTOK);
+	while (tokens.HasMoreTokens())
+		words.Add(tokens.GetNextToken());
+}
+
+
+bool sysQueryHistory::ContainsWords(const wxString &lower, const wxArrayString &words)
+{
+	size_t w;
+	for (w = 0 ; w < words.GetCount() ; w++)
+	{
+		if (lower.Find(words.Item(w)) == wxNOT_FOUND)
+			return false;
+	}
+	return true;
+}
+
+
+void sysQueryHistory::AddListener(wxEvtHandler *listener)
+{
+	if (listeners.Index(listener) == wxNOT_FOUND)
+		listeners.Add(listener);
+}
+
+
+void sysQueryHistory::RemoveListener(wxEvtHandler *listener)
+{
+	listeners.Remove(listener);
+}
+
+
+void sysQueryHistory::Notify(int change, const wxString &query)
+{
+	size_t i;
+	for (i = 0 ; i < listeners.GetCount() ; i++)
+	{
+		wxCommandEvent ev(wxEVT_COMMAND_MENU_SELECTED, QUERYHISTORY_CHANGED);
+		ev.SetInt(change);
+		ev.SetString(query);
+		listeners.Item(i)->AddPendingEvent(ev);
+	}
+}
+
+
+void sysQueryHistory::AddEntry(const wxString &query)
+{
+	queries.Add(query);
+	lowerQueries.Add(query.Lower());
+	serials.Add(nextSerial);
+	index[query] = nextSerial;
+	nextSerial++;
+}
+
+
+void sysQueryHistory::RemoveAt(size_t n)
+{
+	index.erase(queries.Item(n));
+	queries.RemoveAt(n);
+	lowerQueries.RemoveAt(n);
+	serials.RemoveAt(n);
+}
+
+
+// Serials grow with every addition, so the array stays sorted
+int sysQueryHistory::FindSerial(long serial) const
+{
+	int lo = 0, hi = (int)serials.GetCount() - 1;
+	while (lo <= hi)
+	{
+		int mid = (lo + hi) / 2;
+		if (serials.Item(mid) == serial)
+			return mid;
+		if (serials.Item(mid) < serial)
+			lo = mid + 1;
+		else
+			hi = mid - 1;
+	}
+	return wxNOT_FOUND;
+}
+
+
+// Drop the oldest queries beyond the configured maximum
+void sysQueryHistory::Trim()
+{
+	long maxQueries = settings->GetHistoryMaxQueries();
+	if (maxQueries < 0)
+		maxQueries = 0;
+
+	while ((long)queries.GetCount() > maxQueries)
+	{
+		long serial = serials.Item(0);
+		wxString query = queries.Item(0);
+		RemoveAt(0);
+
+		wxMemoryBuffer record(32);
+		wxCharBuffer data = wxString::Format(wxT("- %ld\n"), serial).mb_str(wxConvUTF8);
+		record.AppendData(data, strlen(data));
+		WriteRecord(record);
+
+		Notify(QUERYHISTORY_REMOVED, query);
+	}
+}
+
+
+void sysQueryHistory::Load()
+{
+	// The file may be changed in the options dialogue at any time
+	wxString file = settings->GetHistoryFile();
+	if (loaded && file == fileName)
+		return;
+
+	fileName = file;
+	loaded = true;
+
+	queries.Clear();
+	lowerQueries.Clear();
+	serials.Clear();
+	index.clear();
+	nextSerial = 0;
+	records = 0;
+
+	if (!wxFile::Access(fileName, wxFile::read))
+		return;
+
+	wxFile f(fileName);
+	if (!f.IsOpened())
+		return;
+
+	size_t len = (size_t)f.Length();
+	wxMemoryBuffer buf(len + 1);
+	ssize_t got = f.Read(buf.GetWriteBuf(len + 1), len);
+	f.Close();
+	len = got > 0 ? (size_t)got : 0;
+	buf.UngetWriteBuf(len);
+	buf.AppendByte('\0');
+
+	const char *data = (const char *)buf.GetData();
+	if (!strncmp(data, JOURNAL_HEADER, strlen(JOURNAL_HEADER)))
+	{
+		// A truncated record at the end is dropped by the rewrite
+		if (!LoadJournal(data, len))
+			Compact();
+	}
+	else if (len > 0)
+	{
+		if (LoadXml())
+			Compact();
+		else
+		{
+			wxMessageBox(_("Failed to load the history file!"));
+			::wxRemoveFile(fileName);
+			return;
+		}
+	}
+
+	Trim();
+	if (records > (long)queries.GetCount() * 2 + JOURNAL_SLACK)
+		Compact();
+}
+
+
+bool sysQueryHistory::LoadJournal(const char *data, size_t len)
+{
+	size_t pos = strlen(JOURNAL_HEADER);
+
+	while (pos < len)
+	{
+		const char *nl = (const char *)memchr(data + pos, '\n', len - pos);
+		if (!nl || nl - (data + pos) < 3 || data[pos + 1] != ' ')
+			return false;
+
+		long value = atol(data + pos + 2);
+		char type = data[pos];
+		pos = nl - data + 1;
+
+		if (type == '+')
+		{
+			if (value < 0 || pos + value + 1 > len || data[pos + value] != '\n')
+				return false;
+
+			wxString query(data + pos, wxConvUTF8, value);
+			pos += value + 1;
+
+			queryHistoryIndex::iterator it = index.find(query);
+			if (it != index.end())
+				RemoveAt(FindSerial(it->second));
+			AddEntry(query);
+		}
+		else if (type == '-')
+		{
+			int n = FindSerial(value);
+			if (n != wxNOT_FOUND)
+				RemoveAt(n);
+		}
+		else
+			return false;
+
+		records++;
+	}
+
+	return true;
+}
+
+
+bool sysQueryHistory::LoadXml()
+{
+	xmlDocPtr doc = xmlParseFile((const char *)fileName.mb_str(wxConvUTF8));
+	if (doc == NULL)
+		return false;
+
+	xmlNodePtr cur = xmlDocGetRootElement(doc);
+	if (cur == NULL || xmlStrcmp(cur->name, (const xmlChar *) "histoqueries"))
+	{
+		xmlFreeDoc(doc);
+		return false;
+	}
+
+	for (cur = cur->xmlChildrenNode ; cur != NULL ; cur = cur->next)
+	{
+		if (xmlStrcmp(cur->name, (const xmlChar *)"histoquery"))
+			continue;
+
+		xmlChar *key = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+		if (key)
+		{
+			wxString query = WXSTRING_FROM_XML(key);
+			if (!query.IsEmpty())
+			{
+				queryHistoryIndex::iterator it = index.find(query);
+				if (it != index.end())
+					RemoveAt(FindSerial(it->second));
+				AddEntry(query);
+			}
+			xmlFree(key);
+		}
+	}
+
+	xmlFreeDoc(doc);
+	return true;
+}
+
+
+// Rewrite the file with one record per live query, renumbering the serials
+void sysQueryHistory::Compact()
+{
+	wxString tmpName = fileName + wxT(".tmp");
+	wxFile f;
+	if (!f.Create(tmpName, true))
+	{
+		wxLogError(_("Failed to write to history file!"));
+		return;
+	}
+
+	bool ok = f.Write(JOURNAL_HEADER, strlen(JOURNAL_HEADER)) == strlen(JOURNAL_HEADER);
+
+	size_t i;
+	for (i = 0 ; i < queries.GetCount() && ok ; i++)
+	{
+		wxCharBuffer text = queries.Item(i).mb_str(wxConvUTF8);
+		size_t len = strlen(text);
+		wxCharBuffer head = wxString::Format(wxT("+ %ld\n"), (long)len).mb_str(wxConvUTF8);
+
+		ok = f.Write(head, strlen(head)) == strlen(head)
+		     && f.Write(text, len) == len
+		     && f.Write("\n", 1) == 1;
+
+		serials[i] = i;
+		index[queries.Item(i)] = i;
+	}
+	f.Close();
+
+	nextSerial = queries.GetCount();
+	records = queries.GetCount();
+
+	if (!ok || !wxRenameFile(tmpName, fileName, true))
+	{
+		wxLogError(_("Failed to write to history file!"));
+		::wxRemoveFile(tmpName);
+	}
+}
+
+
+// The change is already applied in memory; a missing file is recreated
+// from there so that the serials in it stay consistent.
+void sysQueryHistory::WriteRecord(const wxMemoryBuffer &record)
+{
+	if (!wxFile::Exists(fileName))
+	{
+		Compact();
+		return;
+	}
+
+	wxFile f;
+	if (!f.Open(fileName, wxFile::write_append))
+	{
+		wxLogError(_("Failed to write to history file!"));
+		return;
+	}
+
+	if (f.Write(record.GetData(), record.GetDataLen()) != record.GetDataLen())
+		wxLogError(_("Failed to write to history file!"));
+	else
+		records++;
+}